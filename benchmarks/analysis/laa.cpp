@@ -0,0 +1,114 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <bloom/analysis/laa.hpp>
+#include <bloom/foundation/context.hpp>
+#include <bloom/foundation/pass-context.hpp>
+#include <bloom/foundation/region.hpp>
+#include <bloom/ir/builder.hpp>
+
+/* one function with N loads and N stores spread over N / 16 stack objects of 256 bytes,
+ * each access at a literal offset; the first few go through an escaped parameter so that
+ * the may-alias-anything path is exercised too */
+
+namespace
+{
+	blm::Node *build_function(blm::Builder &builder, const std::string &name, const std::int64_t accesses)
+	{
+		auto func = builder.create_function(name, { blm::DataType::POINTER }, blm::DataType::VOID);
+		func.body([&]
+		{
+			auto *param = func.add_parameter("escaped", blm::DataType::POINTER);
+			auto *value = builder.literal(7);
+
+			std::vector<blm::Node *> objects;
+			for (std::int64_t i = 0; i < std::max<std::int64_t>(accesses / 16, 1); ++i)
+				objects.push_back(builder.stack_alloc(builder.literal(256), blm::DataType::INT32));
+
+			std::uint32_t seed = 1;
+			const auto next = [&] { return (seed = seed * 1103515245 + 12345) >> 16; };
+			for (std::int64_t i = 0; i < accesses; ++i)
+			{
+				for (const bool is_store: { true, false })
+				{
+					blm::Node *address = param;
+					if (i >= 8)
+					{
+						auto *offset = builder.literal(static_cast<std::int64_t>(next() % 64) * 4);
+						address = builder.ptr_add(objects[next() % objects.size()], offset);
+					}
+
+					if (is_store)
+						builder.store(value, address);
+					else
+						builder.load(address, blm::DataType::INT32);
+				}
+			}
+		});
+		return func.get_function();
+	}
+}
+
+static void BM_LocalAliasAnalysis(benchmark::State &state)
+{
+	blm::Context ctx;
+	blm::Builder builder(ctx);
+	blm::Module *module = builder.create_module("bench");
+	blm::Node *func = build_function(builder, "memory_heavy", state.range(0));
+	blm::PassContext pass_ctx(*module, 2);
+
+	std::size_t relations = 0;
+	for (auto _: state)
+	{
+		blm::LocalAliasAnalysisPass aa;
+		const auto result = aa.analyze(*module, pass_ctx);
+		const auto &aa_result = dynamic_cast<const blm::LocalAliasResult &>(*result);
+		const blm::FunctionAliasResult *func_result = aa_result.get_function_result(func);
+		benchmark::DoNotOptimize(func_result);
+
+		state.PauseTiming();
+		relations = 0;
+		for (blm::Node *load: func_result->get_all_loads())
+			relations += func_result->get_affecting_stores(load).size();
+		state.ResumeTiming();
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+	state.SetComplexityN(state.range(0));
+	state.counters["relations"] = static_cast<double>(relations);
+}
+BENCHMARK(BM_LocalAliasAnalysis)->RangeMultiplier(4)->Range(1 << 8, 1 << 14)->Complexity()
+                                ->Unit(benchmark::kMillisecond);
+
+/* N functions of 256 accesses each; every iteration edits one function and then queries
+ * all of them again, as a transform rerunning after a local change would */
+static void BM_LocalAliasAfterLocalEdit(benchmark::State &state)
+{
+	blm::Context ctx;
+	blm::Builder builder(ctx);
+	blm::Module *module = builder.create_module("bench");
+	std::vector<blm::Node *> functions;
+	for (std::int64_t i = 0; i < state.range(0); ++i)
+		functions.push_back(build_function(builder, "f" + std::to_string(i), 256));
+	blm::PassContext pass_ctx(*module, 2);
+	const blm::LocalAliasResult &aa_result = blm::get_local_alias_result(*module, pass_ctx);
+	for (const blm::Node *func: functions)
+		benchmark::DoNotOptimize(aa_result.get_function_result(func));
+
+	std::size_t edited = 0;
+	for (auto _: state)
+	{
+		module->get_function_region(functions[edited++ % functions.size()])->mark_changed();
+		blm::get_local_alias_result(*module, pass_ctx);
+		for (const blm::Node *func: functions)
+			benchmark::DoNotOptimize(aa_result.get_function_result(func));
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_LocalAliasAfterLocalEdit)->RangeMultiplier(4)->Range(4, 256)->Complexity()
+                                      ->Unit(benchmark::kMillisecond);
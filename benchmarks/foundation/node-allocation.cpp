@@ -0,0 +1,85 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <cstdint>
+#include <memory>
+#include <unordered_set>
+#include <benchmark/benchmark.h>
+#include <bloom/foundation/context.hpp>
+
+/* each iteration creates a batch of nodes through one shared context; the arena
+ * benchmark runs on several threads at once, the pool and slab ones cannot */
+
+namespace
+{
+	constexpr int BATCH = 128;
+	constexpr int ITERATIONS = 2000;
+
+	std::unique_ptr<blm::Context> shared_context;
+
+	void create_batch(blm::Context &ctx)
+	{
+		for (int i = 0; i < BATCH; ++i)
+		{
+			auto *node = ctx.create<blm::Node>();
+			node->ir_type = blm::NodeType::ADD;
+			benchmark::DoNotOptimize(node);
+		}
+	}
+
+	/* memory actually touched per node: distinct 4 KiB pages spanned by a run of
+	 * nodes, which counts headers, padding and alignment gaps alike */
+	double bytes_per_node(const blm::NodeAllocation mode)
+	{
+		constexpr int count = 16384;
+		constexpr std::uintptr_t page = 4096;
+
+		blm::Context ctx(mode);
+		std::unordered_set<std::uintptr_t> pages;
+		for (int i = 0; i < count; ++i)
+		{
+			const auto begin = reinterpret_cast<std::uintptr_t>(ctx.create<blm::Node>());
+			for (std::uintptr_t p = begin / page; p <= (begin + sizeof(blm::Node) - 1) / page; ++p)
+				pages.insert(p);
+		}
+		return static_cast<double>(pages.size() * page) / count;
+	}
+}
+
+static void BM_NodeCreatePool(benchmark::State &state)
+{
+	blm::Context ctx(blm::NodeAllocation::POOL);
+	for (auto _: state)
+		create_batch(ctx);
+	state.SetItemsProcessed(state.iterations() * BATCH);
+	state.counters["bytes/node"] = bytes_per_node(blm::NodeAllocation::POOL);
+}
+BENCHMARK(BM_NodeCreatePool)->Iterations(ITERATIONS);
+
+static void BM_NodeCreateSlab(benchmark::State &state)
+{
+	blm::Context ctx(blm::NodeAllocation::SLAB);
+	for (auto _: state)
+		create_batch(ctx);
+	state.SetItemsProcessed(state.iterations() * BATCH);
+	state.counters["bytes/node"] = bytes_per_node(blm::NodeAllocation::SLAB);
+}
+BENCHMARK(BM_NodeCreateSlab)->Iterations(ITERATIONS);
+
+static void BM_NodeCreateArena(benchmark::State &state)
+{
+	/* set up and torn down by the first thread; the loop start and end are barriers */
+	if (state.thread_index() == 0)
+		shared_context = std::make_unique<blm::Context>(blm::NodeAllocation::ARENA);
+
+	for (auto _: state)
+		create_batch(*shared_context);
+
+	state.SetItemsProcessed(state.iterations() * BATCH);
+	if (state.thread_index() == 0)
+	{
+		state.counters["chunks"] = static_cast<double>(shared_context->get_arena().chunk_count());
+		state.counters["bytes/node"] = bytes_per_node(blm::NodeAllocation::ARENA);
+		shared_context.reset();
+	}
+}
+BENCHMARK(BM_NodeCreateArena)->Iterations(ITERATIONS)->ThreadRange(1, 8)->UseRealTime();
@@ -0,0 +1,84 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <bloom/foundation/context.hpp>
+#include <bloom/foundation/module.hpp>
+#include <bloom/foundation/region.hpp>
+#include <bloom/ir/builder.hpp>
+
+namespace
+{
+	/* builds `functions` functions, each an arithmetic chain of `ops` nodes */
+	blm::Module *build_module(blm::Builder &builder, const int functions, const int ops)
+	{
+		blm::Module *module = builder.create_module("bench");
+		for (int f = 0; f < functions; ++f)
+		{
+			auto func = builder.create_function("f" + std::to_string(f),
+			                                    { blm::DataType::INT32, blm::DataType::INT32 },
+			                                    blm::DataType::INT32);
+			blm::Node *a = func.add_parameter("a", blm::DataType::INT32);
+			blm::Node *b = func.add_parameter("b", blm::DataType::INT32);
+			func.body([&]
+			{
+				blm::Node *acc = builder.add(a, b);
+				for (int i = 0; i < ops; ++i)
+				{
+					blm::Node *rhs = i % 3 == 0 ? builder.literal(i) : b;
+					acc = i % 2 == 0 ? builder.add(acc, rhs) : builder.mul(acc, rhs);
+				}
+				builder.ret(acc);
+			});
+		}
+		return module;
+	}
+
+	/* bytes held by a node, including the heap blocks of its operand/user vectors */
+	std::size_t node_bytes(const blm::Node *node)
+	{
+		return sizeof(blm::Node) +
+		       node->inputs.capacity() * sizeof(blm::Node *) +
+		       node->users.capacity() * sizeof(blm::Node *);
+	}
+
+	void collect(const blm::Region *region, std::vector<const blm::Node *> &out)
+	{
+		for (const blm::Node *node: region->get_nodes())
+			out.push_back(node);
+		for (const blm::Region *child: region->get_children())
+			collect(child, out);
+	}
+}
+
+static void BM_NodeWalk(benchmark::State &state)
+{
+	blm::Context ctx;
+	blm::Builder builder(ctx);
+	blm::Module *module = build_module(builder, 64, static_cast<int>(state.range(0)));
+
+	std::vector<const blm::Node *> nodes;
+	collect(module->get_root_region(), nodes);
+
+	std::size_t bytes = 0;
+	for (const blm::Node *node: nodes)
+		bytes += node_bytes(node);
+
+	for (auto _: state)
+	{
+		std::size_t sum = 0;
+		for (const blm::Node *node: nodes)
+		{
+			for (const blm::Node *input: node->inputs)
+				sum += static_cast<std::size_t>(input->ir_type);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+
+	state.counters["nodes"] = static_cast<double>(nodes.size());
+	state.counters["bytes/node"] = static_cast<double>(bytes) / static_cast<double>(nodes.size());
+	state.counters["bytes/module"] = static_cast<double>(bytes);
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(nodes.size()));
+}
+BENCHMARK(BM_NodeWalk)->Arg(64)->Arg(1024);
@@ -0,0 +1,109 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <bloom/foundation/context.hpp>
+#include <bloom/foundation/module.hpp>
+#include <bloom/foundation/region.hpp>
+
+/* rewrites every node of a region in place: a replacement is inserted before
+ * the original, which is then removed; the shape of instcombine/constfold rewrites */
+
+static void BM_RegionRewriteVector(benchmark::State &state)
+{
+	/* the vector-backed layout regions used before: find, then insert/erase */
+	const auto count = static_cast<std::size_t>(state.range(0));
+	blm::Context ctx;
+	for (auto _: state)
+	{
+		state.PauseTiming();
+		std::vector<blm::Node *> nodes;
+		nodes.reserve(count);
+		for (std::size_t i = 0; i < count; ++i)
+			nodes.push_back(ctx.create<blm::Node>());
+		const std::vector<blm::Node *> originals = nodes;
+		state.ResumeTiming();
+
+		for (blm::Node *original: originals)
+		{
+			blm::Node *replacement = ctx.create<blm::Node>();
+			nodes.insert(std::ranges::find(nodes, original), replacement);
+			nodes.erase(std::ranges::find(nodes, original));
+		}
+		benchmark::DoNotOptimize(nodes.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RegionRewriteVector)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+static void BM_RegionRewriteList(benchmark::State &state)
+{
+	const auto count = static_cast<std::size_t>(state.range(0));
+	blm::Context ctx;
+	blm::Module module(ctx, "bench");
+	for (auto _: state)
+	{
+		state.PauseTiming();
+		blm::Region *region = module.create_region("rewrite");
+		for (std::size_t i = 0; i < count; ++i)
+			region->create_node<blm::Node>();
+		const std::vector<blm::Node *> originals = region->get_nodes().snapshot();
+		state.ResumeTiming();
+
+		for (blm::Node *original: originals)
+		{
+			blm::Node *replacement = ctx.create<blm::Node>();
+			region->insert_node_before(original, replacement);
+			region->remove_node(original);
+		}
+		benchmark::DoNotOptimize(region->get_nodes().size());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RegionRewriteList)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+namespace
+{
+	/* one function body per thread, each holding a single node */
+	struct ParallelBodies
+	{
+		blm::Context ctx;
+		blm::Module module { ctx, "bench" };
+		std::vector<blm::Region *> bodies;
+		std::vector<blm::Node *> nodes;
+	};
+
+	std::unique_ptr<ParallelBodies> parallel_bodies;
+}
+
+static void BM_RegionEditParallel(benchmark::State &state)
+{
+	/* workers of a function pipeline edit sibling bodies of the root region; each edit
+	 * only touches its own region, so throughput should scale with the threads */
+	if (state.thread_index() == 0)
+	{
+		parallel_bodies = std::make_unique<ParallelBodies>();
+		for (int i = 0; i < state.threads(); ++i)
+		{
+			blm::Region *body = parallel_bodies->module.create_region("body" + std::to_string(i));
+			parallel_bodies->bodies.push_back(body);
+			parallel_bodies->nodes.push_back(body->create_node<blm::Node>());
+		}
+	}
+
+	for (auto _: state)
+	{
+		blm::Region *body = parallel_bodies->bodies[static_cast<std::size_t>(state.thread_index())];
+		blm::Node *node = parallel_bodies->nodes[static_cast<std::size_t>(state.thread_index())];
+		body->remove_node(node);
+		body->add_node(node);
+	}
+	state.SetItemsProcessed(state.iterations() * 2);
+
+	if (state.thread_index() == 0)
+		parallel_bodies.reset();
+}
+BENCHMARK(BM_RegionEditParallel)->ThreadRange(1, 8)->UseRealTime();
@@ -0,0 +1,82 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <bloom/foundation/type-registry.hpp>
+
+/* struct-heavy workload: a few hundred record types built from scalars, pointers
+ * and arrays, queried the way SROA, the printer and alias analysis do */
+
+namespace
+{
+	constexpr int STRUCTS = 256;
+
+	struct Workload
+	{
+		blm::TypeRegistry registry;
+		std::vector<std::vector<std::pair<std::string, blm::DataType> > > layouts;
+		std::vector<blm::DataType> structs;
+
+		Workload()
+		{
+			const blm::DataType scalars[] = { blm::DataType::INT8, blm::DataType::INT32, blm::DataType::FLOAT64 };
+			for (int i = 0; i < STRUCTS; ++i)
+			{
+				std::vector<std::pair<std::string, blm::DataType> > fields;
+				for (int f = 0; f < 8; ++f)
+				{
+					blm::DataType type = scalars[(i + f) % 3];
+					if (f == 5)
+						type = registry.create_pointer_type(type);
+					if (f == 6)
+						type = registry.create_array_type(type, 4 + i % 7);
+					if (f == 7 && !structs.empty())
+						type = structs[i / 2];
+					fields.emplace_back("field_" + std::to_string(f), type);
+				}
+				structs.push_back(registry.create_struct_type(fields, 64 + i, 8));
+				layouts.push_back(std::move(fields));
+			}
+		}
+	};
+}
+
+static void BM_TypeRegistryGetType(benchmark::State &state)
+{
+	const Workload workload;
+	for (auto _: state)
+	{
+		for (const blm::DataType type: workload.structs)
+		{
+			for (const auto &[name, field]: workload.registry.get_type(type).get<blm::DataType::STRUCT>().fields)
+				benchmark::DoNotOptimize(workload.registry.get_size(field));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * STRUCTS * 9);
+}
+BENCHMARK(BM_TypeRegistryGetType);
+
+static void BM_TypeRegistryCreateExisting(benchmark::State &state)
+{
+	/* re-creating a known struct is a structural lookup that must not copy the fields */
+	Workload workload;
+	for (auto _: state)
+	{
+		for (int i = 0; i < STRUCTS; ++i)
+			benchmark::DoNotOptimize(workload.registry.create_struct_type(workload.layouts[i], 64 + i, 8));
+	}
+	state.SetItemsProcessed(state.iterations() * STRUCTS);
+}
+BENCHMARK(BM_TypeRegistryCreateExisting);
+
+static void BM_TypeRegistryBuild(benchmark::State &state)
+{
+	for (auto _: state)
+	{
+		Workload workload;
+		benchmark::DoNotOptimize(workload.structs.data());
+	}
+	state.SetItemsProcessed(state.iterations() * STRUCTS);
+}
+BENCHMARK(BM_TypeRegistryBuild);
@@ -0,0 +1,79 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <bloom/foundation/context.hpp>
+#include <bloom/ipo/gvn.hpp>
+#include <bloom/ipo/pass-manager.hpp>
+#include <bloom/ir/builder.hpp>
+
+/* 64 modules of 16 functions each; every function loads from a stack object and sums the
+ * same expressions twice, so each module has work for both LAA and CSE. the argument is
+ * the number of workers modules are spread over */
+
+namespace
+{
+	constexpr int module_count = 64;
+	constexpr int functions_per_module = 16;
+	constexpr int terms_per_function = 64;
+
+	void build_function(blm::Builder &builder, const std::string &name)
+	{
+		auto func = builder.create_function(name, { blm::DataType::INT32, blm::DataType::INT32 }, blm::DataType::INT32);
+		func.body([&]
+		{
+			auto *a = func.add_parameter("a", blm::DataType::INT32);
+			auto *b = func.add_parameter("b", blm::DataType::INT32);
+			auto *slot = builder.stack_alloc(builder.literal(64), blm::DataType::INT32);
+			builder.store(a, slot);
+
+			blm::Node *sum = builder.load(slot, blm::DataType::INT32);
+			for (int i = 0; i < terms_per_function; ++i)
+			{
+				/* the second copy of each term is redundant */
+				auto *first = builder.mul(builder.add(a, builder.literal(i)), b);
+				auto *second = builder.mul(builder.add(a, builder.literal(i)), b);
+				sum = builder.add(sum, builder.add(first, second));
+			}
+			builder.ret(sum);
+		});
+	}
+
+	std::vector<blm::Module *> build_modules(blm::Context &ctx)
+	{
+		std::vector<blm::Module *> modules;
+		for (int m = 0; m < module_count; ++m)
+		{
+			blm::Builder builder(ctx);
+			modules.push_back(builder.create_module("m" + std::to_string(m)));
+			for (int f = 0; f < functions_per_module; ++f)
+				build_function(builder, "f" + std::to_string(f));
+		}
+		return modules;
+	}
+}
+
+static void BM_IPOGVNModules(benchmark::State &state)
+{
+	const auto threads = static_cast<std::size_t>(state.range(0));
+	for (auto _: state)
+	{
+		state.PauseTiming();
+		auto ctx = std::make_unique<blm::Context>();
+		std::vector<blm::Module *> modules = build_modules(*ctx);
+		blm::IPOPassManager manager(modules, 2, false, 0, threads);
+		manager.add_pass<blm::IPOGVNPass>();
+		state.ResumeTiming();
+
+		benchmark::DoNotOptimize(manager.run_pass<blm::IPOGVNPass>());
+
+		state.PauseTiming();
+		ctx.reset();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * module_count);
+}
+BENCHMARK(BM_IPOGVNModules)->RangeMultiplier(2)->Range(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
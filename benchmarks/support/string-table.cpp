@@ -0,0 +1,133 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <bloom/support/string-table.hpp>
+
+/* threads intern a shared working set of names, the way parallel module builders
+ * resolve symbols: most calls hit, a few insert names nobody has seen yet */
+
+namespace
+{
+	constexpr int NAMES = 4096;
+	constexpr int MISS_EVERY = 16;
+
+	/* the previous design with the synchronization it was missing: one lock, string keys */
+	class LockedStringTable
+	{
+	public:
+		std::uint64_t intern(const std::string_view str)
+		{
+			std::lock_guard lock(mutex);
+			if (const auto it = ids.find(std::string(str)); it != ids.end())
+				return it->second;
+			strs.emplace_back(str);
+			return ids[std::string(str)] = strs.size();
+		}
+
+	private:
+		std::mutex mutex;
+		std::unordered_map<std::string, std::uint64_t> ids;
+		std::vector<std::string> strs;
+	};
+
+	const std::vector<std::string> &working_set()
+	{
+		static const std::vector<std::string> names = []
+		{
+			std::vector<std::string> out;
+			for (int i = 0; i < NAMES; ++i)
+				out.push_back("module.function_" + std::to_string(i) + ".local");
+			return out;
+		}();
+		return names;
+	}
+
+	/* takes the owner, not the table: it is only set once the loop's start barrier is passed */
+	template<typename Table>
+	void intern_loop(benchmark::State &state, const std::unique_ptr<Table> &table)
+	{
+		const auto &names = working_set();
+		std::size_t cursor = static_cast<std::size_t>(state.thread_index()) * 97;
+		std::uint64_t fresh = 0;
+		std::string miss;
+		for (auto _: state)
+		{
+			for (int i = 0; i < 64; ++i)
+			{
+				cursor = (cursor + 1) % names.size();
+				if (cursor % MISS_EVERY == 0)
+				{
+					miss = "tmp." + std::to_string(state.thread_index()) + "." + std::to_string(fresh++);
+					benchmark::DoNotOptimize(table->intern(miss));
+				}
+				else
+				{
+					benchmark::DoNotOptimize(table->intern(names[cursor]));
+				}
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * 64);
+	}
+
+	std::unique_ptr<blm::StringTable> sharded;
+	std::unique_ptr<LockedStringTable> locked;
+}
+
+static void BM_StringTableShardedIntern(benchmark::State &state)
+{
+	if (state.thread_index() == 0)
+	{
+		sharded = std::make_unique<blm::StringTable>();
+		for (const std::string &name: working_set())
+			sharded->intern(name);
+	}
+
+	intern_loop(state, sharded);
+
+	if (state.thread_index() == 0)
+		sharded.reset();
+}
+BENCHMARK(BM_StringTableShardedIntern)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_StringTableLockedIntern(benchmark::State &state)
+{
+	if (state.thread_index() == 0)
+	{
+		locked = std::make_unique<LockedStringTable>();
+		for (const std::string &name: working_set())
+			locked->intern(name);
+	}
+
+	intern_loop(state, locked);
+
+	if (state.thread_index() == 0)
+		locked.reset();
+}
+BENCHMARK(BM_StringTableLockedIntern)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_StringTableGet(benchmark::State &state)
+{
+	if (state.thread_index() == 0)
+	{
+		sharded = std::make_unique<blm::StringTable>();
+		for (const std::string &name: working_set())
+			sharded->intern(name);
+	}
+
+	std::uint64_t id = static_cast<std::uint64_t>(state.thread_index());
+	for (auto _: state)
+	{
+		id = id % NAMES + 1;
+		benchmark::DoNotOptimize(sharded->get(id));
+	}
+	state.SetItemsProcessed(state.iterations());
+
+	if (state.thread_index() == 0)
+		sharded.reset();
+}
+BENCHMARK(BM_StringTableGet)->ThreadRange(1, 8)->UseRealTime();
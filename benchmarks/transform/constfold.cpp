@@ -0,0 +1,85 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <memory>
+#include <benchmark/benchmark.h>
+#include <bloom/foundation/context.hpp>
+#include <bloom/foundation/module.hpp>
+#include <bloom/foundation/pass-context.hpp>
+#include <bloom/foundation/region.hpp>
+#include <bloom/transform/constfold.hpp>
+
+/* one function holding a chain `x0 = 1 + 1, x(i) = x(i-1) + 1` that folds down to a
+ * single literal; time per node should stay flat as the chain grows */
+
+namespace
+{
+	void connect(blm::Node *user, blm::Node *input)
+	{
+		user->inputs.push_back(input);
+		input->users.push_back(user);
+	}
+
+	void build_chain(blm::Module &module, const std::int64_t length, const bool reversed)
+	{
+		blm::Region *region = module.create_region("chain");
+		blm::Node *one = module.intern_literal<blm::DataType::INT64>(1);
+
+		blm::Node *ret = region->create_node<blm::Node>();
+		ret->ir_type = blm::NodeType::RET;
+
+		blm::Node *previous = one;
+		for (std::int64_t i = 0; i < length; ++i)
+		{
+			auto *add = module.get_context().create<blm::Node>();
+			add->ir_type = blm::NodeType::ADD;
+			add->type_kind = blm::DataType::INT64;
+			connect(add, previous);
+			connect(add, one);
+
+			/* reversed chains list every user before its input */
+			if (reversed)
+				region->insert_at_beginning(add);
+			else
+				region->insert_node_before(ret, add);
+			previous = add;
+		}
+		connect(ret, previous);
+	}
+
+	void run_chain(benchmark::State &state, const bool reversed)
+	{
+		const std::int64_t length = state.range(0);
+		for (auto _: state)
+		{
+			state.PauseTiming();
+			auto ctx = std::make_unique<blm::Context>();
+			blm::Module *module = ctx->create_module("bench");
+			build_chain(*module, length, reversed);
+			blm::PassContext pass_ctx(*module, 0);
+			blm::ConstantFoldingPass pass;
+			state.ResumeTiming();
+
+			benchmark::DoNotOptimize(pass.run(*module, pass_ctx));
+
+			state.PauseTiming();
+			ctx.reset();
+			state.ResumeTiming();
+		}
+		state.SetItemsProcessed(state.iterations() * length);
+		state.SetComplexityN(length);
+	}
+}
+
+static void BM_ConstantFoldChain(benchmark::State &state)
+{
+	run_chain(state, false);
+}
+BENCHMARK(BM_ConstantFoldChain)->RangeMultiplier(4)->Range(1 << 10, 1 << 16)->Complexity(benchmark::oN)
+                               ->Unit(benchmark::kMillisecond);
+
+static void BM_ConstantFoldReversedChain(benchmark::State &state)
+{
+	run_chain(state, true);
+}
+BENCHMARK(BM_ConstantFoldReversedChain)->RangeMultiplier(4)->Range(1 << 10, 1 << 16)->Complexity(benchmark::oN)
+                                       ->Unit(benchmark::kMillisecond);
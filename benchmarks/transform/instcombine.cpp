@@ -0,0 +1,201 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <memory>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <bloom/foundation/context.hpp>
+#include <bloom/foundation/module.hpp>
+#include <bloom/foundation/pass-context.hpp>
+#include <bloom/foundation/region.hpp>
+#include <bloom/transform/instcombine/instcombine.hpp>
+#include <bloom/transform/instcombine/rewrite-rule.hpp>
+
+/* rule matching with the opcode-indexed table against trying every rule in turn, over a
+ * stream of nodes with a mix of opcodes much like instcombine sees; most nodes match no
+ * rule, which is where the table saves the most */
+
+namespace
+{
+	bool is_lit(const blm::Node *node)
+	{
+		return node->ir_type == blm::NodeType::LIT;
+	}
+
+	/* shaped like the instcombine rules: a few per arithmetic and bitwise opcode, each
+	 * checking its operands before rewriting */
+	constexpr auto rules = blm::make_rule_set(
+		blm::Rewrite::binary<blm::NodeType::ADD>(
+			blm::Rewrite::when([](const blm::RewriteState &s) { return s.rhs()->ir_type == blm::NodeType::SUB; }),
+			blm::Rewrite::to([](const blm::RewriteState &s) { return s.lhs(); })),
+		blm::Rewrite::binary<blm::NodeType::ADD>(
+			blm::Rewrite::when([](const blm::RewriteState &s) { return s.lhs()->ir_type == blm::NodeType::SUB; }),
+			blm::Rewrite::to([](const blm::RewriteState &s) { return s.rhs(); })),
+		blm::Rewrite::binary<blm::NodeType::SUB>(
+			blm::Rewrite::when([](const blm::RewriteState &s) { return s.rhs()->ir_type == blm::NodeType::BAND; }),
+			blm::Rewrite::to([](const blm::RewriteState &s) { return s.lhs(); })),
+		blm::Rewrite::binary<blm::NodeType::SUB, blm::NodeType::BXOR>(
+			blm::Rewrite::same_operands(),
+			blm::Rewrite::to([](const blm::RewriteState &s) { return s.lhs(); })),
+		blm::Rewrite::binary<blm::NodeType::BAND, blm::NodeType::BOR>(
+			blm::Rewrite::same_operands(),
+			blm::Rewrite::to([](const blm::RewriteState &s) { return s.lhs(); })),
+		blm::Rewrite::binary<blm::NodeType::EQ, blm::NodeType::GTE, blm::NodeType::LTE>(
+			blm::Rewrite::same_operands(),
+			blm::Rewrite::to([](const blm::RewriteState &s) { return s.lhs(); })),
+		blm::Rewrite::binary<blm::NodeType::NEQ, blm::NodeType::GT, blm::NodeType::LT>(
+			blm::Rewrite::same_operands(),
+			blm::Rewrite::to([](const blm::RewriteState &s) { return s.lhs(); })),
+		blm::Rewrite::binary<blm::NodeType::ADD, blm::NodeType::SUB, blm::NodeType::BOR,
+		                     blm::NodeType::BXOR, blm::NodeType::BSHL, blm::NodeType::BSHR>(
+			blm::Rewrite::when([](const blm::RewriteState &s) { return is_lit(s.rhs()); }),
+			blm::Rewrite::to([](const blm::RewriteState &s) { return s.lhs(); })),
+		blm::Rewrite::binary<blm::NodeType::MUL, blm::NodeType::BAND>(
+			blm::Rewrite::when([](const blm::RewriteState &s) { return is_lit(s.lhs()); }),
+			blm::Rewrite::to([](const blm::RewriteState &s) { return s.rhs(); })),
+		blm::Rewrite::binary<blm::NodeType::MUL, blm::NodeType::DIV>(
+			blm::Rewrite::when([](const blm::RewriteState &s) { return is_lit(s.rhs()); }),
+			blm::Rewrite::to([](const blm::RewriteState &s) { return s.lhs(); })),
+		blm::Rewrite::binary<blm::NodeType::MUL>(
+			blm::Rewrite::when([](const blm::RewriteState &s) { return s.lhs()->ir_type == blm::NodeType::SUB; }),
+			blm::Rewrite::to([](const blm::RewriteState &s) { return s.rhs(); })),
+		blm::Rewrite::binary<blm::NodeType::BAND>(
+			blm::Rewrite::when([](const blm::RewriteState &s) { return s.rhs()->ir_type == blm::NodeType::BOR; }),
+			blm::Rewrite::to([](const blm::RewriteState &s) { return s.lhs(); })),
+		blm::Rewrite::binary<blm::NodeType::BOR>(
+			blm::Rewrite::when([](const blm::RewriteState &s) { return s.rhs()->ir_type == blm::NodeType::BAND; }),
+			blm::Rewrite::to([](const blm::RewriteState &s) { return s.lhs(); })),
+		blm::Rewrite::binary<blm::NodeType::LT, blm::NodeType::GTE>(
+			blm::Rewrite::when([](const blm::RewriteState &s) { return is_lit(s.rhs()); }),
+			blm::Rewrite::to([](const blm::RewriteState &s) { return s.lhs(); })),
+		blm::Rewrite::binary<blm::NodeType::EQ, blm::NodeType::NEQ>(
+			blm::Rewrite::when([](const blm::RewriteState &s) { return is_lit(s.lhs()); }),
+			blm::Rewrite::to([](const blm::RewriteState &s) { return s.rhs(); })),
+		blm::Rewrite::unary<blm::NodeType::BNOT>(
+			blm::Rewrite::when([](const blm::RewriteState &s) { return s.operand()->ir_type == blm::NodeType::BNOT; }),
+			blm::Rewrite::to([](const blm::RewriteState &s) { return s.operand()->inputs[0]; }))
+	);
+
+	/* operands are parameters, so no rule beyond the same-operand ones fires */
+	std::vector<blm::Node *> build_stream(blm::Context &ctx, const std::int64_t count)
+	{
+		constexpr blm::NodeType types[] = {
+			blm::NodeType::ADD, blm::NodeType::SUB, blm::NodeType::MUL, blm::NodeType::BAND,
+			blm::NodeType::BOR, blm::NodeType::LT, blm::NodeType::EQ, blm::NodeType::LOAD,
+			blm::NodeType::STORE, blm::NodeType::CALL, blm::NodeType::PTR_ADD, blm::NodeType::RET,
+		};
+
+		auto *x = ctx.create<blm::Node>();
+		x->ir_type = blm::NodeType::PARAM;
+		auto *y = ctx.create<blm::Node>();
+		y->ir_type = blm::NodeType::PARAM;
+
+		std::mt19937 rng(42);
+		std::uniform_int_distribution<std::size_t> pick(0, std::size(types) - 1);
+		std::vector<blm::Node *> nodes;
+		nodes.reserve(count);
+		for (std::int64_t i = 0; i < count; ++i)
+		{
+			auto *node = ctx.create<blm::Node>();
+			node->ir_type = types[pick(rng)];
+			node->inputs = { x, i % 8 == 0 ? x : y };
+			nodes.push_back(node);
+		}
+		return nodes;
+	}
+
+	template<bool Indexed>
+	void run_matching(benchmark::State &state)
+	{
+		blm::Context ctx;
+		const std::vector<blm::Node *> nodes = build_stream(ctx, state.range(0));
+		for (auto _: state)
+		{
+			std::size_t matched = 0;
+			for (blm::Node *node: nodes)
+			{
+				blm::RewriteState s;
+				s.node = node;
+				const blm::BTStatus status = Indexed ? rules.apply(s) : rules.apply_linear(s);
+				matched += status == blm::BTStatus::SUCCESS;
+			}
+			benchmark::DoNotOptimize(matched);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	void connect(blm::Node *user, blm::Node *input)
+	{
+		user->inputs.push_back(input);
+		input->users.push_back(user);
+	}
+
+	/* `acc = acc * 1 + 0`, repeated; every other node simplifies */
+	void build_function(blm::Module &module, const std::int64_t length)
+	{
+		blm::Region *region = module.create_region("body");
+		blm::Node *zero = module.intern_literal<blm::DataType::INT64>(0);
+		blm::Node *one = module.intern_literal<blm::DataType::INT64>(1);
+
+		auto *param = region->create_node<blm::Node>();
+		param->ir_type = blm::NodeType::PARAM;
+		param->type_kind = blm::DataType::INT64;
+
+		blm::Node *acc = param;
+		for (std::int64_t i = 0; i < length; ++i)
+		{
+			auto *mul = region->create_node<blm::Node>();
+			mul->ir_type = blm::NodeType::MUL;
+			mul->type_kind = blm::DataType::INT64;
+			connect(mul, acc);
+			connect(mul, one);
+
+			auto *add = region->create_node<blm::Node>();
+			add->ir_type = blm::NodeType::ADD;
+			add->type_kind = blm::DataType::INT64;
+			connect(add, mul);
+			connect(add, zero);
+			acc = add;
+		}
+
+		auto *ret = region->create_node<blm::Node>();
+		ret->ir_type = blm::NodeType::RET;
+		connect(ret, acc);
+	}
+}
+
+static void BM_RuleMatchIndexed(benchmark::State &state)
+{
+	run_matching<true>(state);
+}
+BENCHMARK(BM_RuleMatchIndexed)->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+
+static void BM_RuleMatchLinear(benchmark::State &state)
+{
+	run_matching<false>(state);
+}
+BENCHMARK(BM_RuleMatchLinear)->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+
+static void BM_Instcombine(benchmark::State &state)
+{
+	const std::int64_t length = state.range(0);
+	for (auto _: state)
+	{
+		state.PauseTiming();
+		auto ctx = std::make_unique<blm::Context>();
+		blm::Module *module = ctx->create_module("bench");
+		build_function(*module, length);
+		blm::PassContext pass_ctx(*module, 0);
+		blm::InstcombinePass pass;
+		state.ResumeTiming();
+
+		benchmark::DoNotOptimize(pass.run(*module, pass_ctx));
+
+		state.PauseTiming();
+		ctx.reset();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * length * 2);
+	state.SetComplexityN(length);
+}
+BENCHMARK(BM_Instcombine)->RangeMultiplier(4)->Range(1 << 10, 1 << 16)->Complexity(benchmark::oN)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,184 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <bloom/foundation/analysis-pass.hpp>
+#include <bloom/foundation/pass-context.hpp>
+#include <bloom/foundation/region.hpp>
+
+namespace blm
+{
+	/**
+	 * @brief Dominator tree over the region graph
+	 *
+	 * The control flow graph has an edge from every region to each of its children
+	 * (structured entry) and to the regions targeted by its JUMP, BRANCH and INVOKE
+	 * nodes. Immediate dominators are computed with the Cooper-Harvey-Kennedy
+	 * iterative algorithm over reverse postorder; the tree is then numbered with a
+	 * depth-first pre/post order so `dominates` is a constant-time interval check.
+	 *
+	 * Only regions reachable from the entry are part of the tree; queries about any
+	 * other region answer as if it were dominated by nothing but itself.
+	 */
+	class DominatorTree
+	{
+	public:
+		DominatorTree() = default;
+
+		/**
+		 * @brief Build the tree for every region reachable from an entry region
+		 * @param entry The entry region, usually the module root region
+		 */
+		explicit DominatorTree(Region *entry);
+
+		/**
+		 * @brief Rebuild the tree from scratch
+		 * @param entry The entry region
+		 */
+		void recalculate(Region *entry);
+
+		/**
+		 * @brief Check whether `a` dominates `b`; every region dominates itself
+		 */
+		[[nodiscard]] bool dominates(const Region *a, const Region *b) const;
+
+		/**
+		 * @brief Check whether `a` dominates `b` and is distinct from it
+		 */
+		[[nodiscard]] bool strictly_dominates(const Region *a, const Region *b) const
+		{
+			return a != b && dominates(a, b);
+		}
+
+		/**
+		 * @brief Get the immediate dominator of a region
+		 * @return The immediate dominator, or nullptr for the entry and unknown regions
+		 */
+		[[nodiscard]] Region *get_idom(const Region *region) const;
+
+		/**
+		 * @brief Get the closest region that dominates both `a` and `b`
+		 * @return The common dominator, or nullptr if either region is not in the tree
+		 */
+		[[nodiscard]] Region *nearest_common_dominator(const Region *a, const Region *b) const;
+
+		/**
+		 * @brief Check whether a region is reachable from the entry
+		 */
+		[[nodiscard]] bool contains(const Region *region) const
+		{
+			return index.contains(region);
+		}
+
+		/**
+		 * @brief Get the entry region, or nullptr for an empty tree
+		 */
+		[[nodiscard]] Region *get_root() const
+		{
+			return order.empty() ? nullptr : order.front();
+		}
+
+		/**
+		 * @brief Get the reachable regions in reverse postorder
+		 */
+		[[nodiscard]] const std::vector<Region *> &get_reverse_post_order() const
+		{
+			return order;
+		}
+
+		[[nodiscard]] std::size_t size() const
+		{
+			return order.size();
+		}
+
+	private:
+		/* all per-region tables are indexed by reverse postorder number */
+		std::unordered_map<const Region *, std::uint32_t> index;
+		std::vector<Region *> order;
+		std::vector<std::uint32_t> idom;
+		std::vector<std::uint32_t> pre;
+		std::vector<std::uint32_t> post;
+
+		void compute_idoms(const std::vector<std::vector<std::uint32_t> > &preds);
+
+		void number_tree();
+	};
+
+	/**
+	 * @brief Analysis result holding the module-wide dominator tree
+	 */
+	class DominatorTreeResult final : public AnalysisResult
+	{
+	public:
+		explicit DominatorTreeResult(DominatorTree tree) : tree(std::move(tree)) {}
+
+		[[nodiscard]] const DominatorTree &get_tree() const
+		{
+			return tree;
+		}
+
+		/**
+		 * @brief Check if this analysis is invalidated by a transform
+		 * @param transform_type The type of transform pass
+		 * @return True if invalidated
+		 */
+		bool invalidated_by(const std::type_info &transform_type) const override;
+
+		/**
+		 * @brief Built from regions and their control edges only, so it survives CFG-preserving transforms
+		 * @param transform_type The type of transform pass
+		 * @param preserved The analyses the transform left intact
+		 * @return False if the transform kept the CFG
+		 */
+		bool invalidated_by(const std::type_info &transform_type, const PreservedAnalyses &preserved) const override;
+
+	private:
+		DominatorTree tree;
+	};
+
+	/**
+	 * @brief Analysis pass that builds the dominator tree of the module's regions
+	 */
+	class DominatorTreeAnalysisPass final : public AnalysisPass
+	{
+	public:
+		/**
+		 * @brief Get the name of this pass
+		 */
+		[[nodiscard]] std::string_view name() const override
+		{
+			return "dominator-tree";
+		}
+
+		/**
+		 * @brief Get the description of this pass
+		 */
+		[[nodiscard]] std::string_view description() const override
+		{
+			return "computes region dominance over structured and unstructured control edges";
+		}
+
+		/**
+		 * @brief Build the dominator tree rooted at the module root region
+		 * @param module The module to analyze
+		 * @param context The pass context
+		 * @return Dominator tree result
+		 */
+		std::unique_ptr<AnalysisResult> analyze(Module &module, PassContext &context) override;
+	};
+
+	/**
+	 * @brief Helper function to get the cached dominator tree from pass context
+	 * @param context The pass context
+	 * @return Pointer to the dominator tree, or nullptr if not available
+	 */
+	inline const DominatorTree *get_dominator_tree(const PassContext &context)
+	{
+		/* analysis results are stored under the type of the pass that produced them */
+		const auto *result = context.get_result<DominatorTreeResult>(typeid(DominatorTreeAnalysisPass));
+		return result ? &result->get_tree() : nullptr;
+	}
+}
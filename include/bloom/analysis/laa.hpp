@@ -2,10 +2,17 @@
 
 #pragma once
 
-#include <set>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <unordered_map>
-#include <unordered_set>
+#include <utility>
+#include <vector>
 #include <bloom/foundation/analysis-pass.hpp>
+#include <bloom/foundation/data-layout.hpp>
+#include <bloom/foundation/node-numbering.hpp>
 
 namespace blm
 {
@@ -51,49 +58,42 @@ namespace blm
 	};
 
 	/**
-	 * @brief Result class for local alias analysis
+	 * @brief Alias facts of one function
+	 *
+	 * Per-node facts live in side arrays over the function body's range of the module's node
+	 * numbering; nodes outside that range, or created after the analysis ran, have no
+	 * recorded facts.
 	 */
-	class LocalAliasResult final : public AnalysisResult
+	class FunctionAliasResult
 	{
 	public:
 		/**
-		 * @brief Check whether a transform pass invalidates this analysis
+		 * @param numbering Numbering of the analyzed module; must outlive the result
+		 * @param range Range of the function body in the numbering
 		 */
-		[[nodiscard]] bool invalidated_by(const std::type_info &transform_type) const override;
-
-		/**
-		 * @brief Add a memory location for a pointer
-		 */
-		void add_location(Node *ptr, MemoryLocation loc);
+		FunctionAliasResult(const NodeNumbering &numbering, NodeRange range);
 
-		/**
-		 * @brief Get the memory location for a pointer
-		 */
-		[[nodiscard]] const MemoryLocation *get_location(Node *ptr) const;
+		[[nodiscard]] NodeRange get_range() const
+		{
+			return range;
+		}
 
 		/**
-		 * @brief Determine the alias relationship between two pointers
+		 * @brief Follow a renumber of the module that left the function body as it was
+		 * @param moved The body's range in the current numbering; must have the same size
 		 */
-		[[nodiscard]] AliasResult alias(Node *a, Node *b) const;
+		void rebase(NodeRange moved);
 
 		/**
-		 * @brief Get whether two pointers may alias
+		 * @brief Add a memory location for a pointer
+		 * @note A location always has a base; a null base reads as no location
 		 */
-		[[nodiscard]] bool may_alias(Node *a, Node *b) const
-		{
-			const auto result = alias(a, b);
-			return result == AliasResult::MAY_ALIAS ||
-			       result == AliasResult::MUST_ALIAS ||
-			       result == AliasResult::PARTIAL_ALIAS;
-		}
+		void add_location(Node *ptr, MemoryLocation loc);
 
 		/**
-		 * @brief Get whether two pointers must alias
+		 * @brief Get the memory location for a pointer
 		 */
-		[[nodiscard]] bool must_alias(Node *a, Node *b) const
-		{
-			return alias(a, b) == AliasResult::MUST_ALIAS;
-		}
+		[[nodiscard]] const MemoryLocation *get_location(Node *ptr) const;
 
 		/**
 		 * @brief Add an allocation site to track
@@ -166,24 +166,201 @@ namespace blm
 		 */
 		bool maybe_modified_by(Node* load, Node* store) const;
 
-		std::unordered_set<Node*> get_all_loads()
+		/**
+		 * @brief Index the added store/load relations for lookup
+		 *
+		 * Relations are collected as pairs and then laid out once in both directions as
+		 * flat arrays sorted by node index, without duplicates. Relations added later are
+		 * not visible until this is called again.
+		 */
+		void finalize_relations();
+
+		[[nodiscard]] const std::vector<Node*> &get_all_loads() const
 		{
 			return all_loads;
 		}
 
-		std::unordered_set<Node*> get_all_stores()
+		[[nodiscard]] const std::vector<Node*> &get_all_stores() const
 		{
 			return all_stores;
 		}
 	private:
-		std::unordered_map<Node *, MemoryLocation> memory_locations;
-		std::unordered_set<Node *> allocation_sites;
-		std::unordered_set<Node *> escaped_pointers;
-		std::unordered_map<Node *, Node *> pointer_copies;
-		std::unordered_map<Node*, std::set<Node*>> store_to_loads;
-		std::unordered_map<Node*, std::set<Node*>> load_to_stores;
-		std::unordered_set<Node*> all_stores;
-		std::unordered_set<Node*> all_loads;
+		const NodeNumbering *numbering;
+		NodeRange range;
+		NodeMap<MemoryLocation> memory_locations;
+		NodeBitVector allocation_sites;
+		NodeBitVector escaped_pointers;
+		NodeMap<Node *> pointer_copies;
+		std::size_t pointer_copy_count = 0;
+		/* one direction of the store/load relation: every node's slice of `targets` */
+		struct RelationIndex
+		{
+			struct Span
+			{
+				std::uint32_t begin = 0;
+				std::uint32_t count = 0;
+			};
+
+			NodeMap<Span> spans;
+			std::vector<Node*> targets;
+
+			[[nodiscard]] std::span<Node* const> of(const Node* node) const
+			{
+				const Span span = spans.get(node);
+				return { targets.data() + span.begin, span.count };
+			}
+		};
+
+		std::vector<std::pair<NodeId, NodeId>> relations; /* (store, load) until finalized */
+		RelationIndex store_to_loads;
+		RelationIndex load_to_stores;
+
+		void build_relation_index(RelationIndex& index, bool by_store);
+		std::vector<Node*> all_stores;
+		std::vector<Node*> all_loads;
+	};
+
+	/**
+	 * @brief Result class for local alias analysis
+	 *
+	 * Holds one `FunctionAliasResult` per function, computed by the first query that
+	 * touches the function and kept for as long as its body region's version (see
+	 * `Region::get_version`) does not change. When the module is renumbered, results of
+	 * unchanged functions are moved onto the new numbering and the others are dropped, so a
+	 * local edit costs one function on the next query instead of the whole module.
+	 *
+	 * Nodes outside every function body, or created after their function was analyzed,
+	 * have no recorded facts.
+	 *
+	 * Queries may come from function passes running in parallel: as long as nobody
+	 * renumbers the module, each function is analyzed once by whichever thread asks first.
+	 * `refresh` must not race with queries.
+	 */
+	class LocalAliasResult final : public AnalysisResult
+	{
+	public:
+		/**
+		 * @param module The analyzed module; must outlive the result
+		 */
+		explicit LocalAliasResult(Module &module);
+
+		/**
+		 * @brief Check whether a transform pass invalidates this analysis
+		 * @return Always false; the result tracks changes per function by itself
+		 */
+		[[nodiscard]] bool invalidated_by(const std::type_info &transform_type) const override;
+
+		/**
+		 * @brief Bring the result up to date with the module
+		 *
+		 * Renumbers the module if it changed, then drops the functions whose body changed.
+		 * Side tables a caller built over the old numbering are invalid afterwards.
+		 */
+		void refresh();
+
+		/**
+		 * @brief Get the facts of a function, analyzing it if no current result is cached
+		 * @return The result, or nullptr if the function has no numbered body
+		 */
+		[[nodiscard]] const FunctionAliasResult *get_function_result(const Node *func) const;
+
+		/**
+		 * @brief Get the memory location for a pointer
+		 */
+		[[nodiscard]] const MemoryLocation *get_location(Node *ptr) const;
+
+		/**
+		 * @brief Determine the alias relationship between two pointers
+		 */
+		[[nodiscard]] AliasResult alias(Node *a, Node *b) const;
+
+		/**
+		 * @brief Get whether two pointers may alias
+		 */
+		[[nodiscard]] bool may_alias(Node *a, Node *b) const
+		{
+			const auto result = alias(a, b);
+			return result == AliasResult::MAY_ALIAS ||
+			       result == AliasResult::MUST_ALIAS ||
+			       result == AliasResult::PARTIAL_ALIAS;
+		}
+
+		/**
+		 * @brief Get whether two pointers must alias
+		 */
+		[[nodiscard]] bool must_alias(Node *a, Node *b) const
+		{
+			return alias(a, b) == AliasResult::MUST_ALIAS;
+		}
+
+		/**
+		 * @brief Check if a node is an allocation site
+		 */
+		[[nodiscard]] bool is_allocation_site(Node *node) const;
+
+		/**
+		 * @brief Check if a pointer has escaped
+		 */
+		[[nodiscard]] bool has_escaped(Node *ptr) const;
+
+		/**
+		 * @brief Get the ultimate source of a pointer through copy chains
+		 */
+		[[nodiscard]] Node *get_pointer_source(Node *ptr) const;
+
+		/**
+		 * @brief Get the stores that may affect a load
+		 */
+		[[nodiscard]] std::vector<Node*> get_affecting_stores(Node* load) const;
+
+		/**
+		 * @brief Get the loads a store may affect
+		 */
+		[[nodiscard]] std::vector<Node*> get_affected_loads(Node* store) const;
+
+		/**
+		 * @brief Determines if a load operation may be modified by a store operation
+		 */
+		[[nodiscard]] bool maybe_modified_by(Node* load, Node* store) const;
+
+	private:
+		/* version of a result computed while its body had changes the numbering does not cover */
+		static constexpr std::uint64_t STALE_VERSION = std::numeric_limits<std::uint64_t>::max();
+		static constexpr std::size_t NO_BODY = std::numeric_limits<std::size_t>::max();
+
+		/* a numbered function body; sorted by range so a node's innermost body is found by search */
+		struct FunctionBody
+		{
+			NodeRange range;
+			Node *func;
+			const Region *body;
+			std::size_t enclosing; /* index of the body this one is nested in, or `NO_BODY` */
+		};
+
+		struct CachedFunction
+		{
+			std::once_flag analyzed;
+			std::unique_ptr<FunctionAliasResult> result;
+			const Region *body = nullptr;
+			std::uint64_t version = STALE_VERSION;
+		};
+
+		Module *module;
+		const NodeNumbering *numbering;
+		mutable std::uint64_t generation;
+		mutable std::vector<FunctionBody> bodies;
+		mutable std::unordered_map<const Node *, std::unique_ptr<CachedFunction> > functions;
+		mutable std::mutex functions_mutex; /* entries are stable; only the map is guarded */
+
+		/* follow a renumber of the module, if there was one since the last call */
+		void sync() const;
+
+		void index_bodies() const;
+
+		const FunctionAliasResult &function_result(const FunctionBody &body) const;
+
+		/* the result of the innermost function body holding a node, or nullptr */
+		const FunctionAliasResult *owner_of(const Node *node) const;
 	};
 
 	/**
@@ -208,42 +385,51 @@ namespace blm
 		}
 
 		/**
-		 * @brief perform local alias analysis on a module
+		 * @brief Create the module's result; functions are analyzed when first queried
 		 */
 		std::unique_ptr<AnalysisResult> analyze(Module &module, PassContext &context) override;
 
-	private:
-		void handle_store(LocalAliasResult& result, Node* node);
+		/**
+		 * @brief Bring the result kept in the context up to date instead of replacing it
+		 */
+		bool run(Module &module, PassContext &context) override;
 
-		void analyze_store_load_relations(LocalAliasResult& result);
+		/**
+		 * @brief Compute the alias facts of one function body
+		 * @param result Result covering the body's range of the module numbering
+		 * @param body The function body region
+		 * @param data_layout Layout of the module's context
+		 */
+		void analyze_function(FunctionAliasResult &result, const Region *body, const DataLayout &data_layout);
 
-		bool addresses_may_alias(LocalAliasResult& result, Node* addr1, Node* addr2) const;
+	private:
+		void handle_store(FunctionAliasResult& result, const Node* node) const;
 
-		void analyze_function(LocalAliasResult &result, Node *func, Module &module);
+		void analyze_store_load_relations(FunctionAliasResult& result) const;
 
-		void analyze_region(LocalAliasResult &result, const Region *region);
+		void analyze_region(FunctionAliasResult &result, const Region *region);
 
-		void analyze_node(LocalAliasResult &result, Node *node);
+		void analyze_node(FunctionAliasResult &result, Node *node);
 
-		void handle_allocation(LocalAliasResult &result, Node *node) const;
+		void handle_allocation(FunctionAliasResult &result, Node *node) const;
 
-		void handle_pointer_arithmetic(LocalAliasResult &result, Node *node);
+		void handle_pointer_arithmetic(FunctionAliasResult &result, Node *node);
 
-		void handle_address_of(LocalAliasResult &result, Node *node) const;
+		void handle_address_of(FunctionAliasResult &result, Node *node) const;
 
-		void handle_parameter(LocalAliasResult &result, Node *node) const;
+		void handle_parameter(FunctionAliasResult &result, Node *node) const;
 
-		void handle_load(LocalAliasResult &result, Node *node) const;
+		void handle_load(FunctionAliasResult &result, Node *node) const;
 
-		void handle_function_call(LocalAliasResult &result, const Node *node) const;
+		void handle_function_call(FunctionAliasResult &result, const Node *node) const;
 
-		void handle_return(LocalAliasResult &result, const Node *node) const;
+		void handle_return(FunctionAliasResult &result, const Node *node) const;
 
-		void handle_cast(LocalAliasResult &result, Node *node) const;
+		void handle_cast(FunctionAliasResult &result, Node *node) const;
 
-		void perform_escape_analysis(LocalAliasResult &result, Module &module);
+		void perform_escape_analysis(FunctionAliasResult &result, const Region *body);
 
-		bool propagate_escapes_in_region(LocalAliasResult &result, const Region *region);
+		bool propagate_escapes_in_region(FunctionAliasResult &result, const Region *region);
 
 		std::uint64_t extract_integer_literal(Node *node) const;
 
@@ -251,6 +437,16 @@ namespace blm
 
 		std::uint64_t get_access_size(Node *node) const;
 
-		[[nodiscard]] std::uint64_t get_type_size(DataType type) const;
+		const DataLayout *layout = nullptr; /* the module context's layout; only valid during `analyze_function()` */
 	};
+
+	/**
+	 * @brief Get the alias result kept in a pass context, creating it on first use
+	 *
+	 * The result is refreshed first, so fetch it before building side tables over the
+	 * module's numbering.
+	 * @param module The module the context belongs to
+	 * @param context The pass context
+	 */
+	const LocalAliasResult &get_local_alias_result(Module &module, PassContext &context);
 }
@@ -35,6 +35,14 @@ namespace blm
 		 */
 		bool invalidated_by(const std::type_info& transform_type) const override;
 
+		/**
+		 * @brief Built from regions and their control edges only, so it survives CFG-preserving transforms
+		 * @param transform_type The type of transform pass
+		 * @param preserved The analyses the transform left intact
+		 * @return False if the transform kept the CFG
+		 */
+		bool invalidated_by(const std::type_info& transform_type, const PreservedAnalyses& preserved) const override;
+
 		class Impl;
 		std::unique_ptr<Impl> pimpl;
 
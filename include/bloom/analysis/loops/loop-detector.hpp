@@ -11,6 +11,8 @@
 
 namespace blm
 {
+	class DominatorTree;
+
 	/**
 	 * @brief Represents a single loop in the loop tree (private implementation)
 	 */
@@ -163,9 +165,10 @@ namespace blm
 		/**
 		 * @brief Analyze a function and build its loop tree
 		 * @param function_region The root region of the function
+		 * @param dom_tree Dominator tree covering the function, or nullptr to build one
 		 * @return LoopTree containing all detected loops
 		 */
-		static LoopTree analyze_function(Region *function_region);
+		static LoopTree analyze_function(Region *function_region, const DominatorTree *dom_tree = nullptr);
 
 	private:
 		/**
@@ -180,9 +183,10 @@ namespace blm
 		/**
 		 * @brief Find all back-edges in the function
 		 * @param root The root region to analyze
+		 * @param dom_tree Dominator tree covering the root region
 		 * @return Vector of back-edges
 		 */
-		static std::vector<BackEdge> find_back_edges(Region *root);
+		static std::vector<BackEdge> find_back_edges(Region *root, const DominatorTree &dom_tree);
 
 		/**
 		 * @brief Build a natural loop from a back-edge
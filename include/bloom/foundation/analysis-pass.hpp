@@ -4,6 +4,7 @@
 
 #include <memory>
 #include <bloom/foundation/pass.hpp>
+#include <bloom/foundation/preserved-analyses.hpp>
 
 namespace blm
 {
@@ -21,6 +22,22 @@ namespace blm
 		 * @return True if this result is invalidated by the transform, false otherwise.
 		 */
 		[[nodiscard]] virtual bool invalidated_by(const std::type_info& transform_type) const = 0;
+
+		/**
+		 * @brief Check if this result is invalidated by a transform pass that kept some analyses.
+		 *
+		 * Only asked when the result was not preserved by name. The default ignores what was
+		 * preserved; results built from the control flow graph alone override it.
+		 * @param transform_type The type information of the transform pass.
+		 * @param preserved The analyses the transform left intact.
+		 * @return True if this result is invalidated by the transform, false otherwise.
+		 */
+		[[nodiscard]] virtual bool invalidated_by(const std::type_info& transform_type,
+		                                          const PreservedAnalyses& preserved) const
+		{
+			(void) preserved;
+			return invalidated_by(transform_type);
+		}
 	};
 
 	/**
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <memory>
+#include <bloom/foundation/data-layout.hpp>
 #include <bloom/foundation/node.hpp>
 #include <bloom/foundation/type-registry.hpp>
 #include <bloom/support/allocator.hpp>
@@ -14,13 +15,27 @@ namespace blm
 	class Module;
 	class Region;
 
+	/**
+	 * @brief Where `Context::create` places nodes
+	 */
+	enum class NodeAllocation : std::uint8_t
+	{
+		/* shared size-class pools; single-threaded only */
+		POOL,
+		/* per-thread bump chunks released with the context; safe for concurrent creation */
+		ARENA,
+		/* header-less size-class pages; densest packing, single-threaded only */
+		SLAB
+	};
+
 	class Context
 	{
 	public:
 		/**
 		 * @brief Construct a new Context
+		 * @param allocation Allocation strategy for nodes created through this context
 		 */
-		Context();
+		explicit Context(NodeAllocation allocation = NodeAllocation::ARENA);
 
 		/**
 		 * @brief Destructor
@@ -37,6 +52,7 @@ namespace blm
 		 * @brief Create a node object in the context
 		 *
 		 * Allocates memory for the node and constructs it with the given arguments.
+		 * In arena mode this may be called from several threads at once.
 		 *
 		 * @tparam T Type of node to create (must derive from Node)
 		 * @tparam Args Types of constructor arguments
@@ -48,12 +64,58 @@ namespace blm
 		T *create(Args &&... args)
 		{
 			constexpr auto size = sizeof(T);
-			void *m = allocator.allocate(size);
+			void *m;
+			switch (allocation)
+			{
+				case NodeAllocation::ARENA:
+					m = arena.allocate(size, alignof(T));
+					break;
+				case NodeAllocation::SLAB:
+					m = slab.allocate(size, alignof(T));
+					break;
+				default:
+					m = allocator.allocate(size);
+					break;
+			}
 			if (!m)
 				throw std::bad_alloc();
 			return new(m) T(std::forward<Args>(args)...);
 		}
 
+		/**
+		 * @brief Get the node allocation strategy of this context
+		 */
+		[[nodiscard]] NodeAllocation get_node_allocation() const
+		{
+			return allocation;
+		}
+
+		/**
+		 * @brief Check whether nodes may be created from several threads at once
+		 *
+		 * Only arena mode is; pool and slab mode share unsynchronised free lists.
+		 */
+		[[nodiscard]] bool supports_concurrent_creation() const
+		{
+			return allocation == NodeAllocation::ARENA;
+		}
+
+		/**
+		 * @brief Get the node arena; empty unless the context is in arena mode
+		 */
+		[[nodiscard]] const ach::arena &get_arena() const
+		{
+			return arena;
+		}
+
+		/**
+		 * @brief Get the node slab; empty unless the context is in slab mode
+		 */
+		[[nodiscard]] const ach::slab &get_slab() const
+		{
+			return slab;
+		}
+
 		/**
 		 * @brief Create a new module
 		 * @param name Name of the module
@@ -116,6 +178,15 @@ namespace blm
 			return type_registry;
 		}
 
+		/**
+		 * @brief Get the layout queries for the registered types
+		 * @return Const reference to the data layout
+		 */
+		const DataLayout &get_data_layout() const
+		{
+			return data_layout;
+		}
+
 		/**
 		 * @brief Create a pointer type
 		 * @param pointee The type being pointed to
@@ -193,10 +264,15 @@ namespace blm
 		}
 
 	private:
+		/* declared first so node memory outlives everything that may still point into it */
+		ach::arena arena;
+		ach::slab slab;
 		ach::allocator<char> allocator;
+		NodeAllocation allocation;
 		std::unordered_map<StringTable::StringId, Module *> module_map;
 		std::vector<std::unique_ptr<Module> > modules;
 		StringTable string_table;
 		TypeRegistry type_registry;
+		DataLayout data_layout { type_registry };
 	};
 }
@@ -0,0 +1,76 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+#include <bloom/foundation/type-registry.hpp>
+#include <bloom/foundation/types.hpp>
+
+namespace blm
+{
+	/**
+	 * @brief Size, alignment and field placement queries over the registered types
+	 *
+	 * Every answer comes from the layout the type registry caches when a type is first
+	 * registered, so queries never walk a struct's field list. Field lookups by offset
+	 * binary search the cached offsets.
+	 */
+	class DataLayout
+	{
+	public:
+		static constexpr std::size_t NO_FIELD = std::numeric_limits<std::size_t>::max();
+
+		explicit DataLayout(const TypeRegistry &registry) : registry(registry) {}
+
+		/**
+		 * @brief Get the size of a type in bytes, or 0 if it has none
+		 */
+		[[nodiscard]] std::uint64_t get_size(const DataType type) const
+		{
+			return registry.get_size(type);
+		}
+
+		/**
+		 * @brief Get the alignment of a type in bytes
+		 */
+		[[nodiscard]] std::uint32_t get_alignment(const DataType type) const
+		{
+			return registry.get_alignment(type);
+		}
+
+		/**
+		 * @brief Get the byte offset of every field of a struct type
+		 * @return Offsets in field order, empty for non-struct types
+		 */
+		[[nodiscard]] const std::vector<std::uint64_t> &get_field_offsets(const DataType struct_type) const
+		{
+			return registry.get_field_offsets(struct_type);
+		}
+
+		/**
+		 * @brief Get the field that starts exactly at an offset
+		 * @return Field index, or `NO_FIELD`
+		 */
+		[[nodiscard]] std::size_t get_field_at(DataType struct_type, std::int64_t offset) const;
+
+		/**
+		 * @brief Get the field whose bytes cover an offset
+		 * @return Field index, or `NO_FIELD` for offsets outside every field (padding included)
+		 */
+		[[nodiscard]] std::size_t get_field_containing(DataType struct_type, std::int64_t offset) const;
+
+		/**
+		 * @brief Lay out a field list that is not (yet) a registered struct
+		 * @return Offsets in field order, following the same rules as registered structs
+		 */
+		[[nodiscard]] std::vector<std::uint64_t> compute_field_offsets(
+			const std::vector<std::pair<std::string, DataType> > &fields) const;
+
+	private:
+		const TypeRegistry &registry;
+	};
+}
@@ -0,0 +1,66 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#pragma once
+
+#include <memory>
+#include <bloom/foundation/module.hpp>
+#include <bloom/foundation/node-numbering.hpp>
+#include <bloom/foundation/transform-pass.hpp>
+
+namespace blm
+{
+	class Region;
+
+	/**
+	 * @brief A function handed to a function pass
+	 */
+	struct FunctionUnit
+	{
+		Module &module;
+		Node *function;
+		Region *body;
+		const NodeNumbering &numbering; /* assigned before the run; nodes created since are unnumbered */
+	};
+
+	/**
+	 * @brief Base class for transforms that work on one function body at a time
+	 *
+	 * A function pass only edits the body it is handed. Everything outside it (pooled
+	 * literals, globals, other functions) may be in use by the same pass running on another
+	 * function at the same time, so user lists of such nodes are only edited under
+	 * `Module::lock_shared_users`, new constants come from `Module::intern_literal`, and the
+	 * module is never renumbered while functions run. Module-wide state the pass needs is
+	 * set up in `prepare`, which runs once on the calling thread before any function.
+	 *
+	 * `run` processes the functions of a module in turn; `FunctionPipeline` runs several
+	 * function passes over many functions at once.
+	 */
+	class FunctionPass : public TransformPass
+	{
+	public:
+		/**
+		 * @brief Set up module-wide state before functions are processed
+		 * @param module The module about to be processed
+		 * @param context The caller's context; results stored here are visible to every worker
+		 */
+		virtual void prepare(Module &module, PassContext &context);
+
+		/**
+		 * @brief Transform one function
+		 * @param unit The function and its body
+		 * @param context Context for statistics; private to the calling thread when functions run in parallel
+		 * @return True if the function changed
+		 */
+		virtual bool run_on_function(const FunctionUnit &unit, PassContext &context) = 0;
+
+		/**
+		 * @brief Create a fresh instance with the same configuration, for another worker thread
+		 */
+		[[nodiscard]] virtual std::unique_ptr<FunctionPass> clone() const = 0;
+
+		/**
+		 * @brief Prepare, then transform every function of the module in turn
+		 */
+		bool run(Module &module, PassContext &context) override;
+	};
+}
@@ -0,0 +1,112 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <bloom/foundation/function-pass.hpp>
+#include <bloom/support/thread-pool.hpp>
+
+namespace blm
+{
+	/**
+	 * @brief Runs a sequence of function passes over every function of a module, functions in parallel
+	 *
+	 * Workers take whole functions off a shared counter and run the full sequence on one
+	 * function before taking the next. Every worker owns a clone of each pass and a child
+	 * `PassContext` for its statistics, which are added to the caller's context once all
+	 * functions are done; analysis results set up by the passes' `prepare` are read from
+	 * the caller's context.
+	 *
+	 * Functions only run in parallel when the module's `Context` allocates from per-thread
+	 * arenas; with a pool or slab context they run one after another on the calling thread.
+	 *
+	 * The sequence can be repeated until it stops changing anything, up to an iteration cap.
+	 * Every function carries a dirty bit; after the first iteration only the functions that
+	 * changed in the previous one are run again.
+	 *
+	 * The pipeline is a transform pass itself, so it can be registered with a `PassManager`
+	 * in place of the individual passes.
+	 */
+	class FunctionPipeline final : public TransformPass
+	{
+	public:
+		/**
+		 * @brief Work done by one iteration of the last run
+		 */
+		struct IterationStats
+		{
+			std::size_t functions = 0; /* functions the sequence ran on */
+			std::size_t changed = 0; /* of those, the ones some pass changed */
+			double time = 0.0; /* wall time in seconds */
+		};
+
+		/**
+		 * @param threads Number of workers; 0 uses one per hardware thread, 1 runs on the calling thread only
+		 */
+		explicit FunctionPipeline(std::size_t threads = 0);
+
+		/**
+		 * @brief Append a pass to the sequence
+		 * @tparam PassT The function pass to append
+		 * @param args Arguments to forward to the pass constructor
+		 */
+		template<typename PassT, typename... Args>
+			requires(std::is_base_of_v<FunctionPass, PassT>)
+		FunctionPipeline &add_pass(Args &&... args)
+		{
+			passes.push_back(std::make_unique<PassT>(std::forward<Args>(args)...));
+			return *this;
+		}
+
+		/**
+		 * @brief Repeat the sequence until no function changes, at most `count` times
+		 * @param count Iteration cap; 1 (the default) runs the sequence once, 0 is treated as 1
+		 */
+		FunctionPipeline &set_max_iterations(std::size_t count);
+
+		/**
+		 * @brief Get the iteration cap
+		 */
+		[[nodiscard]] std::size_t get_max_iterations() const
+		{
+			return max_iterations;
+		}
+
+		/**
+		 * @brief Get what each iteration of the last run did, in order
+		 */
+		[[nodiscard]] const std::vector<IterationStats> &get_iteration_stats() const
+		{
+			return iterations;
+		}
+
+		[[nodiscard]] std::string_view name() const override;
+
+		[[nodiscard]] std::string_view description() const override;
+
+		bool run(Module &module, PassContext &context) override;
+
+		/**
+		 * @brief What every pass preserved on every function of the last run
+		 */
+		[[nodiscard]] PreservedAnalyses preserved_analyses() const override;
+
+		/**
+		 * @brief Get the number of workers functions are spread over
+		 */
+		[[nodiscard]] std::size_t get_thread_count() const
+		{
+			return pool.size();
+		}
+
+	private:
+		std::vector<std::unique_ptr<FunctionPass> > passes;
+		ThreadPool pool;
+		PreservedAnalyses preserved = PreservedAnalyses::all();
+		std::size_t max_iterations = 1;
+		std::vector<IterationStats> iterations;
+	};
+}
@@ -2,9 +2,17 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
+#include <bloom/foundation/node-numbering.hpp>
 #include <bloom/foundation/node.hpp>
+#include <bloom/support/allocator.hpp>
 #include <bloom/support/string-table.hpp>
 
 namespace blm
@@ -58,6 +66,16 @@ namespace blm
 		 */
 		Region *create_region(std::string_view name, Region *parent = nullptr);
 
+		/**
+		 * @brief Destroy a region created in this module
+		 *
+		 * Detaches the region from its parent and drops it from the root region
+		 * and function indexes before returning it to the region slab.
+		 *
+		 * @param region Region to destroy; must hold no nodes and no child regions
+		 */
+		void remove_region(Region *region);
+
 		/**
 		 * @brief Find a function by name
 		 *
@@ -73,16 +91,72 @@ namespace blm
 		 */
 		void add_function(Node *func);
 
+		/**
+		 * @brief Unregister a function node and drop its region binding
+		 *
+		 * @param func Function node to unregister
+		 */
+		void remove_function(Node *func);
+
+		/**
+		 * @brief Get the body region of a function in constant time
+		 *
+		 * The binding is established when the function is registered with `add_function`
+		 * (from its parent region or a root region of the same name) or when such a root
+		 * region is created afterwards; passes that move bodies around update it with
+		 * `set_function_region`.
+		 *
+		 * @param func Function node
+		 * @return Region* The body region, or nullptr if the function has none
+		 */
+		[[nodiscard]] Region *get_function_region(const Node *func) const;
+
+		/**
+		 * @brief Bind a function node to its body region
+		 *
+		 * @param func Function node
+		 * @param region Body region; nullptr drops the binding
+		 */
+		void set_function_region(Node *func, Region *region);
+
 		/**
 		 * @brief Intern a string literal into the read-only data region
 		 *
 		 * This will create a new string node in the read-only data region if it does not already exist.
+		 * Safe to call from function passes running in parallel.
 		 *
 		 * @param str String to intern
 		 * @return Node* Pointer to the interned string node
 		 */
 		Node* intern_string_literal(std::string_view str);
 
+		/**
+		 * @brief Get the shared literal node for a scalar constant
+		 *
+		 * Literals are hash-consed on (type, bit pattern): the first request creates an
+		 * unnamed LIT node at the end of the root region and later requests for the same
+		 * constant return that node. If the node has since been removed from the root
+		 * region a fresh one takes its place. String data is forwarded to
+		 * `intern_string_literal`. Safe to call from function passes running in parallel.
+		 *
+		 * @param value Constant value
+		 * @return Node* The literal, or nullptr if the data is not a scalar or string constant
+		 */
+		Node *intern_literal(const TypedData &value);
+
+		/**
+		 * @brief Get the shared literal node for a scalar constant
+		 * @tparam DT Data type of the literal
+		 * @param value Constant value
+		 */
+		template<DataType DT>
+		Node *intern_literal(const typename DataTypeTraits<DT>::type &value)
+		{
+			TypedData data;
+			data.set<typename DataTypeTraits<DT>::type, DT>(value);
+			return intern_literal(data);
+		}
+
 		/**
 		 * @brief Get the context that owns this module
 		 */
@@ -116,12 +190,84 @@ namespace blm
 			return rodata_region;
 		}
 
+		/**
+		 * @brief Get the dense numbering of every node in this module
+		 *
+		 * Regions report node and child changes to their module, and the numbering is
+		 * reassigned on the first request after such a change. Side tables built over an
+		 * earlier numbering must not be used once it has been reassigned.
+		 */
+		const NodeNumbering &get_numbering();
+
+		/**
+		 * @brief Mark the node numbering as out of date
+		 *
+		 * Called by `Region::mark_changed`. Only the first change after a renumber writes
+		 * the flag; later ones just read it, so parallel workers do not contend on it.
+		 */
+		void mark_numbering_dirty()
+		{
+			if (!numbering_dirty.load(std::memory_order_relaxed))
+				numbering_dirty.store(true, std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief Lock the user lists of nodes that several function bodies can reach
+		 *
+		 * Pooled literals, globals and function nodes are used from many bodies at once
+		 * when function passes run in parallel. Such passes hold this lock while adding or
+		 * removing users of a node that may live outside the body they transform.
+		 */
+		[[nodiscard]] std::unique_lock<std::mutex> lock_shared_users()
+		{
+			return std::unique_lock(shared_users_mutex);
+		}
+
 	private:
 		std::vector<Node *> functions;
-		std::vector<std::unique_ptr<Region> > regions;
+		std::unordered_map<const Node *, Region *> function_regions; /* function node -> body region */
+		std::unordered_map<StringTable::StringId, Region *> root_children; /* first root child region per name */
+		std::unordered_map<StringTable::StringId, Node *> unbound_functions; /* registered before their region existed */
+		struct LiteralKey
+		{
+			DataType type;
+			std::uint64_t bits;
+
+			bool operator==(const LiteralKey &) const = default;
+		};
+
+		struct LiteralKeyHash
+		{
+			std::size_t operator()(const LiteralKey &key) const noexcept
+			{
+				return std::hash<std::uint64_t> {}(key.bits * 0x9E3779B97F4A7C15ull ^ static_cast<std::uint64_t>(key.type));
+			}
+		};
+
+		struct StringLiteralHash
+		{
+			using is_transparent = void;
+
+			std::size_t operator()(const std::string_view str) const noexcept
+			{
+				return std::hash<std::string_view> {}(str);
+			}
+		};
+
+		std::unordered_map<LiteralKey, Node *, LiteralKeyHash> literals; /* root region scalar constants */
+		std::unordered_map<std::string, Node *, StringLiteralHash, std::equal_to<> > string_literals; /* rodata strings */
+		ach::slab region_slab; /* declared before `regions` so it outlives them */
+		std::vector<std::unique_ptr<Region, ach::slab_deleter<Region> > > regions;
 		Context &context;
 		Region *root_region; /* also the global region */
 		Region *rodata_region; /* read-only data region */
 		StringTable::StringId name_id;
+		NodeNumbering numbering;
+		std::atomic<bool> numbering_dirty = true;
+		std::mutex literal_mutex; /* guards both literal pools and their regions */
+		std::mutex shared_users_mutex;
+
+		/* allocates a region from the module slab without linking it to its parent */
+		Region *make_region(std::string_view name, Region *parent);
 	};
 }
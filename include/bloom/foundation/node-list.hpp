@@ -0,0 +1,178 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+#include <bloom/foundation/node.hpp>
+
+namespace blm
+{
+	class Region;
+
+	/**
+	 * @brief Ordered list of the nodes of a region
+	 *
+	 * The list is intrusive: the links live in `Node::region_prev`/`Node::region_next`,
+	 * so a node is in at most one list, the one of its `parent_region`. Insertion,
+	 * removal and membership checks are constant time. Iterators stay valid while nodes
+	 * other than the one under them are inserted or removed; a walk that removes or moves
+	 * the current node captures its successor first, or walks a `snapshot()`. Mutation
+	 * goes through `Region`.
+	 */
+	class NodeList
+	{
+	public:
+		/**
+		 * @brief Bidirectional iterator over the nodes of a list
+		 *
+		 * Removing the node an iterator points at clears the node's links; such an
+		 * iterator can only be compared, not advanced.
+		 */
+		class iterator
+		{
+		public:
+			using iterator_category = std::bidirectional_iterator_tag;
+			using iterator_concept = std::bidirectional_iterator_tag;
+			using value_type = Node *;
+			using difference_type = std::ptrdiff_t;
+			using pointer = Node *const *;
+			using reference = Node *;
+
+			iterator() = default;
+
+			iterator(const NodeList *list, Node *node) : list(list), node(node) {}
+
+			Node *operator*() const
+			{
+				return node;
+			}
+
+			iterator &operator++()
+			{
+				node = node->region_next;
+				return *this;
+			}
+
+			iterator operator++(int)
+			{
+				iterator tmp = *this;
+				++*this;
+				return tmp;
+			}
+
+			iterator &operator--()
+			{
+				node = node ? node->region_prev : list->tail;
+				return *this;
+			}
+
+			iterator operator--(int)
+			{
+				iterator tmp = *this;
+				--*this;
+				return tmp;
+			}
+
+			bool operator==(const iterator &other) const
+			{
+				return node == other.node;
+			}
+
+		private:
+			const NodeList *list = nullptr;
+			Node *node = nullptr;
+		};
+
+		using const_iterator = iterator;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using value_type = Node *;
+		using size_type = std::size_t;
+
+		explicit NodeList(const Region &owner) : owner(owner) {}
+
+		NodeList(const NodeList &) = delete;
+
+		NodeList &operator=(const NodeList &) = delete;
+
+		[[nodiscard]] iterator begin() const
+		{
+			return { this, head };
+		}
+
+		[[nodiscard]] iterator end() const
+		{
+			return { this, nullptr };
+		}
+
+		[[nodiscard]] reverse_iterator rbegin() const
+		{
+			return reverse_iterator(end());
+		}
+
+		[[nodiscard]] reverse_iterator rend() const
+		{
+			return reverse_iterator(begin());
+		}
+
+		[[nodiscard]] std::size_t size() const
+		{
+			return count;
+		}
+
+		[[nodiscard]] bool empty() const
+		{
+			return count == 0;
+		}
+
+		[[nodiscard]] Node *front() const
+		{
+			return head;
+		}
+
+		[[nodiscard]] Node *back() const
+		{
+			return tail;
+		}
+
+		/**
+		 * @brief Get the node at a position
+		 *
+		 * @note Linear in `index`; meant for tests and diagnostics, passes should iterate
+		 */
+		[[nodiscard]] Node *operator[](std::size_t index) const;
+
+		/**
+		 * @brief Copy the current order, for walks that restructure the list as they go
+		 */
+		[[nodiscard]] std::vector<Node *> snapshot() const
+		{
+			return { begin(), end() };
+		}
+
+		/**
+		 * @brief Check whether a node is linked into this list
+		 */
+		[[nodiscard]] bool contains(const Node *node) const
+		{
+			return node && node->parent_region == &owner && (node->region_prev || head == node);
+		}
+
+	private:
+		friend class Region;
+
+		const Region &owner;
+		Node *head = nullptr;
+		Node *tail = nullptr;
+		std::size_t count = 0;
+
+		void link_before(Node *pos, Node *node);
+
+		void link_after(Node *pos, Node *node);
+
+		void unlink(Node *node);
+
+		void clear();
+	};
+}
@@ -0,0 +1,343 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <bloom/foundation/node.hpp>
+
+namespace blm
+{
+	class Module;
+	class Region;
+
+	/**
+	 * @brief Half-open range of node indices
+	 */
+	struct NodeRange
+	{
+		NodeId begin = 0;
+		NodeId end = 0;
+
+		[[nodiscard]] std::size_t size() const
+		{
+			return end - begin;
+		}
+
+		[[nodiscard]] bool contains(const NodeId index) const
+		{
+			return index >= begin && index < end;
+		}
+	};
+
+	/**
+	 * @brief Dense numbering of the nodes of a module
+	 *
+	 * Walks regions in pre-order and writes consecutive indices into `Node::index`, so the
+	 * nodes of a region tree (e.g. a function body) occupy one contiguous range and can be
+	 * addressed by `index - range_of(region).begin` as a per-function index.
+	 *
+	 * Indices stay put until the next `assign`; nodes created afterwards are unnumbered and
+	 * removed nodes keep their slot. A node only counts as numbered if the slot its index
+	 * names still points back at it, so stale or foreign indices read as unnumbered.
+	 */
+	class NodeNumbering
+	{
+	public:
+		/**
+		 * @brief Number the root region tree, the read-only data region and any function
+		 * body outside the root tree
+		 */
+		void assign(const Module &module);
+
+		/**
+		 * @brief Number a single region tree
+		 */
+		void assign(const Region *region);
+
+		/**
+		 * @brief Get the index of a node
+		 * @return The index, or `INVALID_NODE_ID` if this numbering does not cover the node
+		 */
+		[[nodiscard]] NodeId index_of(const Node *node) const
+		{
+			if (!node || node->index >= nodes.size() || nodes[node->index] != node)
+				return INVALID_NODE_ID;
+			return node->index;
+		}
+
+		[[nodiscard]] bool contains(const Node *node) const
+		{
+			return index_of(node) != INVALID_NODE_ID;
+		}
+
+		/**
+		 * @brief Get the node at an index
+		 */
+		[[nodiscard]] Node *operator[](const NodeId index) const
+		{
+			return nodes[index];
+		}
+
+		/**
+		 * @brief Get the index range of a region and all regions nested in it
+		 * @return The range, empty if the region was not numbered
+		 */
+		[[nodiscard]] NodeRange range_of(const Region *region) const;
+
+		/**
+		 * @brief Get the range covering every numbered node
+		 */
+		[[nodiscard]] NodeRange range() const
+		{
+			return { 0, static_cast<NodeId>(nodes.size()) };
+		}
+
+		[[nodiscard]] std::size_t size() const
+		{
+			return nodes.size();
+		}
+
+		[[nodiscard]] const std::vector<Node *> &get_nodes() const
+		{
+			return nodes;
+		}
+
+		/**
+		 * @brief Get how many times this numbering has been assigned
+		 *
+		 * Side tables built over the numbering record it and must not be used across a renumber.
+		 */
+		[[nodiscard]] std::uint64_t get_generation() const
+		{
+			return generation;
+		}
+
+	private:
+		std::vector<Node *> nodes;
+		std::unordered_map<const Region *, NodeRange> ranges;
+		std::uint64_t generation = 0;
+
+		void reset();
+
+		void number_region(const Region *region);
+	};
+
+	/**
+	 * @brief Set of nodes stored as one bit per numbered node
+	 *
+	 * Covers a range of a `NodeNumbering`; nodes outside it (unnumbered, foreign or in
+	 * another function's range) are never members and cannot be inserted.
+	 */
+	class NodeBitVector
+	{
+	public:
+		NodeBitVector() = default;
+
+		explicit NodeBitVector(const NodeNumbering &numbering) : NodeBitVector(numbering, numbering.range()) {}
+
+		NodeBitVector(const NodeNumbering &numbering, const NodeRange range)
+			: numbering(&numbering), range(range), generation(numbering.get_generation()),
+			  words((range.size() + 63) / 64, 0)
+		{}
+
+		/**
+		 * @brief Check whether a node is in the set
+		 */
+		[[nodiscard]] bool contains(const Node *node) const
+		{
+			const NodeId slot = slot_of(node);
+			return slot != INVALID_NODE_ID && (words[slot >> 6] >> (slot & 63) & 1) != 0;
+		}
+
+		/**
+		 * @brief Add a node to the set
+		 * @return `true` if the node was not a member before, `false` if it was or is out of range
+		 */
+		bool insert(const Node *node)
+		{
+			const NodeId slot = slot_of(node);
+			if (slot == INVALID_NODE_ID)
+				return false;
+
+			std::uint64_t &word = words[slot >> 6];
+			const std::uint64_t bit = std::uint64_t { 1 } << (slot & 63);
+			const bool inserted = (word & bit) == 0;
+			word |= bit;
+			return inserted;
+		}
+
+		/**
+		 * @brief Remove a node from the set
+		 */
+		void erase(const Node *node)
+		{
+			if (const NodeId slot = slot_of(node); slot != INVALID_NODE_ID)
+				words[slot >> 6] &= ~(std::uint64_t { 1 } << (slot & 63));
+		}
+
+		/**
+		 * @brief Remove every node from the set
+		 */
+		void clear()
+		{
+			std::ranges::fill(words, 0);
+		}
+
+		/**
+		 * @brief Get the number of nodes in the set
+		 */
+		[[nodiscard]] std::size_t count() const
+		{
+			std::size_t total = 0;
+			for (const std::uint64_t word: words)
+				total += std::popcount(word);
+			return total;
+		}
+
+		/**
+		 * @brief Follow a renumber that left the covered region tree as it was
+		 *
+		 * An unchanged tree keeps its relative order, so only the start of its range moves.
+		 * @param moved The tree's range in the current numbering; must have the same size
+		 */
+		void rebase(const NodeRange moved)
+		{
+			assert(moved.size() == range.size() && "rebased onto a range of another size");
+			range = moved;
+			generation = numbering->get_generation();
+		}
+
+		/**
+		 * @brief Call `fn` with every node in the set, in index order
+		 */
+		template<typename Fn>
+		void for_each(Fn &&fn) const
+		{
+			for (std::size_t w = 0; w < words.size(); ++w)
+			{
+				for (std::uint64_t word = words[w]; word != 0; word &= word - 1)
+					fn((*numbering)[range.begin + static_cast<NodeId>(w * 64 + std::countr_zero(word))]);
+			}
+		}
+
+	private:
+		const NodeNumbering *numbering = nullptr;
+		NodeRange range;
+		std::uint64_t generation = 0;
+		std::vector<std::uint64_t> words;
+
+		[[nodiscard]] NodeId slot_of(const Node *node) const
+		{
+			if (!numbering)
+				return INVALID_NODE_ID;
+
+			assert(generation == numbering->get_generation() && "node numbering changed under a bit vector");
+			const NodeId index = numbering->index_of(node);
+			return range.contains(index) ? index - range.begin : INVALID_NODE_ID;
+		}
+	};
+
+	/**
+	 * @brief Side array mapping numbered nodes to values
+	 *
+	 * Every node in the covered range has a slot holding the empty value until written.
+	 * Lookups of nodes outside the range find nothing; writing one is a programming error.
+	 */
+	template<typename T>
+	class NodeMap
+	{
+	public:
+		NodeMap() = default;
+
+		explicit NodeMap(const NodeNumbering &numbering, T empty = {})
+			: NodeMap(numbering, numbering.range(), std::move(empty))
+		{}
+
+		NodeMap(const NodeNumbering &numbering, const NodeRange range, T empty = {})
+			: numbering(&numbering), range(range), generation(numbering.get_generation()),
+			  values(range.size(), empty), fill(std::move(empty))
+		{}
+
+		/**
+		 * @brief Get the slot of a node
+		 * @return Pointer to the value, or nullptr if the node is outside the range
+		 */
+		[[nodiscard]] T *find(const Node *node)
+		{
+			const NodeId slot = slot_of(node);
+			return slot == INVALID_NODE_ID ? nullptr : &values[slot];
+		}
+
+		[[nodiscard]] const T *find(const Node *node) const
+		{
+			const NodeId slot = slot_of(node);
+			return slot == INVALID_NODE_ID ? nullptr : &values[slot];
+		}
+
+		/**
+		 * @brief Get the value of a node, or the empty value if it is outside the range
+		 */
+		[[nodiscard]] const T &get(const Node *node) const
+		{
+			const T *value = find(node);
+			return value ? *value : fill;
+		}
+
+		/**
+		 * @brief Access the slot of a node that must be inside the range
+		 */
+		T &operator[](const Node *node)
+		{
+			T *value = find(node);
+			assert(value && "node is not covered by this map");
+			return *value;
+		}
+
+		/**
+		 * @brief Reset every slot to the empty value
+		 */
+		void clear()
+		{
+			std::ranges::fill(values, fill);
+		}
+
+		/**
+		 * @brief Follow a renumber that left the covered region tree as it was
+		 * @param moved The tree's range in the current numbering; must have the same size
+		 */
+		void rebase(const NodeRange moved)
+		{
+			assert(moved.size() == range.size() && "rebased onto a range of another size");
+			range = moved;
+			generation = numbering->get_generation();
+		}
+
+		[[nodiscard]] std::size_t size() const
+		{
+			return values.size();
+		}
+
+	private:
+		const NodeNumbering *numbering = nullptr;
+		NodeRange range;
+		std::uint64_t generation = 0;
+		std::vector<T> values;
+		T fill {};
+
+		[[nodiscard]] NodeId slot_of(const Node *node) const
+		{
+			if (!numbering)
+				return INVALID_NODE_ID;
+
+			assert(generation == numbering->get_generation() && "node numbering changed under a node map");
+			const NodeId index = numbering->index_of(node);
+			return range.contains(index) ? index - range.begin : INVALID_NODE_ID;
+		}
+	};
+}
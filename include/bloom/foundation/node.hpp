@@ -4,6 +4,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <limits>
 #include <vector>
 #include <bloom/foundation/typed-data.hpp>
 #include <bloom/foundation/types.hpp>
@@ -12,11 +13,17 @@
 namespace blm
 {
 	class Region;
+
+	/** @brief Dense index of a node; see `NodeNumbering` */
+	using NodeId = std::uint32_t;
+
+	inline constexpr NodeId INVALID_NODE_ID = std::numeric_limits<NodeId>::max();
+
 	/**
 	 * @brief Represents the type of operation an IR node performs
 	 * @note This enum is used to identify the type of operation of an IR node
 	 */
-	enum class NodeType : std::uint16_t
+	enum class NodeType : std::uint8_t
 	{
 		/** @brief Entry point of a basic block or function */
 		ENTRY,
@@ -108,8 +115,15 @@ namespace blm
 		VECTOR_EXTRACT,
 		/** @brief Build a vector from scalar values of same operand */
 		VECTOR_SPLAT,
+		/** @brief Not a node type; counts the enumerators above and must stay last */
+		COUNT,
 	};
 
+	/**
+	 * @brief Number of node types; tables indexed by `NodeType` use this size
+	 */
+	inline constexpr std::size_t NODE_TYPE_COUNT = static_cast<std::size_t>(NodeType::COUNT);
+
 	enum class AtomicOrdering : std::uint8_t
 	{
 		RELAXED = 0,
@@ -126,7 +140,7 @@ namespace blm
 	/**
 	 * @brief Bit flags representing node properties
 	 */
-	enum class NodeProps : std::uint16_t
+	enum class NodeProps : std::uint8_t
 	{
 		/** @brief No special properties */
 		NONE = 0,
@@ -210,12 +224,22 @@ namespace blm
 		StringTable::StringId str_id = {};
 		/** @brief Region this node belongs to */
 		Region* parent_region = nullptr;
+		/** @brief Previous node in the parent region's node list */
+		Node *region_prev = nullptr;
+		/** @brief Next node in the parent region's node list */
+		Node *region_next = nullptr;
 		/** @brief Operation type */
 		NodeType ir_type = {};
-		/** @brief Value type this node produces */
-		DataType type_kind = DataType::VOID;
 		/** @brief Type properties */
 		NodeProps props = NodeProps::NONE;
+		/** @brief Value type this node produces */
+		DataType type_kind = DataType::VOID;
+		/**
+		 * @brief Dense index assigned by the owning module's `NodeNumbering`
+		 *
+		 * Shares the last word with the three fields above, so it takes no extra space.
+		 */
+		NodeId index = INVALID_NODE_ID;
 
 		/**
 		 * @brief Access node data with type safety
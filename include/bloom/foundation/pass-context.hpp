@@ -6,10 +6,12 @@
 #include <typeindex>
 #include <unordered_map>
 #include <bloom/foundation/analysis-pass.hpp>
+#include <bloom/foundation/preserved-analyses.hpp>
 
 namespace blm
 {
     class Module;
+    class Profiler;
 
     /**
      * @brief Context for pass execution, storing analysis results and statistics.
@@ -28,6 +30,16 @@ namespace blm
          */
         explicit PassContext(Module& module, int opt_level = 0, bool debug_mode = false);
 
+        /**
+         * @brief Creates a context for one worker of a parallel run.
+         *
+         * The worker keeps its own statistics and reads analysis results it does not
+         * hold itself from this context, which must outlive it and must not change while
+         * workers read from it.
+         * @return The worker context.
+         */
+        [[nodiscard]] PassContext create_worker_context();
+
         /**
          * @brief Returns the module being processed.
          * @return Reference to the module.
@@ -65,7 +77,7 @@ namespace blm
         {
             const auto it = res.find(std::type_index(typeid(ResultT)));
             if (it == res.end())
-                return nullptr;
+                return parent ? parent->get_result<ResultT>() : nullptr;
             return dynamic_cast<const ResultT*>(it->second.get());
         }
 
@@ -80,10 +92,25 @@ namespace blm
         {
             const auto it = res.find(std::type_index(pass_type));
             if (it == res.end())
-                return nullptr;
+                return parent ? parent->get_result<ResultT>(pass_type) : nullptr;
             return dynamic_cast<const ResultT*>(it->second.get());
         }
 
+        /**
+         * @brief Gets a mutable result for a specific pass type.
+         * @tparam ResultT The type of result to get.
+         * @param pass_type Type information for the pass.
+         * @return Pointer to the result, or nullptr if not found.
+         */
+        template<typename ResultT>
+        [[nodiscard]] ResultT* get_result(const std::type_info& pass_type)
+        {
+            const auto it = res.find(std::type_index(pass_type));
+            if (it == res.end())
+                return parent ? parent->get_result<ResultT>(pass_type) : nullptr;
+            return dynamic_cast<ResultT*>(it->second.get());
+        }
+
         /**
          * @brief Checks if a result exists for a pass.
          * @param pass_type Type information for the pass.
@@ -103,6 +130,15 @@ namespace blm
          */
         void invalidate_by(const std::type_info& invalidating_pass);
 
+        /**
+         * @brief Invalidates results affected by a transform pass, keeping what it preserved.
+         *
+         * Preserved results stay; the others are dropped if their `invalidated_by` says so.
+         * @param invalidating_pass Type information for the invalidating pass.
+         * @param preserved The analyses the pass left intact.
+         */
+        void invalidate_by(const std::type_info& invalidating_pass, const PreservedAnalyses& preserved);
+
         /**
          * @brief Updates a statistic value.
          * @param name The name of the statistic.
@@ -117,10 +153,40 @@ namespace blm
          */
         [[nodiscard]] std::size_t get_stat(std::string_view name) const;
 
+        /**
+         * @brief Adds the statistics of another context to this one.
+         * @param other The context whose statistics to add, e.g. a finished worker's.
+         */
+        void merge_stats(const PassContext& other);
+
+        /**
+         * @brief Gets every statistic recorded in this context.
+         * @return The statistics by name.
+         */
+        [[nodiscard]] const std::unordered_map<std::string, std::size_t>& get_stats() const;
+
+        /**
+         * @brief Sets the profiler passes run in this context record into.
+         * @param profiler The profiler, or nullptr to stop profiling; must outlive its use.
+         */
+        void set_profiler(Profiler* profiler);
+
+        /**
+         * @brief Gets the profiler, shared with worker contexts created from this one.
+         * @return The profiler, or nullptr if profiling is off.
+         */
+        [[nodiscard]] Profiler* get_profiler() const;
+
     private:
+        struct WorkerTag {};
+
+        PassContext(PassContext& parent, WorkerTag);
+
         Module& mod;
         int opt_lvl;
         bool dbg_mode;
+        PassContext* parent = nullptr; /* results fallback of a worker context */
+        Profiler* prof = nullptr;
 
         std::unordered_map<std::type_index, std::unique_ptr<AnalysisResult>> res;
         std::unordered_map<std::string, std::size_t> stats;
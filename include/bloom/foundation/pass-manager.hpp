@@ -4,8 +4,8 @@
 
 #include <chrono>
 #include <iostream>
+#include <limits>
 #include <memory>
-#include <set>
 #include <typeindex>
 #include <unordered_map>
 #include <vector>
@@ -21,6 +21,11 @@ namespace blm
      * tracking dependencies between passes, executing passes
      * in the correct order, and collecting and reporting
      * statistics.
+     *
+     * Passes live in a flat array in the order they were added. Before the first run after
+     * a registration, requirements are resolved to array indices and the passes are put in
+     * one topological order; runs walk that plan. Analyses whose results are still held by
+     * the context are not rerun.
      */
     class PassManager
     {
@@ -35,84 +40,39 @@ namespace blm
         explicit PassManager(Module& module, int opt_level = 0,
                             bool debug_mode = false, int verbosity = 0);
 
+        /**
+         * @brief Creates a pass manager that works in an existing context.
+         *
+         * Results and statistics go to that context and outlive the manager, e.g. the
+         * per-module contexts of an `IPOPassContext`.
+         * @param context The context to run passes in; must outlive the manager.
+         * @param verbosity Level of output detail (0=minimal, 1=normal, 2=verbose).
+         */
+        explicit PassManager(PassContext& context, int verbosity = 0);
+
         /**
          * @brief Registers a pass with optional configuration.
          * @tparam PassT The type of pass to register.
          * @tparam Args Types of arguments to forward to the pass constructor.
          * @param args Arguments to forward to the pass constructor.
-         * @throws std::runtime_error if the pass is already registered.
+         * A pass of an already registered type replaces it in place.
          */
         template<typename PassT, typename... Args>
         void add_pass(Args&&... args)
         {
-            auto pass = std::make_unique<PassT>(std::forward<Args>(args)...);
-            const auto type_idx = std::type_index(pass->blm_id());
-
-            /* get deps */
-            auto required = pass->required_passes();
-            auto invalidated = pass->invalidated_passes();
-            passes[type_idx] = {
-                .pass = std::move(pass),
-                .required = {},
-                .invalidated = {}
-            };
-
-            /* convert type info pointers to type indices */
-            for (const auto* req : required)
-            {
-                passes[type_idx].required.push_back(std::type_index(*req));
-            }
-
-            for (const auto* inv : invalidated)
-            {
-                passes[type_idx].invalidated.push_back(std::type_index(*inv));
-            }
-
-            for (const auto& req_idx : passes[type_idx].required)
-            {
-                deps_graph[req_idx].dependents.insert(type_idx);
-                deps_graph[type_idx].required.insert(req_idx);
-            }
-
-            /* Store pass in the order it was added */
-            pass_order.push_back(type_idx);
+            register_pass(std::make_unique<PassT>(std::forward<Args>(args)...));
         }
 
         /**
          * @brief Registers a pass with optional configuration.
          * @tparam PassT The type of pass to register.
          * @param pass The pass to register.
-         * @throws std::runtime_error if the pass is already registered.
+         * A pass of an already registered type replaces it in place.
          */
         template<typename PassT>
         void add_pass(std::unique_ptr<PassT> pass)
         {
-            const auto type_idx = std::type_index(pass->blm_id());
-
-            /* get deps */
-            auto required = pass->required_passes();
-            auto invalidated = pass->invalidated_passes();
-
-            PassInfo info;
-            info.pass = std::move(pass); /* transfer ownership */
-            info.required = {};
-            info.invalidated = {};
-            passes[type_idx] = std::move(info);
-
-            /* convert type info pointers to type indices */
-            for (const auto* req : required)
-                passes[type_idx].required.push_back(std::type_index(*req));
-
-            for (const auto* inv : invalidated)
-                passes[type_idx].invalidated.push_back(std::type_index(*inv));
-
-            for (const auto& req_idx : passes[type_idx].required)
-            {
-                deps_graph[req_idx].dependents.insert(type_idx);
-                deps_graph[type_idx].required.insert(req_idx);
-            }
-
-            pass_order.push_back(type_idx);
+            register_pass(std::move(pass));
         }
 
         /**
@@ -136,7 +96,11 @@ namespace blm
 
         /**
          * @brief Runs all registered passes in dependency order.
+         *
+         * Every pass runs at most once; a required analysis runs again only if a pass
+         * before its user invalidated it.
          * @return True if all passes succeeded, false otherwise.
+         * @throws std::runtime_error if a required pass is not registered or requirements form a cycle.
          */
         bool run_all();
 
@@ -160,14 +124,7 @@ namespace blm
         void print_statistics(std::ostream& os = std::cout) const;
 
     private:
-        /**
-         * @brief Information about pass dependencies.
-         */
-        struct PassDependencyInfo
-        {
-            std::set<std::type_index> required;
-            std::set<std::type_index> dependents;
-        };
+        static constexpr std::size_t NO_PASS = std::numeric_limits<std::size_t>::max();
 
         /**
          * @brief Information about a registered pass.
@@ -175,17 +132,34 @@ namespace blm
         struct PassInfo
         {
             std::unique_ptr<Pass> pass;
-            std::vector<std::type_index> required;
-            std::vector<std::type_index> invalidated;
+            const std::type_info* type = nullptr;
+            bool is_analysis = false;
+            std::vector<const std::type_info*> required_types;
+            std::vector<const std::type_info*> invalidated; /* also dropped when the pass succeeds */
+            std::vector<std::size_t> required; /* indices into `passes`, resolved with the plan */
+            std::vector<std::size_t> schedule; /* this pass and its requirements, in run order */
+            double time = 0.0;
+            std::size_t runs = 0;
         };
 
         Module& mod;
         int verbosity_lvl = 0;
-        PassContext ctx;
+        std::unique_ptr<PassContext> owned_ctx; /* null when the context is borrowed */
+        PassContext& ctx;
+
+        std::vector<PassInfo> passes; /* in registration order */
+        std::unordered_map<std::type_index, std::size_t> pass_index;
+        std::vector<std::size_t> plan; /* every pass, requirements first */
+        bool plan_valid = false;
+
+        void register_pass(std::unique_ptr<Pass> pass);
+
+        [[nodiscard]] std::size_t find_pass(const std::type_info& pass_type) const;
+
+        /* resolve requirements and order the passes; only after a registration */
+        void build_plan();
 
-        std::unordered_map<std::type_index, PassInfo> passes;
-        std::unordered_map<std::type_index, PassDependencyInfo> deps_graph;
-        std::unordered_map<std::type_index, double> pass_times;
-        std::vector<std::type_index> pass_order;
+        /* run one pass, rerunning any required analysis the context no longer holds */
+        bool execute(std::size_t index);
     };
 }
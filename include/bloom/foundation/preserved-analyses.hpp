@@ -0,0 +1,75 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#pragma once
+
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_set>
+
+namespace blm
+{
+	/**
+	 * @brief The analyses a transform left intact
+	 *
+	 * Analyses are named by their analysis pass type, the key their results are stored
+	 * under. Besides individual analyses a transform can state that it kept the control flow
+	 * graph; results that only depend on the CFG (dominators, loops) check for that in their
+	 * `invalidated_by`.
+	 */
+	class PreservedAnalyses
+	{
+	public:
+		/**
+		 * @brief Nothing was changed; every result stays valid
+		 */
+		static PreservedAnalyses all();
+
+		/**
+		 * @brief Nothing is known to be preserved
+		 */
+		static PreservedAnalyses none();
+
+		/**
+		 * @brief Mark the result of an analysis pass as preserved
+		 * @tparam AnalysisT The analysis pass type
+		 */
+		template<typename AnalysisT>
+		PreservedAnalyses &preserve()
+		{
+			return preserve(typeid(AnalysisT));
+		}
+
+		/**
+		 * @brief Mark the result of an analysis pass as preserved
+		 * @param analysis_type The analysis pass type
+		 */
+		PreservedAnalyses &preserve(const std::type_info &analysis_type);
+
+		/**
+		 * @brief Mark the control flow graph as unchanged
+		 */
+		PreservedAnalyses &preserve_cfg();
+
+		/**
+		 * @brief Keep only what both sets preserve, e.g. for several passes run as one
+		 * @param other The other set
+		 */
+		void intersect(const PreservedAnalyses &other);
+
+		[[nodiscard]] bool preserves_all() const;
+
+		[[nodiscard]] bool preserves_cfg() const;
+
+		/**
+		 * @brief Check whether a result was preserved by name, or everything was
+		 * @param analysis_type The analysis pass type the result is stored under
+		 * @return True if the result is still valid
+		 */
+		[[nodiscard]] bool preserves(std::type_index analysis_type) const;
+
+	private:
+		bool everything = false;
+		bool cfg = false;
+		std::unordered_set<std::type_index> analyses;
+	};
+}
@@ -0,0 +1,186 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#pragma once
+
+#include <chrono>
+#include <iosfwd>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace blm
+{
+	class Context;
+	class Module;
+	class Region;
+
+	/**
+	 * @brief Records nested timings of a pipeline run
+	 *
+	 * Every timed span is an event with a parent, so a run forms a tree: IPO pass, module,
+	 * pass, pipeline iteration, function, and the passes run on that function. Events also
+	 * carry the IR node count before and after, the node memory reserved by the context when
+	 * they ended, and the statistics the pass added. The tree can be written as JSON or in
+	 * the Chrome trace-event format for `chrome://tracing` and Perfetto.
+	 *
+	 * Scopes may be opened from any number of threads at once. A scope's parent defaults to
+	 * the innermost scope open on the calling thread; work handed to other threads passes
+	 * the parent explicitly.
+	 */
+	class Profiler
+	{
+	public:
+		static constexpr std::size_t NO_EVENT = std::numeric_limits<std::size_t>::max();
+
+		/**
+		 * @brief One timed span
+		 */
+		struct Event
+		{
+			std::string name;
+			std::string category; /* "pass", "ipo-pass", "module", "iteration", "function" or "phase" */
+			std::size_t parent = NO_EVENT;
+			std::size_t thread = 0; /* threads are numbered in order of their first event */
+			double start = 0.0; /* seconds since the profiler was created */
+			double duration = 0.0;
+			std::size_t nodes_before = 0;
+			std::size_t nodes_after = 0;
+			std::size_t memory_bytes = 0; /* node memory reserved when the span ended; 0 if not sampled */
+			std::vector<std::pair<std::string, std::size_t> > stats; /* statistics added during the span */
+		};
+
+		/**
+		 * @brief Times a span for as long as it lives
+		 *
+		 * A scope on a null profiler does nothing, so callers can open one unconditionally.
+		 */
+		class Scope
+		{
+		public:
+			/**
+			 * @param profiler The profiler to record into; may be null
+			 * @param name Name of the span, e.g. the pass name
+			 * @param category Kind of span
+			 * @param parent Parent event; by default the innermost scope open on this thread
+			 */
+			Scope(Profiler *profiler, std::string_view name, std::string_view category);
+
+			Scope(Profiler *profiler, std::string_view name, std::string_view category, std::size_t parent);
+
+			Scope(const Scope &) = delete;
+
+			Scope &operator=(const Scope &) = delete;
+
+			~Scope();
+
+			/**
+			 * @brief Check whether anything is recorded
+			 */
+			[[nodiscard]] bool active() const
+			{
+				return profiler != nullptr;
+			}
+
+			/**
+			 * @brief Get the event this scope records, to parent work on other threads
+			 */
+			[[nodiscard]] std::size_t event() const
+			{
+				return index;
+			}
+
+			void set_nodes_before(std::size_t count) const;
+
+			void set_nodes_after(std::size_t count) const;
+
+			void set_memory_bytes(std::size_t bytes) const;
+
+			void add_stat(std::string_view name, std::size_t value) const;
+
+			/**
+			 * @brief Record how much each statistic grew between two snapshots
+			 */
+			void add_stats(const std::unordered_map<std::string, std::size_t> &before,
+			               const std::unordered_map<std::string, std::size_t> &after) const;
+
+		private:
+			Profiler *profiler;
+			std::size_t index = NO_EVENT;
+		};
+
+		Profiler();
+
+		Profiler(const Profiler &) = delete;
+
+		Profiler &operator=(const Profiler &) = delete;
+
+		/**
+		 * @brief Get the innermost scope of this profiler open on the calling thread
+		 * @return Its event, or `NO_EVENT` if there is none
+		 */
+		[[nodiscard]] std::size_t current() const;
+
+		/**
+		 * @brief Get the recorded events, parents before their children
+		 *
+		 * Only valid while no scope is open on another thread.
+		 */
+		[[nodiscard]] const std::vector<Event> &get_events() const
+		{
+			return events;
+		}
+
+		/**
+		 * @brief Get the largest node memory sampled by any event
+		 */
+		[[nodiscard]] std::size_t get_peak_memory_bytes() const;
+
+		/**
+		 * @brief Drop every recorded event; no scope may be open
+		 */
+		void clear();
+
+		/**
+		 * @brief Write the event tree as one JSON object
+		 */
+		void write_json(std::ostream &os) const;
+
+		/**
+		 * @brief Write complete ("X") events in the Chrome trace-event format
+		 */
+		void write_chrome_trace(std::ostream &os) const;
+
+		/**
+		 * @brief Count the nodes of every region of a module, function bodies included
+		 */
+		[[nodiscard]] static std::size_t count_nodes(const Module &module);
+
+		/**
+		 * @brief Count the nodes of a region and its children
+		 */
+		[[nodiscard]] static std::size_t count_nodes(const Region *region);
+
+		/**
+		 * @brief Get the bytes a context has reserved for nodes in its arena and slab
+		 */
+		[[nodiscard]] static std::size_t memory_bytes(const Context &context);
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		mutable std::mutex mutex;
+		std::vector<Event> events;
+		std::vector<std::thread::id> threads;
+		std::size_t peak_memory = 0;
+		Clock::time_point epoch;
+
+		std::size_t begin(std::string_view name, std::string_view category, std::size_t parent);
+
+		void end(std::size_t index);
+	};
+}
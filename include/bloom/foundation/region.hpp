@@ -2,10 +2,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <limits>
 #include <string>
 #include <vector>
 #include <bloom/foundation/context.hpp>
 #include <bloom/foundation/dbinfo.hpp>
+#include <bloom/foundation/node-list.hpp>
 #include <bloom/support/string-table.hpp>
 
 namespace blm
@@ -80,6 +83,13 @@ namespace blm
          */
         void add_child(Region *child);
 
+        /**
+         * @brief Remove a child region
+         *
+         * @param child Child region to remove
+         */
+        void remove_child(Region *child);
+
         /**
          * @brief Get all child regions
          */
@@ -101,7 +111,9 @@ namespace blm
         T *create_node(Args &&... args);
 
         /**
-         * @brief Add an existing node to this region
+         * @brief Add an existing node to the end of this region
+         *
+         * A node lives in one region at a time; if it is in another region it is moved.
          *
          * @param node Node to add
          */
@@ -114,10 +126,18 @@ namespace blm
          */
         void remove_node(Node *node);
 
+        /**
+         * @brief Check whether a node is in this region in constant time
+         */
+        [[nodiscard]] bool contains(const Node *node) const
+        {
+            return nodes.contains(node);
+        }
+
         /**
          * @brief Get all nodes in this region
          */
-        [[nodiscard]] const std::vector<Node *> &get_nodes() const
+        [[nodiscard]] const NodeList &get_nodes() const
         {
             return nodes;
         }
@@ -170,14 +190,52 @@ namespace blm
          */
         void insert_node_before(Node* before, Node* node);
 
+        /**
+         * @brief Insert a node after another node in the region
+         * @param after Node to insert after
+         * @param node Node to insert; moved if it is already in this region
+         */
         void insert_node_after(Node *after, Node *node);
 
         /**
-         * @brief Insert a node after another node in the region
+         * @brief Insert a node at the beginning of the region
          * @param node Node to insert
          */
         void insert_at_beginning(Node* node);
 
+        /**
+         * @brief Record that the contents of this region changed
+         *
+         * Node and child edits made through the region call this themselves; passes that
+         * rewrite the inputs of a node in place call it on the node's region. Only this
+         * region's counter is touched, so workers editing different function bodies share
+         * no cache line; enclosing regions see the change through `get_version`. Also marks
+         * the module's node numbering as out of date.
+         */
+        void mark_changed();
+
+        /**
+         * @brief Get the version of this region tree
+         *
+         * The number of changes made to this region and every region nested in it, summed
+         * on each call; linear in the number of nested regions. It grows with every change,
+         * so results cached for a function body stay valid while its version does.
+         */
+        [[nodiscard]] std::uint64_t get_version() const;
+
+        /**
+         * @brief Get the version this region tree had when the module was last numbered
+         *
+         * A region tree whose version still equals this is numbered exactly as it is now.
+         * Regions created since have `NOT_NUMBERED`.
+         */
+        [[nodiscard]] std::uint64_t get_numbered_version() const
+        {
+            return numbered_version;
+        }
+
+        static constexpr std::uint64_t NOT_NUMBERED = std::numeric_limits<std::uint64_t>::max();
+
         /**
          * @brief Check if region is terminated e.g. ends with return, branch and so on
          */
@@ -261,13 +319,23 @@ namespace blm
 
     private:
         std::vector<Region *> children;
-        std::vector<Node *> nodes;
+        NodeList nodes { *this };
         Node *control_dependency = nullptr;
         Context& ctx;
         Module &module;
         Region *parent;
         DebugInfo debug_info { *this };
         StringTable::StringId name_id;
+        std::atomic<std::uint64_t> edits = 0; /* own changes, plus those of removed children */
+        std::uint64_t numbered_version = NOT_NUMBERED; /* written by the module while renumbering */
+
+        friend class Module;
+
+        /* unlink a node from whichever region currently holds it */
+        static void detach(Node *node);
+
+        /* store the version of this tree and of every nested tree as their numbered version */
+        std::uint64_t record_numbered_version();
     };
 
     template<typename T, typename... Args>
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <bloom/foundation/pass.hpp>
+#include <bloom/foundation/preserved-analyses.hpp>
 
 namespace blm
 {
@@ -14,6 +15,19 @@ namespace blm
 	 */
 	class TransformPass : public Pass
 	{
+	public:
+		/**
+		 * @brief Returns the analyses the most recent run left intact.
+		 *
+		 * Queried after a successful run; results not listed are dropped if their
+		 * `invalidated_by` says so. The default preserves nothing.
+		 * @return The preserved analyses.
+		 */
+		[[nodiscard]] virtual PreservedAnalyses preserved_analyses() const
+		{
+			return PreservedAnalyses::none();
+		}
+
 		/* TransformPass uses the run() method directly from Pass
 		 *
 		 * The run() method is defined in the Pass class, and it is responsible for
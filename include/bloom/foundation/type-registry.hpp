@@ -2,6 +2,12 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <bloom/foundation/typed-data.hpp>
@@ -95,6 +101,40 @@ namespace blm
        [[nodiscard]]
        const TypedData& get_type(DataType type) const;
 
+       /**
+        * @brief Gets the size of a type in bytes
+        *
+        * Computed once when the type is registered; primitive type IDs are answered
+        * directly. Pointers are 8 bytes, arrays and vectors multiply their element size
+        * and structs report their declared size.
+        *
+        * @param type The type ID
+        * @return std::uint64_t Size in bytes, or 0 for void, function and unknown types
+        */
+       [[nodiscard]]
+       std::uint64_t get_size(DataType type) const;
+
+       /**
+        * @brief Gets the alignment of a type in bytes
+        *
+        * @param type The type ID
+        * @return std::uint32_t Alignment in bytes; 1 for types without a size
+        */
+       [[nodiscard]]
+       std::uint32_t get_alignment(DataType type) const;
+
+       /**
+        * @brief Gets the byte offset of every field of a struct type
+        *
+        * Fields are placed in declaration order, each at the next multiple of its own
+        * alignment. The offsets are computed once when the struct is registered.
+        *
+        * @param type The struct type ID
+        * @return const std::vector<std::uint64_t>& Offsets, empty for non-struct types
+        */
+       [[nodiscard]]
+       const std::vector<std::uint64_t>& get_field_offsets(DataType type) const;
+
        /**
         * @brief Reserves a type ID for forward declaration
         *
@@ -116,19 +156,51 @@ namespace blm
        void complete_type(DataType placeholder, DataType actual);
 
     private:
-       std::unordered_map<DataType, TypedData> types;
-       std::uint32_t nid = static_cast<std::uint32_t>(DataType::EXTENDED);
+       static constexpr std::uint32_t MAX_TYPES = 2048; /* base IDs live in the low 11 bits */
+       static constexpr std::uint32_t CHUNK_BITS = 6;
 
-       struct TypeHasher
+       struct TypeEntry
        {
-          std::size_t operator()(const TypedData& data) const;
+          TypedData data;
+          std::uint64_t size = 0;
+          std::uint32_t alignment = 1;
+          std::vector<std::uint64_t> field_offsets; /* structs only */
+          bool defined = false;
        };
 
-       struct TypeEqual
+       /* entries are indexed by base type ID; chunks never move, so references handed
+        * out by `get_type` stay valid while more types are registered */
+       std::array<std::unique_ptr<TypeEntry[]>, (MAX_TYPES >> CHUNK_BITS)> chunks;
+       std::uint32_t nid = static_cast<std::uint32_t>(DataType::EXTENDED);
+
+       struct KeyHash
        {
-          bool operator()(const TypedData& a, const TypedData& b) const;
+          using is_transparent = void;
+
+          std::size_t operator()(const std::string_view key) const noexcept
+          {
+             return std::hash<std::string_view> {}(key);
+          }
        };
 
-       std::unordered_map<TypedData, std::uint32_t, TypeHasher, TypeEqual> type_lookup;
+       /* canonical byte encoding of a type's structure -> base type ID */
+       std::unordered_map<std::string, std::uint32_t, KeyHash, std::equal_to<>> type_lookup;
+       std::string scratch; /* reused encoding buffer for lookups */
+
+       [[nodiscard]] const TypeEntry *find_entry(std::uint32_t id) const;
+
+       TypeEntry &make_entry(std::uint32_t id);
+
+       std::uint32_t next_type_id();
+
+       /**
+        * @brief Looks up `scratch` and registers the type built by `make` on a miss
+        */
+       template<typename MakeData>
+       DataType intern(MakeData &&make);
+
+       void define(std::uint32_t id, TypedData &&data);
+
+       static bool encode(const TypedData &data, std::string &out);
     };
 }
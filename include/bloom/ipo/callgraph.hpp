@@ -9,6 +9,7 @@
 #include <bloom/foundation/node.hpp>
 #include <bloom/ipo/pass.hpp>
 #include <bloom/ipo/pass-context.hpp>
+#include <bloom/support/allocator.hpp>
 
 namespace blm
 {
@@ -203,7 +204,8 @@ namespace blm
 		[[nodiscard]] std::vector<CallGraphNode *> get_reverse_post_order() const;
 
 	private:
-		std::unordered_map<Node *, std::unique_ptr<CallGraphNode>> node_map;
+		ach::slab node_slab; /* declared before `node_map` so it outlives the nodes */
+		std::unordered_map<Node *, std::unique_ptr<CallGraphNode, ach::slab_deleter<CallGraphNode>>> node_map;
 		std::vector<CallGraphNode *> nodes;
 
 		/**
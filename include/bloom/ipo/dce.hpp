@@ -100,14 +100,5 @@ namespace blm
 		 * @param function The function to remove
 		 */
 		static void remove_function_and_region(Module* module, Node* function);
-
-		/**
-		 * @brief Find the region associated with a function
-		 *
-		 * @param module The module to search in
-		 * @param function The function to find the region for
-		 * @return Pointer to the function's region, or nullptr if not found
-		 */
-		[[nodiscard]] static Region* find_function_region(Module* module, Node* function) ;
 	};
 }
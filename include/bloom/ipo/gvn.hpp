@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <bloom/foundation/pass-manager.hpp>
 #include <bloom/ipo/pass.hpp>
 #include <bloom/transform/cse.hpp>
@@ -10,28 +11,31 @@ namespace blm
 {
 	/**
 	 * @brief IPO Global Value Numbering pass
+	 *
+	 * Runs LAA + CSE on every module, modules in parallel. Alias results are kept in each
+	 * module's local context, so a later run only re-analyzes functions that changed.
 	 */
 	class IPOGVNPass final : public IPOPass
 	{
 	public:
-		bool run(std::vector<Module*>& modules, IPOPassContext& context) override
+		bool run(std::vector<Module*>&, IPOPassContext& context) override
 		{
-			std::size_t total_eliminated = 0;
+			std::atomic<std::size_t> total_eliminated = 0;
 
-			for (Module* module : modules)
-			{
-				if (!module)
-					continue;
+			context.for_each_module([&](Module&, PassContext& local) {
+				/* the local context keeps counting across runs; only this run's share is ours */
+				const std::size_t before = local.get_stat("cse.eliminated_expressions");
 
-				PassManager local_pm(*module, context.opt_level(), context.debug_mode(), 0);
+				PassManager local_pm(local, 0);
 				local_pm.add_pass<LocalAliasAnalysisPass>();
 				local_pm.add_pass<CSEPass>();
+				if (!local_pm.run_all())
+					return false;
 
-				if (local_pm.run_all())
-				{
-					total_eliminated += local_pm.get_context().get_stat("cse.eliminated_expressions");
-				}
-			}
+				const std::size_t eliminated = local.get_stat("cse.eliminated_expressions") - before;
+				total_eliminated += eliminated;
+				return eliminated > 0;
+			});
 
 			context.update_stat("ipo_gvn.total_eliminated", total_eliminated);
 			return total_eliminated > 0;
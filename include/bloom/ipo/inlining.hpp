@@ -143,6 +143,13 @@ namespace blm
 		 */
 		static void replace_call_with_body(Node* call_site, Region* inlined_region, Node* return_value);
 
+		/**
+		 * @brief Destroy the clone region once its body has been spliced into the caller
+		 * @param inlined_region The clone region; nodes left in it (e.g. returns) are dropped
+		 * @param module Module the clone region was created in
+		 */
+		static void discard_clone_region(Region* inlined_region, Module& module);
+
 		std::size_t max_inline_size = 15;        /* keep it small for real inlining */
 		std::size_t min_benefit_threshold = 3;
 		bool enable_specialization = true;
@@ -2,13 +2,17 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <typeindex>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
+#include <bloom/foundation/pass-context.hpp>
+#include <bloom/support/thread-pool.hpp>
 
 namespace blm
 {
@@ -48,17 +52,30 @@ namespace blm
 
     /**
      * @brief Context for IPO pass execution, storing analysis results and statistics
+     *
+     * Besides the module-spanning results, every module gets a `PassContext` of its own that
+     * keeps local analysis results from one IPO pass to the next. `for_each_module` runs
+     * per-module work on a pool. Modules may share a `Context` only if it allocates nodes
+     * from per-thread arenas; when several modules share a pool or slab context, the work
+     * runs one module after another on the calling thread instead.
      */
     class IPOPassContext
     {
     public:
+        /**
+         * @brief Per-module work item; returns true if it changed the module
+         */
+        using ModuleTask = std::function<bool(Module&, PassContext&)>;
+
         /**
          * @brief Creates a context for the given modules with specified options
          * @param modules The modules being processed
          * @param opt_level The optimization level (0-3)
          * @param debug_mode Whether debug information is enabled
+         * @param threads Number of workers modules are spread over; 0 uses one per hardware thread
          */
-        explicit IPOPassContext(std::vector<Module*>& modules, int opt_level = 0, bool debug_mode = false);
+        explicit IPOPassContext(std::vector<Module*>& modules, int opt_level = 0, bool debug_mode = false,
+                                std::size_t threads = 0);
 
         /**
          * @brief Returns the modules being processed
@@ -145,6 +162,8 @@ namespace blm
 
         /**
          * @brief Invalidates results affected by module changes
+         *
+         * The local contexts of the changed modules are dropped as well.
          * @param changed_modules Set of modules that have been modified
          */
         void invalidate_by_modules(const std::unordered_set<Module*>& changed_modules);
@@ -179,6 +198,48 @@ namespace blm
          */
         [[nodiscard]] std::size_t get_stat(std::string_view name) const;
 
+        /**
+         * @brief Gets every statistic recorded in this context
+         * @return The statistics by name
+         */
+        [[nodiscard]] const std::unordered_map<std::string, std::size_t>& get_stats() const;
+
+        /**
+         * @brief Sets the profiler IPO passes and the per-module contexts record into
+         * @param profiler The profiler, or nullptr to stop profiling; must outlive its use
+         */
+        void set_profiler(Profiler* profiler);
+
+        /**
+         * @brief Gets the profiler
+         * @return The profiler, or nullptr if profiling is off
+         */
+        [[nodiscard]] Profiler* get_profiler() const;
+
+        /**
+         * @brief Gets the local context of a module, creating it on first use
+         * @param module The module, one of `modules()`
+         * @return The module's context; stays valid until `invalidate_by_modules` names the module
+         */
+        PassContext& get_module_context(Module& module);
+
+        /**
+         * @brief Runs a task once for every module, modules in parallel
+         *
+         * Each call gets the module and its local context, and is the only one touching
+         * them while it runs. With a profiler set, each call is timed as a module event
+         * under the scope open on the calling thread. Null modules are skipped. If a task throws, the first
+         * exception is rethrown once all running tasks have returned.
+         * @param task The work to do on each module
+         * @return True if any task reported a change
+         */
+        bool for_each_module(const ModuleTask& task);
+
+        /**
+         * @brief Gets the number of workers `for_each_module` spreads modules over
+         */
+        [[nodiscard]] std::size_t get_thread_count() const;
+
     private:
         std::unordered_map<std::type_index, std::unique_ptr<IPOAnalysisResult>> type_results;
         std::unordered_map<std::string, std::unique_ptr<IPOAnalysisResult>> string_results;
@@ -187,6 +248,11 @@ namespace blm
         std::vector<Module*>& mods;
         int opt_lvl;
         bool dbg_mode;
+        std::size_t thread_count;
+        std::unique_ptr<ThreadPool> pool; /* started by the first `for_each_module` */
+        std::unordered_map<Module*, std::unique_ptr<PassContext>> module_contexts;
+        std::mutex module_contexts_mutex;
+        Profiler* prof = nullptr;
 
         /**
          * @brief Helper to check if a key matches a pattern
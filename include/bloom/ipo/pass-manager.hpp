@@ -30,9 +30,10 @@ namespace blm
          * @param opt_level The optimization level (0-3)
          * @param debug_mode Whether debug information is enabled
          * @param verbosity Level of output detail (0=minimal, 1=normal, 2=verbose)
+         * @param threads Number of workers passes spread modules over; 0 uses one per hardware thread
          */
         explicit IPOPassManager(std::vector<Module*>& modules, int opt_level = 0,
-                               bool debug_mode = false, int verbosity = 0);
+                               bool debug_mode = false, int verbosity = 0, std::size_t threads = 0);
 
         /**
          * @brief Registers a pass with optional configuration
@@ -117,10 +118,18 @@ namespace blm
 
         /**
          * @brief Prints execution statistics
+         *
+         * Times are summed over every run of a pass.
          * @param os Output stream to print to
          */
         void print_statistics(std::ostream& os = std::cout) const;
 
+        /**
+         * @brief Records every pass run, and the module and function passes run inside it, into a profiler
+         * @param profiler The profiler, or nullptr to stop profiling; must outlive its use
+         */
+        void set_profiler(Profiler* profiler);
+
     private:
         std::vector<Module*>& mods;
         int verbosity_lvl = 0;
@@ -129,5 +138,10 @@ namespace blm
         std::unordered_map<std::type_index, std::unique_ptr<IPOPass>> passes;
         std::unordered_map<std::type_index, double> pass_times;
         std::vector<std::type_index> pass_order;
+
+        /* run one pass, timed into the profiler if one is set */
+        bool execute(IPOPass& pass);
+
+        [[nodiscard]] std::size_t count_nodes() const;
     };
 }
@@ -191,62 +191,32 @@ namespace blm
 
 		/**
 		 * @brief Create integer literal
+		 *
+		 * Literals are shared per module; see `Module::intern_literal`.
 		 */
 		template<typename T>
 		Node *literal(T value)
 		{
-			Node *lit = create_node(NodeType::LIT);
 			if constexpr (std::is_same_v<T, std::int8_t>)
-			{
-				lit->type_kind = DataType::INT8;
-				lit->data.set<std::int8_t, DataType::INT8>(value);
-			}
+				return current_module->intern_literal<DataType::INT8>(value);
 			else if constexpr (std::is_same_v<T, std::int16_t>)
-			{
-				lit->type_kind = DataType::INT16;
-				lit->data.set<std::int16_t, DataType::INT16>(value);
-			}
+				return current_module->intern_literal<DataType::INT16>(value);
 			else if constexpr (std::is_same_v<T, std::int32_t>)
-			{
-				lit->type_kind = DataType::INT32;
-				lit->data.set<std::int32_t, DataType::INT32>(value);
-			}
+				return current_module->intern_literal<DataType::INT32>(value);
 			else if constexpr (std::is_same_v<T, std::int64_t>)
-			{
-				lit->type_kind = DataType::INT64;
-				lit->data.set<std::int64_t, DataType::INT64>(value);
-			}
+				return current_module->intern_literal<DataType::INT64>(value);
 			else if constexpr (std::is_same_v<T, std::uint8_t>)
-			{
-				lit->type_kind = DataType::UINT8;
-				lit->data.set<std::uint8_t, DataType::UINT8>(value);
-			}
+				return current_module->intern_literal<DataType::UINT8>(value);
 			else if constexpr (std::is_same_v<T, std::uint16_t>)
-			{
-				lit->type_kind = DataType::UINT16;
-				lit->data.set<std::uint16_t, DataType::UINT16>(value);
-			}
+				return current_module->intern_literal<DataType::UINT16>(value);
 			else if constexpr (std::is_same_v<T, std::uint32_t>)
-			{
-				lit->type_kind = DataType::UINT32;
-				lit->data.set<std::uint32_t, DataType::UINT32>(value);
-			}
+				return current_module->intern_literal<DataType::UINT32>(value);
 			else if constexpr (std::is_same_v<T, std::uint64_t>)
-			{
-				lit->type_kind = DataType::UINT64;
-				lit->data.set<std::uint64_t, DataType::UINT64>(value);
-			}
+				return current_module->intern_literal<DataType::UINT64>(value);
 			else if constexpr (std::is_same_v<T, int>)
-			{
-				lit->type_kind = DataType::INT32;
-				lit->data.set<std::int32_t, DataType::INT32>(static_cast<std::int32_t>(value));
-			}
+				return current_module->intern_literal<DataType::INT32>(static_cast<std::int32_t>(value));
 			else
-			{
 				static_assert(sizeof(T) == 0, "unsupported literal type");
-			}
-
-			return lit;
 		}
 
 		/**
@@ -4,11 +4,13 @@
 * by Al (@alpluspluss) */
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <new>
 #include <type_traits>
+#include <utility>
 #if defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
 /* we compile for Unix e.g. Linux, macOS and so on */
 #include <sys/mman.h>
@@ -544,4 +546,477 @@ namespace ach
 	{
 		return !(lhs == rhs);
 	}
+
+	/**
+	 * @brief Thread-safe bump arena with per-thread chunks
+	 *
+	 * @note Every thread that allocates from an arena bumps a pointer through a chunk of
+	 *  its own, so the fast path touches no shared state and takes no lock. When a chunk
+	 *  runs out the thread maps a fresh one and publishes it on a lock-free list owned by
+	 *  the arena; nothing is freed individually and all chunks are returned to the OS at
+	 *  once when the arena is destroyed. Objects placed in the arena are never destructed.
+	 */
+	class arena
+	{
+	public:
+		static constexpr std::size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+		/**
+		 * @brief Create an arena
+		 * @param chunk_size Bytes mapped per chunk; requests above a quarter of this get a chunk of their own
+		 */
+		explicit arena(const std::size_t chunk_size = DEFAULT_CHUNK_SIZE) noexcept
+			: chunk_size((chunk_size + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1)),
+			  id(next_id().fetch_add(1, std::memory_order_relaxed)) {}
+
+		arena(const arena &) = delete;
+
+		arena &operator=(const arena &) = delete;
+
+		/**
+		 * @brief Destructor
+		 *
+		 * Releases every chunk handed out to any thread. No thread may be allocating from
+		 * the arena while it is destroyed.
+		 */
+		~arena()
+		{
+			Chunk *chunk = chunks.load(std::memory_order_acquire);
+			while (chunk)
+			{
+				Chunk *next = chunk->next;
+				unmap(chunk, chunk->size);
+				chunk = next;
+			}
+		}
+
+		/**
+		 * @brief Allocate uninitialized memory
+		 *
+		 * Safe to call from any number of threads at once.
+		 *
+		 * @param size Number of bytes
+		 * @param align Required alignment; a power of two no larger than the page size
+		 * @return Pointer to the memory, or nullptr if size is zero
+		 * @throws std::bad_alloc if the OS refuses a new chunk
+		 */
+		[[nodiscard]] void *allocate(const std::size_t size, const std::size_t align = alignof(std::max_align_t))
+		{
+			if (size == 0)
+				return nullptr;
+
+			ThreadCache &cache = thread_cache();
+			if (cache.owner == id)
+			{
+				const std::uintptr_t p = (reinterpret_cast<std::uintptr_t>(cache.cur) + align - 1) & ~(align - 1);
+				if (p + size <= reinterpret_cast<std::uintptr_t>(cache.end))
+				{
+					cache.cur = reinterpret_cast<unsigned char *>(p + size);
+					return reinterpret_cast<void *>(p);
+				}
+			}
+
+			return allocate_slow(cache, size, align);
+		}
+
+		/**
+		 * @brief Does nothing; arena memory is released in bulk
+		 */
+		static void deallocate(void *, std::size_t) noexcept {}
+
+		/**
+		 * @brief Total bytes mapped from the OS so far, headers included
+		 */
+		[[nodiscard]] std::size_t bytes_reserved() const noexcept
+		{
+			return reserved.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief Number of chunks mapped so far
+		 */
+		[[nodiscard]] std::size_t chunk_count() const noexcept
+		{
+			return count.load(std::memory_order_relaxed);
+		}
+
+	private:
+		static constexpr std::size_t PAGE_SIZE = 4096;
+
+		/* small per-thread cache of chunks, matched on the full arena id, so that a thread can
+		 * work with a few contexts without them evicting each other's chunk; only a thread
+		 * juggling more than `CACHE_WAYS` arenas gives up the least recently entered one */
+		static constexpr std::size_t CACHE_WAYS = 4;
+
+		struct Chunk
+		{
+			Chunk *next;
+			std::size_t size;
+		};
+
+		struct ThreadCache
+		{
+			std::uint64_t owner = 0;
+			unsigned char *cur = nullptr;
+			unsigned char *end = nullptr;
+			std::uint64_t last_use = 0; /* clock of the last switch to this way */
+		};
+
+		struct ThreadCaches
+		{
+			ThreadCache ways[CACHE_WAYS];
+			std::size_t recent = 0; /* way of the last lookup */
+			std::uint64_t clock = 0;
+		};
+
+		std::size_t chunk_size;
+		std::uint64_t id; /* never reused, so stale thread caches of a dead arena cannot match */
+		std::atomic<Chunk *> chunks = nullptr;
+		std::atomic<std::size_t> reserved = 0;
+		std::atomic<std::size_t> count = 0;
+
+		static std::atomic<std::uint64_t> &next_id() noexcept
+		{
+			static std::atomic<std::uint64_t> counter = 1;
+			return counter;
+		}
+
+		[[nodiscard]] ThreadCache &thread_cache() const noexcept
+		{
+			thread_local ThreadCaches caches;
+			if (caches.ways[caches.recent].owner == id)
+				return caches.ways[caches.recent];
+
+			/* the way this arena owns, otherwise the least recently used one to take over */
+			std::size_t way = 0;
+			for (std::size_t i = 0; i < CACHE_WAYS; ++i)
+			{
+				if (caches.ways[i].owner == id)
+				{
+					way = i;
+					break;
+				}
+				if (caches.ways[i].last_use < caches.ways[way].last_use)
+					way = i;
+			}
+
+			caches.recent = way;
+			caches.ways[way].last_use = ++caches.clock;
+			return caches.ways[way];
+		}
+
+		void *allocate_slow(ThreadCache &cache, const std::size_t size, const std::size_t align)
+		{
+			constexpr std::size_t header_size = sizeof(Chunk);
+			const std::size_t needed = size + align + header_size;
+
+			/* oversized requests get a dedicated chunk and leave the thread's chunk alone */
+			if (needed > chunk_size / 4)
+			{
+				unsigned char *base = map_chunk((needed + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1));
+				const std::uintptr_t p = (reinterpret_cast<std::uintptr_t>(base + header_size) + align - 1) & ~(align - 1);
+				return reinterpret_cast<void *>(p);
+			}
+
+			unsigned char *base = map_chunk(chunk_size);
+			const std::uintptr_t p = (reinterpret_cast<std::uintptr_t>(base + header_size) + align - 1) & ~(align - 1);
+			cache.owner = id;
+			cache.cur = reinterpret_cast<unsigned char *>(p + size);
+			cache.end = base + chunk_size;
+			return reinterpret_cast<void *>(p);
+		}
+
+		unsigned char *map_chunk(const std::size_t bytes)
+		{
+#if defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
+			void *mem = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (mem == MAP_FAILED)
+				throw std::bad_alloc();
+#elif defined(_WIN32) || defined(_WIN64)
+			void *mem = VirtualAlloc(nullptr, bytes, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+			if (!mem)
+				throw std::bad_alloc();
+#endif
+
+			auto *chunk = static_cast<Chunk *>(mem);
+			chunk->size = bytes;
+
+			/* push-only treiber stack; chunks are never popped while the arena lives,
+			 * so there is no aba hazard */
+			chunk->next = chunks.load(std::memory_order_relaxed);
+			while (!chunks.compare_exchange_weak(chunk->next, chunk,
+			                                     std::memory_order_release,
+			                                     std::memory_order_relaxed)) {}
+
+			reserved.fetch_add(bytes, std::memory_order_relaxed);
+			count.fetch_add(1, std::memory_order_relaxed);
+			return static_cast<unsigned char *>(mem);
+		}
+
+		static void unmap(void *mem, [[maybe_unused]] const std::size_t bytes) noexcept
+		{
+#if defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
+			munmap(mem, bytes);
+#elif defined(_WIN32) || defined(_WIN64)
+			VirtualFree(mem, 0, MEM_RELEASE);
+#endif
+		}
+	};
+
+	/**
+	 * @brief Header-less slab allocator for small fixed-size objects
+	 *
+	 * @note Objects are packed back to back at their natural alignment in 64 KiB pages
+	 *  aligned to their own size. The size class, free list and occupancy of a page live
+	 *  in a single header at the start of the page, so a block carries no per-object
+	 *  header and its page is found by masking the address. Freed blocks are reused by
+	 *  later allocations of the same class; pages are only returned to the OS when the
+	 *  slab is destroyed. Requests larger than `MAX_SIZE` or aligned beyond 64 bytes get
+	 *  a dedicated mapping with the same header layout. Not thread-safe; give each
+	 *  owner its own slab.
+	 */
+	class slab
+	{
+	public:
+		static constexpr std::size_t PAGE_SIZE = 64 * 1024;
+		static constexpr std::size_t MAX_SIZE = 1024;
+
+		slab() = default;
+
+		slab(const slab &) = delete;
+
+		slab &operator=(const slab &) = delete;
+
+		/**
+		 * @brief Destructor
+		 *
+		 * Returns every page to the OS without running destructors of live objects.
+		 */
+		~slab()
+		{
+			Page *page = pages;
+			while (page)
+			{
+				Page *next = page->next_all;
+				unmap(page, page->mapped);
+				page = next;
+			}
+		}
+
+		/**
+		 * @brief Allocate uninitialized memory
+		 * @param size Number of bytes
+		 * @param align Required alignment; a power of two
+		 * @return Pointer to the memory, or nullptr if size is zero
+		 * @throws std::bad_alloc if the OS refuses a new page
+		 */
+		[[nodiscard]] void *allocate(const std::size_t size, const std::size_t align = alignof(std::max_align_t))
+		{
+			if (size == 0)
+				return nullptr;
+
+			const std::size_t granule = align > GRANULE ? align : GRANULE;
+			const std::size_t rounded = (size + granule - 1) & ~(granule - 1);
+			if (rounded > MAX_SIZE || align > HEADER_SIZE)
+				return allocate_large(size, align);
+
+			const std::size_t cls = rounded / GRANULE - 1;
+			Page *page = available[cls];
+			if (!page)
+				page = available[cls] = create_page(static_cast<std::uint32_t>(rounded));
+
+			void *result;
+			if (page->free_list)
+			{
+				result = page->free_list;
+				page->free_list = *static_cast<void **>(result);
+			}
+			else
+			{
+				result = reinterpret_cast<unsigned char *>(page) + HEADER_SIZE +
+				         static_cast<std::size_t>(page->bump++) * page->slot;
+			}
+
+			/* full pages leave the class list until a block is freed */
+			if (++page->used == page->capacity)
+				available[cls] = page->next_available;
+			return result;
+		}
+
+		/**
+		 * @brief Return a block to its page
+		 * @param p Pointer previously returned by `allocate` on this slab, or nullptr
+		 */
+		void deallocate(void *p) noexcept
+		{
+			if (!p)
+				return;
+
+			Page *page = page_of(p);
+			if (page->slot == 0)
+			{
+				/* dedicated mapping */
+				if (page->prev_all)
+					page->prev_all->next_all = page->next_all;
+				else
+					pages = page->next_all;
+				if (page->next_all)
+					page->next_all->prev_all = page->prev_all;
+				reserved -= page->mapped;
+				unmap(page, page->mapped);
+				return;
+			}
+
+			*static_cast<void **>(p) = page->free_list;
+			page->free_list = p;
+			if (page->used-- == page->capacity)
+			{
+				const std::size_t cls = page->slot / GRANULE - 1;
+				page->next_available = available[cls];
+				available[cls] = page;
+			}
+		}
+
+		/**
+		 * @brief Allocate and construct an object
+		 */
+		template<typename T, typename... Args>
+		[[nodiscard]] T *create(Args &&... args)
+		{
+			void *m = allocate(sizeof(T), alignof(T));
+			return ::new(m) T(std::forward<Args>(args)...);
+		}
+
+		/**
+		 * @brief Destroy an object made by `create` and free its block
+		 */
+		template<typename T>
+		void destroy(T *p) noexcept
+		{
+			if (!p)
+				return;
+			p->~T();
+			deallocate(p);
+		}
+
+		/**
+		 * @brief Total bytes mapped from the OS, page headers included
+		 */
+		[[nodiscard]] std::size_t bytes_reserved() const noexcept
+		{
+			return reserved;
+		}
+
+		/**
+		 * @brief Slot size used for a request; the real per-object cost in a page
+		 */
+		[[nodiscard]] static constexpr std::size_t slot_size(const std::size_t size,
+		                                                   const std::size_t align = alignof(std::max_align_t))
+		{
+			const std::size_t granule = align > GRANULE ? align : GRANULE;
+			return (size + granule - 1) & ~(granule - 1);
+		}
+
+	private:
+		static constexpr std::size_t GRANULE = 8;
+		static constexpr std::size_t CLASSES = MAX_SIZE / GRANULE;
+		static constexpr std::size_t HEADER_SIZE = 64;
+
+		struct Page
+		{
+			Page *next_all;
+			Page *prev_all;
+			Page *next_available;
+			void *free_list;
+			std::size_t mapped;
+			std::uint32_t slot; /* zero for a dedicated mapping */
+			std::uint32_t capacity;
+			std::uint32_t used;
+			std::uint32_t bump; /* first slot never handed out */
+		};
+
+		static_assert(sizeof(Page) <= HEADER_SIZE);
+
+		Page *pages = nullptr;
+		Page *available[CLASSES] = {};
+		std::size_t reserved = 0;
+
+		static Page *page_of(void *p) noexcept
+		{
+			return reinterpret_cast<Page *>(reinterpret_cast<std::uintptr_t>(p) & ~(PAGE_SIZE - 1));
+		}
+
+		Page *create_page(const std::uint32_t slot)
+		{
+			Page *page = map_page(PAGE_SIZE);
+			page->slot = slot;
+			page->capacity = static_cast<std::uint32_t>((PAGE_SIZE - HEADER_SIZE) / slot);
+			return page;
+		}
+
+		void *allocate_large(const std::size_t size, const std::size_t align)
+		{
+			const std::size_t offset = align > HEADER_SIZE ? align : HEADER_SIZE;
+			Page *page = map_page((offset + size + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1));
+			page->slot = 0;
+			return reinterpret_cast<unsigned char *>(page) + offset;
+		}
+
+		/* maps `bytes` (a multiple of PAGE_SIZE) at a PAGE_SIZE boundary and links it */
+		Page *map_page(const std::size_t bytes)
+		{
+#if defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
+			/* over-map by one page and trim both ends to the boundary */
+			void *raw = mmap(nullptr, bytes + PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (raw == MAP_FAILED)
+				throw std::bad_alloc();
+
+			const auto start = reinterpret_cast<std::uintptr_t>(raw);
+			const std::uintptr_t aligned = (start + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+			if (aligned != start)
+				munmap(raw, aligned - start);
+			if (const std::size_t tail = PAGE_SIZE - (aligned - start))
+				munmap(reinterpret_cast<void *>(aligned + bytes), tail);
+			void *mem = reinterpret_cast<void *>(aligned);
+#elif defined(_WIN32) || defined(_WIN64)
+			/* the allocation granularity is 64 KiB, so mappings are already aligned */
+			void *mem = VirtualAlloc(nullptr, bytes, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+			if (!mem)
+				throw std::bad_alloc();
+#endif
+
+			auto *page = static_cast<Page *>(mem);
+			*page = {};
+			page->mapped = bytes;
+			page->next_all = pages;
+			if (pages)
+				pages->prev_all = page;
+			pages = page;
+			reserved += bytes;
+			return page;
+		}
+
+		static void unmap(void *mem, [[maybe_unused]] const std::size_t bytes) noexcept
+		{
+#if defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
+			munmap(mem, bytes);
+#elif defined(_WIN32) || defined(_WIN64)
+			VirtualFree(mem, 0, MEM_RELEASE);
+#endif
+		}
+	};
+
+	/**
+	 * @brief Deleter for `std::unique_ptr` owning an object created by a slab
+	 */
+	template<typename T>
+	struct slab_deleter
+	{
+		slab *owner = nullptr;
+
+		void operator()(T *p) const noexcept
+		{
+			owner->destroy(p);
+		}
+	};
 }
@@ -2,18 +2,29 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <cstdint>
+#include <functional>
 #include <limits>
+#include <memory>
 #include <shared_mutex>
-#include <string>
+#include <string_view>
 #include <unordered_map>
-#include <vector>
+#include <bloom/support/allocator.hpp>
 
 namespace blm
 {
 	/**
-	 * @brief Concurrent sparse-dense table for string interning
+	 * @brief Concurrent string interning table
+	 *
+	 * String bytes are copied once into a thread-safe bump arena and every lookup is keyed
+	 * by `std::string_view`, so probing never allocates. The string to id map is split into
+	 * shards selected by hash, each behind its own reader-writer lock; the id to string
+	 * direction is a segmented array of atomic pointers that `get` reads without locking.
+	 *
+	 * `intern`, `get`, `contains` and `size` may be called from any number of threads at
+	 * once. `clear` must not race with any other member.
 	 */
 	class StringTable
 	{
@@ -26,6 +37,12 @@ namespace blm
 		 */
 		StringTable();
 
+		StringTable(const StringTable &) = delete;
+
+		StringTable &operator=(const StringTable &) = delete;
+
+		~StringTable();
+
 		/**
 		 * @param str String to intern
 		 * @return string index; invalid if equal `std::numeric_limits<StringId>::max();`
@@ -34,7 +51,7 @@ namespace blm
 
 		/**
 		 * @param id String index that is produced from the table
-		 * @return Read-only version of the initial string from the sparse-dense mapping
+		 * @return Read-only view of the interned string, valid until the table is cleared
 		 */
 		std::string_view get(StringId id) const;
 
@@ -55,8 +72,44 @@ namespace blm
 		void clear();
 
 	private:
-		std::unordered_map<std::string, StringId> strtid;
-		std::vector<std::string> strs;
+		static constexpr std::size_t SHARD_COUNT = 32; /* must match the shift in `shard_index` */
+		static constexpr std::size_t FIRST_SEGMENT = 256; /* ids in segment 0; each next segment doubles */
+		static constexpr std::size_t SEGMENT_COUNT = 40;
+
+		/* arena record for one id; the characters live in the arena as well */
+		struct Entry
+		{
+			std::string_view view;
+		};
+
+		struct alignas(64) Shard
+		{
+			mutable std::shared_mutex mutex;
+			std::unordered_map<std::string_view, StringId> ids; /* keys point into the arena */
+		};
+
+		std::unique_ptr<ach::arena> arena;
+		std::array<Shard, SHARD_COUNT> shards;
+		std::array<std::atomic<std::atomic<const Entry *> *>, SEGMENT_COUNT> segments {};
 		std::atomic<StringId> next_id;
+
+		/* fibonacci hashing on the top bits so shards do not follow the map's bucket index */
+		static std::size_t shard_index(const std::size_t hash)
+		{
+			return static_cast<std::size_t>((static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >> 59);
+		}
+
+		/**
+		 * @brief Get the directory slot for an id
+		 * @return The slot, or nullptr if its segment has not been mapped
+		 */
+		const std::atomic<const Entry *> *find_slot(StringId id) const;
+
+		/**
+		 * @brief Get the directory slot for an id, mapping its segment on first use
+		 */
+		std::atomic<const Entry *> &make_slot(StringId id);
+
+		void release_segments();
 	};
 }
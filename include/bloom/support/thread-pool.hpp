@@ -0,0 +1,71 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace blm
+{
+	/**
+	 * @brief Fixed set of worker threads for data-parallel loops
+	 *
+	 * `parallel_for` hands out indices one at a time from a shared counter, so items of
+	 * uneven cost balance across the workers. The calling thread takes part as worker 0
+	 * and the pool threads are workers 1 to `size() - 1`; the worker number passed to the
+	 * loop body can index per-worker state. Calls to `parallel_for` must not overlap.
+	 */
+	class ThreadPool
+	{
+	public:
+		/**
+		 * @param threads Number of workers including the calling thread; 0 uses one per hardware thread
+		 */
+		explicit ThreadPool(std::size_t threads = 0);
+
+		ThreadPool(const ThreadPool &) = delete;
+
+		ThreadPool &operator=(const ThreadPool &) = delete;
+
+		~ThreadPool();
+
+		/**
+		 * @brief Get the number of workers, the calling thread included
+		 */
+		[[nodiscard]] std::size_t size() const
+		{
+			return threads.size() + 1;
+		}
+
+		/**
+		 * @brief Call `fn(index, worker)` for every index below `count`
+		 *
+		 * Returns once every call has returned. If a call throws, indices not yet handed out
+		 * are skipped and the first exception is rethrown here.
+		 */
+		void parallel_for(std::size_t count, const std::function<void(std::size_t, std::size_t)> &fn);
+
+	private:
+		std::vector<std::thread> threads;
+		std::mutex mutex;
+		std::condition_variable wake; /* a job was posted or the pool is stopping */
+		std::condition_variable idle; /* the last pool thread finished its share of the job */
+		const std::function<void(std::size_t, std::size_t)> *job = nullptr;
+		std::size_t job_size = 0;
+		std::uint64_t job_epoch = 0;
+		std::size_t active = 0; /* pool threads still working on the current job */
+		std::atomic<std::size_t> next_index = 0;
+		std::exception_ptr error;
+		bool stopping = false;
+
+		void work_loop(std::size_t worker);
+
+		void run_share(std::size_t worker);
+	};
+}
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <unordered_set>
+#include <bloom/foundation/node-numbering.hpp>
 #include <bloom/foundation/transform-pass.hpp>
 
 namespace blm
@@ -25,7 +26,7 @@ namespace blm
 
 	private:
 		std::unordered_set<Region*> reachable_regions;
-		std::unordered_set<Node*> live_nodes;
+		NodeBitVector live_nodes; /* over the module numbering; only valid during `run()` */
 		std::unordered_set<Region*> dead_regions;
 
 		/**
@@ -72,15 +73,5 @@ namespace blm
 		 * @brief Remove a single dead node from a region
 		 */
 		static void remove_dead_node(Node* node, Region* region);
-
-		/**
-		 * @brief Find the region containing a function's body
-		 */
-		Region* find_function_region(Node* function, Module& m) const;
-
-		/**
-		 * @brief Find a region by name recursively
-		 */
-		Region* find_region_by_name(const Region* region, std::string_view name) const;
 	};
 }
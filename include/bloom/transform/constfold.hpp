@@ -2,8 +2,11 @@
 
 #pragma once
 
+#include <queue>
+#include <vector>
+#include <bloom/foundation/function-pass.hpp>
 #include <bloom/foundation/module.hpp>
-#include <bloom/foundation/transform-pass.hpp>
+#include <bloom/foundation/node-numbering.hpp>
 
 namespace blm
 {
@@ -11,9 +14,12 @@ namespace blm
 	 * @brief Constant folding optimization pass
 	 *
 	 * Evaluates constant expressions at compile time and replaces them with
-	 * their computed values.
+	 * their computed values. Runs as one worklist over the whole module: every foldable
+	 * node is queued once up front, and folding a node queues its users, so each node is
+	 * revisited only when one of its inputs became a constant. As a function pass the same
+	 * worklist covers a single body.
 	 */
-	class ConstantFoldingPass final : public TransformPass
+	class ConstantFoldingPass final : public FunctionPass
 	{
 	public:
 		[[nodiscard]] std::string_view name() const override;
@@ -25,12 +31,34 @@ namespace blm
 			return {};
 		}
 
+		[[nodiscard]] PreservedAnalyses preserved_analyses() const override;
+
+		void prepare(Module &module, PassContext &context) override;
+
 		bool run(Module &module, PassContext &context) override;
 
+		bool run_on_function(const FunctionUnit &unit, PassContext &context) override;
+
+		[[nodiscard]] std::unique_ptr<FunctionPass> clone() const override;
+
 	private:
 		Module *current_module = nullptr;
+		std::queue<Node *> worklist;
+		NodeBitVector queued; /* over the numbered nodes being folded; only valid during a run */
+		NodeBitVector removed; /* folded nodes still listed as users of their inputs */
+		std::vector<Node *> stale_inputs; /* inputs whose user lists hold removed nodes */
+		bool folded_branch = false; /* since the last prepare or run; a folded BRANCH changes the CFG */
+
+		void enqueue(Node *node);
+
+		/* fold until the worklist is empty and record the count */
+		bool drain_worklist(PassContext &context);
+
+		void drop_removed_users();
+
+		[[nodiscard]] bool is_foldable(const Node *node) const;
 
-		std::size_t process_region(Region *region);
+		bool fold(Node *node);
 
 		Node *create_copy_propagation_node(const Node *node) const;
 
@@ -4,10 +4,11 @@
 
 #include <unordered_map>
 #include <bloom/analysis/laa.hpp>
+#include <bloom/foundation/function-pass.hpp>
 #include <bloom/foundation/module.hpp>
+#include <bloom/foundation/node-numbering.hpp>
 #include <bloom/foundation/node.hpp>
 #include <bloom/foundation/region.hpp>
-#include <bloom/foundation/transform-pass.hpp>
 
 namespace blm
 {
@@ -15,20 +16,32 @@ namespace blm
 
 	/**
 	 * @brief Common Subexpression Elimination Pass using Value Numbering
+	 *
+	 * `run` numbers every function body and then the root region with one table; as a
+	 * function pass each body gets a table of its own.
 	 */
-	class CSEPass final : public TransformPass
+	class CSEPass final : public FunctionPass
 	{
 	public:
 		[[nodiscard]] std::string_view name() const override;
 
 		[[nodiscard]] std::string_view description() const override;
 
+		[[nodiscard]] PreservedAnalyses preserved_analyses() const override;
+
 		[[nodiscard]] std::vector<const std::type_info *> required_passes() const override;
 
 		bool run(Module &m, PassContext &ctx) override;
 
+		void prepare(Module &m, PassContext &ctx) override;
+
+		bool run_on_function(const FunctionUnit &unit, PassContext &ctx) override;
+
+		[[nodiscard]] std::unique_ptr<FunctionPass> clone() const override;
+
 	private:
-		std::unordered_map<Node *, ValueNumber> value_numbers;
+		Module *current_module = nullptr;
+		NodeMap<ValueNumber> value_numbers; /* 0 until numbered; only valid during a run */
 		std::unordered_map<ValueNumber, Node *> expression_to_node;
 		ValueNumber next_value_number = 1;
 
@@ -38,6 +51,9 @@ namespace blm
 
 		ValueNumber compute_value_number(Node *node, const LocalAliasResult &alias_result);
 
+		/* value number of an input; pooled literals outside the numbered range are numbered by value */
+		[[nodiscard]] ValueNumber get_input_value_number(Node *input) const;
+
 		static ValueNumber compute_literal_value_number(Node *node);
 
 		ValueNumber compute_expression_value_number(Node *node);
@@ -56,6 +72,6 @@ namespace blm
 
 		[[nodiscard]] bool loads_may_alias(Node *a, Node *b, const LocalAliasResult &alias_result);
 
-		static bool replace_all_uses(Node *node_to_replace, Node *replacement_node);
+		static bool replace_all_uses(Module &module, Node *node_to_replace, Node *replacement_node);
 	};
 }
@@ -2,31 +2,40 @@
 
 #pragma once
 
-#include <set>
+#include <unordered_set>
+#include <vector>
+#include <bloom/foundation/function-pass.hpp>
 #include <bloom/foundation/module.hpp>
+#include <bloom/foundation/node-numbering.hpp>
 #include <bloom/foundation/node.hpp>
-#include <bloom/foundation/transform-pass.hpp>
 
 namespace blm
 {
-	class DCEPass final : public TransformPass
+	class DCEPass final : public FunctionPass
 	{
 	public:
 		[[nodiscard]] std::string_view name() const override;
 
 		[[nodiscard]] std::string_view description() const override;
 
+		[[nodiscard]] PreservedAnalyses preserved_analyses() const override;
+
 		bool run(Module &m, PassContext &ctx) override;
 
+		bool run_on_function(const FunctionUnit &unit, PassContext &ctx) override;
+
+		[[nodiscard]] std::unique_ptr<FunctionPass> clone() const override;
+
 	private:
-		std::set<Node*> dead;
-		std::set<Node*> alive;
+		std::vector<Node*> dead;
+		NodeBitVector alive; /* over the numbered nodes being scanned; only valid during a run */
+		std::unordered_set<const Node*> unnumbered_alive; /* live nodes created since the numbering */
 
-		void find_live_nodes(const Region* region);
+		void find_live_nodes(const NodeNumbering& numbering, const Region* region);
 
-		void find_dead_nodes(const Region* region);
+		void find_dead_nodes(const NodeNumbering& numbering, const Region* region);
 
-		std::size_t remove_dead_nodes(Region* region);
+		std::size_t remove_dead_nodes(Module& m);
 
 		static bool is_root_node(const Node* node);
 	};
@@ -21,12 +21,15 @@ namespace blm
 
 		[[nodiscard]] std::string_view description() const override;
 
+		[[nodiscard]] PreservedAnalyses preserved_analyses() const override;
+
 		[[nodiscard]] std::vector<const std::type_info*> required_passes() const override;
 
 		bool run(Module& m, PassContext& ctx) override;
 
 	private:
 		std::unordered_set<Node*> dead_stores;
+		const DataLayout* layout = nullptr; /* the module context's layout; only valid during `run()` */
 
 		/**
 		 * @brief Process a region to find dead stores
@@ -74,5 +77,13 @@ namespace blm
 		 * @brief Get the data type of the value being stored
 		 */
 		static DataType get_store_value_type(Node* store) ;
+
+		/**
+		 * @brief Get the number of bytes a store writes
+		 *
+		 * Taken from the layout of the stored value's type; falls back to the size alias
+		 * analysis recorded for the address when the type has no known size.
+		 */
+		std::uint64_t get_store_width(Node* store, const MemoryLocation& loc) const;
 	};
 }
@@ -2,10 +2,14 @@
 
 #pragma once
 
+#include <queue>
+#include <vector>
 #include <bloom/foundation/context.hpp>
+#include <bloom/foundation/function-pass.hpp>
+#include <bloom/foundation/node-numbering.hpp>
 #include <bloom/foundation/region.hpp>
 #include <bloom/foundation/types.hpp>
-#include <bloom/foundation/transform-pass.hpp>
+#include <bloom/transform/instcombine/rewrite-rule.hpp>
 
 namespace blm
 {
@@ -20,8 +24,13 @@ namespace blm
 	 * - Power-of-2 strength reduction (x * 2^n = x << n)
 	 * - Comparison optimizations for unsigned types
 	 * - Bitwise pattern recognition and simplification
+	 *
+	 * Runs as one worklist over the whole module, or over one body as a function pass. A
+	 * rewrite queues the replacement, its operands and its users, since those are the nodes
+	 * a rewrite can enable a new match on, and erases operands it left without users right
+	 * away. One run therefore reaches a fixpoint.
 	 */
-	class InstcombinePass final : public TransformPass
+	class InstcombinePass final : public FunctionPass
 	{
 	public:
 		/**
@@ -36,6 +45,12 @@ namespace blm
 		 */
 		[[nodiscard]] std::string_view description() const override;
 
+		/**
+		 * @brief Simplifications never touch control flow
+		 * @return The CFG is preserved
+		 */
+		[[nodiscard]] PreservedAnalyses preserved_analyses() const override;
+
 		/**
 		 * @brief Run the algebraic simplification pass on a module
 		 * @param m Module to transform
@@ -44,106 +59,88 @@ namespace blm
 		 */
 		bool run(Module &m, PassContext &ctx) override;
 
-	private:
 		/**
-		 * @brief Process a region recursively, simplifying nodes
-		 * @param region Region to process
-		 * @return Number of simplifications performed
+		 * @brief Run the algebraic simplification pass on one function body
+		 * @param unit Function to transform
+		 * @param ctx Pass context for statistics
+		 * @return True if any simplifications were made
 		 */
-		std::size_t process_region(Region *region);
+		bool run_on_function(const FunctionUnit &unit, PassContext &ctx) override;
 
-		/**
-		 * @brief Attempt to simplify a single node
-		 * @param node Node to simplify
-		 * @param region Region containing the node
-		 * @return Simplified node or nullptr if no simplification possible
-		 */
-		Node *simplify_node(Node *node, Region *region);
+		[[nodiscard]] std::unique_ptr<FunctionPass> clone() const override;
 
-		/* pattern matching methods */
+	private:
+		Module *current_module = nullptr;
+		std::queue<Node *> worklist;
+		NodeBitVector queued; /* over the numbered nodes being simplified; only valid during a run */
+		NodeBitVector removed; /* erased nodes still listed as users of pooled literals */
+		std::vector<Node *> stale_inputs; /* literals whose user lists hold removed nodes */
+		std::size_t visited = 0;
+		std::size_t rewritten = 0;
+		std::size_t erased = 0;
 
 		/**
-		 * @brief Simplify patterns involving negation
-		 * @param node Node to check for negation patterns
-		 * @param region Region for creating new nodes
-		 * @return Simplified node or nullptr
+		 * @brief Queue the nodes of a region tree that have users
+		 * @param region Root of the tree
 		 */
-		Node *simplify_negation_patterns(Node *node, Region *region);
+		void enqueue_region(const Region *region);
 
-		/**
-		 * @brief Simplify carry and borrow elimination patterns
-		 * @param node Node to check for carry/borrow patterns
-		 * @param region Region for creating new nodes
-		 * @return Simplified node or nullptr
-		 */
-		static Node *simplify_carry_borrow_patterns(Node *node, Region *region);
+		void enqueue(Node *node);
 
 		/**
-		 * @brief Simplify small constant multiplication using shifts and adds
-		 * @param node Multiplication node to check
-		 * @param left Left operand
-		 * @param right Right operand
-		 * @param region Region for creating new nodes
-		 * @return Simplified node or nullptr
+		 * @brief Simplify until the worklist is empty and record the statistics
+		 * @param ctx Pass context for statistics
+		 * @return True if any node was rewritten
 		 */
-		Node *simplify_small_constant_multiplication(Node *node, Node *left, Node *right, Region *region);
+		bool drain_worklist(PassContext &ctx);
 
 		/**
-		 * @brief Simplify comparison operations with special patterns
-		 * @param node Comparison node to check
-		 * @param left Left operand
-		 * @param right Right operand
-		 * @param region Region for creating new nodes
-		 * @return Simplified node or nullptr
+		 * @brief Replace a node with its simplified form and queue what may simplify next
+		 * @param node Node being replaced
+		 * @param replacement Node taking over its users
 		 */
-		Node *simplify_comparison_patterns(Node *node, Node *left, Node *right, Region *region);
+		void rewrite(Node *node, Node *replacement);
 
 		/**
-		 * @brief Simplify identical operands (x op x patterns)
-		 * @param node Node with identical operands
-		 * @param operand The repeated operand
-		 * @param region Region for creating new nodes
-		 * @return Simplified node or nullptr
+		 * @brief Unlink a node from its operands and its region, then erase operands left unused
+		 *
+		 * Callers hold `Module::lock_shared_users`.
+		 * @param node Node without users
 		 */
-		Node *simplify_identical_operands(Node *node, Node *operand, Region *region);
+		void erase_node(Node *node);
 
 		/**
-		 * @brief Simplify operations with constant operands
-		 * @param node Node to simplify
-		 * @param left Left operand
-		 * @param right Right operand
-		 * @param region Region for creating new nodes
-		 * @return Simplified node or nullptr
+		 * @brief Check whether an unused node can go without changing behaviour
 		 */
-		Node *simplify_with_constants(Node *node, Node *left, Node *right, Region *region);
+		[[nodiscard]] bool is_erasable(const Node *node) const;
+
+		void drop_removed_users();
+
+		/* the rules are defined with the pass and call its helpers */
+		friend struct InstcombineRules;
 
 		/**
-		 * @brief Apply strength reduction transformations
-		 * @param node Node to transform
-		 * @param left Left operand
-		 * @param right Right operand
-		 * @param region Region for creating new nodes
-		 * @return Transformed node or nullptr
+		 * @brief State the rewrite rules run on
 		 */
-		Node *apply_strength_reduction(Node *node, Node *left, Node *right, Region *region);
+		struct RuleContext : RewriteState
+		{
+			InstcombinePass *pass = nullptr;
+		};
 
 		/**
-		 * @brief Apply advanced algebraic patterns
-		 * @param node Node to check
-		 * @param left Left operand
-		 * @param right Right operand
-		 * @return Simplified node or nullptr
+		 * @brief Attempt to simplify a single node
+		 * @param node Node to simplify
+		 * @param region Region containing the node
+		 * @return Simplified node or nullptr if no simplification possible
 		 */
-		static Node *apply_advanced_patterns(Node *node, Node *left, Node *right);
+		Node *simplify_node(Node *node, Region *region);
 
 		/**
-		 * @brief Simplify unary operations
-		 * @param node Unary operation node
-		 * @param input Input operand
-		 * @param region Region for creating new nodes
-		 * @return Simplified node or nullptr
+		 * @brief Decompose a multiplication by a small constant into shifts and adds
+		 * @param state Rule state of the multiplication; one operand is a constant
+		 * @return Replacement node or nullptr
 		 */
-		Node *simplify_unary_operation(Node *node, Node *input, Region *region);
+		Node *decompose_small_multiplication(const RuleContext &state);
 
 		static Node *create_binary_op(Region *region, NodeType op_type, Node *left, Node *right, Node *insert_before);
 
@@ -334,36 +331,18 @@ namespace blm
 		Node *create_bitwise_not_constant(Region *region, Node *constant, Node *insert_before);
 
 		/**
-		 * @brief Find or create a literal constant in a region
+		 * @brief Get the module's shared literal for a constant
 		 * @tparam T C++ type of the literal
 		 * @tparam DT Bloom IR data type
-		 * @param region Region to search/create in
+		 * @param region Region whose module owns the literal
 		 * @param value Literal value
-		 * @param insert_before Node to insert before if creating
+		 * @param insert_before Unused; pooled literals live in the root region
 		 * @return Existing or new literal node
 		 */
 		template<typename T, DataType DT>
-		Node *find_or_create_literal(Region *region, T value, Node *insert_before)
+		Node *find_or_create_literal(Region *region, T value, [[maybe_unused]] Node *insert_before)
 		{
-			for (Node *node: region->get_nodes())
-			{
-				if (node->ir_type == NodeType::LIT && node->type_kind == DT &&
-					node->as<DT>() == value)
-				{
-					return node;
-				}
-			}
-
-			Node *lit = region->get_module().get_context().create<Node>();
-			lit->ir_type = NodeType::LIT;
-			lit->type_kind = DT;
-			lit->data.set<T, DT>(value);
-			if (insert_before)
-				region->insert_node_before(insert_before, lit);
-			else
-				region->add_node(lit);
-
-			return lit;
+			return region->get_module().intern_literal<DT>(static_cast<typename DataTypeTraits<DT>::type>(value));
 		}
 
 		/**
@@ -414,6 +393,8 @@ namespace blm
 
 		/**
 		 * @brief Replace all uses of a node with another node
+		 *
+		 * The replacement may be a pooled literal; callers hold `Module::lock_shared_users`.
 		 * @param node_to_replace Original node
 		 * @param replacement_node Replacement node
 		 */
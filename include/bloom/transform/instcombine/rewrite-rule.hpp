@@ -0,0 +1,303 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#pragma once
+
+#include <array>
+#include <tuple>
+#include <utility>
+#include <bloom/foundation/node.hpp>
+#include <bloom/support/bt.hpp>
+
+namespace blm
+{
+	class Region;
+
+	/**
+	 * @brief State a rewrite rule works on: the node being simplified and what replaces it
+	 *
+	 * Passes derive from this to hand their own helpers to the rules. Satisfies `BTContext`.
+	 */
+	struct RewriteState
+	{
+		Node *node = nullptr;
+		Region *region = nullptr;
+		Node *result = nullptr; /* set by the rule that fired */
+		bool changed = false;
+
+		[[nodiscard]] Node *lhs() const
+		{
+			return node->inputs[0];
+		}
+
+		[[nodiscard]] Node *rhs() const
+		{
+			return node->inputs[1];
+		}
+
+		[[nodiscard]] Node *operand() const
+		{
+			return node->inputs[0];
+		}
+
+		void mark_changed()
+		{
+			changed = true;
+		}
+
+		[[nodiscard]] bool has_changed() const
+		{
+			return changed;
+		}
+
+		void reset_changed()
+		{
+			changed = false;
+		}
+	};
+
+	/**
+	 * @brief A behaviour tree that rewrites nodes of the given opcodes
+	 * @tparam Tree The tree run on a matching node; succeeds once it set a result
+	 * @tparam Roots The opcodes the rule applies to
+	 */
+	template<typename Tree, NodeType... Roots>
+	struct RewriteRule
+	{
+		Tree tree;
+
+		static constexpr bool rooted_at(const NodeType type)
+		{
+			return ((type == Roots) || ...);
+		}
+	};
+
+	/**
+	 * @brief Rewrite rules compiled into a table indexed by opcode
+	 *
+	 * For every opcode the table holds a function that tries, in declaration order, only the
+	 * rules rooted at that opcode, the way a `BTSelector` over them would; opcodes without
+	 * rules share one function that fails immediately. The table is built when the rule set
+	 * is instantiated, so applying it costs one indexed call per node.
+	 */
+	template<typename... Rules>
+	class RuleSet
+	{
+	public:
+		constexpr explicit RuleSet(Rules... args) : rules(std::move(args)...) {}
+
+		/**
+		 * @brief Rewrite `state.node` with the first of its opcode's rules that fires
+		 * @return SUCCESS with `state.result` set, or FAILURE if no rule applied
+		 * @note A rule whose checks pass but whose rewrite returns nullptr (or the node itself)
+		 *       does not end the search: the next rule for the opcode is tried. The hand-written
+		 *       matcher this replaces stopped at the first rule whose pattern matched.
+		 */
+		template<typename State>
+		BTStatus apply(State &state) const
+		{
+			const auto op = static_cast<std::size_t>(state.node->ir_type);
+			if (op >= NODE_TYPE_COUNT)
+				return BTStatus::FAILURE;
+			return table<State>[op](*this, state);
+		}
+
+		/**
+		 * @brief Try every rule in declaration order, checking its root at run time
+		 *
+		 * Gives the same result as `apply`; kept as the reference for tests and benchmarks.
+		 */
+		template<typename State>
+		BTStatus apply_linear(State &state) const
+		{
+			return try_linear(state);
+		}
+
+		/**
+		 * @brief Get the number of rules rooted at an opcode
+		 */
+		static constexpr std::size_t rule_count(const NodeType type)
+		{
+			return (static_cast<std::size_t>(Rules::rooted_at(type)) + ... + 0);
+		}
+
+	private:
+		template<typename State>
+		using Handler = BTStatus (*)(const RuleSet &, State &);
+
+		std::tuple<Rules...> rules;
+
+		template<NodeType Op, std::size_t I, typename State>
+		BTStatus try_rooted(State &state) const
+		{
+			if constexpr (I < sizeof...(Rules))
+			{
+				using Rule = std::tuple_element_t<I, std::tuple<Rules...> >;
+				if constexpr (Rule::rooted_at(Op))
+				{
+					if (const BTStatus status = std::get<I>(rules).tree.execute(state);
+						status != BTStatus::FAILURE)
+						return status;
+				}
+				return try_rooted<Op, I + 1>(state);
+			}
+			else
+			{
+				return BTStatus::FAILURE;
+			}
+		}
+
+		template<std::size_t I = 0, typename State>
+		BTStatus try_linear(State &state) const
+		{
+			if constexpr (I < sizeof...(Rules))
+			{
+				using Rule = std::tuple_element_t<I, std::tuple<Rules...> >;
+				if (Rule::rooted_at(state.node->ir_type))
+				{
+					if (const BTStatus status = std::get<I>(rules).tree.execute(state);
+						status != BTStatus::FAILURE)
+						return status;
+				}
+				return try_linear<I + 1>(state);
+			}
+			else
+			{
+				return BTStatus::FAILURE;
+			}
+		}
+
+		template<typename State>
+		static BTStatus no_rules(const RuleSet &, State &)
+		{
+			return BTStatus::FAILURE;
+		}
+
+		template<std::size_t Op, typename State>
+		static constexpr Handler<State> handler()
+		{
+			constexpr auto type = static_cast<NodeType>(Op);
+			if constexpr (rule_count(type) == 0)
+				return &no_rules<State>;
+			else
+				return [](const RuleSet &set, State &state) { return set.try_rooted<type, 0>(state); };
+		}
+
+		template<typename State, std::size_t... Ops>
+		static constexpr std::array<Handler<State>, NODE_TYPE_COUNT> make_table(std::index_sequence<Ops...>)
+		{
+			return { handler<Ops, State>()... };
+		}
+
+		template<typename State>
+		static constexpr std::array<Handler<State>, NODE_TYPE_COUNT> table =
+				make_table<State>(std::make_index_sequence<NODE_TYPE_COUNT> {});
+	};
+
+	/**
+	 * @brief Static factory for rewrite rules
+	 *
+	 * A rule is a `BTSequence` of checks ending in a rewrite:
+	 *
+	 *     Rewrite::binary<NodeType::ADD>(
+	 *         Rewrite::when([](State &s) { return is_zero(s.rhs()); }),
+	 *         Rewrite::to([](State &s) { return s.lhs(); }))
+	 *
+	 * `binary` and `unary` add the operand count check in front. A rewrite that returns
+	 * nullptr, or the node itself, fails the rule and matching falls through to the next
+	 * rule for the opcode, so a rule may decline after its checks passed.
+	 */
+	class Rewrite
+	{
+	public:
+		/**
+		 * @brief A rule for nodes of the given opcodes, running the steps in sequence
+		 */
+		template<NodeType... Roots, typename... Steps>
+		static constexpr auto rule(Steps &&... steps)
+		{
+			using Tree = decltype(BT::sequence(std::forward<Steps>(steps)...));
+			return RewriteRule<Tree, Roots...> { BT::sequence(std::forward<Steps>(steps)...) };
+		}
+
+		/**
+		 * @brief A rule for nodes with two non-null operands
+		 */
+		template<NodeType... Roots, typename... Steps>
+		static constexpr auto binary(Steps &&... steps)
+		{
+			return rule<Roots...>(operands<2>(), std::forward<Steps>(steps)...);
+		}
+
+		/**
+		 * @brief A rule for nodes with one non-null operand
+		 */
+		template<NodeType... Roots, typename... Steps>
+		static constexpr auto unary(Steps &&... steps)
+		{
+			return rule<Roots...>(operands<1>(), std::forward<Steps>(steps)...);
+		}
+
+		/**
+		 * @brief Check that the node has exactly `Count` non-null operands
+		 */
+		template<std::size_t Count>
+		static constexpr auto operands()
+		{
+			return BT::pattern([](const auto &state)
+			{
+				if (state.node->inputs.size() != Count)
+					return false;
+				for (const Node *input: state.node->inputs)
+				{
+					if (!input)
+						return false;
+				}
+				return true;
+			});
+		}
+
+		/**
+		 * @brief Check that both operands are the same node
+		 */
+		static constexpr auto same_operands()
+		{
+			return BT::pattern([](const auto &state) { return state.lhs() == state.rhs(); });
+		}
+
+		/**
+		 * @brief Check a condition on the state
+		 */
+		template<typename Pred>
+		static constexpr auto when(Pred &&pred)
+		{
+			return BT::pattern(std::forward<Pred>(pred));
+		}
+
+		/**
+		 * @brief Replace the node with what `fn` returns; fails on nullptr or the node itself
+		 */
+		template<typename Fn>
+		static constexpr auto to(Fn &&fn)
+		{
+			return BT::transform([fn = std::forward<Fn>(fn)](auto &state)
+			{
+				Node *replacement = fn(state);
+				if (!replacement || replacement == state.node)
+					return BTStatus::FAILURE;
+
+				state.result = replacement;
+				state.mark_changed();
+				return BTStatus::SUCCESS;
+			});
+		}
+	};
+
+	/**
+	 * @brief Collect rules into a dispatch table
+	 */
+	template<typename... Rules>
+	constexpr auto make_rule_set(Rules &&... rules)
+	{
+		return RuleSet<std::decay_t<Rules>...> { std::forward<Rules>(rules)... };
+	}
+}
@@ -10,6 +10,8 @@
 
 namespace blm
 {
+	class DominatorTree;
+
 	/**
 	 * @brief Result of a PRE optimization
 	 */
@@ -84,5 +86,8 @@ namespace blm
 		bool has_unstructured_control_flow(const Region *region) const;
 
 		std::vector<PREResult> pre_results;
+
+		/* dominance for the module being processed; only valid during run() */
+		const DominatorTree *dom_tree = nullptr;
 	};
 }
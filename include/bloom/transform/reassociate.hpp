@@ -14,6 +14,8 @@ namespace blm
 
 		[[nodiscard]] std::string_view description() const override;
 
+		[[nodiscard]] PreservedAnalyses preserved_analyses() const override;
+
 		[[nodiscard]] std::vector<const std::type_info *> required_passes() const override;
 
 		bool run(Module &m, PassContext &ctx) override;
@@ -6,6 +6,7 @@
 #include <unordered_set>
 #include <vector>
 #include <bloom/analysis/laa.hpp>
+#include <bloom/foundation/data-layout.hpp>
 #include <bloom/foundation/transform-pass.hpp>
 
 namespace blm
@@ -30,6 +31,11 @@ namespace blm
 		 */
 		[[nodiscard]] std::string_view description() const override;
 
+		/**
+		 * @brief Get the analyses this pass leaves intact
+		 */
+		[[nodiscard]] PreservedAnalyses preserved_analyses() const override;
+
 		/**
 		 * @brief Get the passes required before this one
 		 */
@@ -66,6 +72,7 @@ namespace blm
 
 		std::unordered_map<Node *, AllocationInfo> candidates;
 		std::unordered_map<Node *, std::vector<FieldAccess>> field_accesses;
+		const DataLayout *layout = nullptr; /* the module context's layout; only valid during `run()` */
 
 		/**
 		 * @brief Find all struct allocation candidates in the module
@@ -98,9 +105,10 @@ namespace blm
 		bool is_field_access(Node *node, Node *alloc, std::size_t &field_index);
 
 		/**
-		 * @brief Get the field index from a PTR_ADD offset
+		 * @brief Get the index of the field of a struct type that starts at a PTR_ADD offset
+		 * @return Field index, or `DataLayout::NO_FIELD`
 		 */
-		static std::size_t get_field_index_from_offset(std::int64_t offset, const std::vector<std::pair<std::string, DataType>> &fields);
+		[[nodiscard]] std::size_t get_field_index_from_offset(std::int64_t offset, DataType struct_type) const;
 
 		/**
 		 * @brief Transform a promotable struct allocation
@@ -110,7 +118,7 @@ namespace blm
 		/**
 		 * @brief Create scalar allocations for struct fields
 		 */
-		static void create_scalar_allocations(AllocationInfo &info, Module &module);
+		void create_scalar_allocations(AllocationInfo &info, Module &module) const;
 
 		/**
 		 * @brief Replace field accesses with scalar accesses
@@ -120,16 +128,6 @@ namespace blm
 		/**
 		 * @brief Handle partial SROA by creating a reduced struct type
 		 */
-		static DataType create_reduced_struct_type(const AllocationInfo &info, Module &module);
-
-		/**
-		 * @brief Get the size of a data type in bytes
-		 */
-		static std::uint64_t get_type_size(DataType type);
-
-		/**
-		 * @brief Calculate field offsets for a struct type
-		 */
-		static std::vector<std::uint64_t> calculate_field_offsets(const std::vector<std::pair<std::string, DataType>> &fields);
+		DataType create_reduced_struct_type(const AllocationInfo &info, Module &module) const;
 	};
 }
@@ -0,0 +1,170 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#pragma once
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <bloom/analysis/laa.hpp>
+#include <bloom/analysis/loops/loop-analysis.hpp>
+#include <bloom/foundation/data-layout.hpp>
+#include <bloom/foundation/transform-pass.hpp>
+#include <bloom/transform/vectorize/vector-target.hpp>
+
+namespace blm
+{
+	class Context;
+	class Module;
+	struct Node;
+	class PassContext;
+	class Region;
+
+	/**
+	 * @brief Inner-loop vectorization pass
+	 *
+	 * Widens countable innermost loops of the shape the builder's `create_while_loop` gives:
+	 * a header that compares a stack counter against an invariant bound, and one body that
+	 * ends by adding one to the counter and jumping back. Memory is accessed through
+	 * `PTR_ADD(base, i * size)` with `base` invariant, so every access moves one element per
+	 * iteration.
+	 *
+	 * Accesses through different bases must not alias according to `LocalAliasResult`;
+	 * accesses through one base are checked by their distance in elements against the
+	 * vectorization factor (VF). There are no runtime alias checks.
+	 *
+	 * A vectorized loop runs VF iterations at a time while at least VF remain and then falls
+	 * into the original loop, which is kept as the scalar epilogue.
+	 */
+	class LoopVectorizePass : public TransformPass
+	{
+	public:
+		static constexpr std::uint32_t DEFAULT_VF = 4;
+
+		LoopVectorizePass() = default;
+
+		/**
+		 * @brief Vectorize for a target; the VF fills one of its registers
+		 * @param target Target description; must outlive the pass
+		 */
+		explicit LoopVectorizePass(const VectorTarget& target) : target(&target) {}
+
+		[[nodiscard]] std::string_view name() const override;
+
+		[[nodiscard]] std::string_view description() const override;
+
+		[[nodiscard]] std::vector<const std::type_info*> required_passes() const override;
+
+		bool run(Module& module, PassContext& context) override;
+
+	private:
+		/**
+		 * @brief A memory access whose address moves one element per iteration
+		 */
+		struct StridedAccess
+		{
+			Node *access = nullptr;  /* PTR_LOAD or PTR_STORE */
+			Node *base = nullptr;    /* loop-invariant base pointer */
+			std::int64_t offset = 0; /* element offset from the counter; `a[i + offset]` */
+			std::uint64_t size = 0;  /* element size in bytes */
+		};
+
+		/**
+		 * @brief A loop in the supported shape, as found before widening
+		 */
+		struct LoopCandidate
+		{
+			Region *header = nullptr;
+			Region *body = nullptr;
+			Node *counter = nullptr;   /* stack slot of the induction variable */
+			Node *bound = nullptr;     /* loop-invariant upper bound, exclusive */
+			Node *increment = nullptr; /* `STORE(ADD(i, 1), counter)` ending the body */
+			DataType index_type = DataType::VOID;
+			std::vector<Node*> nodes;                   /* body nodes between the entry and the increment */
+			std::unordered_set<const Node*> addressing; /* counter loads and address arithmetic; kept scalar */
+			std::unordered_set<const Node*> widened;    /* loads, stores and operations given VF lanes */
+			std::vector<StridedAccess> accesses;        /* in body order */
+			std::vector<Node*> invariants;              /* operands splat across lanes */
+			std::uint32_t vf = 0;
+		};
+
+		const VectorTarget *target = nullptr;
+		const DataLayout *layout = nullptr; /* the module context's layout; only valid during `run()` */
+		std::size_t vectorized_loops = 0;
+		std::size_t rejected_loops = 0;
+		std::size_t widened_nodes = 0;
+
+		/**
+		 * @brief Vectorize the innermost loops of one function
+		 * @return Whether any loop was vectorized
+		 */
+		bool process_function(Module& module, const LoopTree& loops, const LocalAliasResult& alias_result);
+
+		/**
+		 * @brief Match the header and body of a loop against the supported shape
+		 * @return Whether the loop has that shape; `candidate` is filled in if so
+		 */
+		bool match_loop(const Loop& loop, LoopCandidate& candidate) const;
+
+		/**
+		 * @brief Match `ENTRY; i = LOAD(counter); i < bound; BRANCH` in the header
+		 */
+		static bool match_header(const Loop& loop, Region* body, LoopCandidate& candidate);
+
+		/**
+		 * @brief Sort the body's nodes into addressing, widened and the increment
+		 */
+		bool match_body(LoopCandidate& candidate) const;
+
+		/**
+		 * @brief Match `PTR_ADD(base, i * size)` and record the access
+		 * @return Whether the address is unit-stride for the access's element size
+		 */
+		bool match_address(Node* access, LoopCandidate& candidate) const;
+
+		/**
+		 * @brief Match `i`, `i + c` or `i - c` over a counter load in the body
+		 * @param node Node to match
+		 * @param candidate Loop being matched
+		 * @param offset Receives `c`
+		 */
+		static bool match_index(Node* node, const LoopCandidate& candidate, std::int64_t& offset);
+
+		/**
+		 * @brief Check that values only flow between the parts of the body that can hold them
+		 */
+		static bool check_uses(const LoopCandidate& candidate);
+
+		/**
+		 * @brief Check that running VF iterations at once keeps every memory dependence
+		 */
+		static bool check_dependences(const LoopCandidate& candidate, const LocalAliasResult& alias_result);
+
+		/**
+		 * @brief Choose the VF, and with a target weigh the widened body against the scalar one
+		 * @return Whether the loop is worth vectorizing
+		 */
+		bool choose_vf(LoopCandidate& candidate) const;
+
+		/**
+		 * @brief Emit the vector loop in front of the original one
+		 */
+		void vectorize(LoopCandidate& candidate, Module& module);
+
+		/**
+		 * @brief Get the element type a widened node holds in each lane
+		 */
+		static DataType element_type_of(const Node* node);
+
+		/**
+		 * @brief Check whether a value is the same in every iteration of the loop
+		 */
+		static bool is_invariant(const Node* node, const LoopCandidate& candidate);
+
+		/**
+		 * @brief Check if an operation can be widened lane by lane
+		 */
+		static bool is_widenable_operation(NodeType type);
+
+		static bool is_simd_compatible_type(DataType type);
+	};
+}
@@ -6,7 +6,9 @@
 #include <unordered_set>
 #include <vector>
 #include <bloom/analysis/laa.hpp>
+#include <bloom/foundation/data-layout.hpp>
 #include <bloom/foundation/transform-pass.hpp>
+#include <bloom/transform/vectorize/vector-target.hpp>
 
 namespace blm
 {
@@ -35,6 +37,7 @@ namespace blm
 		DataType element_type = DataType::VOID;
 		std::uint32_t vector_width = 0;
 		std::vector<Node*> scalar_ops;
+		std::int64_t cycles_saved = 0; /* estimated by the pass's target, if it has one */
 
 		/**
 		 * @brief Check if this candidate is valid for vectorization
@@ -46,6 +49,34 @@ namespace blm
 		}
 	};
 
+	/**
+	 * @brief Scalar nodes computing the lanes of one vector in an SLP tree
+	 */
+	struct SLPBundle
+	{
+		enum class Kind : std::uint8_t
+		{
+			STORE,     /* adjacent stores; becomes one vector store */
+			LOAD,      /* adjacent loads; becomes one vector load */
+			OPERATION, /* isomorphic operations; becomes one vector operation */
+			SPLAT,     /* the same scalar in every lane */
+			GATHER     /* unrelated scalars built into a vector */
+		};
+
+		Kind kind = Kind::GATHER;
+		std::vector<Node*> lanes;
+		std::vector<std::size_t> operands; /* bundles feeding each operand, as indices into the tree */
+		Node *vector = nullptr;            /* set once the bundle is emitted */
+	};
+
+	/**
+	 * @brief Bundles reachable from a group of adjacent stores through their stored values
+	 */
+	struct SLPTree
+	{
+		std::vector<SLPBundle> bundles; /* the store group first */
+	};
+
 	/**
 	 * @brief Superword Level Parallelism (SLP) vectorization pass
 	 *
@@ -53,10 +84,27 @@ namespace blm
 	 * into vector operations, enabling SIMD execution. It performs sophisticated
 	 * dependency analysis to determine which operations can be safely vectorized
 	 * together without violating program semantics.
+	 *
+	 * Stores to adjacent constant offsets from one base are packed first. Each group seeds
+	 * a tree over the stored values: adjacent loads become one vector load, isomorphic
+	 * operations one vector operation, and anything else is gathered. A tree is only
+	 * emitted if the scalar operations it saves outnumber the gathers and extracts it adds.
+	 *
+	 * Given a `VectorTarget`, packs are at most one register wide and both trees and
+	 * candidates are weighed in the target's estimated cycles instead; only those that
+	 * save cycles are emitted, the candidates that save most first.
 	 */
 	class SLPPass : public TransformPass
 	{
 	public:
+		SLPPass() = default;
+
+		/**
+		 * @brief Vectorize for a target, choosing widths and packs by its costs
+		 * @param target Target description; must outlive the pass
+		 */
+		explicit SLPPass(const VectorTarget& target) : target(&target) {}
+
 		/**
 		 * @brief Get the name of this pass
 		 * @return Pass name for identification and logging
@@ -84,8 +132,29 @@ namespace blm
 		bool run(Module& module, PassContext& context) override;
 
 	private:
+		/**
+		 * @brief Memory facts of one region, taken before its stores are packed
+		 */
+		struct MemoryFacts
+		{
+			const Region *region = nullptr;
+			const LocalAliasResult *alias_result = nullptr;
+			const DataLayout *layout = nullptr;
+			std::unordered_map<const Node*, MemoryLocation> locations; /* address -> constant offset from its base */
+			std::vector<Node*> order;                                  /* nodes of the region */
+			std::unordered_map<const Node*, std::size_t> positions;    /* node -> index in `order` */
+		};
+
+		static constexpr std::size_t MAX_TREE_DEPTH = 8;
+
+		const VectorTarget *target = nullptr;
+		std::int64_t cycles_saved = 0;
+		std::size_t rejected_candidates = 0;
 		std::unordered_set<Node*> processed_nodes;
 		std::vector<VectorCandidate> candidates;
+		std::size_t store_groups = 0;
+		std::size_t rejected_store_groups = 0;
+		std::size_t tree_operations = 0;
 
 		/**
 		 * @brief Process a region to find vectorization candidates
@@ -95,6 +164,136 @@ namespace blm
 		 */
 		void process_region(Region* region, const LocalAliasResult& alias_result, Context& ctx);
 
+		/**
+		 * @brief Pack groups of adjacent stores and the trees feeding them
+		 * @param region Region to vectorize; not its children
+		 * @param alias_result Alias analysis for the locations and ordering of accesses
+		 * @param ctx Context for creating new nodes
+		 */
+		void vectorize_store_groups(Region* region, const LocalAliasResult& alias_result, Context& ctx);
+
+		/**
+		 * @brief Record the address locations of a region's memory accesses
+		 */
+		static MemoryFacts collect_memory_facts(Region* region, const LocalAliasResult& alias_result,
+		                                        const DataLayout& layout);
+
+		/**
+		 * @brief Record the order of a region's nodes
+		 */
+		static void number_positions(MemoryFacts& facts);
+
+		/**
+		 * @brief Find runs of stores to adjacent offsets from one base, split into vector widths
+		 * @return Groups ordered by offset
+		 */
+		std::vector<std::vector<Node*>> find_store_groups(const MemoryFacts& facts) const;
+
+		/**
+		 * @brief Check that the stores of a group can all move down to the last of them
+		 * @param group Stores of the group
+		 * @param anchor The last store of the group in region order
+		 * @param facts Memory facts of the region
+		 */
+		static bool can_sink_stores(const std::vector<Node*>& group, const Node* anchor, const MemoryFacts& facts);
+
+		/**
+		 * @brief Build the SLP tree of a store group
+		 * @param group Stores of the group ordered by offset
+		 * @param facts Memory facts of the region
+		 * @param forced Nodes that must be gathered rather than packed
+		 */
+		static SLPTree build_tree(const std::vector<Node*>& group, const MemoryFacts& facts,
+		                          const std::unordered_set<const Node*>& forced);
+
+		/**
+		 * @brief Add the bundle for a set of lanes and, for packed ones, their operands
+		 * @return Index of the bundle in the tree
+		 */
+		static std::size_t build_bundle(SLPTree& tree, const std::vector<Node*>& lanes, const MemoryFacts& facts,
+		                                const std::unordered_set<const Node*>& forced,
+		                                std::unordered_set<const Node*>& claimed, std::size_t depth);
+
+		/**
+		 * @brief Find lanes that cannot be packed once every bundle is placed at the anchor
+		 *
+		 * Loads may not move past a store they overlap, and lanes read by scalars placed
+		 * before the anchor or by gathers of the same tree cannot be replaced by extracts.
+		 * @return Lanes to gather instead; empty if the tree is safe as it is
+		 */
+		static std::vector<const Node*> find_unsafe_lanes(const SLPTree& tree, const Node* anchor,
+		                                                 const MemoryFacts& facts);
+
+		/**
+		 * @brief Find lanes of packed bundles the target cannot vectorize
+		 */
+		std::vector<const Node*> find_unsupported_lanes(const SLPTree& tree) const;
+
+		/**
+		 * @brief Count the lanes of packed bundles that need an extract for users outside the tree
+		 */
+		static std::size_t count_extracts(const SLPTree& tree);
+
+		/**
+		 * @brief Estimate what emitting a tree saves over its scalar code
+		 * @return Cycles saved on the target, or without one, scalar operations saved less the
+		 *         gathers, splats and extracts added; not positive if the tree does not pay off
+		 */
+		std::int64_t estimate_savings(const SLPTree& tree) const;
+
+		/**
+		 * @brief Estimate the cycles a candidate saves on the target, gathering and extracting every lane
+		 */
+		std::int64_t estimate_savings(const VectorCandidate& candidate) const;
+
+		/**
+		 * @brief Estimate the cycles to build a vector from scalars on the target
+		 *
+		 * One value in every lane is a broadcast and constants are a load from the constant pool.
+		 */
+		std::int64_t estimate_gather_cost(const std::vector<Node*>& lanes) const;
+
+		/**
+		 * @brief Get the widest vector to pack elements of a type into
+		 */
+		std::uint32_t choose_width(DataType element_type) const;
+
+		/**
+		 * @brief Emit the vector nodes of a tree before the anchor and remove the packed scalars
+		 * @return Number of scalar operations removed
+		 */
+		static std::size_t emit_tree(SLPTree& tree, Region* region, Node* anchor, Context& ctx);
+
+		/**
+		 * @brief Emit one bundle after its operands
+		 */
+		static Node* emit_bundle(SLPTree& tree, std::size_t index, Region* region, Node* anchor, Context& ctx);
+
+		/**
+		 * @brief Check whether lanes are loads of adjacent elements, in lane order
+		 */
+		static bool are_consecutive_accesses(const std::vector<Node*>& accesses, const MemoryFacts& facts);
+
+		/**
+		 * @brief Check whether two memory accesses may touch the same bytes
+		 */
+		static bool may_overlap(Node* a, Node* b, const MemoryFacts& facts);
+
+		/**
+		 * @brief Check whether no memory access may be moved across a node
+		 */
+		static bool is_memory_barrier(const Node* node);
+
+		/**
+		 * @brief Get the address operand of a pointer load or store, or nullptr for other nodes
+		 */
+		static Node* address_operand(const Node* access);
+
+		/**
+		 * @brief Get the number of bytes a pointer load or store accesses, or 0 if unknown
+		 */
+		static std::uint64_t access_size(const Node* access, const MemoryFacts& facts);
+
 		/**
 		 * @brief Build a dependency graph for the given region
 		 * @param region Region to analyze for dependencies
@@ -139,14 +338,15 @@ namespace blm
 		 * @param region Region containing the operations
 		 * @return Vectorization candidate from operation chain
 		 */
-		static VectorCandidate try_build_chain_candidate(Node* start_node, Region* region);
+		VectorCandidate try_build_chain_candidate(Node* start_node, Region* region) const;
 
 		/**
 		 * @brief Find a chain of operations that can be vectorized together
 		 * @param start Starting node for the chain
+		 * @param max_width Maximum length of the chain
 		 * @return Vector of nodes forming a vectorizable chain
 		 */
-		static std::vector<Node*> find_operation_chain(Node *start);
+		static std::vector<Node*> find_operation_chain(Node *start, std::uint32_t max_width);
 
 		/**
 		 * @brief Check if two operations have similar structure (isomorphic)
@@ -263,21 +463,5 @@ namespace blm
 		 * @param region Region containing the operations
 		 */
 		static void remove_scalar_operations(const std::vector<Node*>& ops, Region* region);
-
-		/**
-		 * @brief Find the region corresponding to a function
-		 * @param function Function node to find region for
-		 * @param module Module containing the function
-		 * @return Pointer to function region, or nullptr if not found
-		 */
-		Region* find_function_region(Node* function, Module& module) const;
-
-		/**
-		 * @brief Find a region by name within a region hierarchy
-		 * @param region Root region to search from
-		 * @param name Name of region to find
-		 * @return Pointer to found region, or nullptr if not found
-		 */
-		Region* find_region_by_name(const Region* region, std::string_view name) const;
 	};
 }
@@ -0,0 +1,149 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <bloom/foundation/node.hpp>
+#include <bloom/foundation/types.hpp>
+
+namespace blm
+{
+	/**
+	 * @brief Estimated cycles of one operation, as scalar and per vector register
+	 */
+	struct OperationCost
+	{
+		std::uint32_t scalar = 1;
+		std::uint32_t vector = 1;
+	};
+
+	/**
+	 * @brief What the vectorizers may assume about a target's SIMD unit
+	 *
+	 * A target has one vector register width, the element types it can put in a register,
+	 * and per-opcode costs in estimated cycles. Costs can be refined for one element type,
+	 * e.g. a 64-bit multiply most targets only emulate. Opcodes without a cost do not
+	 * vectorize. Shuffle costs cover moving scalars into and out of registers.
+	 *
+	 * The presets are rough reciprocal throughputs of common cores, not a scheduling model;
+	 * they only need to rank packs the way the hardware would.
+	 */
+	class VectorTarget
+	{
+	public:
+		static constexpr std::uint32_t UNSUPPORTED = std::numeric_limits<std::uint32_t>::max();
+
+		VectorTarget(std::string name, std::uint32_t register_bits);
+
+		[[nodiscard]] std::string_view get_name() const
+		{
+			return name;
+		}
+
+		[[nodiscard]] std::uint32_t get_register_bits() const
+		{
+			return register_bits;
+		}
+
+		/**
+		 * @brief Allow an element type in vector registers
+		 */
+		VectorTarget &add_element_type(DataType type);
+
+		/**
+		 * @brief Check whether vector registers can hold elements of a type
+		 */
+		[[nodiscard]] bool supports_element_type(DataType type) const;
+
+		/**
+		 * @brief Get how many elements of a type fit in one vector register
+		 * @return Lane count, or 0 if the type is not supported
+		 */
+		[[nodiscard]] std::uint32_t get_max_lanes(DataType element) const;
+
+		/**
+		 * @brief Set the cost of an opcode for every element type without a cost of its own
+		 */
+		VectorTarget &set_cost(NodeType op, OperationCost cost);
+
+		/**
+		 * @brief Set the cost of an opcode for one element type
+		 */
+		VectorTarget &set_cost(NodeType op, DataType element, OperationCost cost);
+
+		/**
+		 * @brief Set the cost of moving one scalar into a register, one out, and of a broadcast
+		 */
+		VectorTarget &set_shuffle_costs(std::uint32_t insert, std::uint32_t extract, std::uint32_t splat);
+
+		/**
+		 * @brief Get the cost of one scalar operation
+		 */
+		[[nodiscard]] std::uint32_t get_scalar_cost(NodeType op, DataType element) const;
+
+		/**
+		 * @brief Get the cost of one operation over `lanes` elements, across as many registers as they need
+		 * @return Cost, or `UNSUPPORTED`
+		 */
+		[[nodiscard]] std::uint32_t get_vector_cost(NodeType op, DataType element, std::uint32_t lanes) const;
+
+		[[nodiscard]] std::uint32_t get_insert_cost() const
+		{
+			return insert_cost;
+		}
+
+		[[nodiscard]] std::uint32_t get_extract_cost() const
+		{
+			return extract_cost;
+		}
+
+		[[nodiscard]] std::uint32_t get_splat_cost() const
+		{
+			return splat_cost;
+		}
+
+		/**
+		 * @brief x86-64 with SSE4.2; 128-bit registers
+		 */
+		static const VectorTarget &x86_64_sse();
+
+		/**
+		 * @brief x86-64 with AVX2; 256-bit registers
+		 */
+		static const VectorTarget &x86_64_avx2();
+
+		/**
+		 * @brief x86-64 with AVX-512 F/BW/DQ; 512-bit registers
+		 */
+		static const VectorTarget &x86_64_avx512();
+
+		/**
+		 * @brief AArch64 with Advanced SIMD (NEON); 128-bit registers
+		 */
+		static const VectorTarget &aarch64_neon();
+
+		/**
+		 * @brief Look up a preset by name: "sse", "avx2", "avx512" or "neon"
+		 * @return The preset, or nullptr
+		 */
+		static const VectorTarget *find(std::string_view name);
+
+	private:
+		std::string name;
+		std::uint32_t register_bits;
+		std::vector<DataType> element_types;
+		std::array<OperationCost, NODE_TYPE_COUNT> costs;
+		std::vector<std::pair<std::pair<NodeType, DataType>, OperationCost> > element_costs;
+		std::uint32_t insert_cost = 1;
+		std::uint32_t extract_cost = 1;
+		std::uint32_t splat_cost = 1;
+
+		[[nodiscard]] const OperationCost &get_cost(NodeType op, DataType element) const;
+	};
+}
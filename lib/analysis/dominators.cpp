@@ -0,0 +1,249 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <algorithm>
+#include <unordered_set>
+#include <bloom/analysis/dominators.hpp>
+#include <bloom/foundation/module.hpp>
+
+namespace blm
+{
+	namespace
+	{
+		constexpr auto UNDEFINED = static_cast<std::uint32_t>(-1);
+
+		void append_target(std::vector<Region *> &out, const Node *entry)
+		{
+			if (entry && entry->ir_type == NodeType::ENTRY && entry->parent_region)
+				out.push_back(entry->parent_region);
+		}
+
+		/* children first so structured nesting shapes the dfs, then control targets */
+		std::vector<Region *> successors(const Region *region)
+		{
+			std::vector<Region *> out(region->get_children().begin(), region->get_children().end());
+			for (const Node *node: region->get_nodes())
+			{
+				switch (node->ir_type)
+				{
+					case NodeType::JUMP:
+						if (!node->inputs.empty())
+							append_target(out, node->inputs[0]);
+						break;
+
+					case NodeType::BRANCH:
+						if (node->inputs.size() >= 3)
+						{
+							append_target(out, node->inputs[1]);
+							append_target(out, node->inputs[2]);
+						}
+						break;
+
+					case NodeType::INVOKE:
+						if (node->inputs.size() >= 2)
+						{
+							append_target(out, node->inputs[node->inputs.size() - 2]);
+							append_target(out, node->inputs[node->inputs.size() - 1]);
+						}
+						break;
+
+					default:
+						break;
+				}
+			}
+			return out;
+		}
+	}
+
+	DominatorTree::DominatorTree(Region *entry)
+	{
+		recalculate(entry);
+	}
+
+	void DominatorTree::recalculate(Region *entry)
+	{
+		index.clear();
+		order.clear();
+		idom.clear();
+		pre.clear();
+		post.clear();
+		if (!entry)
+			return;
+
+		/* iterative dfs producing the postorder and the successor lists */
+		struct Frame
+		{
+			Region *region;
+			std::vector<Region *> succs;
+			std::size_t next = 0;
+		};
+
+		std::unordered_map<const Region *, std::vector<Region *> > edges;
+		std::unordered_set<const Region *> visited;
+		std::vector<Frame> stack;
+		visited.insert(entry);
+		stack.push_back({ entry, successors(entry) });
+		while (!stack.empty())
+		{
+			Frame &frame = stack.back();
+			if (frame.next < frame.succs.size())
+			{
+				Region *succ = frame.succs[frame.next++];
+				if (visited.insert(succ).second)
+					stack.push_back({ succ, successors(succ) });
+				continue;
+			}
+
+			order.push_back(frame.region);
+			edges[frame.region] = std::move(frame.succs);
+			stack.pop_back();
+		}
+
+		std::ranges::reverse(order);
+		for (std::uint32_t i = 0; i < order.size(); ++i)
+			index[order[i]] = i;
+
+		std::vector<std::vector<std::uint32_t> > preds(order.size());
+		for (std::uint32_t i = 0; i < order.size(); ++i)
+		{
+			for (const Region *succ: edges[order[i]])
+				preds[index[succ]].push_back(i);
+		}
+
+		compute_idoms(preds);
+		number_tree();
+	}
+
+	void DominatorTree::compute_idoms(const std::vector<std::vector<std::uint32_t> > &preds)
+	{
+		idom.assign(order.size(), UNDEFINED);
+		idom[0] = 0;
+
+		/* walk both fingers up the partially built tree; reverse postorder numbers
+		 * decrease towards the entry */
+		auto intersect = [&](std::uint32_t a, std::uint32_t b)
+		{
+			while (a != b)
+			{
+				while (a > b)
+					a = idom[a];
+				while (b > a)
+					b = idom[b];
+			}
+			return a;
+		};
+
+		bool changed = true;
+		while (changed)
+		{
+			changed = false;
+			for (std::uint32_t b = 1; b < order.size(); ++b)
+			{
+				std::uint32_t new_idom = UNDEFINED;
+				for (const std::uint32_t p: preds[b])
+				{
+					if (idom[p] == UNDEFINED)
+						continue;
+					new_idom = new_idom == UNDEFINED ? p : intersect(p, new_idom);
+				}
+
+				if (new_idom != idom[b])
+				{
+					idom[b] = new_idom;
+					changed = true;
+				}
+			}
+		}
+	}
+
+	void DominatorTree::number_tree()
+	{
+		const auto count = static_cast<std::uint32_t>(order.size());
+		pre.assign(count, 0);
+		post.assign(count, 0);
+		if (count == 0)
+			return;
+
+		/* children in csr form; the entry is its own idom and is skipped */
+		std::vector<std::uint32_t> offsets(count + 1, 0);
+		for (std::uint32_t i = 1; i < count; ++i)
+			offsets[idom[i] + 1]++;
+		for (std::uint32_t i = 1; i <= count; ++i)
+			offsets[i] += offsets[i - 1];
+
+		std::vector<std::uint32_t> children(count - 1);
+		std::vector<std::uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+		for (std::uint32_t i = 1; i < count; ++i)
+			children[cursor[idom[i]]++] = i;
+
+		std::uint32_t pre_clock = 0;
+		std::uint32_t post_clock = 0;
+		std::vector<std::pair<std::uint32_t, std::uint32_t> > stack;
+		stack.emplace_back(0, offsets[0]);
+		pre[0] = pre_clock++;
+		while (!stack.empty())
+		{
+			auto &[node, next] = stack.back();
+			if (next < offsets[node + 1])
+			{
+				const std::uint32_t child = children[next++];
+				pre[child] = pre_clock++;
+				stack.emplace_back(child, offsets[child]);
+				continue;
+			}
+
+			post[node] = post_clock++;
+			stack.pop_back();
+		}
+	}
+
+	bool DominatorTree::dominates(const Region *a, const Region *b) const
+	{
+		if (a == b)
+			return true;
+
+		const auto ia = index.find(a);
+		const auto ib = index.find(b);
+		if (ia == index.end() || ib == index.end())
+			return false;
+
+		return pre[ia->second] <= pre[ib->second] && post[ib->second] <= post[ia->second];
+	}
+
+	Region *DominatorTree::get_idom(const Region *region) const
+	{
+		const auto it = index.find(region);
+		if (it == index.end() || it->second == 0)
+			return nullptr;
+		return order[idom[it->second]];
+	}
+
+	Region *DominatorTree::nearest_common_dominator(const Region *a, const Region *b) const
+	{
+		const auto ia = index.find(a);
+		const auto ib = index.find(b);
+		if (ia == index.end() || ib == index.end())
+			return nullptr;
+
+		std::uint32_t current = ia->second;
+		while (!dominates(order[current], b))
+			current = idom[current];
+		return order[current];
+	}
+
+	bool DominatorTreeResult::invalidated_by(const std::type_info &transform_type) const
+	{
+		return invalidated_by(transform_type, PreservedAnalyses::none());
+	}
+
+	bool DominatorTreeResult::invalidated_by(const std::type_info &, const PreservedAnalyses &preserved) const
+	{
+		return !preserved.preserves_cfg();
+	}
+
+	std::unique_ptr<AnalysisResult> DominatorTreeAnalysisPass::analyze(Module &module, PassContext &context)
+	{
+		auto result = std::make_unique<DominatorTreeResult>(DominatorTree(module.get_root_region()));
+		context.update_stat("dominator_tree.regions", result->get_tree().size());
+		return result;
+	}
+}
@@ -1,5 +1,7 @@
 /* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
 
+#include <algorithm>
+#include <unordered_map>
 #include <bloom/analysis/laa.hpp>
 #include <bloom/foundation/context.hpp>
 #include <bloom/foundation/node.hpp>
@@ -9,102 +11,425 @@
 
 namespace blm
 {
-	bool LocalAliasResult::invalidated_by(const std::type_info &) const
+	namespace
 	{
-		return true;
+		/* a store or load whose address resolved to a location of a non-escaped object */
+		struct Access
+		{
+			Node *op;
+			Node *source;
+			std::int64_t offset; /* -1 if unknown */
+			std::int64_t end;
+		};
+
+		/* accesses sharing one base object */
+		struct AccessBucket
+		{
+			std::vector<Access> stores;
+			std::vector<Access> loads;
+		};
+
+		/**
+		 * @brief Relate every store and load of a bucket that may overlap
+		 *
+		 * Mirrors `LocalAliasResult::alias` for two addresses with the same base: accesses
+		 * through the same source always alias, an unknown offset may alias anything, and
+		 * known offsets alias when their byte ranges overlap. Overlaps are found with a sweep
+		 * over the loads sorted by offset instead of comparing every pair.
+		 */
+		void relate_bucket(FunctionAliasResult &result, AccessBucket &bucket)
+		{
+			const auto is_unknown = [](const Access &access) { return access.offset == -1; };
+			const auto known_stores = std::ranges::partition(bucket.stores, is_unknown);
+			const auto known_loads = std::ranges::partition(bucket.loads, is_unknown);
+
+			for (auto it = bucket.stores.begin(); it != known_stores.begin(); ++it)
+			{
+				for (const Access &load: bucket.loads)
+					result.add_store_load_relation(it->op, load.op);
+			}
+
+			for (auto it = bucket.loads.begin(); it != known_loads.begin(); ++it)
+			{
+				for (const Access &store: bucket.stores)
+					result.add_store_load_relation(store.op, it->op);
+			}
+
+			/* same source; matched by walking both sides sorted by source */
+			const auto by_source = [](const Access &a, const Access &b) { return std::less<> {}(a.source, b.source); };
+			std::ranges::sort(known_stores, by_source);
+			std::ranges::sort(known_loads, by_source);
+			for (auto store = known_stores.begin(), load = known_loads.begin();
+			     store != known_stores.end() && load != known_loads.end();)
+			{
+				if (store->source != load->source)
+				{
+					by_source(*store, *load) ? ++store : ++load;
+					continue;
+				}
+
+				const Node *source = store->source;
+				auto store_last = store;
+				auto load_last = load;
+				while (store_last != known_stores.end() && store_last->source == source)
+					++store_last;
+				while (load_last != known_loads.end() && load_last->source == source)
+					++load_last;
+
+				for (auto s = store; s != store_last; ++s)
+				{
+					for (auto l = load; l != load_last; ++l)
+						result.add_store_load_relation(s->op, l->op);
+				}
+				store = store_last;
+				load = load_last;
+			}
+
+			/* overlapping byte ranges: a load [lo, le) overlaps a store [so, se) when
+			 * lo < se and le > so, and le > so needs lo > so - the widest load */
+			std::ranges::sort(known_loads, {}, &Access::offset);
+			std::int64_t widest = 0;
+			for (const Access &load: known_loads)
+				widest = std::max(widest, load.end - load.offset);
+
+			for (const Access &store: known_stores)
+			{
+				for (auto load = std::ranges::upper_bound(known_loads, store.offset - widest, {}, &Access::offset);
+				     load != known_loads.end() && load->offset < store.end; ++load)
+				{
+					if (load->end > store.offset)
+						result.add_store_load_relation(store.op, load->op);
+				}
+			}
+		}
 	}
 
-	void LocalAliasResult::add_location(Node *ptr, const MemoryLocation loc)
+	FunctionAliasResult::FunctionAliasResult(const NodeNumbering &numbering, const NodeRange range)
+		: numbering(&numbering), range(range), memory_locations(numbering, range),
+		  allocation_sites(numbering, range), escaped_pointers(numbering, range), pointer_copies(numbering, range, nullptr)
+	{}
+
+	void FunctionAliasResult::rebase(const NodeRange moved)
 	{
-		memory_locations[ptr] = loc;
+		/* every index in the body moves by the same amount, so relation targets stay sorted */
+		range = moved;
+		memory_locations.rebase(moved);
+		allocation_sites.rebase(moved);
+		escaped_pointers.rebase(moved);
+		pointer_copies.rebase(moved);
+		store_to_loads.spans.rebase(moved);
+		load_to_stores.spans.rebase(moved);
 	}
 
-	const MemoryLocation *LocalAliasResult::get_location(Node *ptr) const
+	void FunctionAliasResult::add_location(Node *ptr, const MemoryLocation loc)
 	{
-		const auto it = memory_locations.find(ptr);
-		if (it != memory_locations.end())
-			return &it->second;
-		return nullptr;
+		if (MemoryLocation *slot = memory_locations.find(ptr))
+			*slot = loc;
+	}
+
+	const MemoryLocation *FunctionAliasResult::get_location(Node *ptr) const
+	{
+		const MemoryLocation *loc = memory_locations.find(ptr);
+		return loc && loc->base ? loc : nullptr;
 	}
 
-	void LocalAliasResult::mark_escaped(Node *ptr)
+	void FunctionAliasResult::mark_escaped(Node *ptr)
 	{
 		escaped_pointers.insert(ptr);
 	}
 
-	bool LocalAliasResult::has_escaped(Node *ptr) const
+	bool FunctionAliasResult::has_escaped(Node *ptr) const
 	{
 		return escaped_pointers.contains(ptr);
 	}
 
-	void LocalAliasResult::add_pointer_copy(Node *dest, Node *src)
+	void FunctionAliasResult::add_pointer_copy(Node *dest, Node *src)
 	{
-		pointer_copies[dest] = src;
+		if (Node **slot = pointer_copies.find(dest))
+		{
+			if (!*slot)
+				++pointer_copy_count;
+			*slot = src;
+		}
 	}
 
-	Node *LocalAliasResult::get_pointer_source(Node *ptr) const
+	Node *FunctionAliasResult::get_pointer_source(Node *ptr) const
 	{
-		/* we try to follow the chain of pointer copies to find the ultimate source */
+		/* we try to follow the chain of pointer copies to find the ultimate source; a chain
+		 * without cycles visits each recorded copy at most once */
 		Node *current = ptr;
-		std::unordered_set<Node *> visited;
-		while (current && !visited.contains(current))
-		{
-			visited.insert(current);
-			if (auto it = pointer_copies.find(current);
-				it != pointer_copies.end())
-				current = it->second;
-			else
+		for (std::size_t steps = 0; current && steps <= pointer_copy_count; ++steps)
+		{
+			Node *source = pointer_copies.get(current);
+			if (!source)
 				break;
+			current = source;
 		}
 
 		return current;
 	}
 
-	void LocalAliasResult::add_store_operation(Node *store)
+	void FunctionAliasResult::add_store_operation(Node *store)
 	{
-		all_stores.insert(store);
+		all_stores.push_back(store);
 	}
 
-	void LocalAliasResult::add_load_operation(Node *load)
+	void FunctionAliasResult::add_load_operation(Node *load)
 	{
-		all_loads.insert(load);
+		all_loads.push_back(load);
 	}
 
-	void LocalAliasResult::add_store_load_relation(Node *store, Node *load)
+	void FunctionAliasResult::add_store_load_relation(Node *store, Node *load)
 	{
-		store_to_loads[store].insert(load);
-		load_to_stores[load].insert(store);
+		const NodeId store_index = numbering->index_of(store);
+		const NodeId load_index = numbering->index_of(load);
+		if (range.contains(store_index) && range.contains(load_index))
+			relations.emplace_back(store_index, load_index);
 	}
 
-	std::vector<Node *> LocalAliasResult::get_affecting_stores(Node *load) const
+	void FunctionAliasResult::finalize_relations()
 	{
-		std::vector<Node*> stores;
-		if (const auto it = load_to_stores.find(load); it != load_to_stores.end())
+		std::ranges::sort(relations);
+		relations.erase(std::ranges::unique(relations).begin(), relations.end());
+		build_relation_index(store_to_loads, true);
+		build_relation_index(load_to_stores, false);
+	}
+
+	void FunctionAliasResult::build_relation_index(RelationIndex &index, const bool by_store)
+	{
+		std::vector<std::pair<NodeId, NodeId> > swapped;
+		if (!by_store)
 		{
-			stores.reserve(it->second.size());
-			for (Node* store : it->second)
-				stores.push_back(store);
+			swapped.reserve(relations.size());
+			for (const auto &[store, load]: relations)
+				swapped.emplace_back(load, store);
+			std::ranges::sort(swapped);
+		}
+
+		const auto &pairs = by_store ? relations : swapped;
+		index.spans = NodeMap<RelationIndex::Span>(*numbering, range);
+		index.targets.clear();
+		index.targets.reserve(pairs.size());
+		for (std::size_t i = 0; i < pairs.size();)
+		{
+			const NodeId key = pairs[i].first;
+			const auto begin = static_cast<std::uint32_t>(i);
+			for (; i < pairs.size() && pairs[i].first == key; ++i)
+				index.targets.push_back((*numbering)[pairs[i].second]);
+			index.spans[(*numbering)[key]] = { begin, static_cast<std::uint32_t>(i) - begin };
 		}
-		return stores;
 	}
 
-	std::vector<Node *> LocalAliasResult::get_affected_loads(Node *store) const
+	std::vector<Node *> FunctionAliasResult::get_affecting_stores(Node *load) const
+	{
+		const auto stores = load_to_stores.of(load);
+		return { stores.begin(), stores.end() };
+	}
+
+	std::vector<Node *> FunctionAliasResult::get_affected_loads(Node *store) const
+	{
+		const auto loads = store_to_loads.of(store);
+		return { loads.begin(), loads.end() };
+	}
+
+	bool FunctionAliasResult::maybe_modified_by(Node *load, Node *store) const
+	{
+		const NodeId index = numbering->index_of(store);
+		if (index == INVALID_NODE_ID)
+			return false;
+
+		/* targets are sorted by node index */
+		const auto stores = load_to_stores.of(load);
+		const auto it = std::ranges::lower_bound(stores, index, {},
+			[](const Node *node) { return node->index; });
+		return it != stores.end() && *it == store;
+	}
+
+	void FunctionAliasResult::add_allocation_site(Node *node, uint64_t size)
+	{
+		allocation_sites.insert(node);
+		MemoryLocation loc;
+		loc.base = node;
+		loc.offset = 0;
+		loc.size = size;
+		add_location(node, loc);
+	}
+
+	bool FunctionAliasResult::is_allocation_site(Node *node) const
+	{
+		return allocation_sites.contains(node);
+	}
+
+	LocalAliasResult::LocalAliasResult(Module &module) : module(&module), numbering(&module.get_numbering()),
+		generation(numbering->get_generation())
+	{
+		index_bodies();
+	}
+
+	bool LocalAliasResult::invalidated_by(const std::type_info &) const
+	{
+		return false;
+	}
+
+	void LocalAliasResult::refresh()
+	{
+		module->get_numbering();
+		sync();
+	}
+
+	void LocalAliasResult::sync() const
 	{
-		std::vector<Node*> loads;
-		if (auto it = store_to_loads.find(store); it != store_to_loads.end())
+		if (generation == numbering->get_generation())
+			return;
+
+		generation = numbering->get_generation();
+		index_bodies();
+
+		/* a body that kept its version is laid out as before, only at another offset */
+		for (auto it = functions.begin(); it != functions.end();)
 		{
-			loads.reserve(it->second.size());
-			for (Node* load : it->second)
-				loads.push_back(load);
+			const Region *body = module->get_function_region(it->first);
+			const NodeRange range = numbering->range_of(body);
+			const CachedFunction &cached = *it->second;
+			if (!body || body != cached.body || body->get_version() != cached.version || !cached.result ||
+			    range.size() != cached.result->get_range().size())
+			{
+				it = functions.erase(it);
+				continue;
+			}
+
+			cached.result->rebase(range);
+			++it;
 		}
-		return loads;
+	}
+
+	void LocalAliasResult::index_bodies() const
+	{
+		bodies.clear();
+		for (Node *func: module->get_functions())
+		{
+			if (func->ir_type != NodeType::FUNCTION)
+				continue;
+
+			const Region *body = module->get_function_region(func);
+			if (const NodeRange range = numbering->range_of(body); body && range.size() != 0)
+				bodies.push_back({ range, func, body, NO_BODY });
+		}
+
+		/* outer bodies sort before the bodies nested in them */
+		std::ranges::sort(bodies, [](const FunctionBody &a, const FunctionBody &b)
+		{
+			return a.range.begin != b.range.begin ? a.range.begin < b.range.begin : a.range.end > b.range.end;
+		});
+
+		std::vector<std::size_t> open;
+		for (std::size_t i = 0; i < bodies.size(); ++i)
+		{
+			while (!open.empty() && bodies[open.back()].range.end <= bodies[i].range.begin)
+				open.pop_back();
+			if (!open.empty())
+				bodies[i].enclosing = open.back();
+			open.push_back(i);
+		}
+	}
+
+	const FunctionAliasResult &LocalAliasResult::function_result(const FunctionBody &body) const
+	{
+		CachedFunction *cached;
+		{
+			std::lock_guard lock(functions_mutex);
+			std::unique_ptr<CachedFunction> &slot = functions[body.func];
+			if (!slot || slot->body != body.body)
+			{
+				slot = std::make_unique<CachedFunction>();
+				slot->body = body.body;
+			}
+			cached = slot.get();
+		}
+
+		std::call_once(cached->analyzed, [&]
+		{
+			/* a body edited since the numbering was assigned is only partly numbered; such a
+			 * result serves the current pass but is not kept past the next renumber */
+			const std::uint64_t version = body.body->get_version();
+			cached->version = version == body.body->get_numbered_version() ? version : STALE_VERSION;
+			auto result = std::make_unique<FunctionAliasResult>(*numbering, body.range);
+
+			LocalAliasAnalysisPass analyzer;
+			analyzer.analyze_function(*result, body.body, module->get_context().get_data_layout());
+			cached->result = std::move(result);
+		});
+		return *cached->result;
+	}
+
+	const FunctionAliasResult *LocalAliasResult::get_function_result(const Node *func) const
+	{
+		sync();
+		const Region *body = module->get_function_region(func);
+		const auto it = std::ranges::find(bodies, body, &FunctionBody::body);
+		return it == bodies.end() || !body ? nullptr : &function_result(*it);
+	}
+
+	const FunctionAliasResult *LocalAliasResult::owner_of(const Node *node) const
+	{
+		sync();
+		const NodeId index = numbering->index_of(node);
+		if (index == INVALID_NODE_ID)
+			return nullptr;
+
+		const auto after = std::ranges::upper_bound(bodies, index, {},
+			[](const FunctionBody &body) { return body.range.begin; });
+		if (after == bodies.begin())
+			return nullptr;
+
+		for (auto i = static_cast<std::size_t>(after - bodies.begin() - 1); i != NO_BODY; i = bodies[i].enclosing)
+		{
+			if (bodies[i].range.contains(index))
+				return &function_result(bodies[i]);
+		}
+		return nullptr;
+	}
+
+	const MemoryLocation *LocalAliasResult::get_location(Node *ptr) const
+	{
+		const FunctionAliasResult *owner = owner_of(ptr);
+		return owner ? owner->get_location(ptr) : nullptr;
+	}
+
+	bool LocalAliasResult::is_allocation_site(Node *node) const
+	{
+		const FunctionAliasResult *owner = owner_of(node);
+		return owner && owner->is_allocation_site(node);
+	}
+
+	bool LocalAliasResult::has_escaped(Node *ptr) const
+	{
+		const FunctionAliasResult *owner = owner_of(ptr);
+		return owner && owner->has_escaped(ptr);
+	}
+
+	Node *LocalAliasResult::get_pointer_source(Node *ptr) const
+	{
+		const FunctionAliasResult *owner = owner_of(ptr);
+		return owner ? owner->get_pointer_source(ptr) : ptr;
+	}
+
+	std::vector<Node *> LocalAliasResult::get_affecting_stores(Node *load) const
+	{
+		const FunctionAliasResult *owner = owner_of(load);
+		return owner ? owner->get_affecting_stores(load) : std::vector<Node *> {};
+	}
+
+	std::vector<Node *> LocalAliasResult::get_affected_loads(Node *store) const
+	{
+		const FunctionAliasResult *owner = owner_of(store);
+		return owner ? owner->get_affected_loads(store) : std::vector<Node *> {};
 	}
 
 	bool LocalAliasResult::maybe_modified_by(Node *load, Node *store) const
 	{
-		if (auto it = load_to_stores.find(load); it != load_to_stores.end())
-			return it->second.contains(store);
-		return false;
+		const FunctionAliasResult *owner = owner_of(load);
+		return owner && owner->maybe_modified_by(load, store);
 	}
 
 	AliasResult LocalAliasResult::alias(Node *a, Node *b) const
@@ -113,17 +438,22 @@ namespace blm
 		if (a == b)
 			return AliasResult::MUST_ALIAS;
 
+		/* each pointer is looked up in the function it belongs to; copies never cross
+		 * functions, so its ultimate source does too */
+		const FunctionAliasResult *owner_a = owner_of(a);
+		const FunctionAliasResult *owner_b = owner_of(b);
+
 		/* follow pointer copies to get ultimate sources */
-		Node *ultimate_a = get_pointer_source(a);
-		Node *ultimate_b = get_pointer_source(b);
+		Node *ultimate_a = owner_a ? owner_a->get_pointer_source(a) : a;
+		Node *ultimate_b = owner_b ? owner_b->get_pointer_source(b) : b;
 		if (ultimate_a == ultimate_b)
 			return AliasResult::MUST_ALIAS;
 
-		if (has_escaped(ultimate_a) || has_escaped(ultimate_b))
+		if ((owner_a && owner_a->has_escaped(ultimate_a)) || (owner_b && owner_b->has_escaped(ultimate_b)))
 			return AliasResult::MAY_ALIAS;
 
-		const auto *loc_a = get_location(ultimate_a);
-		const auto *loc_b = get_location(ultimate_b);
+		const auto *loc_a = owner_a ? owner_a->get_location(ultimate_a) : nullptr;
+		const auto *loc_b = owner_b ? owner_b->get_location(ultimate_b) : nullptr;
 		if (!loc_a || !loc_b)
 			return AliasResult::MAY_ALIAS;
 
@@ -143,40 +473,51 @@ namespace blm
 		return AliasResult::MAY_ALIAS;
 	}
 
-	void LocalAliasResult::add_allocation_site(Node *node, uint64_t size)
+	const LocalAliasResult &get_local_alias_result(Module &module, PassContext &context)
 	{
-		allocation_sites.insert(node);
-		MemoryLocation loc;
-		loc.base = node;
-		loc.offset = 0;
-		loc.size = size;
-		add_location(node, loc);
+		/* results are stored under the type of the pass that produced them */
+		if (auto *result = context.get_result<LocalAliasResult>(typeid(LocalAliasAnalysisPass)))
+		{
+			result->refresh();
+			return *result;
+		}
+
+		auto result = std::make_unique<LocalAliasResult>(module);
+		const LocalAliasResult &stored = *result;
+		context.store_result(typeid(LocalAliasAnalysisPass), std::move(result));
+		return stored;
 	}
 
-	bool LocalAliasResult::is_allocation_site(Node *node) const
+	std::unique_ptr<AnalysisResult> LocalAliasAnalysisPass::analyze(Module &module, PassContext &)
 	{
-		return allocation_sites.contains(node);
+		return std::make_unique<LocalAliasResult>(module);
 	}
 
-	std::unique_ptr<AnalysisResult> LocalAliasAnalysisPass::analyze(Module &module, PassContext &)
+	bool LocalAliasAnalysisPass::run(Module &module, PassContext &context)
 	{
-		auto result = std::make_unique<LocalAliasResult>();
-		for (Node *func: module.get_functions())
-			analyze_function(*result, func, module);
+		get_local_alias_result(module, context);
+		return true;
+	}
 
-		perform_escape_analysis(*result, module);
-		analyze_store_load_relations(*result);
-		return result;
+	void LocalAliasAnalysisPass::analyze_function(FunctionAliasResult &result, const Region *body,
+	                                              const DataLayout &data_layout)
+	{
+		layout = &data_layout;
+		analyze_region(result, body);
+		perform_escape_analysis(result, body);
+		analyze_store_load_relations(result);
+		result.finalize_relations();
+		layout = nullptr;
 	}
 
-	void LocalAliasAnalysisPass::handle_store(LocalAliasResult &result, Node *node)
+	void LocalAliasAnalysisPass::handle_store(FunctionAliasResult &result, const Node *node) const
 	{
 		if (node->inputs.size() < 2)
 			return;
 
-		Node* stored_value = node->inputs[0];
-		Node* store_address = node->inputs[1];
-		if (stored_value->type_kind == DataType::POINTER)
+		/* relations to loads are built once every pointer is known; see `analyze_store_load_relations` */
+		if (Node* stored_value = node->inputs[0];
+			stored_value->type_kind == DataType::POINTER)
 		{
 			if (Node* source = result.get_pointer_source(stored_value);
 				!result.has_escaped(source))
@@ -184,65 +525,67 @@ namespace blm
 				result.mark_escaped(source);
 			}
 		}
+	}
+
+	void LocalAliasAnalysisPass::analyze_store_load_relations(FunctionAliasResult &result) const
+	{
+		/* an address whose source escaped or has no location may alias anything; any other
+		 * address can only overlap accesses to the same base object, so those are bucketed
+		 * by base and compared within their bucket only */
+		std::vector<Node *> stores;
+		std::vector<Node *> loads;
+		std::vector<Node *> wild_stores;
+		std::vector<Node *> wild_loads;
+		std::unordered_map<Node *, AccessBucket> buckets;
 
-		for (Node* load : result.get_all_loads())
+		const auto classify = [&](Node *op, Node *address, std::vector<Node *> &wild, const bool is_store)
 		{
-			if (load->inputs.empty())
-				continue;
-			if (Node* load_address = load->inputs[0];
-				addresses_may_alias(result, store_address, load_address))
+			Node *source = result.get_pointer_source(address);
+			const MemoryLocation *loc = source && !result.has_escaped(source) ? result.get_location(source) : nullptr;
+			if (!loc)
 			{
-				result.add_store_load_relation(node, load);
+				wild.push_back(op);
+				return;
 			}
-		}
-	}
 
-	void LocalAliasAnalysisPass::analyze_store_load_relations(LocalAliasResult &result)
-	{
-		for (Node* store : result.get_all_stores())
+			AccessBucket &bucket = buckets[loc->base];
+			const Access access { op, source, loc->offset, loc->offset + static_cast<std::int64_t>(loc->size) };
+			(is_store ? bucket.stores : bucket.loads).push_back(access);
+		};
+
+		for (Node *store: result.get_all_stores())
 		{
 			if (store->inputs.size() < 2)
 				continue;
-
-			Node* store_address = store->inputs[1];
-			for (Node* load : result.get_all_loads())
-			{
-				if (load->inputs.empty())
-					continue;
-
-				Node* load_address = load->inputs[0];
-				if (addresses_may_alias(result, store_address, load_address))
-				{
-					result.add_store_load_relation(store, load);
-				}
-			}
+			stores.push_back(store);
+			classify(store, store->inputs[1], wild_stores, true);
 		}
-	}
 
-	bool LocalAliasAnalysisPass::addresses_may_alias(LocalAliasResult &result, Node *addr1, Node *addr2) const
-	{
-		if (addr1 == addr2)
-			return true;
-		const AliasResult alias_result = result.alias(addr1, addr2);
-		return alias_result != AliasResult::NO_ALIAS;
-	}
+		for (Node *load: result.get_all_loads())
+		{
+			if (load->inputs.empty())
+				continue;
+			loads.push_back(load);
+			classify(load, load->inputs[0], wild_loads, false);
+		}
 
-	void LocalAliasAnalysisPass::analyze_function(LocalAliasResult &result, Node *func, Module &module)
-	{
-		if (func->ir_type != NodeType::FUNCTION)
-			return;
+		for (Node *store: wild_stores)
+		{
+			for (Node *load: loads)
+				result.add_store_load_relation(store, load);
+		}
 
-		for (const Region *child: module.get_root_region()->get_children())
+		for (Node *load: wild_loads)
 		{
-			if (child->get_name() == module.get_context().get_string(func->str_id))
-			{
-				analyze_region(result, child);
-				break;
-			}
+			for (Node *store: stores)
+				result.add_store_load_relation(store, load);
 		}
+
+		for (auto &entry: buckets)
+			relate_bucket(result, entry.second);
 	}
 
-	void LocalAliasAnalysisPass::analyze_region(LocalAliasResult &result, const Region *region)
+	void LocalAliasAnalysisPass::analyze_region(FunctionAliasResult &result, const Region *region)
 	{
 		if (!region)
 			return;
@@ -253,7 +596,7 @@ namespace blm
 			analyze_region(result, child);
 	}
 
-	void LocalAliasAnalysisPass::analyze_node(LocalAliasResult &result, Node *node)
+	void LocalAliasAnalysisPass::analyze_node(FunctionAliasResult &result, Node *node)
 	{
 		if (node->parent_region && is_global_scope(node->parent_region))
 		{
@@ -315,7 +658,7 @@ namespace blm
 		}
 	}
 
-	void LocalAliasAnalysisPass::handle_allocation(LocalAliasResult &result, Node *node) const
+	void LocalAliasAnalysisPass::handle_allocation(FunctionAliasResult &result, Node *node) const
 	{
 		std::uint64_t size = 0;
 		if (node->ir_type == NodeType::HEAP_ALLOC)
@@ -344,7 +687,7 @@ namespace blm
 		result.add_allocation_site(node, size);
 	}
 
-	void LocalAliasAnalysisPass::handle_pointer_arithmetic(LocalAliasResult &result, Node *node)
+	void LocalAliasAnalysisPass::handle_pointer_arithmetic(FunctionAliasResult &result, Node *node)
 	{
 		if (node->inputs.size() < 2)
 			return;
@@ -364,7 +707,7 @@ namespace blm
 		}
 	}
 
-	void LocalAliasAnalysisPass::handle_address_of(LocalAliasResult &result, Node *node) const
+	void LocalAliasAnalysisPass::handle_address_of(FunctionAliasResult &result, Node *node) const
 	{
 		if (node->inputs.empty())
 			return;
@@ -380,7 +723,7 @@ namespace blm
 		result.add_location(node, loc);
 	}
 
-	void LocalAliasAnalysisPass::handle_parameter(LocalAliasResult &result, Node *node) const
+	void LocalAliasAnalysisPass::handle_parameter(FunctionAliasResult &result, Node *node) const
 	{
 		if (node->type_kind == DataType::POINTER)
 		{
@@ -400,7 +743,7 @@ namespace blm
 		}
 	}
 
-	void LocalAliasAnalysisPass::handle_load(LocalAliasResult &result, Node *node) const
+	void LocalAliasAnalysisPass::handle_load(FunctionAliasResult &result, Node *node) const
 	{
 		if (node->type_kind == DataType::POINTER)
 			/* this is a load of a pointer value; mark it as potentially
@@ -408,7 +751,7 @@ namespace blm
 			result.mark_escaped(node);
 	}
 
-	void LocalAliasAnalysisPass::handle_function_call(LocalAliasResult &result, const Node *node) const
+	void LocalAliasAnalysisPass::handle_function_call(FunctionAliasResult &result, const Node *node) const
 	{
 		for (std::size_t i = 1; i < node->inputs.size(); ++i)
 		{
@@ -432,7 +775,7 @@ namespace blm
 		}
 	}
 
-	void LocalAliasAnalysisPass::handle_return(LocalAliasResult &result, const Node *node) const
+	void LocalAliasAnalysisPass::handle_return(FunctionAliasResult &result, const Node *node) const
 	{
 		if (!node->inputs.empty())
 		{
@@ -447,7 +790,7 @@ namespace blm
 		}
 	}
 
-	void LocalAliasAnalysisPass::handle_cast(LocalAliasResult &result, Node *node) const
+	void LocalAliasAnalysisPass::handle_cast(FunctionAliasResult &result, Node *node) const
 	{
 		/* pointer casts are essentially copies */
 		if (node->type_kind == DataType::POINTER && !node->inputs.empty())
@@ -457,32 +800,15 @@ namespace blm
 		}
 	}
 
-	void LocalAliasAnalysisPass::perform_escape_analysis(LocalAliasResult &result, Module &module)
+	void LocalAliasAnalysisPass::perform_escape_analysis(FunctionAliasResult &result, const Region *body)
 	{
+		/* propagation only reads and marks nodes of this body, so it settles per function */
 		auto changed = true;
 		while (changed)
-		{
-			changed = false;
-
-			for (Node *func: module.get_functions())
-			{
-				if (func->ir_type != NodeType::FUNCTION)
-					continue;
-
-				for (const Region *child: module.get_root_region()->get_children())
-				{
-					if (child->get_name() == module.get_context().get_string(func->str_id))
-					{
-						if (propagate_escapes_in_region(result, child))
-							changed = true;
-						break;
-					}
-				}
-			}
-		}
+			changed = propagate_escapes_in_region(result, body);
 	}
 
-	bool LocalAliasAnalysisPass::propagate_escapes_in_region(LocalAliasResult &result, const Region *region)
+	bool LocalAliasAnalysisPass::propagate_escapes_in_region(FunctionAliasResult &result, const Region *region)
 	{
 		if (!region)
 			return false;
@@ -606,35 +932,13 @@ namespace blm
 			return 0;
 		switch (node->type_kind)
 		{
-			case DataType::BOOL:
-			case DataType::INT8:
-			case DataType::UINT8:
-				return 1;
-
-			case DataType::INT16:
-			case DataType::UINT16:
-				return 2;
-
-			case DataType::INT32:
-			case DataType::UINT32:
-			case DataType::FLOAT32:
-				return 4;
-
-			case DataType::INT64:
-			case DataType::UINT64:
-			case DataType::FLOAT64:
-			case DataType::POINTER: /* note: assuming 64-bit pointers;
-										doesn't really matter when it is platform-agnostic */
-				return 8;
-
 			case DataType::ARRAY:
 			{
 				/* for arrays, get the element type and count */
 				if (node->data.type() == DataType::ARRAY)
 				{
 					const auto &[elem_type, count] = node->data.get<DataType::ARRAY>();
-					const std::uint64_t elem_size = get_type_size(elem_type);
-					return elem_size * count;
+					return layout->get_size(elem_type) * count;
 				}
 				return 0;
 			}
@@ -648,32 +952,8 @@ namespace blm
 			}
 
 			default:
-				return 0; /* unknown size */
-		}
-	}
-
-	std::uint64_t LocalAliasAnalysisPass::get_type_size(DataType type) const
-	{
-		switch (type)
-		{
-			case DataType::BOOL:
-			case DataType::INT8:
-			case DataType::UINT8:
-				return 1;
-			case DataType::INT16:
-			case DataType::UINT16:
-				return 2;
-			case DataType::INT32:
-			case DataType::UINT32:
-			case DataType::FLOAT32:
-				return 4;
-			case DataType::INT64:
-			case DataType::UINT64:
-			case DataType::FLOAT64:
-			case DataType::POINTER:
-				return 8;
-			default:
-				return 0;
+				/* scalars and registered types; 0 when the size is unknown */
+				return layout->get_size(node->type_kind);
 		}
 	}
 }
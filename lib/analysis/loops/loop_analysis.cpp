@@ -1,5 +1,7 @@
 /* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
 
+#include <optional>
+#include <bloom/analysis/dominators.hpp>
 #include <bloom/analysis/loops/loop-analysis.hpp>
 #include <bloom/analysis/loops/loop-detector.hpp>
 #include <bloom/foundation/context.hpp>
@@ -23,17 +25,11 @@ namespace blm
 
 	Loop *LoopAnalysisResult::get_loop_for_region(Region *region) const
 	{
-		const Region *root = region;
-		while (root->get_parent())
-			root = root->get_parent();
-
-		for (Node *node: root->get_nodes())
+		/* a region belongs to at most one function body, so at most one tree knows it */
+		for (const auto &[function, tree]: pimpl->function_loops)
 		{
-			if (node->ir_type == NodeType::FUNCTION)
-			{
-				const LoopTree *tree = get_loops_for_function(node);
-				return tree ? tree->get_loop_for(region) : nullptr;
-			}
+			if (Loop *loop = tree.get_loop_for(region))
+				return loop;
 		}
 
 		return nullptr;
@@ -45,33 +41,34 @@ namespace blm
 		return it != pimpl->function_loops.end() ? &it->second : nullptr;
 	}
 
-	bool LoopAnalysisResult::invalidated_by(const std::type_info&) const
+	bool LoopAnalysisResult::invalidated_by(const std::type_info& transform_type) const
+	{
+		return invalidated_by(transform_type, PreservedAnalyses::none());
+	}
+
+	bool LoopAnalysisResult::invalidated_by(const std::type_info&, const PreservedAnalyses& preserved) const
 	{
-		return true;
+		return !preserved.preserves_cfg();
 	}
 
 	std::unique_ptr<AnalysisResult> LoopAnalysisPass::analyze(Module &module, PassContext &context)
 	{
 		auto result = std::make_unique<LoopAnalysisResult>();
+
+		/* share one dominator tree across all functions, reusing the cached one if present */
+		const DominatorTree *dom_tree = get_dominator_tree(context);
+		std::optional<DominatorTree> local_tree;
+		if (!dom_tree)
+			dom_tree = &local_tree.emplace(module.get_root_region());
+
 		for (Node *function: module.get_functions())
 		{
 			if (function->ir_type != NodeType::FUNCTION)
 				continue;
 
-			/* find the function's region */
-			Region *function_region = nullptr;
-			for (Region *child: module.get_root_region()->get_children())
-			{
-				if (child->get_name() == module.get_context().get_string(function->str_id))
-				{
-					function_region = child;
-					break;
-				}
-			}
-
-			if (function_region)
+			if (Region *function_region = module.get_function_region(function))
 			{
-				LoopTree tree = LoopDetector::analyze_function(function_region);
+				LoopTree tree = LoopDetector::analyze_function(function_region, dom_tree);
 				result->pimpl->function_loops[function] = std::move(tree);
 			}
 		}
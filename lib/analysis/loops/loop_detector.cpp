@@ -2,17 +2,23 @@
 
 #include <algorithm>
 #include <queue>
+#include <optional>
 #include <stack>
+#include <bloom/analysis/dominators.hpp>
 #include <bloom/analysis/loops/loop-detector.hpp>
 
 namespace blm
 {
-	LoopTree LoopDetector::analyze_function(Region *function_region)
+	LoopTree LoopDetector::analyze_function(Region *function_region, const DominatorTree *dom_tree)
 	{
 		if (!function_region)
 			return {};
 
-		std::vector<BackEdge> back_edges = find_back_edges(function_region);
+		std::optional<DominatorTree> local_tree;
+		if (!dom_tree)
+			dom_tree = &local_tree.emplace(function_region);
+
+		std::vector<BackEdge> back_edges = find_back_edges(function_region, *dom_tree);
 		std::vector<std::unique_ptr<Loop> > loops;
 		for (const BackEdge &edge: back_edges)
 		{
@@ -23,7 +29,7 @@ namespace blm
 		return build_loop_tree(std::move(loops));
 	}
 
-	std::vector<LoopDetector::BackEdge> LoopDetector::find_back_edges(Region *root)
+	std::vector<LoopDetector::BackEdge> LoopDetector::find_back_edges(Region *root, const DominatorTree &dom_tree)
 	{
 		std::vector<BackEdge> back_edges;
 
@@ -41,7 +47,7 @@ namespace blm
 				for (Region *target: targets)
 				{
 					/* back-edge: target dominates source */
-					if (target && target->dominates(region))
+					if (target && dom_tree.dominates(target, region))
 						back_edges.push_back({ region, target });
 				}
 			}
@@ -5,7 +5,7 @@
 
 namespace blm
 {
-	Context::Context() = default;
+	Context::Context(const NodeAllocation allocation) : allocation(allocation) {}
 
 	Context::~Context()
 	{
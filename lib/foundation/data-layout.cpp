@@ -0,0 +1,56 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <algorithm>
+#include <bloom/foundation/data-layout.hpp>
+#include <bloom/foundation/typed-data.hpp>
+
+namespace blm
+{
+	std::size_t DataLayout::get_field_at(const DataType struct_type, const std::int64_t offset) const
+	{
+		if (offset < 0)
+			return NO_FIELD;
+
+		const auto &offsets = get_field_offsets(struct_type);
+		const auto it = std::ranges::lower_bound(offsets, static_cast<std::uint64_t>(offset));
+		if (it == offsets.end() || *it != static_cast<std::uint64_t>(offset))
+			return NO_FIELD;
+
+		/* zero-sized fields share an offset with the next one; report the first */
+		return static_cast<std::size_t>(it - offsets.begin());
+	}
+
+	std::size_t DataLayout::get_field_containing(const DataType struct_type, const std::int64_t offset) const
+	{
+		if (offset < 0)
+			return NO_FIELD;
+
+		const auto &offsets = get_field_offsets(struct_type);
+		const auto it = std::ranges::upper_bound(offsets, static_cast<std::uint64_t>(offset));
+		if (it == offsets.begin())
+			return NO_FIELD;
+
+		const auto index = static_cast<std::size_t>(it - offsets.begin() - 1);
+		const auto &fields = registry.get_type(struct_type).get<DataType::STRUCT>().fields;
+		if (static_cast<std::uint64_t>(offset) >= offsets[index] + get_size(fields[index].second))
+			return NO_FIELD;
+		return index;
+	}
+
+	std::vector<std::uint64_t> DataLayout::compute_field_offsets(
+		const std::vector<std::pair<std::string, DataType> > &fields) const
+	{
+		std::vector<std::uint64_t> offsets;
+		offsets.reserve(fields.size());
+
+		std::uint64_t offset = 0;
+		for (const auto &[name, type]: fields)
+		{
+			const std::uint64_t align = get_alignment(type);
+			offset = (offset + align - 1) & ~(align - 1);
+			offsets.push_back(offset);
+			offset += get_size(type);
+		}
+		return offsets;
+	}
+}
@@ -1,5 +1,6 @@
 /* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
 
+#include <algorithm>
 #include <bloom/foundation/context.hpp>
 #include <bloom/foundation/dbinfo.hpp>
 #include <bloom/foundation/module.hpp>
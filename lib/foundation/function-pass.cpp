@@ -0,0 +1,47 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <bloom/foundation/context.hpp>
+#include <bloom/foundation/function-pass.hpp>
+#include <bloom/foundation/pass-context.hpp>
+#include <bloom/foundation/profiler.hpp>
+#include <bloom/foundation/region.hpp>
+
+namespace blm
+{
+	void FunctionPass::prepare(Module &, PassContext &) {}
+
+	bool FunctionPass::run(Module &module, PassContext &context)
+	{
+		prepare(module, context);
+
+		/* each function only edits its own body, so the other bodies stay numbered */
+		const NodeNumbering &numbering = module.get_numbering();
+		bool changed = false;
+		for (Node *func: module.get_functions())
+		{
+			if (func->ir_type != NodeType::FUNCTION)
+				continue;
+
+			if (Region *body = module.get_function_region(func))
+			{
+				const Profiler::Scope scope(context.get_profiler(), module.get_context().get_string(func->str_id),
+				                            "function");
+				std::unordered_map<std::string, std::size_t> stats_before;
+				if (scope.active())
+				{
+					scope.set_nodes_before(Profiler::count_nodes(body));
+					stats_before = context.get_stats();
+				}
+
+				changed |= run_on_function({ module, func, body, numbering }, context);
+
+				if (scope.active())
+				{
+					scope.set_nodes_after(Profiler::count_nodes(body));
+					scope.add_stats(stats_before, context.get_stats());
+				}
+			}
+		}
+		return changed;
+	}
+}
@@ -0,0 +1,167 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <bloom/foundation/context.hpp>
+#include <bloom/foundation/function-pipeline.hpp>
+#include <bloom/foundation/pass-context.hpp>
+#include <bloom/foundation/profiler.hpp>
+#include <bloom/foundation/region.hpp>
+
+namespace blm
+{
+	FunctionPipeline::FunctionPipeline(const std::size_t threads) : pool(threads) {}
+
+	std::string_view FunctionPipeline::name() const
+	{
+		return "function-pipeline";
+	}
+
+	std::string_view FunctionPipeline::description() const
+	{
+		return "runs function passes over independent functions in parallel";
+	}
+
+	PreservedAnalyses FunctionPipeline::preserved_analyses() const
+	{
+		return preserved;
+	}
+
+	FunctionPipeline &FunctionPipeline::set_max_iterations(const std::size_t count)
+	{
+		max_iterations = std::max<std::size_t>(count, 1);
+		return *this;
+	}
+
+	bool FunctionPipeline::run(Module &module, PassContext &context)
+	{
+		iterations.clear();
+		std::vector<FunctionPass *> active;
+		for (const auto &pass: passes)
+		{
+			if (pass->run_at_opt_level(context.opt_level()))
+			{
+				pass->prepare(module, context);
+				active.push_back(pass.get());
+			}
+		}
+
+		std::vector<FunctionUnit> units;
+		for (Node *func: module.get_functions())
+		{
+			if (func->ir_type != NodeType::FUNCTION)
+				continue;
+
+			/* the numbering object stays the same; it is reassigned before each iteration */
+			if (Region *body = module.get_function_region(func))
+				units.push_back({ module, func, body, module.get_numbering() });
+		}
+
+		/* clones live for the whole run so what they preserved adds up over iterations */
+		const std::size_t workers = pool.size();
+		std::vector<std::vector<std::unique_ptr<FunctionPass> > > worker_passes(workers);
+		std::vector<PassContext> worker_contexts;
+		worker_contexts.reserve(workers);
+		for (std::size_t worker = 0; worker < workers; ++worker)
+		{
+			for (const FunctionPass *pass: active)
+				worker_passes[worker].push_back(pass->clone());
+			worker_contexts.push_back(context.create_worker_context());
+		}
+
+		/* passes create nodes; only an arena context can take that from several threads */
+		const bool concurrent = module.get_context().supports_concurrent_creation();
+		Profiler *profiler = context.get_profiler();
+		std::vector<char> dirty(units.size(), 1);
+		std::vector<std::size_t> pending;
+		bool changed = false;
+		while (iterations.size() < max_iterations)
+		{
+			pending.clear();
+			for (std::size_t index = 0; index < units.size(); ++index)
+			{
+				if (dirty[index])
+					pending.push_back(index);
+				dirty[index] = 0;
+			}
+			if (pending.empty())
+				break;
+
+			const auto start = std::chrono::high_resolution_clock::now();
+			const Profiler::Scope iteration(profiler, std::format("iteration {}", iterations.size() + 1), "iteration");
+
+			/* later iterations see what earlier ones did; workers never renumber */
+			if (!iterations.empty())
+			{
+				for (FunctionPass *pass: active)
+					pass->prepare(module, context);
+			}
+			module.get_numbering();
+
+			const auto run_function = [&](const std::size_t slot, const std::size_t worker)
+			{
+				const std::size_t index = pending[slot];
+				const FunctionUnit &unit = units[index];
+				const Profiler::Scope function(profiler, module.get_context().get_string(unit.function->str_id),
+				                               "function", iteration.event());
+				if (function.active())
+					function.set_nodes_before(Profiler::count_nodes(unit.body));
+
+				PassContext &worker_context = worker_contexts[worker];
+				for (const auto &pass: worker_passes[worker])
+				{
+					const Profiler::Scope phase(profiler, pass->name(), "phase");
+					std::unordered_map<std::string, std::size_t> stats_before;
+					if (phase.active())
+					{
+						phase.set_nodes_before(Profiler::count_nodes(unit.body));
+						stats_before = worker_context.get_stats();
+					}
+
+					if (pass->run_on_function(unit, worker_context))
+						dirty[index] = 1;
+
+					if (phase.active())
+					{
+						phase.set_nodes_after(Profiler::count_nodes(unit.body));
+						phase.add_stats(stats_before, worker_context.get_stats());
+					}
+				}
+
+				if (function.active())
+					function.set_nodes_after(Profiler::count_nodes(unit.body));
+			};
+
+			if (concurrent)
+			{
+				pool.parallel_for(pending.size(), run_function);
+			}
+			else
+			{
+				for (std::size_t slot = 0; slot < pending.size(); ++slot)
+					run_function(slot, 0);
+			}
+
+			const auto end = std::chrono::high_resolution_clock::now();
+			IterationStats &stats = iterations.emplace_back();
+			stats.functions = pending.size();
+			stats.changed = static_cast<std::size_t>(std::ranges::count(dirty, 1));
+			stats.time = std::chrono::duration<double>(end - start).count();
+			changed |= stats.changed > 0;
+		}
+
+		for (const PassContext &worker_context: worker_contexts)
+			context.merge_stats(worker_context);
+		context.update_stat("function_pipeline.iterations", iterations.size());
+
+		/* each clone answers for the functions its worker ran it on */
+		preserved = PreservedAnalyses::all();
+		for (const auto &clones: worker_passes)
+		{
+			for (const auto &pass: clones)
+				preserved.intersect(pass->preserved_analyses());
+		}
+		return changed;
+	}
+}
@@ -1,5 +1,7 @@
 /* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
 
+#include <cassert>
+#include <cstring>
 #include <bloom/foundation/context.hpp>
 #include <bloom/foundation/module.hpp>
 #include <bloom/foundation/node.hpp>
@@ -11,15 +13,17 @@ namespace blm
 	                                                            rodata_region(nullptr), name_id(ctx.intern_string(name))
 	{
 		root_region = create_region(name);
-		regions.push_back(std::make_unique<Region>(context, *this, ".__rodata", nullptr));
-		rodata_region = regions.back().get();
+		rodata_region = make_region(".__rodata", nullptr);
 	}
 
 	Module::~Module()
 	{
 		/* clear references to the dangling pointers */
 		functions.clear();
-		/* note: regions are destroyed automatically by `std::unique_ptr<Region>` */
+		function_regions.clear();
+		root_children.clear();
+		unbound_functions.clear();
+		/* note: regions are destroyed and returned to the slab by their `std::unique_ptr` */
 	}
 
 	std::string_view Module::get_name() const
@@ -32,23 +36,93 @@ namespace blm
 		return root_region;
 	}
 
-	Region *Module::create_region(std::string_view name, Region *parent)
+	const NodeNumbering &Module::get_numbering()
 	{
-		if (!root_region)
+		if (numbering_dirty.load(std::memory_order_relaxed))
 		{
-			regions.push_back(std::make_unique<Region>(context, *this, name, nullptr));
-			return regions.back().get();
+			numbering.assign(*this);
+			for (const auto &region: regions)
+			{
+				if (!region->get_parent())
+					region->record_numbered_version();
+			}
+			numbering_dirty.store(false, std::memory_order_relaxed);
 		}
+		return numbering;
+	}
+
+	Region *Module::create_region(std::string_view name, Region *parent)
+	{
+		if (!root_region)
+			return make_region(name, nullptr);
 
 		if (!parent)
 			parent = root_region;
 
-		regions.push_back(std::make_unique<Region>(context, *this, name, parent));
-		Region *result = regions.back().get();
+		Region *result = make_region(name, parent);
 		parent->add_child(result);
+
+		if (parent == root_region)
+		{
+			const StringTable::StringId id = context.intern_string(name);
+			root_children.try_emplace(id, result);
+			if (const auto it = unbound_functions.find(id);
+				it != unbound_functions.end())
+			{
+				function_regions[it->second] = result;
+				unbound_functions.erase(it);
+			}
+		}
 		return result;
 	}
 
+	void Module::remove_region(Region *region)
+	{
+		if (!region || region == root_region || region == rodata_region)
+			return;
+
+		assert(region->get_nodes().empty() && region->get_children().empty());
+
+		Region *parent = region->get_parent();
+		if (parent)
+			parent->remove_child(region);
+
+		if (parent == root_region)
+		{
+			/* re-point the name index at the next root child of the same name, if any */
+			const StringTable::StringId id = context.intern_string(region->get_name());
+			if (const auto it = root_children.find(id);
+				it != root_children.end() && it->second == region)
+			{
+				root_children.erase(it);
+				for (Region *child: root_region->get_children())
+				{
+					if (child->get_name() == region->get_name())
+					{
+						root_children.emplace(id, child);
+						break;
+					}
+				}
+			}
+		}
+
+		std::erase_if(function_regions, [region](const auto &entry)
+		{
+			return entry.second == region;
+		});
+		std::erase_if(regions, [region](const auto &owned)
+		{
+			return owned.get() == region;
+		});
+	}
+
+	Region *Module::make_region(const std::string_view name, Region *parent)
+	{
+		Region *region = region_slab.create<Region>(context, *this, name, parent);
+		regions.emplace_back(region, ach::slab_deleter<Region> { &region_slab });
+		return region;
+	}
+
 	Node *Module::find_function(const std::string_view name) const
 	{
 		const StringTable::StringId id = context.intern_string(name);
@@ -63,20 +137,83 @@ namespace blm
 
 	void Module::add_function(Node *func)
 	{
-		if (func && func->ir_type == NodeType::FUNCTION)
-			functions.push_back(func);
+		if (!func || func->ir_type != NodeType::FUNCTION)
+			return;
+
+		functions.push_back(func);
+		if (func->parent_region && func->parent_region != root_region)
+		{
+			function_regions[func] = func->parent_region;
+			return;
+		}
+
+		/* the body is a root child named after the function; it may not exist yet */
+		if (const auto it = root_children.find(func->str_id);
+			it != root_children.end())
+		{
+			function_regions[func] = it->second;
+		}
+		else
+		{
+			unbound_functions.try_emplace(func->str_id, func);
+		}
 	}
 
-	Node *Module::intern_string_literal(std::string_view str)
+	void Module::remove_function(Node *func)
 	{
-		for (Node* node : rodata_region->get_nodes())
+		if (!func)
+			return;
+
+		std::erase(functions, func);
+		if (const auto it = unbound_functions.find(func->str_id);
+			it != unbound_functions.end() && it->second == func)
+		{
+			unbound_functions.erase(it);
+		}
+
+		if (const auto it = function_regions.find(func);
+			it != function_regions.end())
 		{
-			if (node->ir_type == NodeType::LIT &&
-				node->type_kind == DataType::STRING &&
-				node->as<DataType::STRING>() == str)
+			/* the body goes away with the function; don't hand it to a later namesake */
+			if (const auto child = root_children.find(func->str_id);
+				child != root_children.end() && child->second == it->second)
 			{
-				return node;
+				root_children.erase(child);
 			}
+			function_regions.erase(it);
+		}
+	}
+
+	Region *Module::get_function_region(const Node *func) const
+	{
+		const auto it = function_regions.find(func);
+		return it == function_regions.end() ? nullptr : it->second;
+	}
+
+	void Module::set_function_region(Node *func, Region *region)
+	{
+		if (!func)
+			return;
+
+		if (const auto it = unbound_functions.find(func->str_id);
+			it != unbound_functions.end() && it->second == func)
+		{
+			unbound_functions.erase(it);
+		}
+
+		if (region)
+			function_regions[func] = region;
+		else
+			function_regions.erase(func);
+	}
+
+	Node *Module::intern_string_literal(std::string_view str)
+	{
+		std::lock_guard lock(literal_mutex);
+		if (const auto it = string_literals.find(str);
+			it != string_literals.end() && rodata_region->contains(it->second))
+		{
+			return it->second;
 		}
 
 		Node* str_lit = context.create<Node>();
@@ -86,6 +223,52 @@ namespace blm
 		str_lit->props |= NodeProps::READONLY;
 
 		rodata_region->add_node(str_lit);
+		string_literals.insert_or_assign(std::string(str), str_lit);
 		return str_lit;
 	}
+
+	Node *Module::intern_literal(const TypedData &value)
+	{
+		/* the key is the zero-extended bit pattern, so -0.0 and 0.0 or distinct NaNs stay apart */
+		LiteralKey key { value.type(), 0 };
+		switch (value.type())
+		{
+#define BLM_LITERAL_BITS(dt) \
+			case DataType::dt: \
+			{ \
+				const auto v = value.get<DataType::dt>(); \
+				std::memcpy(&key.bits, &v, sizeof(v)); \
+				break; \
+			}
+			BLM_LITERAL_BITS(BOOL)
+			BLM_LITERAL_BITS(INT8)
+			BLM_LITERAL_BITS(INT16)
+			BLM_LITERAL_BITS(INT32)
+			BLM_LITERAL_BITS(INT64)
+			BLM_LITERAL_BITS(UINT8)
+			BLM_LITERAL_BITS(UINT16)
+			BLM_LITERAL_BITS(UINT32)
+			BLM_LITERAL_BITS(UINT64)
+			BLM_LITERAL_BITS(FLOAT32)
+			BLM_LITERAL_BITS(FLOAT64)
+#undef BLM_LITERAL_BITS
+			case DataType::STRING:
+				return intern_string_literal(value.get<DataType::STRING>());
+			default:
+				return nullptr;
+		}
+
+		std::lock_guard lock(literal_mutex);
+		auto [it, inserted] = literals.try_emplace(key, nullptr);
+		if (!inserted && root_region->contains(it->second))
+			return it->second;
+
+		Node *lit = context.create<Node>();
+		lit->ir_type = NodeType::LIT;
+		lit->type_kind = value.type();
+		lit->data = value;
+		root_region->add_node(lit);
+		it->second = lit;
+		return lit;
+	}
 }
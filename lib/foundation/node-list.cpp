@@ -0,0 +1,68 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <bloom/foundation/node-list.hpp>
+
+namespace blm
+{
+	Node *NodeList::operator[](std::size_t index) const
+	{
+		Node *node = head;
+		while (node && index-- > 0)
+			node = node->region_next;
+		return node;
+	}
+
+	void NodeList::link_before(Node *pos, Node *node)
+	{
+		/* a null position appends */
+		Node *prev = pos ? pos->region_prev : tail;
+		node->region_prev = prev;
+		node->region_next = pos;
+		if (prev)
+			prev->region_next = node;
+		else
+			head = node;
+
+		if (pos)
+			pos->region_prev = node;
+		else
+			tail = node;
+		++count;
+	}
+
+	void NodeList::link_after(Node *pos, Node *node)
+	{
+		link_before(pos ? pos->region_next : head, node);
+	}
+
+	void NodeList::unlink(Node *node)
+	{
+		if (node->region_prev)
+			node->region_prev->region_next = node->region_next;
+		else
+			head = node->region_next;
+
+		if (node->region_next)
+			node->region_next->region_prev = node->region_prev;
+		else
+			tail = node->region_prev;
+
+		/* a stale link would lead an iterator on this node into a list it is no longer part of */
+		node->region_prev = nullptr;
+		node->region_next = nullptr;
+		--count;
+	}
+
+	void NodeList::clear()
+	{
+		for (Node *node = head; node;)
+		{
+			Node *next = node->region_next;
+			node->region_prev = nullptr;
+			node->region_next = nullptr;
+			node = next;
+		}
+		head = tail = nullptr;
+		count = 0;
+	}
+}
@@ -0,0 +1,63 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <bloom/foundation/module.hpp>
+#include <bloom/foundation/node-numbering.hpp>
+#include <bloom/foundation/region.hpp>
+
+namespace blm
+{
+	void NodeNumbering::assign(const Module &module)
+	{
+		reset();
+		number_region(module.get_root_region());
+		number_region(module.get_rodata_region());
+
+		/* bodies are normally nested in the root region; pick up any that were not */
+		for (const Node *func: module.get_functions())
+		{
+			if (const Region *body = module.get_function_region(func);
+				body && !ranges.contains(body))
+			{
+				number_region(body);
+			}
+		}
+	}
+
+	void NodeNumbering::assign(const Region *region)
+	{
+		reset();
+		number_region(region);
+	}
+
+	NodeRange NodeNumbering::range_of(const Region *region) const
+	{
+		const auto it = ranges.find(region);
+		return it != ranges.end() ? it->second : NodeRange {};
+	}
+
+	void NodeNumbering::reset()
+	{
+		nodes.clear();
+		ranges.clear();
+		++generation;
+	}
+
+	void NodeNumbering::number_region(const Region *region) // NOLINT(*-no-recursion)
+	{
+		if (!region || ranges.contains(region))
+			return;
+
+		const auto begin = static_cast<NodeId>(nodes.size());
+		ranges[region] = { begin, begin };
+		for (Node *node: region->get_nodes())
+		{
+			node->index = static_cast<NodeId>(nodes.size());
+			nodes.push_back(node);
+		}
+
+		for (const Region *child: region->get_children())
+			number_region(child);
+
+		ranges[region].end = static_cast<NodeId>(nodes.size());
+	}
+}
@@ -7,6 +7,15 @@ namespace blm
 	PassContext::PassContext(Module& module, const int opt_level, const bool debug_mode)
 		: mod(module), opt_lvl(opt_level), dbg_mode(debug_mode) {}
 
+	PassContext::PassContext(PassContext& parent, WorkerTag)
+		: mod(parent.mod), opt_lvl(parent.opt_lvl), dbg_mode(parent.dbg_mode), parent(&parent),
+		  prof(parent.prof) {}
+
+	PassContext PassContext::create_worker_context()
+	{
+		return { *this, WorkerTag {} };
+	}
+
 	Module& PassContext::module()
 	{
 		return mod;
@@ -35,7 +44,7 @@ namespace blm
 
 	bool PassContext::has_result(const std::type_info& pass_type) const
 	{
-		return res.contains(std::type_index(pass_type));
+		return res.contains(std::type_index(pass_type)) || (parent && parent->has_result(pass_type));
 	}
 
 	void PassContext::invalidate(const std::type_info& pass_type)
@@ -45,19 +54,21 @@ namespace blm
 
 	void PassContext::invalidate_by(const std::type_info& invalidating_pass)
 	{
-		std::vector<std::type_index> keys;
-		keys.reserve(res.size());
-		for (const auto& [key, value] : res)
-			keys.push_back(key);
+		invalidate_by(invalidating_pass, PreservedAnalyses::none());
+	}
+
+	void PassContext::invalidate_by(const std::type_info& invalidating_pass, const PreservedAnalyses& preserved)
+	{
+		if (preserved.preserves_all())
+			return;
 
-		for (const auto& key : keys)
+		std::erase_if(res, [&](const auto& entry)
 		{
-			if (const auto& result = res[key];
-				result->invalidated_by(invalidating_pass))
-			{
-				res.erase(key);
-			}
-		}
+			const auto& [key, result] = entry;
+			if (preserved.preserves(key))
+				return false;
+			return result->invalidated_by(invalidating_pass, preserved);
+		});
 	}
 
 	void PassContext::update_stat(const std::string_view name, const std::size_t delta)
@@ -72,4 +83,25 @@ namespace blm
 			return 0;
 		return it->second;
 	}
+
+	void PassContext::merge_stats(const PassContext& other)
+	{
+		for (const auto& [name, value] : other.stats)
+			stats[name] += value;
+	}
+
+	const std::unordered_map<std::string, std::size_t>& PassContext::get_stats() const
+	{
+		return stats;
+	}
+
+	void PassContext::set_profiler(Profiler* profiler)
+	{
+		prof = profiler;
+	}
+
+	Profiler* PassContext::get_profiler() const
+	{
+		return prof;
+	}
 }
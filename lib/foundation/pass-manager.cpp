@@ -1,121 +1,221 @@
 /* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
 
 #include <algorithm>
+#include <format>
 #include <functional>
 #include <iostream>
-#include <unordered_set>
-#include <bloom/foundation/region.hpp>
+#include <string>
+#include <bloom/foundation/analysis-pass.hpp>
+#include <bloom/foundation/function-pipeline.hpp>
 #include <bloom/foundation/pass-manager.hpp>
+#include <bloom/foundation/profiler.hpp>
+#include <bloom/foundation/region.hpp>
+#include <bloom/foundation/transform-pass.hpp>
 
 namespace blm
 {
     PassManager::PassManager(Module &module, const int opt_level,
                              const bool debug_mode, const int verbosity) : mod(module), verbosity_lvl(verbosity),
-                                                                           ctx(module, opt_level, debug_mode) {}
+                                                                           owned_ctx(std::make_unique<PassContext>(
+                                                                               module, opt_level, debug_mode)),
+                                                                           ctx(*owned_ctx) {}
 
-    bool PassManager::run_pass(const std::type_info &pass_type)
+    PassManager::PassManager(PassContext &context, const int verbosity) : mod(context.module()),
+                                                                          verbosity_lvl(verbosity), ctx(context) {}
+
+    void PassManager::register_pass(std::unique_ptr<Pass> pass)
     {
-        const auto type_idx = std::type_index(pass_type);
-        const auto it = passes.find(type_idx);
-        if (it == passes.end())
-        {
-            throw std::runtime_error(
-                std::format("pass {} not found", pass_type.name()));
-        }
+        PassInfo info;
+        info.type = &pass->blm_id();
+        info.is_analysis = dynamic_cast<const AnalysisPass *>(pass.get()) != nullptr;
+        info.required_types = pass->required_passes();
+        info.invalidated = pass->invalidated_passes();
+        info.pass = std::move(pass);
 
-        auto &[pass, required, invalidated] = it->second;
+        if (const auto [it, inserted] = pass_index.try_emplace(std::type_index(*info.type), passes.size());
+            inserted)
+            passes.push_back(std::move(info));
+        else
+            passes[it->second] = std::move(info);
+        plan_valid = false;
+    }
 
-        /* Run any required passes first */
-        for (const auto &req: required)
+    std::size_t PassManager::find_pass(const std::type_info &pass_type) const
+    {
+        const auto it = pass_index.find(std::type_index(pass_type));
+        return it == pass_index.end() ? NO_PASS : it->second;
+    }
+
+    void PassManager::build_plan()
+    {
+        for (PassInfo &info: passes)
         {
-            const std::type_info *req_type = nullptr;
-            for (const auto &[idx, data]: passes)
+            info.required.clear();
+            for (const std::type_info *req: info.required_types)
             {
-                if (idx == req)
+                const std::size_t index = find_pass(*req);
+                if (index == NO_PASS)
                 {
-                    req_type = &data.pass->blm_id();
-                    break;
+                    throw std::runtime_error(
+                        std::format("Required pass {} not found", req->name()));
                 }
+                info.required.push_back(index);
             }
+        }
 
-            if (!req_type)
+        /* depth-first, requirements before their users, registration order otherwise */
+        enum class Mark : std::uint8_t { NONE, VISITING, DONE };
+        std::vector<Mark> marks(passes.size(), Mark::NONE);
+        std::vector<std::size_t> path; /* the passes being visited, outermost first */
+        plan.clear();
+        std::function<void(std::size_t)> visit = [&](const std::size_t index)
+        {
+            if (marks[index] == Mark::DONE)
+                return;
+            if (marks[index] == Mark::VISITING)
             {
-                throw std::runtime_error(
-                    std::format("Required pass {} not found", req.name()));
+                /* the cycle runs from the earlier visit of this pass back to it */
+                std::string cycle;
+                for (auto it = std::ranges::find(path, index); it != path.end(); ++it)
+                    cycle += std::format("{} -> ", passes[*it].pass->name());
+                cycle += passes[index].pass->name();
+                throw std::runtime_error(std::format("pass dependency cycle: {}", cycle));
             }
 
-            if (!run_pass(*req_type))
+            marks[index] = Mark::VISITING;
+            path.push_back(index);
+            for (const std::size_t req: passes[index].required)
+                visit(req);
+            path.pop_back();
+            marks[index] = Mark::DONE;
+            plan.push_back(index);
+        };
+        for (std::size_t i = 0; i < passes.size(); ++i)
+            visit(i);
+
+        /* a pass's own schedule is the plan restricted to what it depends on */
+        std::vector<char> needed(passes.size());
+        for (std::size_t i = 0; i < passes.size(); ++i)
+        {
+            std::ranges::fill(needed, 0);
+            needed[i] = 1;
+            for (auto it = plan.rbegin(); it != plan.rend(); ++it)
+            {
+                if (!needed[*it])
+                    continue;
+                for (const std::size_t req: passes[*it].required)
+                    needed[req] = 1;
+            }
+
+            passes[i].schedule.clear();
+            for (const std::size_t index: plan)
+            {
+                if (needed[index])
+                    passes[i].schedule.push_back(index);
+            }
+        }
+        plan_valid = true;
+    }
+
+    bool PassManager::execute(const std::size_t index) // NOLINT(*-no-recursion)
+    {
+        PassInfo &info = passes[index];
+
+        /* an analysis earlier in the plan may have been invalidated since */
+        for (const std::size_t req: info.required)
+        {
+            if (passes[req].is_analysis && !ctx.has_result(*passes[req].type) && !execute(req))
                 return false;
         }
 
         /* skip if not applicable at this opt level */
-        if (!pass->run_at_opt_level(ctx.opt_level()))
+        if (!info.pass->run_at_opt_level(ctx.opt_level()))
             return true; /* skipping is not failure */
 
+        /* nothing to do for an analysis whose result is still valid */
+        if (info.is_analysis && ctx.has_result(*info.type))
+            return true;
+
         const auto start = std::chrono::high_resolution_clock::now();
-        const bool success = pass->run(mod, ctx);
+        bool success;
+        {
+            const Profiler::Scope scope(ctx.get_profiler(), info.pass->name(), "pass");
+            std::unordered_map<std::string, std::size_t> stats_before;
+            if (scope.active())
+            {
+                scope.set_nodes_before(Profiler::count_nodes(mod));
+                stats_before = ctx.get_stats();
+            }
+
+            success = info.pass->run(mod, ctx);
+
+            if (scope.active())
+            {
+                scope.set_nodes_after(Profiler::count_nodes(mod));
+                scope.set_memory_bytes(Profiler::memory_bytes(mod.get_context()));
+                scope.add_stats(stats_before, ctx.get_stats());
+            }
+        }
         const auto end = std::chrono::high_resolution_clock::now();
 
         /* record timing information */
         const auto duration = std::chrono::duration<double>(end - start).count();
-        pass_times[type_idx] += duration;
+        info.time += duration;
+        ++info.runs;
 
         /* output progress information based on verbosity */
         if (verbosity_lvl > 0)
         {
             std::cout << std::format("pass {} completed in {:.2f}ms ({})\n",
-                                     pass->name(),
+                                     info.pass->name(),
                                      duration * 1000,
                                      success ? "success" : "failure");
         }
 
         if (success)
         {
-            for (const auto &inv: invalidated)
-            {
-                const std::type_info *inv_type = nullptr;
-                for (const auto &[idx, data]: passes)
-                {
-                    if (idx == inv)
-                    {
-                        inv_type = &data.pass->blm_id();
-                        break;
-                    }
-                }
+            for (const std::type_info *inv: info.invalidated)
+                ctx.invalidate(*inv);
 
-                if (inv_type)
-                {
-                    ctx.invalidate(*inv_type);
-                }
-            }
-            ctx.invalidate_by(pass_type);
+            /* analyses leave the IR alone; transforms report what they kept */
+            if (const auto *transform = dynamic_cast<const TransformPass *>(info.pass.get()))
+                ctx.invalidate_by(*info.type, transform->preserved_analyses());
+            else if (!info.is_analysis)
+                ctx.invalidate_by(*info.type);
         }
 
         return success;
     }
 
-    bool PassManager::run_all()
+    bool PassManager::run_pass(const std::type_info &pass_type)
     {
-        /* Run passes in the order they were added */
-        for (const auto& type_idx : pass_order)
+        const std::size_t index = find_pass(pass_type);
+        if (index == NO_PASS)
         {
-            const std::type_info *pass_type = nullptr;
-            for (const auto &[idx, data]: passes)
-            {
-                if (idx == type_idx)
-                {
-                    pass_type = &data.pass->blm_id();
-                    break;
-                }
-            }
+            throw std::runtime_error(
+                std::format("pass {} not found", pass_type.name()));
+        }
 
-            if (!pass_type)
-            {
-                throw std::runtime_error(
-                    std::format("pass {} not found in execution order", type_idx.name()));
-            }
+        if (!plan_valid)
+            build_plan();
+
+        /* required passes first; the pass itself is last */
+        for (const std::size_t step: passes[index].schedule)
+        {
+            if (!execute(step))
+                return false;
+        }
+        return true;
+    }
 
-            if (!run_pass(*pass_type))
+    bool PassManager::run_all()
+    {
+        if (!plan_valid)
+            build_plan();
+
+        for (const std::size_t index: plan)
+        {
+            if (!execute(index))
                 return false;
         }
 
@@ -139,15 +239,19 @@ namespace blm
 
     void PassManager::print_statistics(std::ostream &os) const
     {
-        if (pass_times.empty())
+        std::vector<std::pair<const PassInfo *, double> > sorted_times;
+        for (const PassInfo &info: passes)
+        {
+            if (info.runs > 0)
+                sorted_times.emplace_back(&info, info.time);
+        }
+
+        if (sorted_times.empty())
         {
             os << "no passes have been executed.\n";
             return;
         }
 
-        std::vector<std::pair<std::type_index, double> > sorted_times(
-            pass_times.begin(), pass_times.end());
-
         std::ranges::sort(sorted_times,
                           [](const auto &a, const auto &b)
                           {
@@ -159,18 +263,24 @@ namespace blm
             total_time += time;
         os << "pass execution statistics:\n";
 
-        for (const auto &[idx, time]: sorted_times)
+        for (const auto &[info, time]: sorted_times)
         {
             double percent = (time / total_time) * 100.0;
-            std::string_view name = "unknown";
-            if (auto it = passes.find(idx);
-                it != passes.end())
+            os << std::format("{:<30} {:>8.2f}ms ({:>5.1f}%)\n",
+                              info->pass->name(), time * 1000, percent);
+
+            /* iterations of the last run of a pipeline driven to a fixpoint */
+            const auto *pipeline = dynamic_cast<const FunctionPipeline *>(info->pass.get());
+            if (!pipeline || pipeline->get_iteration_stats().size() < 2)
+                continue;
+
+            const auto &iterations = pipeline->get_iteration_stats();
+            for (std::size_t i = 0; i < iterations.size(); ++i)
             {
-                name = it->second.pass->name();
+                os << std::format("  iteration {:<18} {:>8.2f}ms ({} functions, {} changed)\n",
+                                  i + 1, iterations[i].time * 1000,
+                                  iterations[i].functions, iterations[i].changed);
             }
-
-            os << std::format("{:<30} {:>8.2f}ms ({:>5.1f}%)\n",
-                              name, time * 1000, percent);
         }
 
         os << std::format("total: {:.2f}ms\n", total_time * 1000);
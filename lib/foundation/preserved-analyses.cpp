@@ -0,0 +1,63 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <bloom/foundation/preserved-analyses.hpp>
+
+namespace blm
+{
+	PreservedAnalyses PreservedAnalyses::all()
+	{
+		PreservedAnalyses result;
+		result.everything = true;
+		result.cfg = true;
+		return result;
+	}
+
+	PreservedAnalyses PreservedAnalyses::none()
+	{
+		return {};
+	}
+
+	PreservedAnalyses &PreservedAnalyses::preserve(const std::type_info &analysis_type)
+	{
+		analyses.insert(std::type_index(analysis_type));
+		return *this;
+	}
+
+	PreservedAnalyses &PreservedAnalyses::preserve_cfg()
+	{
+		cfg = true;
+		return *this;
+	}
+
+	void PreservedAnalyses::intersect(const PreservedAnalyses &other)
+	{
+		if (other.everything)
+			return;
+		if (everything)
+		{
+			*this = other;
+			return;
+		}
+
+		cfg = cfg && other.cfg;
+		std::erase_if(analyses, [&other](const std::type_index &type)
+		{
+			return !other.analyses.contains(type);
+		});
+	}
+
+	bool PreservedAnalyses::preserves_all() const
+	{
+		return everything;
+	}
+
+	bool PreservedAnalyses::preserves_cfg() const
+	{
+		return cfg;
+	}
+
+	bool PreservedAnalyses::preserves(const std::type_index analysis_type) const
+	{
+		return everything || analyses.contains(analysis_type);
+	}
+}
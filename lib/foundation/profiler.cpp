@@ -0,0 +1,283 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <algorithm>
+#include <format>
+#include <ostream>
+#include <unordered_set>
+#include <bloom/foundation/context.hpp>
+#include <bloom/foundation/module.hpp>
+#include <bloom/foundation/profiler.hpp>
+#include <bloom/foundation/region.hpp>
+
+namespace blm
+{
+	namespace
+	{
+		/* scopes open on this thread, innermost last; shared by every profiler */
+		thread_local std::vector<std::pair<const Profiler *, std::size_t> > open_scopes;
+
+		void write_string(std::ostream &os, const std::string_view text)
+		{
+			os << '"';
+			for (const char c: text)
+			{
+				switch (c)
+				{
+					case '"':
+						os << "\\\"";
+						break;
+					case '\\':
+						os << "\\\\";
+						break;
+					case '\n':
+						os << "\\n";
+						break;
+					case '\t':
+						os << "\\t";
+						break;
+					default:
+						if (static_cast<unsigned char>(c) < 0x20)
+							os << std::format("\\u{:04x}", static_cast<unsigned>(c));
+						else
+							os << c;
+						break;
+				}
+			}
+			os << '"';
+		}
+
+		void write_stats(std::ostream &os, const Profiler::Event &event)
+		{
+			os << '{';
+			for (std::size_t i = 0; i < event.stats.size(); ++i)
+			{
+				if (i > 0)
+					os << ',';
+				write_string(os, event.stats[i].first);
+				os << ':' << event.stats[i].second;
+			}
+			os << '}';
+		}
+
+		void count_region(const Region *region, std::unordered_set<const Region *> &seen, std::size_t &count) // NOLINT(*-no-recursion)
+		{
+			if (!region || !seen.insert(region).second)
+				return;
+
+			count += region->get_nodes().size();
+			for (const Region *child: region->get_children())
+				count_region(child, seen, count);
+		}
+	}
+
+	Profiler::Scope::Scope(Profiler *profiler, const std::string_view name, const std::string_view category)
+		: Scope(profiler, name, category, profiler ? profiler->current() : NO_EVENT) {}
+
+	Profiler::Scope::Scope(Profiler *profiler, const std::string_view name, const std::string_view category,
+	                       const std::size_t parent) : profiler(profiler)
+	{
+		if (!profiler)
+			return;
+
+		index = profiler->begin(name, category, parent);
+		open_scopes.emplace_back(profiler, index);
+	}
+
+	Profiler::Scope::~Scope()
+	{
+		if (!profiler)
+			return;
+
+		profiler->end(index);
+		open_scopes.pop_back();
+	}
+
+	void Profiler::Scope::set_nodes_before(const std::size_t count) const
+	{
+		if (!profiler)
+			return;
+
+		std::lock_guard lock(profiler->mutex);
+		profiler->events[index].nodes_before = count;
+	}
+
+	void Profiler::Scope::set_nodes_after(const std::size_t count) const
+	{
+		if (!profiler)
+			return;
+
+		std::lock_guard lock(profiler->mutex);
+		profiler->events[index].nodes_after = count;
+	}
+
+	void Profiler::Scope::set_memory_bytes(const std::size_t bytes) const
+	{
+		if (!profiler)
+			return;
+
+		std::lock_guard lock(profiler->mutex);
+		profiler->events[index].memory_bytes = bytes;
+		profiler->peak_memory = std::max(profiler->peak_memory, bytes);
+	}
+
+	void Profiler::Scope::add_stat(const std::string_view name, const std::size_t value) const
+	{
+		if (!profiler)
+			return;
+
+		std::lock_guard lock(profiler->mutex);
+		profiler->events[index].stats.emplace_back(name, value);
+	}
+
+	void Profiler::Scope::add_stats(const std::unordered_map<std::string, std::size_t> &before,
+	                                const std::unordered_map<std::string, std::size_t> &after) const
+	{
+		if (!profiler)
+			return;
+
+		std::vector<std::pair<std::string, std::size_t> > grown;
+		for (const auto &[name, value]: after)
+		{
+			const auto it = before.find(name);
+			if (const std::size_t old = it == before.end() ? 0 : it->second; value > old)
+				grown.emplace_back(name, value - old);
+		}
+		std::ranges::sort(grown);
+
+		std::lock_guard lock(profiler->mutex);
+		auto &stats = profiler->events[index].stats;
+		stats.insert(stats.end(), grown.begin(), grown.end());
+	}
+
+	Profiler::Profiler() : epoch(Clock::now()) {}
+
+	std::size_t Profiler::current() const
+	{
+		for (auto it = open_scopes.rbegin(); it != open_scopes.rend(); ++it)
+		{
+			if (it->first == this)
+				return it->second;
+		}
+		return NO_EVENT;
+	}
+
+	std::size_t Profiler::get_peak_memory_bytes() const
+	{
+		std::lock_guard lock(mutex);
+		return peak_memory;
+	}
+
+	void Profiler::clear()
+	{
+		std::lock_guard lock(mutex);
+		events.clear();
+		threads.clear();
+		peak_memory = 0;
+		epoch = Clock::now();
+	}
+
+	std::size_t Profiler::begin(const std::string_view name, const std::string_view category, const std::size_t parent)
+	{
+		const double start = std::chrono::duration<double>(Clock::now() - epoch).count();
+		const std::thread::id thread = std::this_thread::get_id();
+
+		std::lock_guard lock(mutex);
+		Event &event = events.emplace_back();
+		event.name = name;
+		event.category = category;
+		event.parent = parent;
+		event.start = start;
+
+		const auto it = std::ranges::find(threads, thread);
+		event.thread = static_cast<std::size_t>(it - threads.begin());
+		if (it == threads.end())
+			threads.push_back(thread);
+		return events.size() - 1;
+	}
+
+	void Profiler::end(const std::size_t index)
+	{
+		const double now = std::chrono::duration<double>(Clock::now() - epoch).count();
+
+		std::lock_guard lock(mutex);
+		events[index].duration = now - events[index].start;
+	}
+
+	void Profiler::write_json(std::ostream &os) const
+	{
+		std::lock_guard lock(mutex);
+		os << "{\"peak_memory_bytes\":" << peak_memory << ",\"events\":[";
+		for (std::size_t i = 0; i < events.size(); ++i)
+		{
+			const Event &event = events[i];
+			if (i > 0)
+				os << ',';
+			os << "{\"id\":" << i << ",\"parent\":";
+			if (event.parent == NO_EVENT)
+				os << "null";
+			else
+				os << event.parent;
+			os << ",\"name\":";
+			write_string(os, event.name);
+			os << ",\"category\":";
+			write_string(os, event.category);
+			os << std::format(",\"thread\":{},\"start_us\":{:.3f},\"duration_us\":{:.3f}",
+			                  event.thread, event.start * 1e6, event.duration * 1e6);
+			os << ",\"nodes_before\":" << event.nodes_before
+					<< ",\"nodes_after\":" << event.nodes_after
+					<< ",\"memory_bytes\":" << event.memory_bytes << ",\"stats\":";
+			write_stats(os, event);
+			os << '}';
+		}
+		os << "]}\n";
+	}
+
+	void Profiler::write_chrome_trace(std::ostream &os) const
+	{
+		std::lock_guard lock(mutex);
+		os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		for (std::size_t i = 0; i < events.size(); ++i)
+		{
+			const Event &event = events[i];
+			if (i > 0)
+				os << ',';
+			os << "{\"name\":";
+			write_string(os, event.name);
+			os << ",\"cat\":";
+			write_string(os, event.category);
+			os << std::format(",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}",
+			                  event.thread, event.start * 1e6, event.duration * 1e6);
+			os << ",\"args\":{\"nodes_before\":" << event.nodes_before
+					<< ",\"nodes_after\":" << event.nodes_after
+					<< ",\"memory_bytes\":" << event.memory_bytes << ",\"stats\":";
+			write_stats(os, event);
+			os << "}}";
+		}
+		os << "]}\n";
+	}
+
+	std::size_t Profiler::count_nodes(const Module &module)
+	{
+		/* same walk as the numbering: root, rodata, then bodies outside the root tree */
+		std::unordered_set<const Region *> seen;
+		std::size_t count = 0;
+		count_region(module.get_root_region(), seen, count);
+		count_region(module.get_rodata_region(), seen, count);
+		for (const Node *func: module.get_functions())
+			count_region(module.get_function_region(func), seen, count);
+		return count;
+	}
+
+	std::size_t Profiler::count_nodes(const Region *region)
+	{
+		std::unordered_set<const Region *> seen;
+		std::size_t count = 0;
+		count_region(region, seen, count);
+		return count;
+	}
+
+	std::size_t Profiler::memory_bytes(const Context &context)
+	{
+		return context.get_arena().bytes_reserved() + context.get_slab().bytes_reserved();
+	}
+}
@@ -1,6 +1,8 @@
 /* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
 
+#include <algorithm>
 #include <bloom/foundation/context.hpp>
+#include <bloom/foundation/module.hpp>
 #include <bloom/foundation/node.hpp>
 #include <bloom/foundation/region.hpp>
 
@@ -20,10 +22,7 @@ namespace blm
 	{
 		/* clear all connections */
 		for (Node *node: nodes)
-		{
-			if (node)
-				node->parent_region = nullptr;
-		}
+			node->parent_region = nullptr;
 
 		nodes.clear();
 		children.clear();
@@ -41,80 +40,122 @@ namespace blm
 		{
 			children.push_back(child);
 			child->parent = this;
+			mark_changed();
 		}
 	}
 
-	void Region::add_node(Node *node)
+	void Region::remove_child(Region *child)
 	{
-		if (node && std::ranges::find(nodes, node) == nodes.end())
+		if (const auto it = std::ranges::find(children, child);
+			it != children.end())
 		{
-			nodes.push_back(node);
-			node->parent_region = this;
+			children.erase(it);
+			child->parent = nullptr;
+			/* keep the child's changes counted so this tree's version never goes back */
+			edits.fetch_add(child->get_version(), std::memory_order_relaxed);
+			mark_changed();
 		}
 	}
 
-	void Region::remove_node(Node *node)
+	void Region::add_node(Node *node)
 	{
-		if (!node)
+		if (!node || nodes.contains(node))
 			return;
 
-		if (const auto it = std::ranges::find(nodes, node);
-			it != nodes.end())
-		{
-			node->parent_region = nullptr;
-			nodes.erase(it);
-		}
+		detach(node);
+		nodes.link_before(nullptr, node);
+		node->parent_region = this;
+		mark_changed();
 	}
 
-	void Region::insert_node_before(Node *before, Node *node)
+	void Region::remove_node(Node *node)
 	{
-		if (!node)
+		if (!nodes.contains(node))
 			return;
 
-		if (std::ranges::find(nodes, node) != nodes.end())
+		nodes.unlink(node);
+		node->parent_region = nullptr;
+		mark_changed();
+	}
+
+	void Region::insert_node_before(Node *before, Node *node)
+	{
+		if (!node || nodes.contains(node))
 			return;
 
-		if (const auto it = std::ranges::find(nodes, before);
-			it != nodes.end())
-		{
-			nodes.insert(it, node);
-			node->parent_region = this;
-		}
-		else
+		if (!nodes.contains(before))
 		{
 			/* if before node not found, append to end */
 			add_node(node);
+			return;
 		}
+
+		detach(node);
+		nodes.link_before(before, node);
+		node->parent_region = this;
+		mark_changed();
 	}
 
 	void Region::insert_node_after(Node *after, Node *node)
 	{
-		if (!node || !after)
+		if (!node || !after || node == after)
 			return;
 
-		if (const auto it = std::ranges::find(nodes, after);
-			it != nodes.end())
-		{
-			nodes.insert(it + 1, node);
-			node->parent_region = this;
-		}
-		else
+		if (!nodes.contains(after))
 		{
 			/* if after node not found, append to end */
 			add_node(node);
+			return;
 		}
+
+		detach(node);
+		nodes.link_after(after, node);
+		node->parent_region = this;
+		mark_changed();
 	}
 
 	void Region::insert_at_beginning(Node *node)
 	{
-		if (!node)
-			return;
-
-		if (std::ranges::find(nodes, node) != nodes.end())
+		if (!node || nodes.contains(node))
 			return;
 
-		nodes.insert(nodes.begin(), node);
+		detach(node);
+		nodes.link_before(nodes.front(), node);
 		node->parent_region = this;
+		mark_changed();
+	}
+
+	void Region::mark_changed()
+	{
+		edits.fetch_add(1, std::memory_order_relaxed);
+		module.mark_numbering_dirty();
+	}
+
+	std::uint64_t Region::get_version() const // NOLINT(*-no-recursion)
+	{
+		std::uint64_t version = edits.load(std::memory_order_relaxed);
+		for (const Region *child: children)
+			version += child->get_version();
+		return version;
+	}
+
+	std::uint64_t Region::record_numbered_version() // NOLINT(*-no-recursion)
+	{
+		std::uint64_t version = edits.load(std::memory_order_relaxed);
+		for (Region *child: children)
+			version += child->record_numbered_version();
+		numbered_version = version;
+		return version;
+	}
+
+	void Region::detach(Node *node)
+	{
+		if (Region *owner = node->parent_region;
+			owner && owner->nodes.contains(node))
+		{
+			owner->nodes.unlink(node);
+			owner->mark_changed();
+		}
 	}
 
 	bool Region::is_terminated() const
@@ -263,17 +304,22 @@ namespace blm
 		if (!old_node || !new_node)
 			return false;
 
-		const auto it = std::ranges::find(nodes, old_node);
-		if (it == nodes.end())
+		if (!nodes.contains(old_node) || old_node == new_node)
 			return false;
 
 		/* replace in node list */
-		*it = new_node;
+		detach(new_node);
+		nodes.link_before(old_node, new_node);
+		nodes.unlink(old_node);
 		new_node->parent_region = this;
 		old_node->parent_region = nullptr;
+		mark_changed();
 
 		if (update_connections)
 		{
+			/* inputs may be pooled literals or globals that other bodies use concurrently */
+			const auto lock = module.lock_shared_users();
+
 			/* update all users of old_node to point to new_node */
 			for (const auto users = old_node->users;
 			     Node *user: users)
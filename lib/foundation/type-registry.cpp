@@ -1,7 +1,10 @@
 /* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
 
+#include <algorithm>
+#include <bit>
 #include <cassert>
-#include <mutex>
+#include <cstring>
+#include <stdexcept>
 #include <bloom/foundation/context.hpp>
 #include <bloom/foundation/type-registry.hpp>
 #include <bloom/foundation/typed-data.hpp>
@@ -9,37 +12,135 @@
 
 namespace blm
 {
+	namespace
+	{
+		template<typename T>
+		void put(std::string &out, const T &value)
+		{
+			char bytes[sizeof(T)];
+			std::memcpy(bytes, &value, sizeof(T));
+			out.append(bytes, sizeof(T));
+		}
+
+		/* every encoding starts with the kind so structures of different kinds never collide */
+		void start(std::string &out, const DataType kind)
+		{
+			out.clear();
+			put(out, static_cast<std::uint16_t>(kind));
+		}
+
+		void encode_pointer(std::string &out, const DataType pointee, const std::uint32_t addr_space)
+		{
+			start(out, DataType::POINTER);
+			put(out, pointee);
+			put(out, addr_space);
+		}
+
+		void encode_array(std::string &out, const DataType element_type, const std::uint64_t count)
+		{
+			start(out, DataType::ARRAY);
+			put(out, element_type);
+			put(out, count);
+		}
+
+		void encode_struct(std::string &out, const std::vector<std::pair<std::string, DataType> > &fields,
+		                   const std::uint32_t size, const std::uint32_t align)
+		{
+			start(out, DataType::STRUCT);
+			put(out, size);
+			put(out, align);
+			put(out, static_cast<std::uint32_t>(fields.size()));
+			for (const auto &[name, type]: fields)
+			{
+				put(out, static_cast<std::uint32_t>(name.size()));
+				out.append(name);
+				put(out, type);
+			}
+		}
+
+		void encode_function(std::string &out, const DataType return_type, const std::vector<DataType> &param_types,
+		                     const bool is_vararg)
+		{
+			start(out, DataType::FUNCTION);
+			put(out, return_type);
+			put(out, static_cast<std::uint8_t>(is_vararg));
+			put(out, static_cast<std::uint32_t>(param_types.size()));
+			for (const DataType param: param_types)
+				put(out, param);
+		}
+
+		void encode_vector(std::string &out, const DataType element_type, const std::uint32_t count)
+		{
+			start(out, DataType::VECTOR);
+			put(out, element_type);
+			put(out, count);
+		}
+
+		std::uint32_t primitive_size(const DataType type)
+		{
+			switch (type)
+			{
+				case DataType::BOOL:
+				case DataType::INT8:
+				case DataType::UINT8:
+					return 1;
+				case DataType::INT16:
+				case DataType::UINT16:
+					return 2;
+				case DataType::INT32:
+				case DataType::UINT32:
+				case DataType::FLOAT32:
+					return 4;
+				case DataType::INT64:
+				case DataType::UINT64:
+				case DataType::FLOAT64:
+				case DataType::POINTER:
+					return 8;
+				default:
+					return 0;
+			}
+		}
+	}
+
 	TypeRegistry::TypeRegistry() = default;
 
 	DataType TypeRegistry::register_type(TypedData &&type_data)
 	{
-		if (const auto it = type_lookup.find(type_data);
-			it != type_lookup.end())
+		if (!encode(type_data, scratch))
 		{
-			return static_cast<DataType>(it->second);
+			/* kinds without a structural encoding are never shared */
+			const std::uint32_t id = next_type_id();
+			define(id, std::move(type_data));
+			return static_cast<DataType>(id);
 		}
 
-		std::uint32_t id = nid++;
-		types[static_cast<DataType>(id)] = std::move(type_data);
-		type_lookup[types[static_cast<DataType>(id)]] = id;
-		return static_cast<DataType>(id);
+		return intern([&]
+		{
+			return std::move(type_data);
+		});
 	}
 
 	DataType TypeRegistry::create_pointer_type(const DataType pointee, const std::uint32_t addr_space)
 	{
-		auto ptr_data = DataTypeTraits<DataType::POINTER>::type { pointee, addr_space };
-		TypedData type_data;
-		type_data.set<DataTypeTraits<DataType::POINTER>::type, DataType::POINTER>(ptr_data);
-		const DataType base_id = register_type(std::move(type_data));
+		encode_pointer(scratch, pointee, addr_space);
+		const DataType base_id = intern([&]
+		{
+			TypedData type_data;
+			type_data.set<DataTypeTraits<DataType::POINTER>::type, DataType::POINTER>({ pointee, addr_space });
+			return type_data;
+		});
 		return encode_type_flags(base_id, TypeFlags::POINTER);
 	}
 
 	DataType TypeRegistry::create_array_type(const DataType element_type, const std::uint64_t count)
 	{
-		auto arr_data = DataTypeTraits<DataType::ARRAY>::type { element_type, count };
-		TypedData type_data;
-		type_data.set<DataTypeTraits<DataType::ARRAY>::type, DataType::ARRAY>(arr_data);
-		DataType base_id = register_type(std::move(type_data));
+		encode_array(scratch, element_type, count);
+		const DataType base_id = intern([&]
+		{
+			TypedData type_data;
+			type_data.set<DataTypeTraits<DataType::ARRAY>::type, DataType::ARRAY>({ element_type, count });
+			return type_data;
+		});
 		return encode_type_flags(base_id, TypeFlags::ARRAY);
 	}
 
@@ -47,10 +148,14 @@ namespace blm
 		const std::vector<std::pair<std::string, DataType> > &fields,
 		const std::uint32_t size, std::uint32_t align)
 	{
-		auto struct_data = DataTypeTraits<DataType::STRUCT>::type { size, align, fields };
-		TypedData type_data;
-		type_data.set<DataTypeTraits<DataType::STRUCT>::type, DataType::STRUCT>(std::move(struct_data));
-		DataType base_id = register_type(std::move(type_data));
+		/* the field list is only copied when the struct is new */
+		encode_struct(scratch, fields, size, align);
+		const DataType base_id = intern([&]
+		{
+			TypedData type_data;
+			type_data.set<DataTypeTraits<DataType::STRUCT>::type, DataType::STRUCT>({ size, align, fields });
+			return type_data;
+		});
 		return encode_type_flags(base_id, TypeFlags::STRUCT);
 	}
 
@@ -59,225 +164,259 @@ namespace blm
 		const std::vector<DataType> &param_types,
 		const bool is_vararg)
 	{
-		auto func_data = DataTypeTraits<DataType::FUNCTION>::type { param_types, return_type, is_vararg };
-		TypedData type_data;
-		type_data.set<DataTypeTraits<DataType::FUNCTION>::type, DataType::FUNCTION>(std::move(func_data));
-		DataType base_id = register_type(std::move(type_data));
+		encode_function(scratch, return_type, param_types, is_vararg);
+		const DataType base_id = intern([&]
+		{
+			TypedData type_data;
+			type_data.set<DataTypeTraits<DataType::FUNCTION>::type, DataType::FUNCTION>(
+				{ param_types, return_type, is_vararg });
+			return type_data;
+		});
 		return encode_type_flags(base_id, TypeFlags::FUNCTION);
 	}
 
 	DataType TypeRegistry::create_vector_type(const DataType element_type, const std::uint32_t count)
 	{
-		auto vec_data = DataTypeTraits<DataType::VECTOR>::type { element_type, count };
-		TypedData type_data;
-		type_data.set<DataTypeTraits<DataType::VECTOR>::type, DataType::VECTOR>(vec_data);
-		DataType base_id = register_type(std::move(type_data));
+		encode_vector(scratch, element_type, count);
+		const DataType base_id = intern([&]
+		{
+			TypedData type_data;
+			type_data.set<DataTypeTraits<DataType::VECTOR>::type, DataType::VECTOR>({ element_type, count });
+			return type_data;
+		});
 		return encode_type_flags(base_id, TypeFlags::VECTOR);
 	}
 
 	const TypedData &TypeRegistry::get_type(const DataType type) const
 	{
-		const DataType base_id = get_base_type_id(type);
-		const auto it = types.find(base_id);
-		assert(it != types.end() && "invalid type ID");
-		return it->second;
+		const TypeEntry *entry = find_entry(static_cast<std::uint32_t>(get_base_type_id(type)));
+		assert(entry && "invalid type ID");
+		return entry->data;
+	}
+
+	std::uint64_t TypeRegistry::get_size(const DataType type) const
+	{
+		if (static_cast<std::uint32_t>(type) < static_cast<std::uint32_t>(DataType::EXTENDED))
+			return primitive_size(type);
+
+		const auto base_id = static_cast<std::uint32_t>(get_base_type_id(type));
+		if (base_id < static_cast<std::uint32_t>(DataType::EXTENDED))
+			return is_pointer_type(type) ? primitive_size(DataType::POINTER) : 0;
+
+		const TypeEntry *entry = find_entry(base_id);
+		return entry ? entry->size : 0;
+	}
+
+	std::uint32_t TypeRegistry::get_alignment(const DataType type) const
+	{
+		if (static_cast<std::uint32_t>(type) < static_cast<std::uint32_t>(DataType::EXTENDED))
+			return std::max(primitive_size(type), 1u);
+
+		const auto base_id = static_cast<std::uint32_t>(get_base_type_id(type));
+		if (base_id < static_cast<std::uint32_t>(DataType::EXTENDED))
+			return is_pointer_type(type) ? primitive_size(DataType::POINTER) : 1;
+
+		const TypeEntry *entry = find_entry(base_id);
+		return entry ? entry->alignment : 1;
+	}
+
+	const std::vector<std::uint64_t> &TypeRegistry::get_field_offsets(const DataType type) const
+	{
+		static const std::vector<std::uint64_t> none;
+		if (static_cast<std::uint32_t>(type) < static_cast<std::uint32_t>(DataType::EXTENDED))
+			return none;
+
+		const TypeEntry *entry = find_entry(static_cast<std::uint32_t>(get_base_type_id(type)));
+		return entry ? entry->field_offsets : none;
 	}
 
 	DataType TypeRegistry::reserve_type_id()
 	{
-		std::uint32_t id = nid++;
-		if (constexpr std::uint16_t FLAG_MASK = 0xF000;
-			(id & FLAG_MASK) != 0)
-		{
-			throw std::runtime_error("type ID space exhausted");
-		}
-		return static_cast<DataType>(id);
+		return static_cast<DataType>(next_type_id());
 	}
 
 	void TypeRegistry::complete_type(DataType placeholder, DataType actual)
 	{
-		DataType actual_base = get_base_type_id(actual);
-
-		auto ph_id = static_cast<std::uint32_t>(placeholder);
-		auto actual_id = static_cast<std::uint32_t>(actual_base);
+		const auto ph_id = static_cast<std::uint32_t>(placeholder);
+		const auto actual_id = static_cast<std::uint32_t>(get_base_type_id(actual));
 
 		assert(ph_id >= static_cast<std::uint32_t>(DataType::EXTENDED) && "invalid type ID");
-		assert(!types.contains(static_cast<DataType>(ph_id)) && "type already defined");
+		assert(!find_entry(ph_id) && "type already defined");
+
+		const TypeEntry *actual_entry = find_entry(actual_id);
+		assert(actual_entry && "invalid type ID");
+
+		TypeEntry &entry = make_entry(ph_id);
+		entry = *actual_entry;
 
-		types[static_cast<DataType>(ph_id)] = types[static_cast<DataType>(actual_id)];
-		type_lookup[types[static_cast<DataType>(ph_id)]] = ph_id;
+		/* later registrations of the same structure resolve to the placeholder */
+		if (encode(entry.data, scratch))
+			type_lookup.insert_or_assign(scratch, ph_id);
 	}
 
-	size_t TypeRegistry::TypeHasher::operator()(const TypedData &data) const
+	const TypeRegistry::TypeEntry *TypeRegistry::find_entry(const std::uint32_t id) const
 	{
-		size_t hash = std::hash<int>()(static_cast<int>(data.type()));
+		if (id >= MAX_TYPES)
+			return nullptr;
 
-		/* golden ratio hash type shit */
-		switch (data.type())
-		{
-			case DataType::BOOL:
-				hash ^= std::hash<bool>()(data.get<DataType::BOOL>()) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-				break;
+		const auto &chunk = chunks[id >> CHUNK_BITS];
+		if (!chunk)
+			return nullptr;
 
-			case DataType::INT8:
-				hash ^= std::hash<int8_t>()(data.get<DataType::INT8>()) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-				break;
-
-			case DataType::INT16:
-				hash ^= std::hash<int16_t>()(data.get<DataType::INT16>()) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-				break;
+		const TypeEntry &entry = chunk[id & ((1u << CHUNK_BITS) - 1)];
+		return entry.defined ? &entry : nullptr;
+	}
 
-			case DataType::INT32:
-				hash ^= std::hash<int32_t>()(data.get<DataType::INT32>()) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-				break;
+	TypeRegistry::TypeEntry &TypeRegistry::make_entry(const std::uint32_t id)
+	{
+		auto &chunk = chunks[id >> CHUNK_BITS];
+		if (!chunk)
+			chunk = std::make_unique<TypeEntry[]>(1u << CHUNK_BITS);
+		return chunk[id & ((1u << CHUNK_BITS) - 1)];
+	}
 
-			case DataType::INT64:
-				hash ^= std::hash<int64_t>()(data.get<DataType::INT64>()) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-				break;
+	std::uint32_t TypeRegistry::next_type_id()
+	{
+		/* IDs above the base mask would collide with the type flag bits */
+		if (nid >= MAX_TYPES)
+			throw std::runtime_error("type ID space exhausted");
+		return nid++;
+	}
 
-			case DataType::UINT8:
-				hash ^= std::hash<uint8_t>()(data.get<DataType::UINT8>()) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-				break;
+	template<typename MakeData>
+	DataType TypeRegistry::intern(MakeData &&make)
+	{
+		if (const auto it = type_lookup.find(std::string_view(scratch));
+			it != type_lookup.end())
+		{
+			return static_cast<DataType>(it->second);
+		}
 
-			case DataType::UINT16:
-				hash ^= std::hash<uint16_t>()(data.get<DataType::UINT16>()) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-				break;
+		const std::uint32_t id = next_type_id();
+		type_lookup.emplace(scratch, id);
+		define(id, make());
+		return static_cast<DataType>(id);
+	}
 
-			case DataType::UINT32:
-				hash ^= std::hash<uint32_t>()(data.get<DataType::UINT32>()) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-				break;
+	void TypeRegistry::define(const std::uint32_t id, TypedData &&data)
+	{
+		TypeEntry &entry = make_entry(id);
+		entry.data = std::move(data);
+		entry.defined = true;
 
-			case DataType::UINT64:
-				hash ^= std::hash<uint64_t>()(data.get<DataType::UINT64>()) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-				break;
-			case DataType::FLOAT32:
-				hash ^= std::hash<float>()(data.get<DataType::FLOAT32>()) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-				break;
-			case DataType::FLOAT64:
-				hash ^= std::hash<double>()(data.get<DataType::FLOAT64>()) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-				break;
+		/* element types are registered first, so their layouts are already cached */
+		switch (entry.data.type())
+		{
 			case DataType::POINTER:
-			{
-				const auto &ptr = data.get<DataType::POINTER>();
-				hash ^= std::hash<int>()(static_cast<int>(ptr.pointee_type)) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-				hash ^= std::hash<uint32_t>()(ptr.addr_space) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+				entry.size = primitive_size(DataType::POINTER);
+				entry.alignment = static_cast<std::uint32_t>(entry.size);
 				break;
-			}
+
 			case DataType::ARRAY:
 			{
-				const auto &arr = data.get<DataType::ARRAY>();
-				hash ^= std::hash<int>()(static_cast<int>(arr.elem_type)) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-				hash ^= std::hash<uint64_t>()(arr.count) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+				const auto &[elem_type, count] = entry.data.get<DataType::ARRAY>();
+				entry.size = get_size(elem_type) * count;
+				entry.alignment = get_alignment(elem_type);
 				break;
 			}
+
 			case DataType::STRUCT:
 			{
-				const auto &struct_data = data.get<DataType::STRUCT>();
-				hash ^= std::hash<uint32_t>()(struct_data.size) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-				hash ^= std::hash<uint32_t>()(struct_data.alignment) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-				for (const auto &[field_name, field_type]: struct_data.fields)
+				const auto &struct_data = entry.data.get<DataType::STRUCT>();
+				entry.size = struct_data.size;
+				entry.alignment = std::max(struct_data.alignment, 1u);
+
+				std::uint64_t offset = 0;
+				entry.field_offsets.clear();
+				entry.field_offsets.reserve(struct_data.fields.size());
+				for (const auto &[name, field]: struct_data.fields)
 				{
-					hash ^= std::hash<std::string>()(field_name) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-					hash ^= std::hash<int>()(static_cast<int>(field_type)) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+					const std::uint64_t align = get_alignment(field);
+					offset = (offset + align - 1) & ~(align - 1);
+					entry.field_offsets.push_back(offset);
+					offset += get_size(field);
 				}
 				break;
 			}
-			case DataType::FUNCTION:
-			{
-				const auto &func = data.get<DataType::FUNCTION>();
-				hash ^= std::hash<int>()(static_cast<int>(func.return_type)) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-				hash ^= std::hash<bool>()(func.is_vararg) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-
-				/* hash parameter types */
-				for (const auto &param_type: func.param_types)
-					hash ^= std::hash<int>()(static_cast<int>(param_type)) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-				break;
-			}
 
 			case DataType::VECTOR:
 			{
-				const auto &[elem_type, count] = data.get<DataType::VECTOR>();
-				hash ^= std::hash<int>()(static_cast<int>(elem_type)) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-				hash ^= std::hash<uint32_t>()(count) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+				const auto &[elem_type, count] = entry.data.get<DataType::VECTOR>();
+				entry.size = get_size(elem_type) * count;
+				entry.alignment = std::has_single_bit(entry.size)
+					                  ? static_cast<std::uint32_t>(entry.size)
+					                  : get_alignment(elem_type);
 				break;
 			}
 
-			/* VOID is also noop as well */
 			default:
+				entry.size = primitive_size(entry.data.type());
+				entry.alignment = std::max(static_cast<std::uint32_t>(entry.size), 1u);
 				break;
 		}
-
-		return hash;
 	}
 
-	bool TypeRegistry::TypeEqual::operator()(const TypedData &a, const TypedData &b) const
+	bool TypeRegistry::encode(const TypedData &data, std::string &out)
 	{
-		if (a.type() != b.type())
-			return false;
-
-		switch (a.type())
+		switch (data.type())
 		{
 			case DataType::VOID:
+				start(out, DataType::VOID);
+				return true;
+
+#define BLM_ENCODE_SCALAR(dt) \
+			case DataType::dt: \
+				start(out, DataType::dt); \
+				put(out, data.get<DataType::dt>()); \
 				return true;
-			case DataType::BOOL:
-				return a.get<DataType::BOOL>() == b.get<DataType::BOOL>();
-			case DataType::INT8:
-				return a.get<DataType::INT8>() == b.get<DataType::INT8>();
-			case DataType::INT16:
-				return a.get<DataType::INT16>() == b.get<DataType::INT16>();
-			case DataType::INT32:
-				return a.get<DataType::INT32>() == b.get<DataType::INT32>();
-			case DataType::INT64:
-				return a.get<DataType::INT64>() == b.get<DataType::INT64>();
-			case DataType::UINT8:
-				return a.get<DataType::UINT8>() == b.get<DataType::UINT8>();
-			case DataType::UINT16:
-				return a.get<DataType::UINT16>() == b.get<DataType::UINT16>();
-			case DataType::UINT32:
-				return a.get<DataType::UINT32>() == b.get<DataType::UINT32>();
-			case DataType::UINT64:
-				return a.get<DataType::UINT64>() == b.get<DataType::UINT64>();
-			case DataType::FLOAT32:
-				return a.get<DataType::FLOAT32>() == b.get<DataType::FLOAT32>();
-			case DataType::FLOAT64:
-				return a.get<DataType::FLOAT64>() == b.get<DataType::FLOAT64>();
+			BLM_ENCODE_SCALAR(BOOL)
+			BLM_ENCODE_SCALAR(INT8)
+			BLM_ENCODE_SCALAR(INT16)
+			BLM_ENCODE_SCALAR(INT32)
+			BLM_ENCODE_SCALAR(INT64)
+			BLM_ENCODE_SCALAR(UINT8)
+			BLM_ENCODE_SCALAR(UINT16)
+			BLM_ENCODE_SCALAR(UINT32)
+			BLM_ENCODE_SCALAR(UINT64)
+			BLM_ENCODE_SCALAR(FLOAT32)
+			BLM_ENCODE_SCALAR(FLOAT64)
+#undef BLM_ENCODE_SCALAR
+
 			case DataType::POINTER:
 			{
-				const auto &ptr_a = a.get<DataType::POINTER>();
-				const auto &ptr_b = b.get<DataType::POINTER>();
-				return ptr_a.pointee_type == ptr_b.pointee_type &&
-				       ptr_a.addr_space == ptr_b.addr_space;
+				const auto &ptr = data.get<DataType::POINTER>();
+				encode_pointer(out, ptr.pointee_type, ptr.addr_space);
+				return true;
 			}
+
 			case DataType::ARRAY:
 			{
-				const auto &arr_a = a.get<DataType::ARRAY>();
-				const auto &arr_b = b.get<DataType::ARRAY>();
-				return arr_a.elem_type == arr_b.elem_type &&
-				       arr_a.count == arr_b.count;
+				const auto &arr = data.get<DataType::ARRAY>();
+				encode_array(out, arr.elem_type, arr.count);
+				return true;
 			}
+
 			case DataType::STRUCT:
 			{
-				const auto &struct_a = a.get<DataType::STRUCT>();
-				const auto &struct_b = b.get<DataType::STRUCT>();
-				return struct_a.size == struct_b.size &&
-				       struct_a.alignment == struct_b.alignment &&
-				       struct_a.fields == struct_b.fields;
+				const auto &struct_data = data.get<DataType::STRUCT>();
+				encode_struct(out, struct_data.fields, struct_data.size, struct_data.alignment);
+				return true;
 			}
+
 			case DataType::FUNCTION:
 			{
-				const auto &func_a = a.get<DataType::FUNCTION>();
-				const auto &func_b = b.get<DataType::FUNCTION>();
-				return func_a.param_types == func_b.param_types &&
-				       func_a.return_type == func_b.return_type &&
-				       func_a.is_vararg == func_b.is_vararg;
+				const auto &func = data.get<DataType::FUNCTION>();
+				encode_function(out, func.return_type, func.param_types, func.is_vararg);
+				return true;
 			}
+
 			case DataType::VECTOR:
 			{
-				const auto &vec_a = a.get<DataType::VECTOR>();
-				const auto &vec_b = b.get<DataType::VECTOR>();
-				return vec_a.elem_type == vec_b.elem_type &&
-				       vec_a.count == vec_b.count;
+				const auto &[elem_type, count] = data.get<DataType::VECTOR>();
+				encode_vector(out, elem_type, count);
+				return true;
 			}
+
 			default:
 				return false;
 		}
@@ -65,6 +65,8 @@ namespace blm
 			BIR_TYPEDATA_DESTROY(ARRAY)
 			BIR_TYPEDATA_DESTROY(STRUCT)
 			BIR_TYPEDATA_DESTROY(FUNCTION)
+			BIR_TYPEDATA_DESTROY(VECTOR)
+			BIR_TYPEDATA_DESTROY(STRING)
 #undef BIR_TYPEDATA_DESTROY
 
 			default:
@@ -117,6 +119,8 @@ namespace blm
 			BIR_TYPEDATA_CONSTRUCT(ARRAY)
 			BIR_TYPEDATA_CONSTRUCT(STRUCT)
 			BIR_TYPEDATA_CONSTRUCT(FUNCTION)
+			BIR_TYPEDATA_CONSTRUCT(VECTOR)
+			BIR_TYPEDATA_CONSTRUCT(STRING)
 			default:
 				break;
 		}
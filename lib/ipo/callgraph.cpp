@@ -55,8 +55,8 @@ namespace blm
 			return it->second.get();
 		}
 
-		auto [inserted_it, success] = node_map.emplace(function, std::make_unique<CallGraphNode>(function));
-		CallGraphNode *node_ptr = inserted_it->second.get();
+		CallGraphNode *node_ptr = node_slab.create<CallGraphNode>(function);
+		node_map.try_emplace(function, node_ptr, ach::slab_deleter<CallGraphNode> { &node_slab });
 		nodes.push_back(node_ptr);
 		return node_ptr;
 	}
@@ -246,16 +246,9 @@ namespace blm
 			return;
 
 		const Region *func_region = nullptr;
-		for (Module *module : modules)
+		for (const Module *module : modules)
 		{
-			for (const Region *child : module->get_root_region()->get_children())
-			{
-				if (child->get_name() == module->get_context().get_string(func->str_id))
-				{
-					func_region = const_cast<Region*>(child);
-					break;
-				}
-			}
+			func_region = module->get_function_region(func);
 			if (func_region)
 				break;
 		}
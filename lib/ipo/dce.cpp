@@ -1,7 +1,6 @@
 /* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
 
 #include <algorithm>
-#include <functional>
 #include <queue>
 #include <bloom/foundation/region.hpp>
 #include <bloom/ipo/dce.hpp>
@@ -98,17 +97,17 @@ namespace blm
 
 	void IPODCEPass::remove_function_and_region(Module* module, Node* function)
 	{
-		if (Region* function_region = find_function_region(module, function))
+		if (Region* function_region = module->get_function_region(function))
 		{
 			if (Region* parent = function_region->get_parent())
 			{
 				auto& children = const_cast<std::vector<Region*>&>(parent->get_children());
 				std::erase(children, function_region);
+				parent->mark_changed();
 			}
 		}
 
-		auto& functions = const_cast<std::vector<Node*>&>(module->get_functions());
-		std::erase(functions, function);
+		module->remove_function(function);
 		for (Node* input : function->inputs)
 		{
 			if (input)
@@ -121,30 +120,4 @@ namespace blm
 		function->inputs.clear();
 		function->users.clear();
 	}
-
-	Region* IPODCEPass::find_function_region(Module* module, Node* function)
-	{
-		if (!function || function->ir_type != NodeType::FUNCTION)
-			return nullptr;
-
-		const std::string_view function_name = module->get_context().get_string(function->str_id);
-		const std::function<Region*(const Region*)> search_region = [&](const Region* region) -> Region*
-		{
-			if (!region)
-				return nullptr;
-
-			if (region->get_name() == function_name)
-				return const_cast<Region*>(region);
-
-			for (const Region* child : region->get_children())
-			{
-				if (Region* found = search_region(child))
-					return found;
-			}
-
-			return nullptr;
-		};
-
-		return search_region(module->get_root_region());
-	}
 }
@@ -1,5 +1,6 @@
 /* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <bloom/foundation/region.hpp>
@@ -7,141 +8,6 @@
 
 namespace blm
 {
-	template<typename T>
-	Node *find_or_create_literal(Module &module, T value)
-	{
-		/* search for existing literal with same value in the root region */
-		Region *root = module.get_root_region();
-		for (Node *node: root->get_nodes())
-		{
-			if (node->ir_type != NodeType::LIT)
-				continue;
-
-			/* check if this literal has the same type and value */
-			if constexpr (std::is_same_v<T, bool>)
-			{
-				if (node->type_kind == DataType::BOOL && node->as<DataType::BOOL>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::int8_t>)
-			{
-				if (node->type_kind == DataType::INT8 && node->as<DataType::INT8>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::int16_t>)
-			{
-				if (node->type_kind == DataType::INT16 && node->as<DataType::INT16>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::int32_t>)
-			{
-				if (node->type_kind == DataType::INT32 && node->as<DataType::INT32>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::int64_t>)
-			{
-				if (node->type_kind == DataType::INT64 && node->as<DataType::INT64>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::uint8_t>)
-			{
-				if (node->type_kind == DataType::UINT8 && node->as<DataType::UINT8>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::uint16_t>)
-			{
-				if (node->type_kind == DataType::UINT16 && node->as<DataType::UINT16>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::uint32_t>)
-			{
-				if (node->type_kind == DataType::UINT32 && node->as<DataType::UINT32>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::uint64_t>)
-			{
-				if (node->type_kind == DataType::UINT64 && node->as<DataType::UINT64>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, float>)
-			{
-				if (node->type_kind == DataType::FLOAT32 && node->as<DataType::FLOAT32>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, double>)
-			{
-				if (node->type_kind == DataType::FLOAT64 && node->as<DataType::FLOAT64>() == value)
-					return node;
-			}
-		}
-
-		/* no existing literal found; create a new one */
-		Node *lit = module.get_context().create<Node>();
-		lit->ir_type = NodeType::LIT;
-		lit->parent_region = module.get_root_region();
-
-		/* set type and value based on template parameter */
-		if constexpr (std::is_same_v<T, bool>)
-		{
-			lit->type_kind = DataType::BOOL;
-			lit->data.set<bool, DataType::BOOL>(value);
-		}
-		else if constexpr (std::is_same_v<T, std::int8_t>)
-		{
-			lit->type_kind = DataType::INT8;
-			lit->data.set<std::int8_t, DataType::INT8>(value);
-		}
-		else if constexpr (std::is_same_v<T, std::int16_t>)
-		{
-			lit->type_kind = DataType::INT16;
-			lit->data.set<std::int16_t, DataType::INT16>(value);
-		}
-		else if constexpr (std::is_same_v<T, std::int32_t>)
-		{
-			lit->type_kind = DataType::INT32;
-			lit->data.set<std::int32_t, DataType::INT32>(value);
-		}
-		else if constexpr (std::is_same_v<T, std::int64_t>)
-		{
-			lit->type_kind = DataType::INT64;
-			lit->data.set<std::int64_t, DataType::INT64>(value);
-		}
-		else if constexpr (std::is_same_v<T, std::uint8_t>)
-		{
-			lit->type_kind = DataType::UINT8;
-			lit->data.set<std::uint8_t, DataType::UINT8>(value);
-		}
-		else if constexpr (std::is_same_v<T, std::uint16_t>)
-		{
-			lit->type_kind = DataType::UINT16;
-			lit->data.set<std::uint16_t, DataType::UINT16>(value);
-		}
-		else if constexpr (std::is_same_v<T, std::uint32_t>)
-		{
-			lit->type_kind = DataType::UINT32;
-			lit->data.set<std::uint32_t, DataType::UINT32>(value);
-		}
-		else if constexpr (std::is_same_v<T, std::uint64_t>)
-		{
-			lit->type_kind = DataType::UINT64;
-			lit->data.set<std::uint64_t, DataType::UINT64>(value);
-		}
-		else if constexpr (std::is_same_v<T, float>)
-		{
-			lit->type_kind = DataType::FLOAT32;
-			lit->data.set<float, DataType::FLOAT32>(value);
-		}
-		else if constexpr (std::is_same_v<T, double>)
-		{
-			lit->type_kind = DataType::FLOAT64;
-			lit->data.set<double, DataType::FLOAT64>(value);
-		}
-
-		/* add the new literal to the root region */
-		module.get_root_region()->add_node(lit);
-		return lit;
-	}
-
 	template<typename T, DataType DT>
 	LatticeValue evaluate_bitwise_typed(Node *node, const LatticeValue &lhs, const LatticeValue &rhs)
 	{
@@ -330,11 +196,30 @@ namespace blm
 	{
 		std::size_t replaced_count = 0;
 
+		/* literals come from the module pool and stay in the root region, so only the uses move */
+		auto replace_with_literal = [](Region* region, Node* node, Node* literal)
+		{
+			for (Node* user : node->users)
+			{
+				std::ranges::replace(user->inputs, node, literal);
+				if (std::ranges::find(literal->users, user) == literal->users.end())
+					literal->users.push_back(user);
+			}
+			for (Node* input : node->inputs)
+			{
+				if (input)
+					std::erase(input->users, node);
+			}
+			node->users.clear();
+			region->remove_node(node);
+			return true;
+		};
+
 		std::function<void(Region*)> replace_in_region = [&](Region* region)
 		{
 			if (!region)
 				return;
-			std::vector<Node*> nodes_copy = region->get_nodes();
+			std::vector<Node*> nodes_copy = region->get_nodes().snapshot();
 			for (Node* node : nodes_copy)
 			{
 				if (node->ir_type == NodeType::LIT ||
@@ -355,7 +240,7 @@ namespace blm
 					if (call_val.is_constant())
 					{
 						Node* literal = create_literal_from_lattice(call_val, module);
-						if (literal && region->replace_node(node, literal, true))
+						if (literal && replace_with_literal(region, node, literal))
 						{
 							replaced_count++;
 						}
@@ -388,7 +273,7 @@ namespace blm
 					lattice_val.is_constant())
 				{
 					if (Node* literal = create_literal_from_lattice(lattice_val, module);
-						literal && region->replace_node(node, literal, true))
+						literal && replace_with_literal(region, node, literal))
 					{
 						replaced_count++;
 					}
@@ -421,6 +306,9 @@ namespace blm
 						new_literal->users.push_back(user);
 				}
 			}
+
+			if (user->parent_region)
+				user->parent_region->mark_changed();
 		}
 
 		old_node->users.clear();
@@ -1017,16 +905,10 @@ namespace blm
 		if (!func || func->ir_type != NodeType::FUNCTION)
 			return nullptr;
 
-		for (Module *module: modules)
+		for (const Module *module: modules)
 		{
-			for (const Region *child: module->get_root_region()->get_children())
-			{
-				for (Node *node: child->get_nodes())
-				{
-					if (node == func)
-						return const_cast<Region *>(child);
-				}
-			}
+			if (Region *region = module->get_function_region(func))
+				return region;
 		}
 
 		return nullptr;
@@ -1037,32 +919,6 @@ namespace blm
 		if (!lattice_val.is_constant())
 			return nullptr;
 
-		switch (lattice_val.value.type())
-		{
-			case DataType::BOOL:
-				return find_or_create_literal<bool>(module, lattice_val.value.get<DataType::BOOL>());
-			case DataType::INT8:
-				return find_or_create_literal<std::int8_t>(module, lattice_val.value.get<DataType::INT8>());
-			case DataType::INT16:
-				return find_or_create_literal<std::int16_t>(module, lattice_val.value.get<DataType::INT16>());
-			case DataType::INT32:
-				return find_or_create_literal<std::int32_t>(module, lattice_val.value.get<DataType::INT32>());
-			case DataType::INT64:
-				return find_or_create_literal<std::int64_t>(module, lattice_val.value.get<DataType::INT64>());
-			case DataType::UINT8:
-				return find_or_create_literal<std::uint8_t>(module, lattice_val.value.get<DataType::UINT8>());
-			case DataType::UINT16:
-				return find_or_create_literal<std::uint16_t>(module, lattice_val.value.get<DataType::UINT16>());
-			case DataType::UINT32:
-				return find_or_create_literal<std::uint32_t>(module, lattice_val.value.get<DataType::UINT32>());
-			case DataType::UINT64:
-				return find_or_create_literal<std::uint64_t>(module, lattice_val.value.get<DataType::UINT64>());
-			case DataType::FLOAT32:
-				return find_or_create_literal<float>(module, lattice_val.value.get<DataType::FLOAT32>());
-			case DataType::FLOAT64:
-				return find_or_create_literal<double>(module, lattice_val.value.get<DataType::FLOAT64>());
-			default:
-				return nullptr;
-		}
+		return module.intern_literal(lattice_val.value);
 	}
 }
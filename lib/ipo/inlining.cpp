@@ -157,13 +157,14 @@ namespace blm
 
 	bool IPOInliningPass::is_recursive_call(const InlineCandidate &candidate)
 	{
-		Region *current = candidate.call_site->parent_region;
-		std::string_view callee_name = candidate.caller_module->get_context().get_string(
-			candidate.callee_function->str_id);
+		const Region *callee_region = candidate.callee_module->get_function_region(candidate.callee_function);
+		if (!callee_region)
+			return false;
 
+		const Region *current = candidate.call_site->parent_region;
 		while (current)
 		{
-			if (current->get_name() == callee_name)
+			if (current == callee_region)
 				return true;
 			current = current->get_parent();
 		}
@@ -229,6 +230,7 @@ namespace blm
 		Node *return_value = extract_return_value(inlined_region);
 		substitute_parameters(inlined_region, candidate.call_site);
 		replace_call_with_body(candidate.call_site, inlined_region, return_value);
+		discard_clone_region(inlined_region, *candidate.caller_module);
 		return true;
 	}
 
@@ -325,16 +327,10 @@ namespace blm
 
 	Region *IPOInliningPass::find_function_region(Node *function, std::vector<Module *> &modules)
 	{
-		const Module* target_module = find_module_for_function(function, modules);
-		if (!target_module)
-			return nullptr;
-
-		for (const Region* child : target_module->get_root_region()->get_children()) {
-			for (Node* node : child->get_nodes())
-			{
-				if (node == function)
-					return const_cast<Region*>(child);
-			}
+		for (const Module *mod: modules)
+		{
+			if (Region *region = mod->get_function_region(function))
+				return region;
 		}
 
 		return nullptr;
@@ -362,7 +358,9 @@ namespace blm
 
 			if (Node *cloned_node = clone_node(original_node, target_module))
 			{
-				cloned_region->add_node(cloned_node);
+				/* pooled literals already live in the root region */
+				if (!cloned_node->parent_region)
+					cloned_region->add_node(cloned_node);
 				node_mapping[original_node] = cloned_node;
 			}
 		}
@@ -378,58 +376,11 @@ namespace blm
 
 		Context &ctx = target_module.get_context();
 
-		/* try to reuse existing ones for literals */
+		/* literals resolve to the target module's shared pool entry */
 		if (original->ir_type == NodeType::LIT)
 		{
-			Region *root_region = target_module.get_root_region();
-			for (Node *existing: root_region->get_nodes())
-			{
-				if (existing->ir_type != NodeType::LIT || existing->type_kind != original->type_kind)
-					continue;
-
-				auto data_matches = false;
-				switch (original->type_kind)
-				{
-					case DataType::BOOL:
-						data_matches = (existing->as<DataType::BOOL>() == original->as<DataType::BOOL>());
-						break;
-					case DataType::INT8:
-						data_matches = (existing->as<DataType::INT8>() == original->as<DataType::INT8>());
-						break;
-					case DataType::INT16:
-						data_matches = (existing->as<DataType::INT16>() == original->as<DataType::INT16>());
-						break;
-					case DataType::INT32:
-						data_matches = (existing->as<DataType::INT32>() == original->as<DataType::INT32>());
-						break;
-					case DataType::INT64:
-						data_matches = (existing->as<DataType::INT64>() == original->as<DataType::INT64>());
-						break;
-					case DataType::UINT8:
-						data_matches = (existing->as<DataType::UINT8>() == original->as<DataType::UINT8>());
-						break;
-					case DataType::UINT16:
-						data_matches = (existing->as<DataType::UINT16>() == original->as<DataType::UINT16>());
-						break;
-					case DataType::UINT32:
-						data_matches = (existing->as<DataType::UINT32>() == original->as<DataType::UINT32>());
-						break;
-					case DataType::UINT64:
-						data_matches = (existing->as<DataType::UINT64>() == original->as<DataType::UINT64>());
-						break;
-					case DataType::FLOAT32:
-						data_matches = (existing->as<DataType::FLOAT32>() == original->as<DataType::FLOAT32>());
-						break;
-					case DataType::FLOAT64:
-						data_matches = (existing->as<DataType::FLOAT64>() == original->as<DataType::FLOAT64>());
-						break;
-					default:
-						break;
-				}
-
-				if (data_matches)
-					return existing;
-			}
+			if (Node *pooled = target_module.intern_literal(original->data))
+				return pooled;
 		}
 
 		/* create new node */
@@ -455,18 +406,32 @@ namespace blm
 			if (cloned_it == mapping.end())
 				continue;
 
+			/* shared literals keep their users from elsewhere in the module */
 			Node *cloned_node = cloned_it->second;
+			if (cloned_node->parent_region != cloned)
+				continue;
+
 			cloned_node->inputs.clear();
 			cloned_node->users.clear();
 
 			for (Node *original_input: original_node->inputs)
 			{
+				Node *cloned_input = nullptr;
 				if (auto input_it = mapping.find(original_input);
 					input_it != mapping.end())
 				{
-					Node *cloned_input = input_it->second;
+					cloned_input = input_it->second;
+				}
+				else if (original_input && original_input->ir_type == NodeType::LIT)
+				{
+					cloned_input = cloned->get_module().intern_literal(original_input->data);
+				}
+
+				if (cloned_input)
+				{
 					cloned_node->inputs.push_back(cloned_input);
-					cloned_input->users.push_back(cloned_node);
+					if (std::ranges::find(cloned_input->users, cloned_node) == cloned_input->users.end())
+						cloned_input->users.push_back(cloned_node);
 				}
 			}
 		}
@@ -477,6 +442,7 @@ namespace blm
 		if (!inlined_region || !call_site)
 			return;
 
+		/* collected in region order, which is parameter order */
 		std::vector<Node *> param_nodes;
 		for (Node *node: inlined_region->get_nodes())
 		{
@@ -484,15 +450,6 @@ namespace blm
 				param_nodes.push_back(node);
 		}
 
-		/* sort by position in region */
-		std::ranges::sort(param_nodes, [inlined_region](const Node *a, const Node *b)
-		{
-			const auto &nodes = inlined_region->get_nodes();
-			auto pos_a = std::ranges::find(nodes, a);
-			auto pos_b = std::ranges::find(nodes, b);
-			return pos_a < pos_b;
-		});
-
 		std::size_t arg_end = call_site->inputs.size();
 		if (call_site->ir_type == NodeType::INVOKE)
 			arg_end -= 2;
@@ -532,9 +489,7 @@ namespace blm
 		if (!caller_region)
 			return;
 
-		auto &caller_nodes = const_cast<std::vector<Node *> &>(caller_region->get_nodes());
-		const auto call_pos = std::ranges::find(caller_nodes, call_site);
-		if (call_pos == caller_nodes.end())
+		if (!caller_region->contains(call_site))
 			return;
 
 		std::vector<Node *> nodes_to_inline;
@@ -545,7 +500,6 @@ namespace blm
 			    node->ir_type != NodeType::PARAM &&
 			    node->ir_type != NodeType::RET)
 			{
-				node->parent_region = caller_region;
 				nodes_to_inline.push_back(node);
 			}
 		}
@@ -568,8 +522,9 @@ namespace blm
 
 		/* remove the call site and insert inlined nodes and then
 		 * clear call site connections */
-		caller_nodes.erase(call_pos);
-		caller_nodes.insert(call_pos, nodes_to_inline.begin(), nodes_to_inline.end());
+		for (Node *node: nodes_to_inline)
+			caller_region->insert_node_before(call_site, node);
+		caller_region->remove_node(call_site);
 		for (Node *input: call_site->inputs)
 		{
 			if (input)
@@ -581,4 +536,22 @@ namespace blm
 		call_site->inputs.clear();
 		call_site->users.clear();
 	}
+
+	void IPOInliningPass::discard_clone_region(Region *inlined_region, Module &module)
+	{
+		if (!inlined_region)
+			return;
+
+		for (Node *node: inlined_region->get_nodes().snapshot())
+		{
+			for (Node *input: node->inputs)
+			{
+				if (input)
+					std::erase(input->users, node);
+			}
+			node->inputs.clear();
+			inlined_region->remove_node(node);
+		}
+		module.remove_region(inlined_region);
+	}
 }
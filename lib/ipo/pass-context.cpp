@@ -1,11 +1,18 @@
 /* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
 
+#include <algorithm>
+#include <thread>
+#include <bloom/foundation/context.hpp>
+#include <bloom/foundation/module.hpp>
+#include <bloom/foundation/profiler.hpp>
 #include <bloom/ipo/pass-context.hpp>
 
 namespace blm
 {
-    IPOPassContext::IPOPassContext(std::vector<Module*>& modules, int opt_level, bool debug_mode)
-        : mods(modules), opt_lvl(opt_level), dbg_mode(debug_mode)
+    IPOPassContext::IPOPassContext(std::vector<Module*>& modules, int opt_level, bool debug_mode,
+                                   std::size_t threads)
+        : mods(modules), opt_lvl(opt_level), dbg_mode(debug_mode),
+          thread_count(threads ? threads : std::max(1u, std::thread::hardware_concurrency()))
     {
     }
 
@@ -83,6 +90,11 @@ namespace blm
             const auto& [key, result] = pair;
             return result->invalidated_by_modules(changed_modules);
         });
+
+        /* local results of a changed module start over */
+        std::lock_guard lock(module_contexts_mutex);
+        for (Module* module : changed_modules)
+            module_contexts.erase(module);
     }
 
     void IPOPassContext::invalidate_matching(std::string_view pattern)
@@ -118,4 +130,83 @@ namespace blm
         /* exact match */
         return key == pattern;
     }
-}
\ No newline at end of file
+
+    const std::unordered_map<std::string, std::size_t>& IPOPassContext::get_stats() const
+    {
+        return stats;
+    }
+
+    void IPOPassContext::set_profiler(Profiler* profiler)
+    {
+        std::lock_guard lock(module_contexts_mutex);
+        prof = profiler;
+        for (auto& [_, context] : module_contexts)
+            context->set_profiler(profiler);
+    }
+
+    Profiler* IPOPassContext::get_profiler() const
+    {
+        return prof;
+    }
+
+    PassContext& IPOPassContext::get_module_context(Module& module)
+    {
+        std::lock_guard lock(module_contexts_mutex);
+        std::unique_ptr<PassContext>& slot = module_contexts[&module];
+        if (!slot)
+        {
+            slot = std::make_unique<PassContext>(module, opt_lvl, dbg_mode);
+            slot->set_profiler(prof);
+        }
+        return *slot;
+    }
+
+    bool IPOPassContext::for_each_module(const ModuleTask& task)
+    {
+        /* contexts are set up first so workers only look them up */
+        std::vector<std::pair<Module*, PassContext*>> work;
+        for (Module* module : mods)
+        {
+            if (module)
+                work.emplace_back(module, &get_module_context(*module));
+        }
+
+        if (!pool)
+            pool = std::make_unique<ThreadPool>(thread_count);
+
+        /* workers parent their module events to the scope open here */
+        const std::size_t parent = prof ? prof->current() : Profiler::NO_EVENT;
+        std::vector<char> changed(work.size(), 0);
+        const auto run_module = [&](const std::size_t index, std::size_t) {
+            auto& [module, context] = work[index];
+            const Profiler::Scope scope(prof, module->get_name(), "module", parent);
+            changed[index] = task(*module, *context);
+        };
+
+        /* modules sharing a pool or slab context would create nodes from it concurrently */
+        std::unordered_set<const Context*> single_threaded;
+        bool concurrent = true;
+        for (const auto& [module, context] : work)
+        {
+            const Context& ctx = module->get_context();
+            if (!ctx.supports_concurrent_creation() && !single_threaded.insert(&ctx).second)
+                concurrent = false;
+        }
+
+        if (concurrent)
+        {
+            pool->parallel_for(work.size(), run_module);
+        }
+        else
+        {
+            for (std::size_t index = 0; index < work.size(); ++index)
+                run_module(index, 0);
+        }
+        return std::ranges::find(changed, 1) != changed.end();
+    }
+
+    std::size_t IPOPassContext::get_thread_count() const
+    {
+        return thread_count;
+    }
+}
@@ -2,13 +2,18 @@
 
 #include <format>
 #include <stdexcept>
+#include <unordered_set>
+#include <bloom/foundation/context.hpp>
+#include <bloom/foundation/module.hpp>
+#include <bloom/foundation/profiler.hpp>
 #include <bloom/ipo/pass-manager.hpp>
 #include <bloom/ipo/pass.hpp>
 
 namespace blm
 {
-    IPOPassManager::IPOPassManager(std::vector<Module*>& modules, int opt_level, bool debug_mode, int verbosity)
-        : mods(modules), verbosity_lvl(verbosity), ctx(modules, opt_level, debug_mode)
+    IPOPassManager::IPOPassManager(std::vector<Module*>& modules, int opt_level, bool debug_mode, int verbosity,
+                                   std::size_t threads)
+        : mods(modules), verbosity_lvl(verbosity), ctx(modules, opt_level, debug_mode, threads)
     {
     }
 
@@ -31,21 +36,10 @@ namespace blm
         }
 
         const auto start_time = std::chrono::high_resolution_clock::now();
-
-        bool result = false;
-        try
-        {
-            result = pass->run(mods, ctx);
-        }
-        catch (const std::exception& e)
-        {
-            throw std::runtime_error(
-                std::format("IPO pass {} failed: {}", pass->name(), e.what()));
-        }
-
+        const bool result = execute(*pass);
         const auto end_time = std::chrono::high_resolution_clock::now();
         const auto duration = std::chrono::duration<double>(end_time - start_time);
-        pass_times[type_idx] = duration.count();
+        pass_times[type_idx] += duration.count();
 
         if (verbosity_lvl >= 1)
         {
@@ -76,21 +70,10 @@ namespace blm
             }
 
             const auto start_time = std::chrono::high_resolution_clock::now();
-
-            bool result = false;
-            try
-            {
-                result = pass->run(mods, ctx);
-            }
-            catch (const std::exception& e)
-            {
-                throw std::runtime_error(
-                    std::format("IPO pass {} failed: {}", pass->name(), e.what()));
-            }
-
+            const bool result = execute(*pass);
             const auto end_time = std::chrono::high_resolution_clock::now();
             const auto duration = std::chrono::duration<double>(end_time - start_time);
-            pass_times[type_idx] = duration.count();
+            pass_times[type_idx] += duration.count();
 
             if (result)
             {
@@ -112,6 +95,56 @@ namespace blm
         }
     }
 
+    bool IPOPassManager::execute(IPOPass& pass)
+    {
+        const Profiler::Scope scope(ctx.get_profiler(), pass.name(), "ipo-pass");
+        std::unordered_map<std::string, std::size_t> stats_before;
+        if (scope.active())
+        {
+            scope.set_nodes_before(count_nodes());
+            stats_before = ctx.get_stats();
+        }
+
+        bool result = false;
+        try
+        {
+            result = pass.run(mods, ctx);
+        }
+        catch (const std::exception& e)
+        {
+            throw std::runtime_error(
+                std::format("IPO pass {} failed: {}", pass.name(), e.what()));
+        }
+
+        if (scope.active())
+        {
+            scope.set_nodes_after(count_nodes());
+            scope.add_stats(stats_before, ctx.get_stats());
+
+            /* modules may share a context; count each context's memory once */
+            std::unordered_set<const Context*> contexts;
+            std::size_t memory = 0;
+            for (const Module* module : mods)
+            {
+                if (module && contexts.insert(&module->get_context()).second)
+                    memory += Profiler::memory_bytes(module->get_context());
+            }
+            scope.set_memory_bytes(memory);
+        }
+        return result;
+    }
+
+    std::size_t IPOPassManager::count_nodes() const
+    {
+        std::size_t count = 0;
+        for (const Module* module : mods)
+        {
+            if (module)
+                count += Profiler::count_nodes(*module);
+        }
+        return count;
+    }
+
     IPOPassContext& IPOPassManager::get_context()
     {
         return ctx;
@@ -127,6 +160,11 @@ namespace blm
         verbosity_lvl = level;
     }
 
+    void IPOPassManager::set_profiler(Profiler* profiler)
+    {
+        ctx.set_profiler(profiler);
+    }
+
     void IPOPassManager::print_statistics(std::ostream& os) const
     {
         os << "IPO statistics" << std::endl;
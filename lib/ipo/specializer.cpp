@@ -87,6 +87,8 @@ namespace blm
 				}
 
 				call_site->inputs = new_inputs;
+				if (call_site->parent_region)
+					call_site->parent_region->mark_changed();
 
 				for (Node *new_input: new_inputs)
 				{
@@ -116,6 +118,8 @@ namespace blm
 				}
 
 				call_site->inputs = new_inputs;
+				if (call_site->parent_region)
+					call_site->parent_region->mark_changed();
 
 				for (Node *new_input: new_inputs)
 				{
@@ -242,147 +246,13 @@ namespace blm
 		return cloned;
 	}
 
-	template<typename T>
-	Node *find_or_create_literal(Module &module, T value)
-	{
-		/* search for existing literal with same value in the root region */
-		Region *root = module.get_root_region();
-		for (Node *node : root->get_nodes())
-		{
-			if (node->ir_type != NodeType::LIT)
-				continue;
-
-			/* check if this literal has the same type and value */
-			if constexpr (std::is_same_v<T, bool>)
-			{
-				if (node->type_kind == DataType::BOOL && node->as<DataType::BOOL>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::int8_t>)
-			{
-				if (node->type_kind == DataType::INT8 && node->as<DataType::INT8>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::int16_t>)
-			{
-				if (node->type_kind == DataType::INT16 && node->as<DataType::INT16>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::int32_t>)
-			{
-				if (node->type_kind == DataType::INT32 && node->as<DataType::INT32>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::int64_t>)
-			{
-				if (node->type_kind == DataType::INT64 && node->as<DataType::INT64>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::uint8_t>)
-			{
-				if (node->type_kind == DataType::UINT8 && node->as<DataType::UINT8>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::uint16_t>)
-			{
-				if (node->type_kind == DataType::UINT16 && node->as<DataType::UINT16>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::uint32_t>)
-			{
-				if (node->type_kind == DataType::UINT32 && node->as<DataType::UINT32>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::uint64_t>)
-			{
-				if (node->type_kind == DataType::UINT64 && node->as<DataType::UINT64>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, float>)
-			{
-				if (node->type_kind == DataType::FLOAT32 && node->as<DataType::FLOAT32>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, double>)
-			{
-				if (node->type_kind == DataType::FLOAT64 && node->as<DataType::FLOAT64>() == value)
-					return node;
-			}
-		}
-
-		/* no existing literal found, create a new one */
-		Node *lit = module.get_context().create<Node>();
-		lit->ir_type = NodeType::LIT;
-		lit->parent_region = module.get_root_region();
-
-		/* set type and value based on template parameter */
-		if constexpr (std::is_same_v<T, bool>)
-		{
-			lit->type_kind = DataType::BOOL;
-			lit->data.set<bool, DataType::BOOL>(value);
-		}
-		else if constexpr (std::is_same_v<T, std::int8_t>)
-		{
-			lit->type_kind = DataType::INT8;
-			lit->data.set<std::int8_t, DataType::INT8>(value);
-		}
-		else if constexpr (std::is_same_v<T, std::int16_t>)
-		{
-			lit->type_kind = DataType::INT16;
-			lit->data.set<std::int16_t, DataType::INT16>(value);
-		}
-		else if constexpr (std::is_same_v<T, std::int32_t>)
-		{
-			lit->type_kind = DataType::INT32;
-			lit->data.set<std::int32_t, DataType::INT32>(value);
-		}
-		else if constexpr (std::is_same_v<T, std::int64_t>)
-		{
-			lit->type_kind = DataType::INT64;
-			lit->data.set<std::int64_t, DataType::INT64>(value);
-		}
-		else if constexpr (std::is_same_v<T, std::uint8_t>)
-		{
-			lit->type_kind = DataType::UINT8;
-			lit->data.set<std::uint8_t, DataType::UINT8>(value);
-		}
-		else if constexpr (std::is_same_v<T, std::uint16_t>)
-		{
-			lit->type_kind = DataType::UINT16;
-			lit->data.set<std::uint16_t, DataType::UINT16>(value);
-		}
-		else if constexpr (std::is_same_v<T, std::uint32_t>)
-		{
-			lit->type_kind = DataType::UINT32;
-			lit->data.set<std::uint32_t, DataType::UINT32>(value);
-		}
-		else if constexpr (std::is_same_v<T, std::uint64_t>)
-		{
-			lit->type_kind = DataType::UINT64;
-			lit->data.set<std::uint64_t, DataType::UINT64>(value);
-		}
-		else if constexpr (std::is_same_v<T, float>)
-		{
-			lit->type_kind = DataType::FLOAT32;
-			lit->data.set<float, DataType::FLOAT32>(value);
-		}
-		else if constexpr (std::is_same_v<T, double>)
-		{
-			lit->type_kind = DataType::FLOAT64;
-			lit->data.set<double, DataType::FLOAT64>(value);
-		}
-
-		/* add the new literal to the root region */
-		module.get_root_region()->add_node(lit);
-		return lit;
-	}
-
 	void FunctionSpecializer::substitute_parameters_with_constants(Region *cloned_region,
                                                                const std::vector<std::pair<std::size_t, LatticeValue>> &specialized_params)
 	{
 	    if (!cloned_region || specialized_params.empty())
 	        return;
 
+	    /* collected in region order, which is declaration order */
 	    std::vector<Node *> param_nodes;
 	    for (Node *node: cloned_region->get_nodes())
 	    {
@@ -390,16 +260,6 @@ namespace blm
 	            param_nodes.push_back(node);
 	    }
 
-	    /* sort parameters by declaration order */
-	    std::ranges::sort(param_nodes,
-	                      [&cloned_region](const Node *a, const Node *b)
-	                      {
-	                          const auto &nodes = cloned_region->get_nodes();
-	                          const auto pos_a = std::ranges::find(nodes, a);
-	                          const auto pos_b = std::ranges::find(nodes, b);
-	                          return pos_a < pos_b;
-	                      });
-
 	    for (const auto &[param_idx, constant_val]: specialized_params)
 	    {
 	        if (param_idx >= param_nodes.size() || !constant_val.is_constant())
@@ -407,46 +267,22 @@ namespace blm
 
 	        Node *param = param_nodes[param_idx];
 	        Module &module = cloned_region->get_module();
-	    	Node *literal = nullptr;
-	        switch (param->type_kind)
+	        if (constant_val.value.type() != param->type_kind)
+	            continue;
+
+	        /* the literal is shared across the module, so rewire the uses rather than moving it */
+	        Node *literal = module.intern_literal(constant_val.value);
+	        if (!literal)
+	            continue; /* unsupported type for specialization */
+
+	        for (Node *user: param->users)
 	        {
-	            case DataType::INT8:
-	                literal = find_or_create_literal<std::int8_t>(module, constant_val.value.get<DataType::INT8>());
-	                break;
-	            case DataType::INT16:
-	                literal = find_or_create_literal<std::int16_t>(module, constant_val.value.get<DataType::INT16>());
-	                break;
-	            case DataType::INT32:
-	                literal = find_or_create_literal<std::int32_t>(module, constant_val.value.get<DataType::INT32>());
-	                break;
-	            case DataType::INT64:
-	                literal = find_or_create_literal<std::int64_t>(module, constant_val.value.get<DataType::INT64>());
-	                break;
-	            case DataType::UINT8:
-	                literal = find_or_create_literal<std::uint8_t>(module, constant_val.value.get<DataType::UINT8>());
-	                break;
-	            case DataType::UINT16:
-	                literal = find_or_create_literal<std::uint16_t>(module, constant_val.value.get<DataType::UINT16>());
-	                break;
-	            case DataType::UINT32:
-	                literal = find_or_create_literal<std::uint32_t>(module, constant_val.value.get<DataType::UINT32>());
-	                break;
-	            case DataType::UINT64:
-	                literal = find_or_create_literal<std::uint64_t>(module, constant_val.value.get<DataType::UINT64>());
-	                break;
-	            case DataType::FLOAT32:
-	                literal = find_or_create_literal<float>(module, constant_val.value.get<DataType::FLOAT32>());
-	                break;
-	            case DataType::FLOAT64:
-	                literal = find_or_create_literal<double>(module, constant_val.value.get<DataType::FLOAT64>());
-	                break;
-	            case DataType::BOOL:
-	                literal = find_or_create_literal<bool>(module, constant_val.value.get<DataType::BOOL>());
-	                break;
-	            default:
-	                continue; /* unsupported type for specialization */
+	            std::ranges::replace(user->inputs, param, literal);
+	            if (std::ranges::find(literal->users, user) == literal->users.end())
+	                literal->users.push_back(user);
 	        }
-    		cloned_region->replace_node(param, literal, true);
+	        param->users.clear();
+	        cloned_region->remove_node(param);
 	    }
 	}
 
@@ -528,14 +364,8 @@ namespace blm
 
 		for (const Module *module : modules)
 		{
-			for (const Region *child : module->get_root_region()->get_children())
-			{
-				for (const Node* node : child->get_nodes())
-				{
-					if (node == func)
-						return const_cast<Region *>(child);
-				}
-			}
+			if (Region *region = module->get_function_region(func))
+				return region;
 		}
 
 		return nullptr;
@@ -85,6 +85,7 @@ namespace blm
 
 		Region *func_region = create_region_with_entry(name, current_region);
 		func_region->add_node(func);
+		current_module->set_function_region(func, func_region);
 		return { *this, func, func_region };
 	}
 
@@ -139,23 +140,17 @@ namespace blm
 
 	Node *Builder::literal(const bool value)
 	{
-		Node *lit = create_node(NodeType::LIT, DataType::BOOL);
-		lit->data.set<bool, DataType::BOOL>(value);
-		return lit;
+		return current_module->intern_literal<DataType::BOOL>(value);
 	}
 
 	Node *Builder::literal(const float value)
 	{
-		Node *lit = create_node(NodeType::LIT, DataType::FLOAT32);
-		lit->data.set<float, DataType::FLOAT32>(value);
-		return lit;
+		return current_module->intern_literal<DataType::FLOAT32>(value);
 	}
 
 	Node *Builder::literal(const double value)
 	{
-		Node *lit = create_node(NodeType::LIT, DataType::FLOAT64);
-		lit->data.set<double, DataType::FLOAT64>(value);
-		return lit;
+		return current_module->intern_literal<DataType::FLOAT64>(value);
 	}
 
 	Node *Builder::add(Node *lhs, Node *rhs, const std::optional<DataType> result_type)
@@ -460,8 +455,8 @@ namespace blm
 		Region *true_region = create_region_with_entry(true_name);
 		Region *false_region = create_region_with_entry(false_name);
 
-		Node *true_entry = true_region->get_nodes().empty() ? nullptr : true_region->get_nodes()[0];
-		Node *false_entry = false_region->get_nodes().empty() ? nullptr : false_region->get_nodes()[0];
+		Node *true_entry = true_region->get_nodes().front();
+		Node *false_entry = false_region->get_nodes().front();
 
 		if (true_entry && false_entry)
 			branch(condition, true_entry, false_entry);
@@ -777,16 +777,7 @@ namespace blm
 		if (!func || func->ir_type != NodeType::FUNCTION)
 			return nullptr;
 
-		const Context &ctx = module.get_context();
-		std::string_view func_name = ctx.get_string(func->str_id);
-
-		for (const Region *child: module.get_root_region()->get_children())
-		{
-			if (child->get_name() == func_name)
-				return child;
-		}
-
-		return nullptr;
+		return module.get_function_region(func);
 	}
 
 	bool IRPrinter::is_value_producing(Node *node)
@@ -60,14 +60,8 @@ namespace blm
        os << TREE_SPACE << TREE_LAST << ANSI_WHITE << func_name << "()"
           << (attrs.empty() ? "" : " ") << ANSI_DIM << attrs << ANSI_RESET << "\n";
 
-       for (const Region* child : module.get_root_region()->get_children())
-       {
-           if (child->get_name() == func_name)
-           {
-               print_region(child, 2, true);
-               break;
-           }
-       }
+       if (const Region* func_region = module.get_function_region(func))
+           print_region(func_region, 2, true);
    }
 
    void TreePrinter::print_region(const Region* region, int depth, bool is_last) // NOLINT(*-no-recursion)
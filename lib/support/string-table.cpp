@@ -1,13 +1,22 @@
 /* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
 
+#include <bit>
+#include <cstring>
+#include <mutex>
+#include <new>
 #include <bloom/support/string-table.hpp>
 
 namespace blm
 {
-	StringTable::StringTable() : next_id(1)
+	StringTable::StringTable() : arena(std::make_unique<ach::arena>()), next_id(1)
 	{
-		strs.emplace_back("");
-		strtid[""] = 0;
+		/* id 0 is the empty string and is never looked up in the shards */
+		make_slot(0).store(new (arena->allocate(sizeof(Entry), alignof(Entry))) Entry {}, std::memory_order_release);
+	}
+
+	StringTable::~StringTable()
+	{
+		release_segments();
 	}
 
 	StringTable::StringId StringTable::intern(std::string_view str)
@@ -16,44 +25,109 @@ namespace blm
 		if (str.empty())
 			return 0;
 
+		const std::size_t hash = std::hash<std::string_view> {}(str);
+		Shard &shard = shards[shard_index(hash)];
+
 		/* if already exists */
-		if (const auto it = strtid.find(std::string(str));
-			it != strtid.end())
 		{
-			return it->second;
+			std::shared_lock lock(shard.mutex);
+			if (const auto it = shard.ids.find(str);
+				it != shard.ids.end())
+			{
+				return it->second;
+			}
+		}
+
+		std::unique_lock lock(shard.mutex);
+		if (const auto it = shard.ids.find(str);
+			it != shard.ids.end())
+		{
+			return it->second; /* another thread interned it in between */
 		}
 
-		const StringId nid = next_id++;
-		strs.emplace_back(str);
-		strtid[std::string(str)] = nid;
+		auto *chars = static_cast<char *>(arena->allocate(str.size() + 1, 1));
+		std::memcpy(chars, str.data(), str.size());
+		chars[str.size()] = '\0';
+		const auto *entry = new (arena->allocate(sizeof(Entry), alignof(Entry))) Entry { { chars, str.size() } };
+
+		/* publish the string before the id can be handed out through the shard */
+		const StringId nid = next_id.fetch_add(1, std::memory_order_relaxed);
+		make_slot(nid).store(entry, std::memory_order_release);
+		shard.ids.emplace(entry->view, nid);
 		return nid;
 	}
 
 	std::string_view StringTable::get(const StringId id) const
 	{
-		if (id >= strs.size())
+		const std::atomic<const Entry *> *entry_slot = find_slot(id);
+		if (!entry_slot)
 			return {}; /* invalid id */
-		return strs[id];
+
+		const Entry *entry = entry_slot->load(std::memory_order_acquire);
+		return entry ? entry->view : std::string_view {};
 	}
 
 	bool StringTable::contains(std::string_view str) const
 	{
-		return strtid.contains(std::string(str));
+		if (str.empty())
+			return true;
+
+		const Shard &shard = shards[shard_index(std::hash<std::string_view> {}(str))];
+		std::shared_lock lock(shard.mutex);
+		return shard.ids.contains(str);
 	}
 
 	std::size_t StringTable::size() const
 	{
-		return strs.size();
+		return next_id.load(std::memory_order_acquire);
 	}
 
 	void StringTable::clear()
 	{
-		strs.clear();
-		strtid.clear();
-
-		strs.emplace_back("");
-		strtid[""] = 0;
+		for (Shard &shard: shards)
+			shard.ids.clear();
+		release_segments();
 
+		arena = std::make_unique<ach::arena>();
+		make_slot(0).store(new (arena->allocate(sizeof(Entry), alignof(Entry))) Entry {}, std::memory_order_release);
 		next_id = 1;
 	}
+
+	/* segment s holds FIRST_SEGMENT << s ids starting at FIRST_SEGMENT * (2^s - 1) */
+	const std::atomic<const StringTable::Entry *> *StringTable::find_slot(const StringId id) const
+	{
+		const std::uint64_t scaled = id / FIRST_SEGMENT + 1;
+		const auto segment = static_cast<std::size_t>(std::bit_width(scaled) - 1);
+		if (segment >= SEGMENT_COUNT)
+			return nullptr;
+
+		const std::atomic<const Entry *> *base = segments[segment].load(std::memory_order_acquire);
+		if (!base)
+			return nullptr;
+		return base + (id - FIRST_SEGMENT * ((std::uint64_t { 1 } << segment) - 1));
+	}
+
+	std::atomic<const StringTable::Entry *> &StringTable::make_slot(const StringId id)
+	{
+		const std::uint64_t scaled = id / FIRST_SEGMENT + 1;
+		const auto segment = static_cast<std::size_t>(std::bit_width(scaled) - 1);
+
+		std::atomic<const Entry *> *base = segments[segment].load(std::memory_order_acquire);
+		if (!base)
+		{
+			/* shards create segments independently; the loser of the race frees its copy */
+			auto *fresh = new std::atomic<const Entry *>[FIRST_SEGMENT << segment]();
+			if (segments[segment].compare_exchange_strong(base, fresh, std::memory_order_acq_rel))
+				base = fresh;
+			else
+				delete[] fresh;
+		}
+		return base[id - FIRST_SEGMENT * ((std::uint64_t { 1 } << segment) - 1)];
+	}
+
+	void StringTable::release_segments()
+	{
+		for (auto &segment: segments)
+			delete[] segment.exchange(nullptr, std::memory_order_acq_rel);
+	}
 }
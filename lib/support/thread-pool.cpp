@@ -0,0 +1,93 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <algorithm>
+#include <utility>
+#include <bloom/support/thread-pool.hpp>
+
+namespace blm
+{
+	ThreadPool::ThreadPool(std::size_t threads)
+	{
+		if (threads == 0)
+			threads = std::max(1u, std::thread::hardware_concurrency());
+
+		this->threads.reserve(threads - 1);
+		for (std::size_t worker = 1; worker < threads; ++worker)
+			this->threads.emplace_back([this, worker] { work_loop(worker); });
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard lock(mutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		for (std::thread &thread: threads)
+			thread.join();
+	}
+
+	void ThreadPool::parallel_for(const std::size_t count, const std::function<void(std::size_t, std::size_t)> &fn)
+	{
+		if (threads.empty() || count <= 1)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+				fn(i, 0);
+			return;
+		}
+
+		{
+			std::lock_guard lock(mutex);
+			job = &fn;
+			job_size = count;
+			next_index = 0;
+			active = threads.size();
+			++job_epoch;
+		}
+		wake.notify_all();
+		run_share(0);
+
+		std::unique_lock lock(mutex);
+		idle.wait(lock, [this] { return active == 0; });
+		job = nullptr;
+		if (error)
+			std::rethrow_exception(std::exchange(error, nullptr));
+	}
+
+	void ThreadPool::work_loop(const std::size_t worker)
+	{
+		std::uint64_t seen = 0;
+		std::unique_lock lock(mutex);
+		while (true)
+		{
+			wake.wait(lock, [&] { return stopping || job_epoch != seen; });
+			if (stopping)
+				return;
+
+			seen = job_epoch;
+			lock.unlock();
+			run_share(worker);
+			lock.lock();
+			if (--active == 0)
+				idle.notify_one();
+		}
+	}
+
+	void ThreadPool::run_share(const std::size_t worker)
+	{
+		for (std::size_t i = next_index++; i < job_size; i = next_index++)
+		{
+			try
+			{
+				(*job)(i, worker);
+			}
+			catch (...)
+			{
+				std::lock_guard lock(mutex);
+				if (!error)
+					error = std::current_exception();
+				next_index = job_size;
+			}
+		}
+	}
+}
@@ -21,13 +21,14 @@ namespace blm
 	bool ADCEPass::run(Module& m, PassContext& ctx)
 	{
 		reachable_regions.clear();
-		live_nodes.clear();
+		live_nodes = NodeBitVector(m.get_numbering());
 		dead_regions.clear();
 
 		mark_reachable_regions(m);
 		mark_live_nodes(m);
 		const std::size_t removed_regions = remove_unreachable_regions(m);
 		const std::size_t removed_nodes = remove_dead_nodes(m);
+		live_nodes = {};
 		const auto total_removed = removed_regions + removed_nodes;
 		ctx.update_stat("adce.removed_regions", removed_regions);
 		ctx.update_stat("adce.removed_nodes", removed_nodes);
@@ -40,7 +41,7 @@ namespace blm
 		{
 			if (func->ir_type == NodeType::FUNCTION)
 			{
-				if (const Region* func_region = find_function_region(func, m))
+				if (const Region* func_region = m.get_function_region(func))
 					mark_region_reachable(m, func_region);
 			}
 		}
@@ -87,7 +88,7 @@ namespace blm
 					/* calls can reach other functions */
 					if (!node->inputs.empty())
 					{
-						if (Region* callee_region = find_function_region(node->inputs[0], m))
+						if (Region* callee_region = m.get_function_region(node->inputs[0]))
 							mark_region_reachable(m, callee_region);
 					}
 					break;
@@ -129,7 +130,7 @@ namespace blm
 			worklist.pop();
 			for (Node* input : current->inputs)
 			{
-				if (input && live_nodes.insert(input).second)
+				if (live_nodes.insert(input))
 					worklist.push(input); /* live node */
 			}
 		}
@@ -185,11 +186,12 @@ namespace blm
 		/* actually remove dead regions from their parents */
 		for (Region* dead_region : dead_regions)
 		{
-			if (const Region* parent = dead_region->get_parent())
+			if (Region* parent = dead_region->get_parent())
 			{
 				/* remove from parent's children list */
 				auto& children = const_cast<std::vector<Region*>&>(parent->get_children());
 				std::erase(children, dead_region);
+				parent->mark_changed();
 			}
 		}
 
@@ -239,30 +241,4 @@ namespace blm
 		}
 		region->remove_node(node); /* remove from region */
 	}
-
-	Region* ADCEPass::find_function_region(Node* function, Module& m) const
-	{
-		if (!function || function->ir_type != NodeType::FUNCTION)
-			return nullptr;
-
-		const std::string_view func_name = m.get_context().get_string(function->str_id);
-		return find_region_by_name(m.get_root_region(), func_name); /* search for a region with matching name */
-	}
-
-	Region* ADCEPass::find_region_by_name(const Region* region, std::string_view name) const // NOLINT(*-no-recursion)
-	{
-		if (!region)
-			return nullptr;
-
-		if (region->get_name() == name)
-			return const_cast<Region*>(region);
-
-		for (const Region* child : region->get_children())
-		{
-			if (Region* found = find_region_by_name(child, name))
-				return found;
-		}
-
-		return nullptr;
-	}
 }
@@ -1,5 +1,6 @@
 /* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
 
+#include <algorithm>
 #include <cmath>
 #include <bloom/foundation/context.hpp>
 #include <bloom/foundation/module.hpp>
@@ -9,134 +10,36 @@
 
 namespace blm
 {
+	/* folded constants are shared through the module literal pool, which already places
+	 * them in the root region; the target region and insertion point are kept so the
+	 * folding helpers keep one signature */
 	template<typename T>
-	Node *find_or_create_literal(Module &module, T value, Region *target_region, Node *insert_before = nullptr)
+	Node *find_or_create_literal(Module &module, T value, Region *, Node * = nullptr)
 	{
-		if (!target_region)
-			target_region = module.get_root_region();
-
-		for (Node *node: target_region->get_nodes())
-		{
-			if (node->ir_type != NodeType::LIT)
-				continue;
-
-			if constexpr (std::is_same_v<T, bool>)
-			{
-				if (node->type_kind == DataType::BOOL && node->as<DataType::BOOL>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::int8_t>)
-			{
-				if (node->type_kind == DataType::INT8 && node->as<DataType::INT8>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::int16_t>)
-			{
-				if (node->type_kind == DataType::INT16 && node->as<DataType::INT16>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::int32_t>)
-			{
-				if (node->type_kind == DataType::INT32 && node->as<DataType::INT32>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::int64_t>)
-			{
-				if (node->type_kind == DataType::INT64 && node->as<DataType::INT64>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::uint8_t>)
-			{
-				if (node->type_kind == DataType::UINT8 && node->as<DataType::UINT8>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::uint16_t>)
-			{
-				if (node->type_kind == DataType::UINT16 && node->as<DataType::UINT16>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::uint32_t>)
-			{
-				if (node->type_kind == DataType::UINT32 && node->as<DataType::UINT32>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, std::uint64_t>)
-			{
-				if (node->type_kind == DataType::UINT64 && node->as<DataType::UINT64>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, float>)
-			{
-				if (node->type_kind == DataType::FLOAT32 && node->as<DataType::FLOAT32>() == value)
-					return node;
-			}
-			else if constexpr (std::is_same_v<T, double>)
-			{
-				if (node->type_kind == DataType::FLOAT64 && node->as<DataType::FLOAT64>() == value)
-					return node;
-			}
-		}
-
-		Node *lit = module.get_context().create<Node>();
-		lit->ir_type = NodeType::LIT;
-
 		if constexpr (std::is_same_v<T, bool>)
-		{
-			lit->type_kind = DataType::BOOL;
-			lit->data.set<bool, DataType::BOOL>(value);
-		}
+			return module.intern_literal<DataType::BOOL>(value);
 		else if constexpr (std::is_same_v<T, std::int8_t>)
-		{
-			lit->type_kind = DataType::INT8;
-			lit->data.set<std::int8_t, DataType::INT8>(value);
-		}
+			return module.intern_literal<DataType::INT8>(value);
 		else if constexpr (std::is_same_v<T, std::int16_t>)
-		{
-			lit->type_kind = DataType::INT16;
-			lit->data.set<std::int16_t, DataType::INT16>(value);
-		}
+			return module.intern_literal<DataType::INT16>(value);
 		else if constexpr (std::is_same_v<T, std::int32_t>)
-		{
-			lit->type_kind = DataType::INT32;
-			lit->data.set<std::int32_t, DataType::INT32>(value);
-		}
+			return module.intern_literal<DataType::INT32>(value);
 		else if constexpr (std::is_same_v<T, std::int64_t>)
-		{
-			lit->type_kind = DataType::INT64;
-			lit->data.set<std::int64_t, DataType::INT64>(value);
-		}
+			return module.intern_literal<DataType::INT64>(value);
 		else if constexpr (std::is_same_v<T, std::uint8_t>)
-		{
-			lit->type_kind = DataType::UINT8;
-			lit->data.set<std::uint8_t, DataType::UINT8>(value);
-		}
+			return module.intern_literal<DataType::UINT8>(value);
 		else if constexpr (std::is_same_v<T, std::uint16_t>)
-		{
-			lit->type_kind = DataType::UINT16;
-			lit->data.set<std::uint16_t, DataType::UINT16>(value);
-		}
+			return module.intern_literal<DataType::UINT16>(value);
 		else if constexpr (std::is_same_v<T, std::uint32_t>)
-		{
-			lit->type_kind = DataType::UINT32;
-			lit->data.set<std::uint32_t, DataType::UINT32>(value);
-		}
+			return module.intern_literal<DataType::UINT32>(value);
 		else if constexpr (std::is_same_v<T, std::uint64_t>)
-		{
-			lit->type_kind = DataType::UINT64;
-			lit->data.set<std::uint64_t, DataType::UINT64>(value);
-		}
+			return module.intern_literal<DataType::UINT64>(value);
 		else if constexpr (std::is_same_v<T, float>)
-		{
-			lit->type_kind = DataType::FLOAT32;
-			lit->data.set<float, DataType::FLOAT32>(value);
-		}
+			return module.intern_literal<DataType::FLOAT32>(value);
 		else if constexpr (std::is_same_v<T, double>)
-		{
-			lit->type_kind = DataType::FLOAT64;
-			lit->data.set<double, DataType::FLOAT64>(value);
-		}
-
-		return lit;
+			return module.intern_literal<DataType::FLOAT64>(value);
+		else
+			static_assert(sizeof(T) == 0, "unsupported literal type");
 	}
 
 	template<typename T, DataType DT>
@@ -229,106 +132,170 @@ namespace blm
 		return "evaluates and replaces constant expressions with their computed values";
 	}
 
+	PreservedAnalyses ConstantFoldingPass::preserved_analyses() const
+	{
+		if (folded_branch)
+			return PreservedAnalyses::none();
+		return PreservedAnalyses::none().preserve_cfg();
+	}
+
+	void ConstantFoldingPass::prepare(Module &, PassContext &)
+	{
+		folded_branch = false;
+	}
+
 	bool ConstantFoldingPass::run(Module &module, PassContext &context)
 	{
 		current_module = &module;
-		std::size_t folded = process_region(module.get_root_region());
-		for (const Node *fn: module.get_functions())
+		folded_branch = false;
+		const NodeNumbering &numbering = module.get_numbering();
+		queued = NodeBitVector(numbering);
+		removed = NodeBitVector(numbering);
+
+		/* the numbering covers the root region tree and every function body */
+		for (Node *node: numbering.get_nodes())
 		{
-			if (fn->ir_type != NodeType::FUNCTION)
-				continue;
+			if (is_foldable(node))
+				enqueue(node);
+		}
+		return drain_worklist(context);
+	}
 
-			for (Region *region: module.get_root_region()->get_children())
+	bool ConstantFoldingPass::run_on_function(const FunctionUnit &unit, PassContext &context)
+	{
+		current_module = &unit.module;
+		const NodeRange range = unit.numbering.range_of(unit.body);
+		queued = NodeBitVector(unit.numbering, range);
+		removed = NodeBitVector(unit.numbering, range);
+
+		/* walk the body itself; its range misses nodes created since it was numbered */
+		std::vector<const Region *> regions { unit.body };
+		while (!regions.empty())
+		{
+			const Region *region = regions.back();
+			regions.pop_back();
+			for (Node *node: region->get_nodes())
 			{
-				if (region->get_name() == module.get_context().get_string(fn->str_id))
-				{
-					folded += process_region(region);
-					break;
-				}
+				if (is_foldable(node))
+					enqueue(node);
 			}
+			regions.insert(regions.end(), region->get_children().begin(), region->get_children().end());
+		}
+		return drain_worklist(context);
+	}
+
+	std::unique_ptr<FunctionPass> ConstantFoldingPass::clone() const
+	{
+		return std::make_unique<ConstantFoldingPass>();
+	}
+
+	bool ConstantFoldingPass::drain_worklist(PassContext &context)
+	{
+		std::size_t folded = 0;
+		while (!worklist.empty())
+		{
+			Node *node = worklist.front();
+			worklist.pop();
+			queued.erase(node);
+
+			if (node->parent_region && is_foldable(node) && fold(node))
+				folded++;
 		}
 
+		drop_removed_users();
+		queued = {};
+		removed = {};
+		current_module = nullptr;
 		context.update_stat("constant_folding.folded_nodes", folded);
 		return folded > 0;
 	}
 
-	std::size_t ConstantFoldingPass::process_region(Region *region)
+	void ConstantFoldingPass::enqueue(Node *node)
+	{
+		/* nodes outside the numbering cannot be tracked and are simply queued again */
+		if (queued.insert(node) || !queued.contains(node))
+			worklist.push(node);
+	}
+
+	bool ConstantFoldingPass::is_foldable(const Node *node) const
 	{
-		if (!region)
-			return 0;
+		return node->ir_type != NodeType::LIT &&
+		       (node->props & NodeProps::NO_OPTIMIZE) == NodeProps::NONE &&
+		       is_constant(node);
+	}
 
-		std::size_t total_folded = 0;
-		bool changed = true;
-		while (changed)
-		{
-			changed = false;
-			for (std::vector<Node *> nodes = region->get_nodes();
-			     Node *node: nodes)
-			{
-				if (!is_constant(node) ||
-				    node->ir_type == NodeType::LIT ||
-				    (node->props & NodeProps::NO_OPTIMIZE) != NodeProps::NONE)
-				{
-					continue;
-				}
+	bool ConstantFoldingPass::fold(Node *node)
+	{
+		Node *folded_node = nullptr;
+		if (has_global_inputs(node) && (node->props & NodeProps::EXPORT) != NodeProps::NONE)
+			folded_node = create_copy_propagation_node(node);
+		else
+			folded_node = create_folded_node(node);
 
-				Node *folded_node = nullptr;
-				if (has_global_inputs(node) && (node->props & NodeProps::EXPORT) != NodeProps::NONE)
-				{
-					folded_node = create_copy_propagation_node(node);
-				}
-				else
-				{
-					folded_node = create_folded_node(node);
-				}
+		if (!folded_node)
+			return false;
 
-				if (!folded_node)
-					continue;
+		if (node->ir_type == NodeType::BRANCH)
+			folded_branch = true;
+
+		if (folded_node->parent_region == nullptr)
+			node->parent_region->insert_node_before(node, folded_node);
+
+		/* the folded value is usually a pooled literal that other functions use as well */
+		const auto lock = current_module->lock_shared_users();
+		for (Node *user: node->users)
+		{
+			if (removed.contains(user))
+				continue;
 
-				if (node->parent_region)
+			for (std::size_t i = 0; i < user->inputs.size(); i++)
+			{
+				if (user->inputs[i] == node)
 				{
-					if (folded_node->parent_region == nullptr)
-					{
-						node->parent_region->insert_node_before(node, folded_node);
-					}
-
-					for (Node *user: node->users)
-					{
-						for (std::size_t i = 0; i < user->inputs.size(); i++)
-						{
-							if (user->inputs[i] == node)
-							{
-								user->inputs[i] = folded_node;
-								if (std::ranges::find(folded_node->users, user) == folded_node->users.end())
-									folded_node->users.push_back(user);
-							}
-						}
-					}
-
-					for (Node *input: node->inputs)
-					{
-						auto &input_users = input->users;
-						std::erase(input_users, node);
-					}
-
-					node->parent_region->remove_node(node);
-					total_folded++;
-					changed = true;
+					user->inputs[i] = folded_node;
+					if (std::ranges::find(folded_node->users, user) == folded_node->users.end())
+						folded_node->users.push_back(user);
 				}
 			}
+
+			/* an input of the user just became a constant */
+			if (user->parent_region)
+				user->parent_region->mark_changed();
+			enqueue(user);
+		}
+
+		/* shared literals can have a user per folded node; unlinking those one by one
+		 * is quadratic, so they are unlinked in one sweep at the end */
+		if (removed.insert(node))
+			stale_inputs.insert(stale_inputs.end(), node->inputs.begin(), node->inputs.end());
+		else
+		{
+			for (Node *input: node->inputs)
+				std::erase(input->users, node);
 		}
 
-		for (Region *child: region->get_children())
-			total_folded += process_region(child);
+		node->parent_region->remove_node(node);
+		return true;
+	}
 
-		return total_folded;
+	void ConstantFoldingPass::drop_removed_users()
+	{
+		std::ranges::sort(stale_inputs);
+		const auto [first, last] = std::ranges::unique(stale_inputs);
+		stale_inputs.erase(first, last);
+
+		const auto lock = current_module->lock_shared_users();
+		for (Node *input: stale_inputs)
+			std::erase_if(input->users, [this](const Node *user) { return removed.contains(user); });
+		stale_inputs.clear();
 	}
 
 	bool ConstantFoldingPass::has_global_inputs(const Node *node) const
 	{
 		for (const Node *input: node->inputs)
 		{
-			if (input->parent_region == current_module->get_root_region())
+			/* pooled literals live in the root region too but are not globals */
+			if (input->ir_type != NodeType::LIT && input->parent_region == current_module->get_root_region())
 				return true;
 		}
 		return false;
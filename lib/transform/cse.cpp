@@ -1,5 +1,6 @@
 /* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
 
+#include <algorithm>
 #include <cstring>
 #include <bloom/analysis/laa.hpp>
 #include <bloom/foundation/context.hpp>
@@ -18,6 +19,12 @@ namespace blm
 		return "eliminates redundant computations by reusing previously computed values";
 	}
 
+	PreservedAnalyses CSEPass::preserved_analyses() const
+	{
+		/* terminators are never merged */
+		return PreservedAnalyses::none().preserve_cfg();
+	}
+
 	std::vector<const std::type_info *> CSEPass::required_passes() const
 	{
 		return get_pass_types<LocalAliasAnalysisPass>();
@@ -25,26 +32,47 @@ namespace blm
 
 	bool CSEPass::run(Module &m, PassContext &ctx)
 	{
-		const auto *alias_result = ctx.get_result<LocalAliasResult>();
+		const LocalAliasResult &alias_result = get_local_alias_result(m, ctx);
+
+		current_module = &m;
+		value_numbers = NodeMap<ValueNumber>(m.get_numbering());
+		expression_to_node.clear();
+		next_value_number = 1;
+
+		const auto eliminated = static_cast<std::int64_t>(process_function(m, alias_result));
+		value_numbers = {};
+		ctx.update_stat("cse.eliminated_expressions", eliminated);
+		return eliminated > 0;
+	}
+
+	void CSEPass::prepare(Module &m, PassContext &ctx)
+	{
+		/* computed up front so workers only read it; function results are filled in on demand */
+		get_local_alias_result(m, ctx);
+	}
 
-		std::unique_ptr<LocalAliasResult> local_result;
+	bool CSEPass::run_on_function(const FunctionUnit &unit, PassContext &ctx)
+	{
+		const auto *alias_result = ctx.get_result<LocalAliasResult>(typeid(LocalAliasAnalysisPass));
 		if (!alias_result)
-		{
-			LocalAliasAnalysisPass laa;
-			local_result = std::unique_ptr<LocalAliasResult>(
-				dynamic_cast<LocalAliasResult *>(laa.analyze(m, ctx).release()));
-			alias_result = local_result.get();
-		}
+			alias_result = &get_local_alias_result(unit.module, ctx);
 
-		value_numbers.clear();
+		current_module = &unit.module;
+		value_numbers = NodeMap<ValueNumber>(unit.numbering, unit.numbering.range_of(unit.body));
 		expression_to_node.clear();
 		next_value_number = 1;
 
-		const auto eliminated = static_cast<std::int64_t>(process_function(m, *alias_result));
+		const auto eliminated = static_cast<std::int64_t>(process_region(unit.body, *alias_result));
+		value_numbers = {};
 		ctx.update_stat("cse.eliminated_expressions", eliminated);
 		return eliminated > 0;
 	}
 
+	std::unique_ptr<FunctionPass> CSEPass::clone() const
+	{
+		return std::make_unique<CSEPass>();
+	}
+
 	std::size_t CSEPass::process_function(Module &module, const LocalAliasResult &alias_result)
 	{
 		std::size_t eliminated = 0;
@@ -54,14 +82,8 @@ namespace blm
 			if (func_node->ir_type != NodeType::FUNCTION)
 				continue;
 
-			for (const Region *child : module.get_root_region()->get_children())
-			{
-				if (child->get_name() == module.get_context().get_string(func_node->str_id))
-				{
-					eliminated += process_region(child, alias_result);
-					break;
-				}
-			}
+			if (const Region *func_region = module.get_function_region(func_node))
+				eliminated += process_region(func_region, alias_result);
 		}
 
 		eliminated += process_region(module.get_root_region(), alias_result);
@@ -94,7 +116,7 @@ namespace blm
 						continue;
 				}
 
-				if (replace_all_uses(node, existing))
+				if (replace_all_uses(*current_module, node, existing))
 				{
 					eliminated++;
 					continue;
@@ -102,7 +124,8 @@ namespace blm
 			}
 
 			expression_to_node[vn] = node;
-			value_numbers[node] = vn;
+			if (ValueNumber *slot = value_numbers.find(node))
+				*slot = vn;
 		}
 
 		for (const Region *child : region->get_children())
@@ -115,8 +138,8 @@ namespace blm
 
 	ValueNumber CSEPass::compute_value_number(Node *node, const LocalAliasResult &alias_result)
 	{
-		if (auto it = value_numbers.find(node); it != value_numbers.end())
-			return it->second;
+		if (const ValueNumber known = value_numbers.get(node); known != 0)
+			return known;
 
 		ValueNumber vn = 0;
 		if (node->ir_type == NodeType::LIT)
@@ -128,12 +151,22 @@ namespace blm
 		else
 			vn = next_value_number++;
 
-		if (vn != 0)
-			value_numbers[node] = vn;
+		if (ValueNumber *slot = value_numbers.find(node); slot && vn != 0)
+			*slot = vn;
 
 		return vn;
 	}
 
+	ValueNumber CSEPass::get_input_value_number(Node *input) const
+	{
+		if (const ValueNumber known = value_numbers.get(input); known != 0)
+			return known;
+
+		if (input->ir_type == NodeType::LIT && !value_numbers.find(input))
+			return compute_literal_value_number(input);
+		return 0;
+	}
+
 	ValueNumber CSEPass::compute_literal_value_number(Node *node)
 	{
 		/* note: there was once a mysterious hash-related bug here that
@@ -207,7 +240,7 @@ namespace blm
 		input_vns.reserve(node->inputs.size());
 		for (Node *input : node->inputs)
 		{
-			ValueNumber input_vn = value_numbers.contains(input) ? value_numbers[input] : 0;
+			const ValueNumber input_vn = get_input_value_number(input);
 			if (input_vn == 0)
 				return 0;
 			input_vns.push_back(input_vn);
@@ -236,7 +269,7 @@ namespace blm
 		if (!address)
 			return next_value_number++;
 
-		ValueNumber addr_vn = value_numbers.contains(address) ? value_numbers[address] : 0;
+		const ValueNumber addr_vn = get_input_value_number(address);
 		if (addr_vn == 0)
 			return 0;
 
@@ -258,7 +291,7 @@ namespace blm
 		if (node->ir_type == NodeType::ATOMIC_LOAD && node->inputs.size() > 1)
 		{
 			Node *ordering = node->inputs[1];
-			const ValueNumber ordering_vn = value_numbers.contains(ordering) ? value_numbers[ordering] : 0;
+			const ValueNumber ordering_vn = get_input_value_number(ordering);
 			if (ordering_vn == 0)
 				return 0;  /* can't compute value number without ordering */
 			hash = (hash * 31) + ordering_vn;
@@ -281,13 +314,8 @@ namespace blm
 
 	bool CSEPass::are_equivalent_expressions(Node *a, Node *b)
 	{
-		const auto a_vn = value_numbers.find(a);
-		const auto b_vn = value_numbers.find(b);
-
-		if (a_vn == value_numbers.end() || b_vn == value_numbers.end())
-			return false;
-
-		return a_vn->second == b_vn->second;
+		const ValueNumber a_vn = value_numbers.get(a);
+		return a_vn != 0 && a_vn == value_numbers.get(b);
 	}
 
 	bool CSEPass::is_commutative(const NodeType type)
@@ -396,11 +424,13 @@ namespace blm
 		return alias_result.may_alias(addr_a, addr_b);
 	}
 
-	bool CSEPass::replace_all_uses(Node *node_to_replace, Node *replacement_node)
+	bool CSEPass::replace_all_uses(Module &module, Node *node_to_replace, Node *replacement_node)
 	{
 		if (node_to_replace == replacement_node || node_to_replace->ir_type == NodeType::ENTRY)
 			return false;
 
+		/* the replacement may be a pooled literal used by other functions as well */
+		const auto lock = module.lock_shared_users();
 		for (const std::vector<Node *> users_copy = node_to_replace->users;
 		     Node *user : users_copy)
 		{
@@ -413,6 +443,9 @@ namespace blm
 						replacement_node->users.push_back(user);
 				}
 			}
+
+			if (user->parent_region)
+				user->parent_region->mark_changed();
 		}
 
 		node_to_replace->users.clear();
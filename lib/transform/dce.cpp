@@ -21,35 +21,58 @@ namespace blm
 		return "eliminates code that has no observable effects";
 	}
 
+	PreservedAnalyses DCEPass::preserved_analyses() const
+	{
+		/* only removes nodes that are not terminators */
+		return PreservedAnalyses::none().preserve_cfg();
+	}
+
 	bool DCEPass::run(Module &m, PassContext &ctx)
 	{
-		alive.clear();
+		const NodeNumbering &numbering = m.get_numbering();
+		alive = NodeBitVector(numbering);
 		dead.clear();
 
-		find_live_nodes(m.get_root_region());
+		find_live_nodes(numbering, m.get_root_region());
 		for (const Node *fn: m.get_functions())
 		{
 			if (fn->ir_type != NodeType::FUNCTION)
 				continue;
 
-			for (const Region *c: m.get_root_region()->get_children())
-			{
-				if (c->get_name() == m.get_context().get_string(fn->str_id))
-				{
-					find_live_nodes(c);
-					break;
-				}
-			}
+			if (const Region *c = m.get_function_region(fn))
+				find_live_nodes(numbering, c);
 		}
 
-		find_dead_nodes(m.get_root_region());
-		const auto removed = static_cast<std::int64_t>(remove_dead_nodes(m.get_root_region()));
+		find_dead_nodes(numbering, m.get_root_region());
+		alive = {};
+		unnumbered_alive.clear();
+		const auto removed = static_cast<std::int64_t>(remove_dead_nodes(m));
+
+		ctx.update_stat("dce.removed_nodes", removed);
+		return removed > 0;
+	}
+
+	bool DCEPass::run_on_function(const FunctionUnit &unit, PassContext &ctx)
+	{
+		alive = NodeBitVector(unit.numbering, unit.numbering.range_of(unit.body));
+		dead.clear();
+
+		find_live_nodes(unit.numbering, unit.body);
+		find_dead_nodes(unit.numbering, unit.body);
+		alive = {};
+		unnumbered_alive.clear();
+		const auto removed = static_cast<std::int64_t>(remove_dead_nodes(unit.module));
 
 		ctx.update_stat("dce.removed_nodes", removed);
 		return removed > 0;
 	}
 
-	void DCEPass::find_live_nodes(const Region *region) // NOLINT(*-no-recursion)
+	std::unique_ptr<FunctionPass> DCEPass::clone() const
+	{
+		return std::make_unique<DCEPass>();
+	}
+
+	void DCEPass::find_live_nodes(const NodeNumbering &numbering, const Region *region) // NOLINT(*-no-recursion)
 	{
 		if (!region)
 			return;
@@ -71,55 +94,48 @@ namespace blm
 
 			for (Node *input: current->inputs)
 			{
-				/* node was not previously marked alive */
-				if (alive.insert(input).second)
+				/* node was not previously marked alive; nodes created after the numbering
+				 * have no bit and are tracked on the side */
+				if (alive.insert(input) || (!numbering.contains(input) && unnumbered_alive.insert(input).second))
 					worklist.push(input);
 			}
 		}
 
 		for (const Region *child: region->get_children())
-			find_live_nodes(child);
+			find_live_nodes(numbering, child);
 	}
 
-	void DCEPass::find_dead_nodes(const Region *region) // NOLINT(*-no-recursion)
+	void DCEPass::find_dead_nodes(const NodeNumbering &numbering, const Region *region)
 	{
-		if (!region)
-			return;
-
-		/* any node that isn't in the alive set is considered dead */
-		for (Node *node: region->get_nodes())
+		/* any node of the region tree that isn't in the alive set is considered dead; the
+		 * tree is one contiguous range of the numbering. slots of nodes removed since the
+		 * numbering was assigned are skipped */
+		const NodeRange range = numbering.range_of(region);
+		for (NodeId i = range.begin; i < range.end; ++i)
 		{
-			if (!alive.contains(node))
-				dead.insert(node);
+			if (Node *node = numbering[i]; node->parent_region && !alive.contains(node))
+				dead.push_back(node);
 		}
-
-		for (const Region *child: region->get_children())
-			find_dead_nodes(child);
 	}
 
-	std::size_t DCEPass::remove_dead_nodes(Region *region) // NOLINT(*-no-recursion)
+	std::size_t DCEPass::remove_dead_nodes(Module &m)
 	{
-		if (!region || dead.empty())
-			return 0;
-
-		std::size_t removed = 0;
 		for (Node *node: dead)
 		{
-			/* remove from users list of all inputs */
-			for (Node *input: node->inputs)
+			/* remove from users list of all inputs; those may be shared with other functions */
 			{
-				auto &users = input->users;
-				std::erase(users, node);
+				const auto lock = m.lock_shared_users();
+				for (Node *input: node->inputs)
+				{
+					auto &users = input->users;
+					std::erase(users, node);
+				}
 			}
 
-			/* remove from this region if it belongs here */
-			region->remove_node(node);
-			removed++;
+			if (Region *region = node->parent_region)
+				region->remove_node(node);
 		}
-
-		for (Region *child: region->get_children())
-			remove_dead_nodes(child);
-		return removed;
+		return dead.size();
 	}
 
 	bool DCEPass::is_root_node(const Node *node)
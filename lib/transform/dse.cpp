@@ -1,6 +1,8 @@
 /* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
 
 #include <bloom/analysis/laa.hpp>
+#include <bloom/foundation/context.hpp>
+#include <bloom/foundation/module.hpp>
 #include <bloom/foundation/pass-context.hpp>
 #include <bloom/foundation/region.hpp>
 #include <bloom/support/relation.hpp>
@@ -18,6 +20,12 @@ namespace blm
 		return "removes stores that are never read before being overwritten";
 	}
 
+	PreservedAnalyses DSEPass::preserved_analyses() const
+	{
+		/* only stores are removed */
+		return PreservedAnalyses::none().preserve_cfg();
+	}
+
 	std::vector<const std::type_info *> DSEPass::required_passes() const
 	{
 		return get_pass_types<LocalAliasAnalysisPass>();
@@ -25,18 +33,12 @@ namespace blm
 
 	bool DSEPass::run(Module &m, PassContext &ctx)
 	{
-		const auto *alias_result = ctx.get_result<LocalAliasResult>();
-		std::unique_ptr<LocalAliasResult> local_result;
-		if (!alias_result)
-		{
-			LocalAliasAnalysisPass laa;
-			local_result = std::unique_ptr<LocalAliasResult>(
-				dynamic_cast<LocalAliasResult *>(laa.analyze(m, ctx).release()));
-			alias_result = local_result.get();
-		}
+		const LocalAliasResult &alias_result = get_local_alias_result(m, ctx);
 
 		dead_stores.clear();
-		const auto removed = static_cast<std::int64_t>(process_region(m.get_root_region(), *alias_result));
+		layout = &m.get_context().get_data_layout();
+		const auto removed = static_cast<std::int64_t>(process_region(m.get_root_region(), alias_result));
+		layout = nullptr;
 		ctx.update_stat("dse.removed_stores", removed);
 
 		return removed > 0;
@@ -251,16 +253,18 @@ namespace blm
 			return false;
 		}
 
+		const std::uint64_t old_width = get_store_width(old_store, *old_loc);
+		const std::uint64_t new_width = get_store_width(new_store, *new_loc);
 		const std::int64_t old_start = old_loc->offset;
-		const std::int64_t old_end = old_start + static_cast<std::int64_t>(old_loc->size);
+		const std::int64_t old_end = old_start + static_cast<std::int64_t>(old_width);
 		const std::int64_t new_start = new_loc->offset;
-		if (const std::int64_t new_end = new_start + static_cast<int64_t>(new_loc->size);
+		if (const std::int64_t new_end = new_start + static_cast<int64_t>(new_width);
 			new_start <= old_start && new_end >= old_end)
 		{
 			return true; /* new store completely overwrites old store */
 		}
 
-		if (old_loc->size == new_loc->size &&
+		if (old_width == new_width &&
 		    old_start == new_start &&
 		    get_store_value_type(old_store) == get_store_value_type(new_store))
 		{
@@ -275,4 +279,11 @@ namespace blm
 			return DataType::VOID;
 		return store->inputs[0]->type_kind;
 	}
+
+	std::uint64_t DSEPass::get_store_width(Node *store, const MemoryLocation &loc) const
+	{
+		if (const std::uint64_t width = layout->get_size(get_store_value_type(store)))
+			return width;
+		return loc.size;
+	}
 }
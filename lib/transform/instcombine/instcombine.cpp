@@ -1,6 +1,6 @@
 /* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
 
-#include <unordered_set>
+#include <algorithm>
 #include <bloom/foundation/module.hpp>
 #include <bloom/foundation/pass-context.hpp>
 #include <bloom/foundation/region.hpp>
@@ -18,417 +18,614 @@ namespace blm
 		return "simplifies expressions using algebraic identities and strength reduction";
 	}
 
-	bool InstcombinePass::run(Module &m, PassContext &ctx)
+	PreservedAnalyses InstcombinePass::preserved_analyses() const
 	{
-		const auto simplified = static_cast<std::int64_t>(process_region(m.get_root_region()));
-		ctx.update_stat("agbs.simplified_expressions", simplified);
-		return simplified > 0;
+		/* control flow is never rewritten */
+		return PreservedAnalyses::none().preserve_cfg();
 	}
 
-	std::size_t InstcombinePass::process_region(Region *region) // NOLINT(*-no-recursion)
+	bool InstcombinePass::run(Module &m, PassContext &ctx)
 	{
-		if (!region)
-			return 0;
+		current_module = &m;
+		const NodeNumbering &numbering = m.get_numbering();
+		queued = NodeBitVector(numbering);
+		removed = NodeBitVector(numbering);
 
-		std::size_t simplified = 0;
-		std::vector<Node *> nodes_copy = region->get_nodes();
-		std::unordered_set<Node *> processed;
-		for (Node *node : nodes_copy)
+		/* the numbering covers the root region tree and every function body */
+		for (Node *node: numbering.get_nodes())
 		{
-			if (!node || node->users.empty() || processed.contains(node))
-				continue;
+			if (!node->users.empty())
+				enqueue(node);
+		}
+		return drain_worklist(ctx);
+	}
+
+	bool InstcombinePass::run_on_function(const FunctionUnit &unit, PassContext &ctx)
+	{
+		current_module = &unit.module;
+		const NodeRange range = unit.numbering.range_of(unit.body);
+		queued = NodeBitVector(unit.numbering, range);
+		removed = NodeBitVector(unit.numbering, range);
+
+		/* walk the body itself; its range misses nodes created since it was numbered */
+		enqueue_region(unit.body);
+		return drain_worklist(ctx);
+	}
 
-			processed.insert(node);
+	std::unique_ptr<FunctionPass> InstcombinePass::clone() const
+	{
+		return std::make_unique<InstcombinePass>();
+	}
 
-			if (Node *simplified_node = simplify_node(node, region);
-				simplified_node && simplified_node != node)
+	void InstcombinePass::enqueue_region(const Region *region)
+	{
+		std::vector regions { region };
+		while (!regions.empty())
+		{
+			const Region *current = regions.back();
+			regions.pop_back();
+			for (Node *node: current->get_nodes())
 			{
-				replace_all_uses(node, simplified_node);
-				region->remove_node(node);
-				simplified++;
+				if (!node->users.empty())
+					enqueue(node);
 			}
+			regions.insert(regions.end(), current->get_children().begin(), current->get_children().end());
 		}
-
-		for (Region *child : region->get_children())
-			simplified += process_region(child);
-
-		return simplified;
 	}
 
-	Node *InstcombinePass::simplify_node(Node *node, Region *region)
+	void InstcombinePass::enqueue(Node *node)
 	{
-		if (!node || (node->props & NodeProps::NO_OPTIMIZE) != NodeProps::NONE)
-			return nullptr;
-
-		Node *result = nullptr;
-
-		/* try specialized patterns first */
-		result = simplify_negation_patterns(node, region);
-		if (result)
-			return result;
+		/* literals never simplify; nodes of the root and rodata regions are shared by every
+		 * function, so a function pass must leave them alone */
+		if (!node || node->ir_type == NodeType::LIT || !node->parent_region ||
+		    node->parent_region == current_module->get_root_region() ||
+		    node->parent_region == current_module->get_rodata_region())
+			return;
 
-		result = simplify_carry_borrow_patterns(node, region);
-		if (result)
-			return result;
+		/* nodes outside the numbering cannot be tracked and are simply queued again */
+		if (queued.insert(node) || !queued.contains(node))
+			worklist.push(node);
+	}
 
-		/* try general binary operation patterns */
-		if (node->inputs.size() == 2)
+	bool InstcombinePass::drain_worklist(PassContext &ctx)
+	{
+		visited = 0;
+		rewritten = 0;
+		erased = 0;
+		while (!worklist.empty())
 		{
-			Node *left = node->inputs[0];
-			Node *right = node->inputs[1];
-			if (!left || !right)
-				return nullptr;
+			Node *node = worklist.front();
+			worklist.pop();
+			queued.erase(node);
 
-			if (left == right)
-				result = simplify_identical_operands(node, left, region);
-			if (!result)
-				result = simplify_with_constants(node, left, right, region);
-			if (!result)
-				result = apply_strength_reduction(node, left, right, region);
-			if (!result)
-				result = apply_advanced_patterns(node, left, right);
-			if (!result)
-				result = simplify_small_constant_multiplication(node, left, right, region);
-			if (!result)
-				result = simplify_comparison_patterns(node, left, right, region);
-		}
-		/* try unary operation patterns */
-		else if (node->inputs.size() == 1)
-		{
-			result = simplify_unary_operation(node, node->inputs[0], region);
+			/* erased since it was queued, or nothing left to simplify for */
+			if (!node->parent_region || node->users.empty())
+				continue;
+
+			visited++;
+			if (Node *replacement = simplify_node(node, node->parent_region);
+				replacement && replacement != node)
+			{
+				rewrite(node, replacement);
+				rewritten++;
+			}
 		}
 
-		return result;
+		drop_removed_users();
+		queued = {};
+		removed = {};
+		current_module = nullptr;
+		ctx.update_stat("agbs.simplified_expressions", rewritten);
+		ctx.update_stat("instcombine.visited_nodes", visited);
+		ctx.update_stat("instcombine.rewritten_nodes", rewritten);
+		ctx.update_stat("instcombine.erased_nodes", erased);
+		return rewritten > 0;
 	}
 
-	Node *InstcombinePass::simplify_negation_patterns(Node *node, Region *region)
+	void InstcombinePass::rewrite(Node *node, Node *replacement)
 	{
-		if (node->inputs.size() != 2)
-			return nullptr;
+		/* the replacement and any nodes the rule built under it may match in turn */
+		enqueue(replacement);
+		for (Node *input: replacement->inputs)
+			enqueue(input);
 
-		Node *left = node->inputs[0];
-		Node *right = node->inputs[1];
-
-		switch (node->ir_type)
+		const std::vector<Node *> users = node->users;
+		const std::vector<Node *> operands = node->inputs;
 		{
-			case NodeType::ADD:
-				/* x + (-y) -> x - y */
-				if (is_negation(right))
-					return create_binary_op(region, NodeType::SUB, left, get_negated_value(right), node);
-			/* (-x) + y -> y - x */
-				if (is_negation(left))
-					return create_binary_op(region, NodeType::SUB, right, get_negated_value(left), node);
-				break;
-
-			case NodeType::SUB:
-				/* x - (-y) -> x + y */
-				if (is_negation(right))
-					return create_binary_op(region, NodeType::ADD, left, get_negated_value(right), node);
-			/* (-x) - y -> -(x + y) */
-				if (is_negation(left))
-				{
-					Node *add = create_binary_op(region, NodeType::ADD, get_negated_value(left), right, node);
-					return create_negation(region, add, node);
-				}
-				break;
-
-			case NodeType::MUL:
-				/* (-x) * y -> -(x * y) */
-				if (is_negation(left))
-				{
-					Node *mul = create_binary_op(region, NodeType::MUL, get_negated_value(left), right, node);
-					return create_negation(region, mul, node);
-				}
-			/* x * (-y) -> -(x * y) */
-				if (is_negation(right))
-				{
-					Node *mul = create_binary_op(region, NodeType::MUL, left, get_negated_value(right), node);
-					return create_negation(region, mul, node);
-				}
-				break;
-
-			default:
-				break;
+			/* the replacement may be a pooled literal */
+			const auto lock = current_module->lock_shared_users();
+			replace_all_uses(node, replacement);
+			erase_node(node);
 		}
 
-		return nullptr;
+		/* users see a new operand; operands that survived lost a user */
+		for (Node *user: users)
+			enqueue(user);
+		for (Node *operand: operands)
+			enqueue(operand);
 	}
 
-	Node *InstcombinePass::simplify_carry_borrow_patterns(Node *node, Region *region)
+	void InstcombinePass::erase_node(Node *node)
 	{
-		if (node->inputs.size() != 2)
-			return nullptr;
-
-		Node *left = node->inputs[0];
-		Node *right = node->inputs[1];
-
-		switch (node->ir_type)
+		std::vector dead { node };
+		while (!dead.empty())
 		{
-			case NodeType::SUB:
-				/* x - (x & y) -> x & ~y */
-				if (right->ir_type == NodeType::BAND && right->inputs.size() == 2)
-				{
-					if (right->inputs[0] == left || right->inputs[1] == left)
-					{
-						Node *y = (right->inputs[0] == left) ? right->inputs[1] : right->inputs[0];
-						Node *not_y = create_bitwise_not(region, y, node);
-						return create_binary_op(region, NodeType::BAND, left, not_y, node);
-					}
-				}
-			/* (x | y) - x -> ~x & y */
-				if (left->ir_type == NodeType::BOR && left->inputs.size() == 2)
-				{
-					if (left->inputs[0] == right || left->inputs[1] == right)
-					{
-						Node *y = (left->inputs[0] == right) ? left->inputs[1] : left->inputs[0];
-						Node *not_x = create_bitwise_not(region, right, node);
-						return create_binary_op(region, NodeType::BAND, not_x, y, node);
-					}
-				}
-				break;
+			Node *current = dead.back();
+			dead.pop_back();
 
-			case NodeType::ADD:
-				/* x + (x & y) -> x | y */
-				if (right->ir_type == NodeType::BAND && right->inputs.size() == 2)
-				{
-					if (right->inputs[0] == left || right->inputs[1] == left)
-					{
-						Node *y = (right->inputs[0] == left) ? right->inputs[1] : right->inputs[0];
-						return create_binary_op(region, NodeType::BOR, left, y, node);
-					}
-				}
-			/* (x & y) + (x | y) -> x + y */
-				if ((left->ir_type == NodeType::BAND && right->ir_type == NodeType::BOR) ||
-				    (left->ir_type == NodeType::BOR && right->ir_type == NodeType::BAND))
+			/* shared literals can have a user per erased node; unlinking those one by one
+			 * is quadratic, so they are unlinked in one sweep at the end */
+			const bool tracked = removed.insert(current);
+			for (Node *input: current->inputs)
+			{
+				if (!input)
+					continue;
+				if (tracked && input->ir_type == NodeType::LIT)
 				{
-					Node *and_node = (left->ir_type == NodeType::BAND) ? left : right;
-					Node *or_node = (left->ir_type == NodeType::BOR) ? left : right;
-
-					if (and_node->inputs.size() == 2 && or_node->inputs.size() == 2)
-					{
-						if ((and_node->inputs[0] == or_node->inputs[0] && and_node->inputs[1] == or_node->inputs[1]) ||
-						    (and_node->inputs[0] == or_node->inputs[1] && and_node->inputs[1] == or_node->inputs[0]))
-						{
-							return create_binary_op(region, NodeType::ADD, and_node->inputs[0], and_node->inputs[1],
-							                        node);
-						}
-					}
+					stale_inputs.push_back(input);
+					continue;
 				}
-				break;
 
-			default:
-				break;
-		}
-
-		return nullptr;
-	}
+				std::erase(input->users, current);
+				if (input->users.empty() && is_erasable(input) && std::ranges::find(dead, input) == dead.end())
+					dead.push_back(input);
+			}
 
-	Node *InstcombinePass::simplify_identical_operands(Node *node, Node *operand, Region *region)
-	{
-		switch (node->ir_type)
-		{
-			case NodeType::SUB:
-				return create_zero_literal(region, node->type_kind, node);
-			case NodeType::DIV:
-				if (!is_zero_constant(operand))
-					return create_one_literal(region, node->type_kind, node);
-				break;
-			case NodeType::BXOR:
-				return create_zero_literal(region, node->type_kind, node);
-			case NodeType::BAND:
-			case NodeType::BOR:
-				return operand;
-			case NodeType::EQ:
-			case NodeType::GTE:
-			case NodeType::LTE:
-				return find_or_create_literal<bool, DataType::BOOL>(region, true, node);
-			case NodeType::NEQ:
-			case NodeType::GT:
-			case NodeType::LT:
-				return find_or_create_literal<bool, DataType::BOOL>(region, false, node);
-			default:
-				break;
+			current->parent_region->remove_node(current);
+			if (current != node)
+				erased++;
 		}
-		return nullptr;
 	}
 
-	Node *InstcombinePass::simplify_with_constants(Node *node, Node *left, Node *right, Region *region)
+	bool InstcombinePass::is_erasable(const Node *node) const
 	{
+		if (!node->parent_region || node->parent_region == current_module->get_root_region() ||
+		    (node->props & (NodeProps::NO_OPTIMIZE | NodeProps::EXPORT)) != NodeProps::NONE)
+			return false;
+
+		/* operations without side effects that cannot trap */
 		switch (node->ir_type)
 		{
 			case NodeType::ADD:
-				if (is_zero_constant(right))
-					return left;
-				if (is_zero_constant(left))
-					return right;
-				if (left == right) /* x + x = x * 2 */
-					return create_binary_op(region, NodeType::MUL, left,
-					                        create_constant_with_value(region, 2, node->type_kind, node), node);
-				break;
-
 			case NodeType::SUB:
-				if (is_zero_constant(right))
-					return left;
-			/* 0 - (0 - x) = x; double negation */
-				if (is_zero_constant(left) && right->ir_type == NodeType::SUB &&
-				    right->inputs.size() == 2 && is_zero_constant(right->inputs[0]))
-					return right->inputs[1];
-				break;
-
 			case NodeType::MUL:
-				if (is_zero_constant(right) || is_zero_constant(left))
-					return create_zero_literal(region, node->type_kind, node);
-				if (is_one_constant(right))
-					return left;
-				if (is_one_constant(left))
-					return right;
-				if (is_minus_one_constant(right))
-					return create_negation(region, left, node);
-				if (is_minus_one_constant(left))
-					return create_negation(region, right, node);
-				break;
-
-			case NodeType::DIV:
-				if (is_one_constant(right))
-					return left;
-				if (is_zero_constant(left) && !is_zero_constant(right))
-					return create_zero_literal(region, node->type_kind, node);
-				if (is_minus_one_constant(right))
-					return create_negation(region, left, node);
-				break;
-
+			case NodeType::GT:
+			case NodeType::GTE:
+			case NodeType::LT:
+			case NodeType::LTE:
+			case NodeType::EQ:
+			case NodeType::NEQ:
 			case NodeType::BAND:
-				if (is_zero_constant(right) || is_zero_constant(left))
-					return create_zero_literal(region, node->type_kind, node);
-				if (is_minus_one_constant(right))
-					return left;
-				if (is_minus_one_constant(left))
-					return right;
-				break;
-
 			case NodeType::BOR:
-				if (is_zero_constant(right))
-					return left;
-				if (is_zero_constant(left))
-					return right;
-				if (is_minus_one_constant(right) || is_minus_one_constant(left))
-					return create_minus_one_literal(region, node->type_kind, node);
-				break;
-
 			case NodeType::BXOR:
-				if (is_zero_constant(right))
-					return left;
-				if (is_zero_constant(left))
-					return right;
-				break;
-
+			case NodeType::BNOT:
 			case NodeType::BSHL:
 			case NodeType::BSHR:
-				if (is_zero_constant(right))
-					return left;
-				if (is_zero_constant(left))
-					return create_zero_literal(region, node->type_kind, node);
-				break;
-
-			case NodeType::LT:
-				/* x < 0 = false for unsigned */
-				if (is_unsigned_type(left->type_kind) && is_zero_constant(right))
-					return find_or_create_literal<bool, DataType::BOOL>(region, false, node);
-			/* 0 < x = x != 0 for unsigned */
-				if (is_unsigned_type(right->type_kind) && is_zero_constant(left))
-					return create_binary_op(region, NodeType::NEQ, right,
-					                        create_zero_literal(region, right->type_kind, node), node);
-				break;
-
+				return true;
 			default:
-				break;
+				return false;
 		}
+	}
 
-		return nullptr;
+	void InstcombinePass::drop_removed_users()
+	{
+		std::ranges::sort(stale_inputs);
+		const auto [first, last] = std::ranges::unique(stale_inputs);
+		stale_inputs.erase(first, last);
+
+		const auto lock = current_module->lock_shared_users();
+		for (Node *input: stale_inputs)
+			std::erase_if(input->users, [this](const Node *user) { return removed.contains(user); });
+		stale_inputs.clear();
 	}
 
-	Node *InstcombinePass::apply_strength_reduction(Node *node, Node *left, Node *right, Region *region)
+	/* the rules of the pass; the rule set tries only those rooted at a node's opcode, in
+	 * the order given here */
+	struct InstcombineRules
 	{
-		switch (node->ir_type)
-		{
-			case NodeType::MUL:
-				/* x * 2^n -> x << n */
-				if (is_power_of_two_constant(right))
-					return create_shift(region, NodeType::BSHL, left, get_log2_of_constant(right), node);
-			/* 2^n * x -> x << n */
-				if (is_power_of_two_constant(left))
-					return create_shift(region, NodeType::BSHL, right, get_log2_of_constant(left), node);
-				break;
+		using State = InstcombinePass::RuleContext;
+		using Pass = InstcombinePass;
 
-			case NodeType::DIV:
-				/* x / 2^n -> x >> n for unsigned */
-				if (is_power_of_two_constant(right) && is_unsigned_type(node->type_kind))
-					return create_shift(region, NodeType::BSHR, left, get_log2_of_constant(right), node);
-				break;
+		/* `a` is one of the two operands of `n` */
+		static bool has_operand(const Node *n, const Node *a)
+		{
+			return n->inputs.size() == 2 && (n->inputs[0] == a || n->inputs[1] == a);
+		}
 
-			default:
-				break;
+		/* the operand of `n` that is not `a` */
+		static Node *other_operand(const Node *n, const Node *a)
+		{
+			return n->inputs[0] == a ? n->inputs[1] : n->inputs[0];
 		}
 
-		return nullptr;
-	}
+		/* the BAND and BOR operands of `s.node`, or nulls unless it has one of each */
+		static std::pair<Node *, Node *> and_or_pair(const State &s)
+		{
+			if (s.lhs()->ir_type == NodeType::BAND && s.rhs()->ir_type == NodeType::BOR)
+				return { s.lhs(), s.rhs() };
+			if (s.lhs()->ir_type == NodeType::BOR && s.rhs()->ir_type == NodeType::BAND)
+				return { s.rhs(), s.lhs() };
+			return { nullptr, nullptr };
+		}
 
-	Node *InstcombinePass::apply_advanced_patterns(Node *node, Node *left, Node *right)
-	{
-		switch (node->ir_type)
+		static const auto &get()
 		{
-			case NodeType::BAND:
-				/* x & (x | y) -> x */
-				if (right->ir_type == NodeType::BOR && right->inputs.size() == 2 &&
-				    (right->inputs[0] == left || right->inputs[1] == left))
-					return left;
-			/* (x | y) & x -> x */
-				if (left->ir_type == NodeType::BOR && left->inputs.size() == 2 &&
-				    (left->inputs[0] == right || left->inputs[1] == right))
-					return right;
-				break;
+			static constexpr auto rules = make_rule_set(
+				/* negation sinking */
+				Rewrite::binary<NodeType::ADD>( /* x + (-y) -> x - y */
+					Rewrite::when([](const State &s) { return s.pass->is_negation(s.rhs()); }),
+					Rewrite::to([](const State &s)
+					{
+						return Pass::create_binary_op(s.region, NodeType::SUB, s.lhs(),
+						                              s.pass->get_negated_value(s.rhs()), s.node);
+					})),
+				Rewrite::binary<NodeType::ADD>( /* (-x) + y -> y - x */
+					Rewrite::when([](const State &s) { return s.pass->is_negation(s.lhs()); }),
+					Rewrite::to([](const State &s)
+					{
+						return Pass::create_binary_op(s.region, NodeType::SUB, s.rhs(),
+						                              s.pass->get_negated_value(s.lhs()), s.node);
+					})),
+				Rewrite::binary<NodeType::SUB>( /* x - (-y) -> x + y */
+					Rewrite::when([](const State &s) { return s.pass->is_negation(s.rhs()); }),
+					Rewrite::to([](const State &s)
+					{
+						return Pass::create_binary_op(s.region, NodeType::ADD, s.lhs(),
+						                              s.pass->get_negated_value(s.rhs()), s.node);
+					})),
+				Rewrite::binary<NodeType::SUB>( /* (-x) - y -> -(x + y) */
+					Rewrite::when([](const State &s) { return s.pass->is_negation(s.lhs()); }),
+					Rewrite::to([](const State &s)
+					{
+						Node *add = Pass::create_binary_op(s.region, NodeType::ADD,
+						                                   s.pass->get_negated_value(s.lhs()), s.rhs(), s.node);
+						return s.pass->create_negation(s.region, add, s.node);
+					})),
+				Rewrite::binary<NodeType::MUL>( /* (-x) * y -> -(x * y) */
+					Rewrite::when([](const State &s) { return s.pass->is_negation(s.lhs()); }),
+					Rewrite::to([](const State &s)
+					{
+						Node *mul = Pass::create_binary_op(s.region, NodeType::MUL,
+						                                   s.pass->get_negated_value(s.lhs()), s.rhs(), s.node);
+						return s.pass->create_negation(s.region, mul, s.node);
+					})),
+				Rewrite::binary<NodeType::MUL>( /* x * (-y) -> -(x * y) */
+					Rewrite::when([](const State &s) { return s.pass->is_negation(s.rhs()); }),
+					Rewrite::to([](const State &s)
+					{
+						Node *mul = Pass::create_binary_op(s.region, NodeType::MUL, s.lhs(),
+						                                   s.pass->get_negated_value(s.rhs()), s.node);
+						return s.pass->create_negation(s.region, mul, s.node);
+					})),
+
+				/* carry and borrow elimination */
+				Rewrite::binary<NodeType::SUB>( /* x - (x & y) -> x & ~y */
+					Rewrite::when([](const State &s)
+					{
+						return s.rhs()->ir_type == NodeType::BAND && has_operand(s.rhs(), s.lhs());
+					}),
+					Rewrite::to([](const State &s)
+					{
+						Node *not_y = Pass::create_bitwise_not(s.region, other_operand(s.rhs(), s.lhs()), s.node);
+						return Pass::create_binary_op(s.region, NodeType::BAND, s.lhs(), not_y, s.node);
+					})),
+				Rewrite::binary<NodeType::SUB>( /* (x | y) - x -> ~x & y */
+					Rewrite::when([](const State &s)
+					{
+						return s.lhs()->ir_type == NodeType::BOR && has_operand(s.lhs(), s.rhs());
+					}),
+					Rewrite::to([](const State &s)
+					{
+						Node *not_x = Pass::create_bitwise_not(s.region, s.rhs(), s.node);
+						return Pass::create_binary_op(s.region, NodeType::BAND, not_x,
+						                              other_operand(s.lhs(), s.rhs()), s.node);
+					})),
+				Rewrite::binary<NodeType::ADD>( /* x + (x & y) -> x | y */
+					Rewrite::when([](const State &s)
+					{
+						return s.rhs()->ir_type == NodeType::BAND && has_operand(s.rhs(), s.lhs());
+					}),
+					Rewrite::to([](const State &s)
+					{
+						return Pass::create_binary_op(s.region, NodeType::BOR, s.lhs(),
+						                              other_operand(s.rhs(), s.lhs()), s.node);
+					})),
+				Rewrite::binary<NodeType::ADD>( /* (x & y) + (x | y) -> x + y */
+					Rewrite::when([](const State &s)
+					{
+						const auto [and_node, or_node] = and_or_pair(s);
+						if (!and_node || and_node->inputs.size() != 2 || or_node->inputs.size() != 2)
+							return false;
+						return (and_node->inputs[0] == or_node->inputs[0] && and_node->inputs[1] == or_node->inputs[1]) ||
+						       (and_node->inputs[0] == or_node->inputs[1] && and_node->inputs[1] == or_node->inputs[0]);
+					}),
+					Rewrite::to([](const State &s)
+					{
+						const Node *and_node = and_or_pair(s).first;
+						return Pass::create_binary_op(s.region, NodeType::ADD, and_node->inputs[0],
+						                              and_node->inputs[1], s.node);
+					})),
+
+				/* x op x */
+				Rewrite::binary<NodeType::SUB, NodeType::BXOR>(
+					Rewrite::same_operands(),
+					Rewrite::to([](const State &s)
+					{
+						return s.pass->create_zero_literal(s.region, s.node->type_kind, s.node);
+					})),
+				Rewrite::binary<NodeType::DIV>(
+					Rewrite::same_operands(),
+					Rewrite::when([](const State &s) { return !s.pass->is_zero_constant(s.lhs()); }),
+					Rewrite::to([](const State &s)
+					{
+						return s.pass->create_one_literal(s.region, s.node->type_kind, s.node);
+					})),
+				Rewrite::binary<NodeType::BAND, NodeType::BOR>(
+					Rewrite::same_operands(),
+					Rewrite::to([](const State &s) { return s.lhs(); })),
+				Rewrite::binary<NodeType::EQ, NodeType::GTE, NodeType::LTE>(
+					Rewrite::same_operands(),
+					Rewrite::to([](const State &s)
+					{
+						return s.pass->find_or_create_literal<bool, DataType::BOOL>(s.region, true, s.node);
+					})),
+				Rewrite::binary<NodeType::NEQ, NodeType::GT, NodeType::LT>(
+					Rewrite::same_operands(),
+					Rewrite::to([](const State &s)
+					{
+						return s.pass->find_or_create_literal<bool, DataType::BOOL>(s.region, false, s.node);
+					})),
+
+				/* identities with constants */
+				Rewrite::binary<NodeType::ADD, NodeType::SUB, NodeType::BOR, NodeType::BXOR,
+				                NodeType::BSHL, NodeType::BSHR>( /* x op 0 -> x */
+					Rewrite::when([](const State &s) { return s.pass->is_zero_constant(s.rhs()); }),
+					Rewrite::to([](const State &s) { return s.lhs(); })),
+				Rewrite::binary<NodeType::ADD, NodeType::BOR, NodeType::BXOR>( /* 0 op x -> x */
+					Rewrite::when([](const State &s) { return s.pass->is_zero_constant(s.lhs()); }),
+					Rewrite::to([](const State &s) { return s.rhs(); })),
+				Rewrite::binary<NodeType::ADD>( /* x + x -> x * 2 */
+					Rewrite::same_operands(),
+					Rewrite::to([](const State &s)
+					{
+						Node *two = s.pass->create_constant_with_value(s.region, 2, s.node->type_kind, s.node);
+						return Pass::create_binary_op(s.region, NodeType::MUL, s.lhs(), two, s.node);
+					})),
+				Rewrite::binary<NodeType::SUB>( /* 0 - (0 - x) -> x */
+					Rewrite::when([](const State &s)
+					{
+						return s.pass->is_zero_constant(s.lhs()) && s.rhs()->ir_type == NodeType::SUB &&
+						       s.rhs()->inputs.size() == 2 && s.pass->is_zero_constant(s.rhs()->inputs[0]);
+					}),
+					Rewrite::to([](const State &s) { return s.rhs()->inputs[1]; })),
+				Rewrite::binary<NodeType::MUL, NodeType::BAND>( /* x * 0, 0 & x -> 0 */
+					Rewrite::when([](const State &s)
+					{
+						return s.pass->is_zero_constant(s.rhs()) || s.pass->is_zero_constant(s.lhs());
+					}),
+					Rewrite::to([](const State &s)
+					{
+						return s.pass->create_zero_literal(s.region, s.node->type_kind, s.node);
+					})),
+				Rewrite::binary<NodeType::MUL, NodeType::DIV>( /* x * 1, x / 1 -> x */
+					Rewrite::when([](const State &s) { return s.pass->is_one_constant(s.rhs()); }),
+					Rewrite::to([](const State &s) { return s.lhs(); })),
+				Rewrite::binary<NodeType::MUL>( /* 1 * x -> x */
+					Rewrite::when([](const State &s) { return s.pass->is_one_constant(s.lhs()); }),
+					Rewrite::to([](const State &s) { return s.rhs(); })),
+				Rewrite::binary<NodeType::DIV>( /* 0 / x -> 0 for x != 0 */
+					Rewrite::when([](const State &s)
+					{
+						return s.pass->is_zero_constant(s.lhs()) && !s.pass->is_zero_constant(s.rhs());
+					}),
+					Rewrite::to([](const State &s)
+					{
+						return s.pass->create_zero_literal(s.region, s.node->type_kind, s.node);
+					})),
+				Rewrite::binary<NodeType::MUL, NodeType::DIV>( /* x * -1, x / -1 -> -x */
+					Rewrite::when([](const State &s) { return s.pass->is_minus_one_constant(s.rhs()); }),
+					Rewrite::to([](const State &s) { return s.pass->create_negation(s.region, s.lhs(), s.node); })),
+				Rewrite::binary<NodeType::MUL>( /* -1 * x -> -x */
+					Rewrite::when([](const State &s) { return s.pass->is_minus_one_constant(s.lhs()); }),
+					Rewrite::to([](const State &s) { return s.pass->create_negation(s.region, s.rhs(), s.node); })),
+				Rewrite::binary<NodeType::BAND>( /* x & -1 -> x */
+					Rewrite::when([](const State &s) { return s.pass->is_minus_one_constant(s.rhs()); }),
+					Rewrite::to([](const State &s) { return s.lhs(); })),
+				Rewrite::binary<NodeType::BAND>( /* -1 & x -> x */
+					Rewrite::when([](const State &s) { return s.pass->is_minus_one_constant(s.lhs()); }),
+					Rewrite::to([](const State &s) { return s.rhs(); })),
+				Rewrite::binary<NodeType::BOR>( /* x | -1 -> -1 */
+					Rewrite::when([](const State &s)
+					{
+						return s.pass->is_minus_one_constant(s.rhs()) || s.pass->is_minus_one_constant(s.lhs());
+					}),
+					Rewrite::to([](const State &s)
+					{
+						return s.pass->create_minus_one_literal(s.region, s.node->type_kind, s.node);
+					})),
+				Rewrite::binary<NodeType::BSHL, NodeType::BSHR>( /* 0 << x -> 0 */
+					Rewrite::when([](const State &s) { return s.pass->is_zero_constant(s.lhs()); }),
+					Rewrite::to([](const State &s)
+					{
+						return s.pass->create_zero_literal(s.region, s.node->type_kind, s.node);
+					})),
+				Rewrite::binary<NodeType::LT>( /* x < 0 -> false for unsigned */
+					Rewrite::when([](const State &s)
+					{
+						return Pass::is_unsigned_type(s.lhs()->type_kind) && s.pass->is_zero_constant(s.rhs());
+					}),
+					Rewrite::to([](const State &s)
+					{
+						return s.pass->find_or_create_literal<bool, DataType::BOOL>(s.region, false, s.node);
+					})),
+				Rewrite::binary<NodeType::LT>( /* 0 < x -> x != 0 for unsigned */
+					Rewrite::when([](const State &s)
+					{
+						return Pass::is_unsigned_type(s.rhs()->type_kind) && s.pass->is_zero_constant(s.lhs());
+					}),
+					Rewrite::to([](const State &s)
+					{
+						Node *zero = s.pass->create_zero_literal(s.region, s.rhs()->type_kind, s.node);
+						return Pass::create_binary_op(s.region, NodeType::NEQ, s.rhs(), zero, s.node);
+					})),
+
+				/* strength reduction */
+				Rewrite::binary<NodeType::MUL>( /* x * 2^n -> x << n */
+					Rewrite::when([](const State &s) { return Pass::is_power_of_two_constant(s.rhs()); }),
+					Rewrite::to([](const State &s)
+					{
+						return s.pass->create_shift(s.region, NodeType::BSHL, s.lhs(),
+						                            Pass::get_log2_of_constant(s.rhs()), s.node);
+					})),
+				Rewrite::binary<NodeType::MUL>( /* 2^n * x -> x << n */
+					Rewrite::when([](const State &s) { return Pass::is_power_of_two_constant(s.lhs()); }),
+					Rewrite::to([](const State &s)
+					{
+						return s.pass->create_shift(s.region, NodeType::BSHL, s.rhs(),
+						                            Pass::get_log2_of_constant(s.lhs()), s.node);
+					})),
+				Rewrite::binary<NodeType::DIV>( /* x / 2^n -> x >> n for unsigned */
+					Rewrite::when([](const State &s)
+					{
+						return Pass::is_power_of_two_constant(s.rhs()) && Pass::is_unsigned_type(s.node->type_kind);
+					}),
+					Rewrite::to([](const State &s)
+					{
+						return s.pass->create_shift(s.region, NodeType::BSHR, s.lhs(),
+						                            Pass::get_log2_of_constant(s.rhs()), s.node);
+					})),
 
-			case NodeType::BOR:
-				/* x | (x & y) -> x */
-				if (right->ir_type == NodeType::BAND && right->inputs.size() == 2 &&
-				    (right->inputs[0] == left || right->inputs[1] == left))
-					return left;
-			/* (x & y) | x -> x */
-				if (left->ir_type == NodeType::BAND && left->inputs.size() == 2 &&
-				    (left->inputs[0] == right || left->inputs[1] == right))
-					return right;
-				break;
+				/* absorption */
+				Rewrite::binary<NodeType::BAND>( /* x & (x | y) -> x */
+					Rewrite::when([](const State &s)
+					{
+						return s.rhs()->ir_type == NodeType::BOR && has_operand(s.rhs(), s.lhs());
+					}),
+					Rewrite::to([](const State &s) { return s.lhs(); })),
+				Rewrite::binary<NodeType::BAND>( /* (x | y) & x -> x */
+					Rewrite::when([](const State &s)
+					{
+						return s.lhs()->ir_type == NodeType::BOR && has_operand(s.lhs(), s.rhs());
+					}),
+					Rewrite::to([](const State &s) { return s.rhs(); })),
+				Rewrite::binary<NodeType::BOR>( /* x | (x & y) -> x */
+					Rewrite::when([](const State &s)
+					{
+						return s.rhs()->ir_type == NodeType::BAND && has_operand(s.rhs(), s.lhs());
+					}),
+					Rewrite::to([](const State &s) { return s.lhs(); })),
+				Rewrite::binary<NodeType::BOR>( /* (x & y) | x -> x */
+					Rewrite::when([](const State &s)
+					{
+						return s.lhs()->ir_type == NodeType::BAND && has_operand(s.lhs(), s.rhs());
+					}),
+					Rewrite::to([](const State &s) { return s.rhs(); })),
+
+				/* x * C for small C -> shifts and adds */
+				Rewrite::binary<NodeType::MUL>(
+					Rewrite::when([](const State &s) { return Pass::is_constant(s.rhs()) || Pass::is_constant(s.lhs()); }),
+					Rewrite::to([](const State &s) { return s.pass->decompose_small_multiplication(s); })),
+
+				/* comparisons */
+				Rewrite::binary<NodeType::LT, NodeType::GTE>( /* x < 2^n -> (x & ~(2^n - 1)) == 0 for unsigned */
+					Rewrite::when([](const State &s)
+					{
+						return Pass::is_unsigned_type(s.lhs()->type_kind) && Pass::is_power_of_two_constant(s.rhs());
+					}),
+					Rewrite::to([](const State &s)
+					{
+						const std::uint64_t c = Pass::get_constant_value(s.rhs());
+						Node *mask = s.pass->create_constant_with_value(s.region, ~(c - 1), s.lhs()->type_kind, s.node);
+						Node *and_op = Pass::create_binary_op(s.region, NodeType::BAND, s.lhs(), mask, s.node);
+						Node *zero = s.pass->create_zero_literal(s.region, s.lhs()->type_kind, s.node);
+						return Pass::create_binary_op(s.region, s.node->ir_type == NodeType::LT ? NodeType::EQ : NodeType::NEQ,
+						                              and_op, zero, s.node);
+					})),
+				Rewrite::binary<NodeType::EQ, NodeType::NEQ>( /* b == false -> !b, b != false -> b */
+					Rewrite::when([](const State &s)
+					{
+						return s.lhs()->type_kind == DataType::BOOL &&
+						       s.pass->is_constant_value<bool, DataType::BOOL>(s.rhs(), false);
+					}),
+					Rewrite::to([](const State &s) { return logical_test(s, s.lhs()); })),
+				Rewrite::binary<NodeType::EQ, NodeType::NEQ>( /* false == b -> !b, false != b -> b */
+					Rewrite::when([](const State &s)
+					{
+						return s.rhs()->type_kind == DataType::BOOL &&
+						       s.pass->is_constant_value<bool, DataType::BOOL>(s.lhs(), false);
+					}),
+					Rewrite::to([](const State &s) { return logical_test(s, s.rhs()); })),
+				Rewrite::binary<NodeType::EQ, NodeType::NEQ>( /* b == 0 -> !b, b != 0 -> b */
+					Rewrite::when([](const State &s)
+					{
+						return s.lhs()->type_kind == DataType::BOOL && s.pass->is_zero_constant(s.rhs());
+					}),
+					Rewrite::to([](const State &s) { return logical_test(s, s.lhs()); })),
 
-			default:
-				break;
+				/* unary */
+				Rewrite::unary<NodeType::BNOT>( /* ~(~x) -> x */
+					Rewrite::when([](const State &s)
+					{
+						return s.operand()->ir_type == NodeType::BNOT && !s.operand()->inputs.empty();
+					}),
+					Rewrite::to([](const State &s) { return s.operand()->inputs[0]; })),
+				Rewrite::unary<NodeType::BNOT>( /* ~(x ^ C) -> x ^ ~C */
+					Rewrite::when([](const State &s)
+					{
+						return s.operand()->ir_type == NodeType::BXOR && s.operand()->inputs.size() == 2 &&
+						       Pass::is_constant(s.operand()->inputs[1]);
+					}),
+					Rewrite::to([](const State &s) -> Node *
+					{
+						Node *not_const = s.pass->create_bitwise_not_constant(s.region, s.operand()->inputs[1], s.node);
+						if (!not_const)
+							return nullptr;
+						return Pass::create_binary_op(s.region, NodeType::BXOR, s.operand()->inputs[0], not_const, s.node);
+					}))
+			);
+			return rules;
 		}
 
-		return nullptr;
-	}
+		/* `value == false` is `!value`; `value != false` is `value` */
+		static Node *logical_test(const State &s, Node *value)
+		{
+			if (s.node->ir_type == NodeType::NEQ)
+				return value;
+			return s.pass->create_logical_not(s.region, value, s.node);
+		}
+	};
 
-	Node *InstcombinePass::simplify_small_constant_multiplication(
-		Node *node, Node *left, Node *right, Region *region)
+	Node *InstcombinePass::simplify_node(Node *node, Region *region)
 	{
-		if (node->ir_type != NodeType::MUL)
+		if (!node || (node->props & NodeProps::NO_OPTIMIZE) != NodeProps::NONE)
+			return nullptr;
+
+		RuleContext state;
+		state.node = node;
+		state.region = region;
+		state.pass = this;
+		if (InstcombineRules::get().apply(state) != BTStatus::SUCCESS)
 			return nullptr;
+		return state.result;
+	}
 
+	Node *InstcombinePass::decompose_small_multiplication(const RuleContext &state)
+	{
 		Node *var = nullptr;
 		std::uint64_t constant = 0;
-
-		if (is_constant(right))
+		if (is_constant(state.rhs()))
 		{
-			var = left;
-			constant = get_constant_value(right);
+			var = state.lhs();
+			constant = get_constant_value(state.rhs());
 		}
-		else if (is_constant(left))
+		else
 		{
-			var = right;
-			constant = get_constant_value(left);
+			var = state.rhs();
+			constant = get_constant_value(state.lhs());
 		}
-		else
-			return nullptr;
 
-		/* decompose specific small constants */
+		Region *region = state.region;
+		Node *node = state.node;
 		switch (constant)
 		{
 			case 3: /* x * 3 = (x << 1) + x */
@@ -451,7 +648,7 @@ namespace blm
 				/* check for 2^n + 1 patterns */
 				if (constant > 2 && is_power_of_two_plus_one(constant))
 					return create_shift_add(region, var, get_log2_of_constant_minus_one(constant), var, node);
-			/* check for 2^n - 1 patterns */
+				/* check for 2^n - 1 patterns */
 				if (constant > 2 && is_power_of_two_minus_one(constant))
 					return create_shift_sub(region, var, get_log2_of_constant_plus_one(constant), var, node);
 				break;
@@ -460,85 +657,6 @@ namespace blm
 		return nullptr;
 	}
 
-	Node *InstcombinePass::simplify_comparison_patterns(Node *node, Node *left, Node *right, Region *region)
-	{
-		switch (node->ir_type)
-		{
-			case NodeType::LT:
-				/* x < C where C is power of 2 -> (x & ~(C-1)) == 0 for unsigned */
-				if (is_unsigned_type(left->type_kind) && is_power_of_two_constant(right))
-				{
-					std::uint64_t c = get_constant_value(right);
-					Node *mask = create_constant_with_value(region, ~(c - 1), left->type_kind, node);
-					Node *and_op = create_binary_op(region, NodeType::BAND, left, mask, node);
-					Node *zero = create_zero_literal(region, left->type_kind, node);
-					return create_binary_op(region, NodeType::EQ, and_op, zero, node);
-				}
-				break;
-
-			case NodeType::GTE:
-				/* x >= C where C is power of 2 -> (x & ~(C-1)) != 0 for unsigned */
-				if (is_unsigned_type(left->type_kind) && is_power_of_two_constant(right))
-				{
-					std::uint64_t c = get_constant_value(right);
-					Node *mask = create_constant_with_value(region, ~(c - 1), left->type_kind, node);
-					Node *and_op = create_binary_op(region, NodeType::BAND, left, mask, node);
-					Node *zero = create_zero_literal(region, left->type_kind, node);
-					return create_binary_op(region, NodeType::NEQ, and_op, zero, node);
-				}
-				break;
-
-			case NodeType::EQ:
-				/* x == false -> !x when x is bool */
-					if (left->type_kind == DataType::BOOL && is_constant_value<bool, DataType::BOOL>(right, false))
-						return create_logical_not(region, left, node);
-			/* false == x -> !x when x is bool */
-			if (right->type_kind == DataType::BOOL && is_constant_value<bool, DataType::BOOL>(left, false))
-				return create_logical_not(region, right, node);
-			/* x == 0 -> !x when x is bool */
-			if (left->type_kind == DataType::BOOL && is_zero_constant(right))
-				return create_logical_not(region, left, node);
-			break;
-
-			case NodeType::NEQ:
-				/* x != false -> x when x is bool */
-					if (left->type_kind == DataType::BOOL && is_constant_value<bool, DataType::BOOL>(right, false))
-						return left;
-			/* false != x -> x when x is bool */
-			if (right->type_kind == DataType::BOOL && is_constant_value<bool, DataType::BOOL>(left, false))
-				return right;
-			/* x != 0 -> x when x is bool */
-			if (left->type_kind == DataType::BOOL && is_zero_constant(right))
-				return left;
-			break;
-
-			default:
-				break;
-		}
-
-		return nullptr;
-	}
-
-	Node *InstcombinePass::simplify_unary_operation(Node *node, Node *input, Region *region)
-	{
-		if (node->ir_type == NodeType::BNOT)
-		{
-			/* ~(~x) = x */
-			if (input->ir_type == NodeType::BNOT && !input->inputs.empty())
-				return input->inputs[0];
-
-			/* ~(x ^ const) = x ^ ~const */
-			if (input->ir_type == NodeType::BXOR && input->inputs.size() == 2 && is_constant(input->inputs[1]))
-			{
-				Node *not_const = create_bitwise_not_constant(region, input->inputs[1], node);
-				if (not_const)
-					return create_binary_op(region, NodeType::BXOR, input->inputs[0], not_const, node);
-			}
-		}
-
-		return nullptr;
-	}
-
 	Node *InstcombinePass::create_binary_op(Region *region, NodeType op_type,
 	                                                    Node *left, Node *right, Node *insert_before)
 	{
@@ -909,12 +1027,17 @@ namespace blm
 						replacement_node->users.push_back(user);
 				}
 			}
+
+			if (user->parent_region)
+				user->parent_region->mark_changed();
 		}
 		node_to_replace->users.clear();
 	}
 
 	void InstcombinePass::connect_nodes(Node *user, const std::vector<Node *> &inputs)
 	{
+		/* inputs may be pooled literals used by other functions as well */
+		const auto lock = user->parent_region->get_module().lock_shared_users();
 		for (Node *input: inputs)
 		{
 			if (input)
@@ -3,6 +3,8 @@
 #include <algorithm>
 #include <cstring>
 #include <functional>
+#include <optional>
+#include <bloom/analysis/dominators.hpp>
 #include <bloom/foundation/context.hpp>
 #include <bloom/foundation/module.hpp>
 #include <bloom/foundation/pass-context.hpp>
@@ -24,6 +26,13 @@ namespace blm
 	{
 		pre_results.clear();
 
+		/* hoisting only moves value nodes, so the control edges the tree is built
+		 * from stay intact for the whole run */
+		std::optional<DominatorTree> local_tree;
+		dom_tree = get_dominator_tree(ctx);
+		if (!dom_tree)
+			dom_tree = &local_tree.emplace(m.get_root_region());
+
 		std::size_t total_hoisted = 0;
 
 		total_hoisted += process_region(m.get_root_region());
@@ -33,16 +42,11 @@ namespace blm
 			if (func->ir_type != NodeType::FUNCTION)
 				continue;
 
-			for (Region *region : m.get_root_region()->get_children())
-			{
-				if (region->get_name() == m.get_context().get_string(func->str_id))
-				{
-					total_hoisted += process_region(region);
-					break;
-				}
-			}
+			if (Region *region = m.get_function_region(func))
+				total_hoisted += process_region(region);
 		}
 
+		dom_tree = nullptr;
 		ctx.update_stat("pre.hoisted_expressions", total_hoisted);
 		return total_hoisted > 0;
 	}
@@ -222,30 +226,7 @@ namespace blm
 		if (r1 == r2)
 			return r1;
 
-		/* use proper dominance analysis */
-		if (r1->dominates(r2))
-			return r1;
-		if (r2->dominates(r1))
-			return r2;
-
-		/* find lowest common ancestor that dominates both */
-		Region *curr1 = r1->get_parent();
-		while (curr1)
-		{
-			if (curr1->dominates(r2))
-				return curr1;
-			curr1 = curr1->get_parent();
-		}
-
-		Region *curr2 = r2->get_parent();
-		while (curr2)
-		{
-			if (curr2->dominates(r1))
-				return curr2;
-			curr2 = curr2->get_parent();
-		}
-
-		return nullptr;
+		return dom_tree->nearest_common_dominator(r1, r2);
 	}
 
 	bool PREPass::inputs_available_at(Node *node, Region *target) const
@@ -256,7 +237,7 @@ namespace blm
 				return false;
 
 			/* input must dominate or be in the target region */
-			if (!input->parent_region->dominates(target) && input->parent_region != target)
+			if (!dom_tree->dominates(input->parent_region, target))
 				return false;
 		}
 		return true;
@@ -341,7 +322,7 @@ namespace blm
 			if (!node->parent_region)
 				continue;
 
-			if (!dominator->dominates(node->parent_region) && dominator != node->parent_region)
+			if (!dom_tree->dominates(dominator, node->parent_region))
 				continue;
 
 			std::vector<Node *> users = node->users;
@@ -356,6 +337,9 @@ namespace blm
 					}
 				}
 
+				if (user->parent_region)
+					user->parent_region->mark_changed();
+
 				/* remove from original node's users */
 				auto &user_list = node->users;
 				user_list.erase(std::ranges::remove(user_list, user).begin(), user_list.end());
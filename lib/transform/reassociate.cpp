@@ -1,5 +1,6 @@
 /* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
 
+#include <algorithm>
 #include <bloom/analysis/laa.hpp>
 #include <bloom/foundation/context.hpp>
 #include <bloom/foundation/region.hpp>
@@ -18,6 +19,12 @@ namespace blm
 		return "reorder associative expression for better optimization opportunity in next phrases";
 	}
 
+	PreservedAnalyses ReassociatePass::preserved_analyses() const
+	{
+		/* only arithmetic is reordered */
+		return PreservedAnalyses::none().preserve_cfg();
+	}
+
 	std::vector<const std::type_info *> ReassociatePass::required_passes() const
 	{
 		return get_pass_types<LocalAliasAnalysisPass>();
@@ -44,7 +51,7 @@ namespace blm
 			return false;
 
 		auto changed = false;
-		std::vector<Node *> nodes_to_process = region->get_nodes();
+		std::vector<Node *> nodes_to_process = region->get_nodes().snapshot();
 		for (Node *n: nodes_to_process)
 		{
 			if (reassociate(n))
@@ -246,6 +253,9 @@ namespace blm
 						new_node->users.push_back(usr);
 				}
 			}
+
+			if (usr->parent_region)
+				usr->parent_region->mark_changed();
 		}
 
 		/* Clear the old node's users list */
@@ -20,6 +20,12 @@ namespace blm
 		return "replaces struct allocations with individual scalar allocations when safe";
 	}
 
+	PreservedAnalyses SROAPass::preserved_analyses() const
+	{
+		/* allocations and their accesses are rewritten in place */
+		return PreservedAnalyses::none().preserve_cfg();
+	}
+
 	std::vector<const std::type_info *> SROAPass::required_passes() const
 	{
 		return get_pass_types<LocalAliasAnalysisPass>();
@@ -27,26 +33,19 @@ namespace blm
 
 	bool SROAPass::run(Module &module, PassContext &context)
 	{
-		const auto *alias_result = context.get_result<LocalAliasResult>();
-		std::unique_ptr<LocalAliasResult> local_result;
-		if (!alias_result)
-		{
-			LocalAliasAnalysisPass laa;
-			local_result = std::unique_ptr<LocalAliasResult>(
-				dynamic_cast<LocalAliasResult *>(laa.analyze(module, context).release()));
-			alias_result = local_result.get();
-		}
+		const LocalAliasResult &alias_result = get_local_alias_result(module, context);
 
 		candidates.clear();
 		field_accesses.clear();
+		layout = &module.get_context().get_data_layout();
 
-		find_candidates(module, *alias_result);
+		find_candidates(module, alias_result);
 
 		std::size_t promoted_allocations = 0;
 		std::size_t scalar_replacements = 0;
 		for (auto &[alloc_node, info]: candidates)
 		{
-			if (analyze_struct_uses(alloc_node, info, *alias_result))
+			if (analyze_struct_uses(alloc_node, info, alias_result))
 			{
 				if (transform_allocation(info, module))
 				{
@@ -60,6 +59,7 @@ namespace blm
 			}
 		}
 
+		layout = nullptr;
 		context.update_stat("sroa.promoted_allocations", promoted_allocations);
 		context.update_stat("sroa.scalar_replacements", scalar_replacements);
 		return promoted_allocations > 0;
@@ -74,14 +74,8 @@ namespace blm
 			if (func->ir_type != NodeType::FUNCTION)
 				continue;
 
-			for (const Region *child: module.get_root_region()->get_children())
-			{
-				if (child->get_name() == module.get_context().get_string(func->str_id))
-				{
-					find_candidates_in_region(child, alias_result);
-					break;
-				}
-			}
+			if (const Region *func_region = module.get_function_region(func))
+				find_candidates_in_region(func_region, alias_result);
 		}
 	}
 
@@ -129,15 +123,9 @@ namespace blm
 			if (func->ir_type != NodeType::FUNCTION)
 				continue;
 
-			for (const Region *child: module.get_root_region()->get_children())
-			{
-				if (child->get_name() == module.get_context().get_string(func->str_id))
-				{
-					if (!analyze_uses_in_region(child, alloc, info, alias_result))
-						return false;
-					break;
-				}
-			}
+			const Region *func_region = module.get_function_region(func);
+			if (func_region && !analyze_uses_in_region(func_region, alloc, info, alias_result))
+				return false;
 		}
 
 		return true;
@@ -335,21 +323,13 @@ namespace blm
 		if (it == candidates.end())
 			return false;
 
-		field_index = get_field_index_from_offset(offset, it->second.fields);
+		field_index = get_field_index_from_offset(offset, it->second.struct_type);
 		return field_index < it->second.fields.size();
 	}
 
-	std::size_t SROAPass::get_field_index_from_offset(std::int64_t offset,
-	                                                  const std::vector<std::pair<std::string, DataType> > &fields)
+	std::size_t SROAPass::get_field_index_from_offset(const std::int64_t offset, const DataType struct_type) const
 	{
-		std::vector<std::uint64_t> offsets = calculate_field_offsets(fields);
-		for (std::size_t i = 0; i < offsets.size(); ++i)
-		{
-			if (static_cast<std::int64_t>(offsets[i]) == offset)
-				return i;
-		}
-
-		return fields.size(); /* invalid index */
+		return layout->get_field_at(struct_type, offset);
 	}
 
 	bool SROAPass::transform_allocation(AllocationInfo &info, Module &module)
@@ -374,7 +354,7 @@ namespace blm
 		return false;
 	}
 
-	void SROAPass::create_scalar_allocations(AllocationInfo &info, Module &module)
+	void SROAPass::create_scalar_allocations(AllocationInfo &info, Module &module) const
 	{
 		Context &ctx = module.get_context();
 		Region *alloc_region = info.alloc_node->parent_region;
@@ -388,36 +368,8 @@ namespace blm
 				continue;
 
 			const DataType field_type = info.fields[i].second;
-			std::uint64_t field_size = get_type_size(field_type);
-			std::uint32_t field_align = 0;
-			switch (field_type)
-			{
-				case DataType::BOOL:
-				case DataType::INT8:
-				case DataType::UINT8:
-					field_align = 1;
-					break;
-				case DataType::INT16:
-				case DataType::UINT16:
-					field_align = 2;
-					break;
-				case DataType::INT32:
-				case DataType::UINT32:
-				case DataType::FLOAT32:
-					field_align = 4;
-					break;
-				case DataType::INT64:
-				case DataType::UINT64:
-				case DataType::FLOAT64:
-				case DataType::POINTER:
-					field_align = 8;
-					break;
-				default:
-					field_align = static_cast<std::uint32_t>(field_size);
-					if (field_align > 8)
-						field_align = 8;
-					break;
-			}
+			const std::uint64_t field_size = layout->get_size(field_type);
+			const std::uint32_t field_align = layout->get_alignment(field_type);
 
 			Node *size_node = ctx.create<Node>();
 			size_node->ir_type = NodeType::LIT;
@@ -477,6 +429,8 @@ namespace blm
 						auto &field_users = field_addr->users;
 						std::erase(field_users, access_node);
 						scalar_alloc->users.push_back(access_node);
+						if (access_node->parent_region)
+							access_node->parent_region->mark_changed();
 					}
 				}
 			}
@@ -493,13 +447,15 @@ namespace blm
 						auto &field_users = field_addr->users;
 						std::erase(field_users, access_node);
 						scalar_alloc->users.push_back(access_node);
+						if (access_node->parent_region)
+							access_node->parent_region->mark_changed();
 					}
 				}
 			}
 		}
 	}
 
-	DataType SROAPass::create_reduced_struct_type(const AllocationInfo &info, Module &module)
+	DataType SROAPass::create_reduced_struct_type(const AllocationInfo &info, Module &module) const
 	{
 		std::vector<std::pair<std::string, DataType> > reduced_fields;
 
@@ -512,95 +468,15 @@ namespace blm
 		if (reduced_fields.empty())
 			return module.get_context().create_struct_type({}, 0, 1);
 
-		const std::vector<std::uint64_t> field_offsets = calculate_field_offsets(reduced_fields);
-		std::uint64_t last_field_size = get_type_size(reduced_fields.back().second);
+		const std::vector<std::uint64_t> field_offsets = layout->compute_field_offsets(reduced_fields);
+		const std::uint64_t last_field_size = layout->get_size(reduced_fields.back().second);
 		auto total_size = static_cast<std::uint32_t>(field_offsets.back() + last_field_size);
 		std::uint32_t max_align = 1;
 		for (const auto &[name, type]: reduced_fields)
-		{
-			std::uint32_t field_align = 0;
-			switch (type)
-			{
-				case DataType::BOOL:
-				case DataType::INT8:
-				case DataType::UINT8:
-					field_align = 1;
-					break;
-				case DataType::INT16:
-				case DataType::UINT16:
-					field_align = 2;
-					break;
-				case DataType::INT32:
-				case DataType::UINT32:
-				case DataType::FLOAT32:
-					field_align = 4;
-					break;
-				case DataType::INT64:
-				case DataType::UINT64:
-				case DataType::FLOAT64:
-				case DataType::POINTER:
-					field_align = 8;
-					break;
-				default:
-					field_align = static_cast<std::uint32_t>(get_type_size(type));
-					if (field_align > 8)
-						field_align = 8;
-					break;
-			}
-
-			if (field_align > max_align)
-				max_align = field_align;
-		}
+			max_align = std::max(max_align, layout->get_alignment(type));
 
 		if (max_align > 1)
 			total_size = total_size + max_align - 1 & ~(max_align - 1);
 		return module.get_context().create_struct_type(reduced_fields, total_size, max_align);
 	}
-
-	std::uint64_t SROAPass::get_type_size(DataType type)
-	{
-		switch (type)
-		{
-			case DataType::BOOL:
-			case DataType::INT8:
-			case DataType::UINT8:
-				return 1;
-			case DataType::INT16:
-			case DataType::UINT16:
-				return 2;
-			case DataType::INT32:
-			case DataType::UINT32:
-			case DataType::FLOAT32:
-				return 4;
-			case DataType::INT64:
-			case DataType::UINT64:
-			case DataType::FLOAT64:
-			case DataType::POINTER:
-				return 8;
-			default:
-				return 0; /* unknown or complex type */
-		}
-	}
-
-	std::vector<std::uint64_t> SROAPass::calculate_field_offsets(
-		const std::vector<std::pair<std::string, DataType> > &fields)
-	{
-		std::vector<std::uint64_t> offsets;
-		std::uint64_t current_offset = 0;
-
-		for (const auto &[name, type]: fields)
-		{
-			const std::uint64_t field_size = get_type_size(type);
-			if (std::uint64_t alignment = field_size;
-				alignment > 1)
-			{
-				current_offset = (current_offset + alignment - 1) & ~(alignment - 1);
-			}
-
-			offsets.push_back(current_offset);
-			current_offset += field_size;
-		}
-
-		return offsets;
-	}
 }
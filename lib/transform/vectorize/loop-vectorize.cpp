@@ -0,0 +1,673 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <bloom/foundation/context.hpp>
+#include <bloom/foundation/module.hpp>
+#include <bloom/foundation/pass-context.hpp>
+#include <bloom/foundation/region.hpp>
+#include <bloom/transform/vectorize/loop-vectorize.hpp>
+
+namespace blm
+{
+	namespace
+	{
+		bool is_integer_type(const DataType type)
+		{
+			switch (type)
+			{
+				case DataType::INT8:
+				case DataType::INT16:
+				case DataType::INT32:
+				case DataType::INT64:
+				case DataType::UINT8:
+				case DataType::UINT16:
+				case DataType::UINT32:
+				case DataType::UINT64:
+					return true;
+				default:
+					return false;
+			}
+		}
+
+		bool literal_value(const Node *node, std::int64_t &value)
+		{
+			if (!node || node->ir_type != NodeType::LIT)
+				return false;
+
+			switch (node->type_kind)
+			{
+				case DataType::INT8:
+					value = node->as<DataType::INT8>();
+					return true;
+				case DataType::INT16:
+					value = node->as<DataType::INT16>();
+					return true;
+				case DataType::INT32:
+					value = node->as<DataType::INT32>();
+					return true;
+				case DataType::INT64:
+					value = node->as<DataType::INT64>();
+					return true;
+				case DataType::UINT8:
+					value = node->as<DataType::UINT8>();
+					return true;
+				case DataType::UINT16:
+					value = node->as<DataType::UINT16>();
+					return true;
+				case DataType::UINT32:
+					value = node->as<DataType::UINT32>();
+					return true;
+				case DataType::UINT64:
+					value = static_cast<std::int64_t>(node->as<DataType::UINT64>());
+					return true;
+				default:
+					return false;
+			}
+		}
+
+		Node *integer_literal(Module &module, const DataType type, const std::uint32_t value)
+		{
+			switch (type)
+			{
+				case DataType::INT8:
+					return module.intern_literal<DataType::INT8>(static_cast<std::int8_t>(value));
+				case DataType::INT16:
+					return module.intern_literal<DataType::INT16>(static_cast<std::int16_t>(value));
+				case DataType::INT32:
+					return module.intern_literal<DataType::INT32>(static_cast<std::int32_t>(value));
+				case DataType::INT64:
+					return module.intern_literal<DataType::INT64>(value);
+				case DataType::UINT8:
+					return module.intern_literal<DataType::UINT8>(static_cast<std::uint8_t>(value));
+				case DataType::UINT16:
+					return module.intern_literal<DataType::UINT16>(static_cast<std::uint16_t>(value));
+				case DataType::UINT32:
+					return module.intern_literal<DataType::UINT32>(value);
+				case DataType::UINT64:
+					return module.intern_literal<DataType::UINT64>(value);
+				default:
+					return nullptr;
+			}
+		}
+
+		bool is_counter_load(const Node *node, const Node *counter, const Region *body)
+		{
+			return node->ir_type == NodeType::LOAD && node->inputs.size() == 1 &&
+			       node->inputs[0] == counter && node->parent_region == body;
+		}
+
+		Node *address_operand(const Node *access)
+		{
+			if (access->ir_type == NodeType::PTR_LOAD && access->inputs.size() == 1)
+				return access->inputs[0];
+			if (access->ir_type == NodeType::PTR_STORE && access->inputs.size() == 2)
+				return access->inputs[1];
+			return nullptr;
+		}
+
+		Node *append_node(Context &ctx, Region *region, const NodeType type, const DataType type_kind,
+		                  std::vector<Node *> inputs)
+		{
+			Node *node = ctx.create<Node>();
+			node->ir_type = type;
+			node->type_kind = type_kind;
+			node->inputs = std::move(inputs);
+			for (Node *input: node->inputs)
+				input->users.push_back(node);
+			region->add_node(node);
+			return node;
+		}
+	}
+
+	std::string_view LoopVectorizePass::name() const
+	{
+		return "loop-vectorize";
+	}
+
+	std::string_view LoopVectorizePass::description() const
+	{
+		return "widens countable inner loops over unit-stride accesses and keeps a scalar epilogue";
+	}
+
+	std::vector<const std::type_info *> LoopVectorizePass::required_passes() const
+	{
+		return get_pass_types<LoopAnalysisPass, LocalAliasAnalysisPass>();
+	}
+
+	bool LoopVectorizePass::run(Module &module, PassContext &context)
+	{
+		const LocalAliasResult &alias_result = get_local_alias_result(module, context);
+
+		/* results are stored under the type of the pass that produced them */
+		const auto *loop_result = context.get_result<LoopAnalysisResult>(typeid(LoopAnalysisPass));
+		if (!loop_result)
+		{
+			context.store_result(typeid(LoopAnalysisPass), LoopAnalysisPass().analyze(module, context));
+			loop_result = context.get_result<LoopAnalysisResult>(typeid(LoopAnalysisPass));
+		}
+
+		layout = &module.get_context().get_data_layout();
+		vectorized_loops = 0;
+		rejected_loops = 0;
+		widened_nodes = 0;
+
+		bool changed = false;
+		for (Node *func: module.get_functions())
+		{
+			if (func->ir_type != NodeType::FUNCTION ||
+			    (func->props & NodeProps::NO_OPTIMIZE) != NodeProps::NONE)
+				continue;
+
+			if (const LoopTree *loops = loop_result ? loop_result->get_loops_for_function(func) : nullptr)
+				changed |= process_function(module, *loops, alias_result);
+		}
+
+		context.update_stat("loop_vectorize.vectorized_loops", vectorized_loops);
+		context.update_stat("loop_vectorize.rejected_loops", rejected_loops);
+		context.update_stat("loop_vectorize.widened_nodes", widened_nodes);
+		layout = nullptr;
+		return changed;
+	}
+
+	bool LoopVectorizePass::process_function(Module &module, const LoopTree &loops,
+	                                         const LocalAliasResult &alias_result)
+	{
+		/* every candidate is matched before any is widened, so alias queries only ever see the
+		 * function as it was analyzed */
+		std::vector<LoopCandidate> candidates;
+		for (const auto &loop: loops.all_loops)
+		{
+			if (!loop->children.empty())
+				continue;
+
+			LoopCandidate candidate;
+			if (match_loop(*loop, candidate) && choose_vf(candidate) &&
+			    check_dependences(candidate, alias_result))
+				candidates.push_back(std::move(candidate));
+			else
+				++rejected_loops;
+		}
+
+		for (LoopCandidate &candidate: candidates)
+			vectorize(candidate, module);
+		vectorized_loops += candidates.size();
+		return !candidates.empty();
+	}
+
+	bool LoopVectorizePass::match_loop(const Loop &loop, LoopCandidate &candidate) const
+	{
+		if (!loop.is_natural() || loop.body_regions.size() != 1 || loop.exits.size() != 1)
+			return false;
+
+		/* one body that is also the latch; anything inside it would be control flow */
+		Region *body = *loop.body_regions.begin();
+		if (loop.latches[0] != body || !body->get_children().empty() || body->get_nodes().empty())
+			return false;
+
+		candidate.header = loop.header;
+		candidate.body = body;
+		return match_header(loop, body, candidate) && match_body(candidate) && check_uses(candidate);
+	}
+
+	bool LoopVectorizePass::match_header(const Loop &loop, Region *body, LoopCandidate &candidate)
+	{
+		const std::vector<Node *> nodes = loop.header->get_nodes().snapshot();
+		if (nodes.size() != 4 || nodes[0]->ir_type != NodeType::ENTRY)
+			return false;
+
+		Node *load = nodes[1];
+		Node *condition = nodes[2];
+		Node *branch = nodes[3];
+		if (load->ir_type != NodeType::LOAD || load->inputs.size() != 1 ||
+		    condition->inputs.size() != 2 ||
+		    branch->ir_type != NodeType::BRANCH || branch->inputs.size() != 3 || branch->inputs[0] != condition)
+			return false;
+
+		/* the counter lives in a slot nothing else can reach */
+		Node *counter = load->inputs[0];
+		if (counter->ir_type != NodeType::STACK_ALLOC || !is_integer_type(load->type_kind))
+			return false;
+
+		Node *bound = nullptr;
+		if (condition->ir_type == NodeType::LT && condition->inputs[0] == load)
+			bound = condition->inputs[1];
+		else if (condition->ir_type == NodeType::GT && condition->inputs[1] == load)
+			bound = condition->inputs[0];
+		if (!bound || bound->type_kind != load->type_kind)
+			return false;
+
+		const Node *exit = branch->inputs[2];
+		if (branch->inputs[1] != body->get_nodes().front() || exit->ir_type != NodeType::ENTRY ||
+		    loop.contains(exit->parent_region))
+			return false;
+
+		candidate.counter = counter;
+		candidate.bound = bound;
+		candidate.index_type = load->type_kind;
+		return is_invariant(bound, candidate);
+	}
+
+	bool LoopVectorizePass::match_body(LoopCandidate &candidate) const
+	{
+		const std::vector<Node *> nodes = candidate.body->get_nodes().snapshot();
+		if (nodes.size() < 4 || nodes.front()->ir_type != NodeType::ENTRY)
+			return false;
+
+		/* the body ends with `STORE(ADD(i, 1), counter); JUMP(header)` */
+		const Node *jump = nodes.back();
+		Node *increment = nodes[nodes.size() - 2];
+		if (jump->ir_type != NodeType::JUMP || jump->inputs.size() != 1 ||
+		    jump->inputs[0] != candidate.header->get_nodes().front() ||
+		    increment->ir_type != NodeType::STORE || increment->inputs.size() != 2 ||
+		    increment->inputs[1] != candidate.counter)
+			return false;
+
+		const Node *next = increment->inputs[0];
+		std::int64_t step = 0;
+		if (next->ir_type != NodeType::ADD || next->parent_region != candidate.body || next->inputs.size() != 2 ||
+		    !is_counter_load(next->inputs[0], candidate.counter, candidate.body) ||
+		    !literal_value(next->inputs[1], step) || step != 1)
+			return false;
+
+		candidate.increment = increment;
+		candidate.nodes.assign(nodes.begin() + 1, nodes.end() - 2);
+
+		for (Node *node: candidate.nodes)
+		{
+			if ((node->props & NodeProps::NO_OPTIMIZE) != NodeProps::NONE)
+				return false;
+			if (is_counter_load(node, candidate.counter, candidate.body))
+				candidate.addressing.insert(node);
+		}
+
+		for (Node *node: candidate.nodes)
+		{
+			if (node->ir_type != NodeType::PTR_LOAD && node->ir_type != NodeType::PTR_STORE)
+				continue;
+			if (!match_address(node, candidate))
+				return false;
+			candidate.widened.insert(node);
+		}
+
+		for (Node *node: candidate.nodes)
+		{
+			if (node == next || candidate.addressing.contains(node) || candidate.widened.contains(node))
+				continue;
+			if (!is_widenable_operation(node->ir_type) || node->inputs.size() != 2)
+				return false;
+			candidate.widened.insert(node);
+		}
+
+		/* widened values take their operands from other lanes of the same iteration or
+		 * from values every lane shares */
+		for (Node *node: candidate.nodes)
+		{
+			if (!candidate.widened.contains(node))
+				continue;
+			if (!is_simd_compatible_type(element_type_of(node)))
+				return false;
+			if (node->ir_type == NodeType::PTR_LOAD)
+				continue;
+
+			const std::size_t count = node->ir_type == NodeType::PTR_STORE ? 1 : node->inputs.size();
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				Node *input = node->inputs[i];
+				if (candidate.widened.contains(input))
+					continue;
+				if (!is_invariant(input, candidate))
+					return false;
+				if (std::ranges::find(candidate.invariants, input) == candidate.invariants.end())
+					candidate.invariants.push_back(input);
+			}
+		}
+		return true;
+	}
+
+	bool LoopVectorizePass::match_address(Node *access, LoopCandidate &candidate) const
+	{
+		Node *address = address_operand(access);
+		const DataType element = element_type_of(access);
+		if (!address || !is_simd_compatible_type(element))
+			return false;
+
+		const std::uint64_t size = layout->get_size(element);
+		if (size == 0 || address->ir_type != NodeType::PTR_ADD || address->inputs.size() != 2 ||
+		    address->parent_region != candidate.body || !is_invariant(address->inputs[0], candidate))
+			return false;
+
+		/* the offset is `i * size`, `i << log2(size)`, or just `i` for bytes */
+		Node *offset = address->inputs[1];
+		Node *index = nullptr;
+		std::int64_t value = 0;
+		if (size == 1)
+			index = offset;
+		else if (offset->ir_type == NodeType::MUL && offset->inputs.size() == 2)
+		{
+			if (literal_value(offset->inputs[1], value) && value == static_cast<std::int64_t>(size))
+				index = offset->inputs[0];
+			else if (literal_value(offset->inputs[0], value) && value == static_cast<std::int64_t>(size))
+				index = offset->inputs[1];
+		}
+		else if (offset->ir_type == NodeType::BSHL && offset->inputs.size() == 2 && std::has_single_bit(size) &&
+		         literal_value(offset->inputs[1], value) && value == std::countr_zero(size))
+			index = offset->inputs[0];
+
+		if (!index || (index != offset && offset->parent_region != candidate.body))
+			return false;
+
+		std::int64_t index_offset = 0;
+		if (!match_index(index, candidate, index_offset))
+			return false;
+
+		candidate.addressing.insert(address);
+		candidate.addressing.insert(offset);
+		candidate.addressing.insert(index);
+		candidate.accesses.push_back({ access, address->inputs[0], index_offset, size });
+		return true;
+	}
+
+	bool LoopVectorizePass::match_index(Node *node, const LoopCandidate &candidate, std::int64_t &offset)
+	{
+		if (is_counter_load(node, candidate.counter, candidate.body))
+		{
+			offset = 0;
+			return true;
+		}
+
+		if (node->parent_region != candidate.body || node->inputs.size() != 2)
+			return false;
+
+		Node *lhs = node->inputs[0];
+		Node *rhs = node->inputs[1];
+		std::int64_t value = 0;
+		switch (node->ir_type)
+		{
+			case NodeType::ADD:
+				if (is_counter_load(lhs, candidate.counter, candidate.body) && literal_value(rhs, value))
+				{
+					offset = value;
+					return true;
+				}
+				if (literal_value(lhs, value) && is_counter_load(rhs, candidate.counter, candidate.body))
+				{
+					offset = value;
+					return true;
+				}
+				return false;
+			case NodeType::SUB:
+				if (is_counter_load(lhs, candidate.counter, candidate.body) && literal_value(rhs, value))
+				{
+					offset = -value;
+					return true;
+				}
+				return false;
+			default:
+				return false;
+		}
+	}
+
+	bool LoopVectorizePass::check_uses(const LoopCandidate &candidate)
+	{
+		const Node *next = candidate.increment->inputs[0];
+		for (const Node *node: candidate.nodes)
+		{
+			if (node == next)
+			{
+				if (node->users.size() != 1 || node->users[0] != candidate.increment)
+					return false;
+				continue;
+			}
+
+			const bool is_address = candidate.addressing.contains(node);
+			for (const Node *user: node->users)
+			{
+				/* addresses stay scalar, so they only feed other addresses and the accesses
+				 * they address; values from a lane never leave the body */
+				if (is_address)
+				{
+					const bool feeds_access = candidate.widened.contains(user) && address_operand(user) == node &&
+					                          (user->ir_type == NodeType::PTR_LOAD || user->inputs[0] != node);
+					const bool feeds_increment = user == next;
+					if (!candidate.addressing.contains(user) && !feeds_access && !feeds_increment)
+						return false;
+				}
+				else if (!candidate.widened.contains(user) || address_operand(user) == node)
+					return false;
+			}
+		}
+		return true;
+	}
+
+	bool LoopVectorizePass::check_dependences(const LoopCandidate &candidate, const LocalAliasResult &alias_result)
+	{
+		const auto &accesses = candidate.accesses;
+		for (const StridedAccess &access: accesses)
+		{
+			if (access.access->ir_type == NodeType::PTR_STORE &&
+			    alias_result.alias(access.base, candidate.counter) != AliasResult::NO_ALIAS)
+				return false;
+		}
+
+		for (std::size_t i = 0; i < accesses.size(); ++i)
+		{
+			for (std::size_t j = i + 1; j < accesses.size(); ++j)
+			{
+				const StridedAccess &first = accesses[i];
+				const StridedAccess &second = accesses[j];
+				if (first.access->ir_type != NodeType::PTR_STORE && second.access->ir_type != NodeType::PTR_STORE)
+					continue;
+
+				if (first.base != second.base)
+				{
+					if (alias_result.alias(first.base, second.base) != AliasResult::NO_ALIAS)
+						return false;
+					continue;
+				}
+				if (first.size != second.size)
+					return false;
+
+				/* lane k of `first` and lane k' of `second` touch one element when
+				 * k' - k = first.offset - second.offset. the vector body runs every lane of
+				 * `first` before any lane of `second`, which only reverses the scalar order
+				 * if k' < k; that pair must then fall in different vector iterations */
+				const std::int64_t distance = second.offset - first.offset;
+				if (distance > 0 && distance < static_cast<std::int64_t>(candidate.vf))
+					return false;
+			}
+		}
+		return true;
+	}
+
+	bool LoopVectorizePass::choose_vf(LoopCandidate &candidate) const
+	{
+		if (!target)
+		{
+			candidate.vf = DEFAULT_VF;
+			return true;
+		}
+
+		std::uint32_t vf = std::numeric_limits<std::uint32_t>::max();
+		for (const Node *node: candidate.nodes)
+		{
+			if (candidate.widened.contains(node))
+				vf = std::min(vf, target->get_max_lanes(element_type_of(node)));
+		}
+		if (vf < 2 || vf == std::numeric_limits<std::uint32_t>::max())
+			return false;
+
+		/* VF scalar iterations against one vector iteration; the counter and addresses are
+		 * computed once per iteration either way */
+		std::uint64_t scalar_cost = 0;
+		std::uint64_t vector_cost = static_cast<std::uint64_t>(candidate.invariants.size()) * target->get_splat_cost();
+		for (const Node *node: candidate.nodes)
+		{
+			if (!candidate.widened.contains(node))
+				continue;
+
+			const DataType element = element_type_of(node);
+			const std::uint32_t cost = target->get_vector_cost(node->ir_type, element, vf);
+			if (cost == VectorTarget::UNSUPPORTED)
+				return false;
+			vector_cost += cost;
+			scalar_cost += static_cast<std::uint64_t>(target->get_scalar_cost(node->ir_type, element)) * vf;
+		}
+
+		candidate.vf = vf;
+		return vector_cost < scalar_cost;
+	}
+
+	void LoopVectorizePass::vectorize(LoopCandidate &candidate, Module &module)
+	{
+		Context &ctx = module.get_context();
+		Node *header_entry = candidate.header->get_nodes().front();
+
+		Region *vector_header = module.create_region(std::string(candidate.header->get_name()) + ".vec",
+		                                             candidate.header->get_parent());
+		Region *vector_body = module.create_region(std::string(candidate.body->get_name()) + ".vec", vector_header);
+		Node *vector_header_entry = append_node(ctx, vector_header, NodeType::ENTRY, DataType::VOID, {});
+		Node *vector_body_entry = append_node(ctx, vector_body, NodeType::ENTRY, DataType::VOID, {});
+
+		/* control that entered the loop enters the vector loop instead */
+		std::vector<Node *> entering;
+		for (Node *user: header_entry->users)
+		{
+			if (user->parent_region != candidate.header && user->parent_region != candidate.body &&
+			    std::ranges::find(entering, user) == entering.end())
+				entering.push_back(user);
+		}
+		for (Node *user: entering)
+		{
+			for (Node *&input: user->inputs)
+			{
+				if (input != header_entry)
+					continue;
+				input = vector_header_entry;
+				vector_header_entry->users.push_back(user);
+			}
+			std::erase(header_entry->users, user);
+		}
+
+		/* run VF iterations while at least VF are left. `i + VF <= bound` would wrap for
+		 * counters near the type's max, so test `bound >= VF && i <= bound - VF` instead */
+		Node *vf = integer_literal(module, candidate.index_type, candidate.vf);
+		Node *index = append_node(ctx, vector_header, NodeType::LOAD, candidate.index_type, { candidate.counter });
+		Node *has_room = append_node(ctx, vector_header, NodeType::GTE, DataType::BOOL, { candidate.bound, vf });
+		Node *limit = append_node(ctx, vector_header, NodeType::SUB, candidate.index_type, { candidate.bound, vf });
+		Node *in_range = append_node(ctx, vector_header, NodeType::LTE, DataType::BOOL, { index, limit });
+		Node *condition = append_node(ctx, vector_header, NodeType::BAND, DataType::BOOL, { has_room, in_range });
+		append_node(ctx, vector_header, NodeType::BRANCH, DataType::VOID,
+		            { condition, vector_body_entry, header_entry });
+
+		std::unordered_map<Node *, Node *> mapped;
+		std::unordered_map<Node *, Node *> splats;
+		Node *body_index = append_node(ctx, vector_body, NodeType::LOAD, candidate.index_type, { candidate.counter });
+
+		auto scalar_operand = [&](Node *input)
+		{
+			const auto it = mapped.find(input);
+			return it != mapped.end() ? it->second : input;
+		};
+		auto vector_operand = [&](Node *input)
+		{
+			if (const auto it = mapped.find(input); it != mapped.end())
+				return it->second;
+
+			Node *&splat = splats[input];
+			if (!splat)
+				splat = append_node(ctx, vector_body, NodeType::VECTOR_SPLAT,
+				                    ctx.create_vector_type(input->type_kind, candidate.vf), { input });
+			return splat;
+		};
+
+		const Node *scalar_next = candidate.increment->inputs[0];
+		for (Node *node: candidate.nodes)
+		{
+			if (node == scalar_next)
+				continue;
+
+			if (is_counter_load(node, candidate.counter, candidate.body))
+			{
+				mapped[node] = body_index;
+				continue;
+			}
+
+			Node *copy = nullptr;
+			if (candidate.addressing.contains(node))
+			{
+				std::vector<Node *> inputs;
+				for (Node *input: node->inputs)
+					inputs.push_back(scalar_operand(input));
+				copy = append_node(ctx, vector_body, node->ir_type, node->type_kind, std::move(inputs));
+			}
+			else if (node->ir_type == NodeType::PTR_LOAD)
+			{
+				copy = append_node(ctx, vector_body, NodeType::PTR_LOAD,
+				                   ctx.create_vector_type(node->type_kind, candidate.vf),
+				                   { scalar_operand(node->inputs[0]) });
+				++widened_nodes;
+			}
+			else if (node->ir_type == NodeType::PTR_STORE)
+			{
+				Node *value = vector_operand(node->inputs[0]);
+				copy = append_node(ctx, vector_body, NodeType::PTR_STORE, node->type_kind,
+				                   { value, scalar_operand(node->inputs[1]) });
+				++widened_nodes;
+			}
+			else
+			{
+				Node *lhs = vector_operand(node->inputs[0]);
+				Node *rhs = vector_operand(node->inputs[1]);
+				copy = append_node(ctx, vector_body, node->ir_type,
+				                   ctx.create_vector_type(node->type_kind, candidate.vf), { lhs, rhs });
+				++widened_nodes;
+			}
+			copy->props = node->props;
+			mapped[node] = copy;
+		}
+
+		/* the header guarantees `i + VF <= bound`, so the step cannot wrap */
+		Node *next = append_node(ctx, vector_body, NodeType::ADD, candidate.index_type, { body_index, vf });
+		append_node(ctx, vector_body, NodeType::STORE, candidate.increment->type_kind, { next, candidate.counter });
+		append_node(ctx, vector_body, NodeType::JUMP, DataType::VOID, { vector_header_entry });
+	}
+
+	DataType LoopVectorizePass::element_type_of(const Node *node)
+	{
+		if (node->ir_type == NodeType::PTR_STORE)
+			return node->inputs.empty() ? DataType::VOID : node->inputs[0]->type_kind;
+		return node->type_kind;
+	}
+
+	bool LoopVectorizePass::is_invariant(const Node *node, const LoopCandidate &candidate)
+	{
+		return node->ir_type == NodeType::LIT ||
+		       (node->parent_region != candidate.header && node->parent_region != candidate.body);
+	}
+
+	bool LoopVectorizePass::is_widenable_operation(const NodeType type)
+	{
+		switch (type)
+		{
+			case NodeType::ADD:
+			case NodeType::SUB:
+			case NodeType::MUL:
+			case NodeType::DIV:
+			case NodeType::BAND:
+			case NodeType::BOR:
+			case NodeType::BXOR:
+			case NodeType::BSHL:
+			case NodeType::BSHR:
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	bool LoopVectorizePass::is_simd_compatible_type(const DataType type)
+	{
+		return is_integer_type(type) || type == DataType::FLOAT32 || type == DataType::FLOAT64;
+	}
+}
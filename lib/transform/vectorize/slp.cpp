@@ -1,6 +1,7 @@
 /* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
 
 #include <algorithm>
+#include <bit>
 #include <functional>
 #include <bloom/foundation/context.hpp>
 #include <bloom/foundation/pass-context.hpp>
@@ -27,49 +28,73 @@ namespace blm
 
 	bool SLPPass::run(Module &module, PassContext &context)
 	{
-		const auto *alias_result = context.get_result<LocalAliasResult>();
-		std::unique_ptr<LocalAliasResult> local_result;
-		if (!alias_result)
-		{
-			LocalAliasAnalysisPass laa;
-			local_result = std::unique_ptr<LocalAliasResult>(
-				dynamic_cast<LocalAliasResult *>(laa.analyze(module, context).release()));
-			alias_result = local_result.get();
-		}
+		const LocalAliasResult &alias_result = get_local_alias_result(module, context);
 
 		processed_nodes.clear();
 		candidates.clear();
+		store_groups = 0;
+		rejected_store_groups = 0;
+		tree_operations = 0;
+		cycles_saved = 0;
+		rejected_candidates = 0;
 		std::size_t vectorized_count = 0;
+		std::size_t vectorized_groups = 0;
 
 		for (Node *func: module.get_functions())
 		{
 			if (func->ir_type != NodeType::FUNCTION)
 				continue;
 
-			if (Region *func_region = find_function_region(func, module))
-				process_region(func_region, *alias_result, module.get_context());
+			if (Region *func_region = module.get_function_region(func))
+				process_region(func_region, alias_result, module.get_context());
 		}
 
-		std::ranges::sort(candidates,
-		                  [](const VectorCandidate &a, const VectorCandidate &b)
-		                  {
-			                  return a.scalar_ops.size() > b.scalar_ops.size();
-		                  });
+		if (target)
+		{
+			for (auto &candidate: candidates)
+				candidate.cycles_saved = estimate_savings(candidate);
+			std::ranges::stable_sort(candidates,
+			                         [](const VectorCandidate &a, const VectorCandidate &b)
+			                         {
+				                         return a.cycles_saved > b.cycles_saved;
+			                         });
+		}
+		else
+		{
+			std::ranges::sort(candidates,
+			                  [](const VectorCandidate &a, const VectorCandidate &b)
+			                  {
+				                  return a.scalar_ops.size() > b.scalar_ops.size();
+			                  });
+		}
 
 		for (const auto &candidate: candidates)
 		{
-			if (candidate.is_valid())
+			if (!candidate.is_valid())
+				continue;
+
+			if (target && candidate.cycles_saved <= 0)
 			{
-				if (Region *target_region = candidate.scalar_ops[0]->parent_region)
-				{
-					vectorize_candidate(candidate, target_region, module.get_context());
-					vectorized_count += candidate.scalar_ops.size();
-				}
+				++rejected_candidates;
+				continue;
+			}
+
+			if (Region *target_region = candidate.scalar_ops[0]->parent_region)
+			{
+				vectorize_candidate(candidate, target_region, module.get_context());
+				vectorized_count += candidate.scalar_ops.size();
+				cycles_saved += candidate.cycles_saved;
+				++vectorized_groups;
 			}
 		}
 
+		vectorized_count += tree_operations;
 		context.update_stat("slp.vectorized_operations", vectorized_count);
-		context.update_stat("slp.vector_groups", candidates.size());
+		context.update_stat("slp.vector_groups", vectorized_groups + store_groups);
+		context.update_stat("slp.store_groups", store_groups);
+		context.update_stat("slp.rejected_store_groups", rejected_store_groups);
+		context.update_stat("slp.rejected_candidates", rejected_candidates);
+		context.update_stat("slp.estimated_cycles_saved", static_cast<std::size_t>(cycles_saved));
 		return vectorized_count > 0;
 	}
 
@@ -78,6 +103,8 @@ namespace blm
 		if (!region)
 			return;
 
+		vectorize_store_groups(region, alias_result, ctx);
+
 		DependencyGraph dep_graph = build_dependency_graph(region);
 		for (auto region_candidates = find_vectorization_candidates(region);
 		     const auto &candidate: region_candidates)
@@ -90,6 +117,683 @@ namespace blm
 			process_region(child, alias_result, ctx);
 	}
 
+	void SLPPass::vectorize_store_groups(Region *region, const LocalAliasResult &alias_result, Context &ctx)
+	{
+		MemoryFacts facts = collect_memory_facts(region, alias_result, ctx.get_data_layout());
+		for (const std::vector<Node *> &group: find_store_groups(facts))
+		{
+			number_positions(facts);
+			Node *anchor = *std::ranges::max_element(group, {},
+			                                         [&](const Node *store)
+			                                         {
+				                                         return facts.positions.at(store);
+			                                         });
+			if (!can_sink_stores(group, anchor, facts))
+			{
+				++rejected_store_groups;
+				continue;
+			}
+
+			/* lanes that cannot move to the anchor, or that the target cannot vectorize, are
+			 * gathered instead, which may free others */
+			std::unordered_set<const Node *> forced;
+			SLPTree tree = build_tree(group, facts, forced);
+			while (true)
+			{
+				std::vector<const Node *> unsafe = find_unsafe_lanes(tree, anchor, facts);
+				if (unsafe.empty())
+					unsafe = find_unsupported_lanes(tree);
+				if (unsafe.empty())
+					break;
+
+				forced.insert(unsafe.begin(), unsafe.end());
+				tree = build_tree(group, facts, forced);
+			}
+
+			const std::int64_t savings = estimate_savings(tree);
+			if (savings <= 0)
+			{
+				++rejected_store_groups;
+				continue;
+			}
+
+			if (target)
+				cycles_saved += savings;
+			tree_operations += emit_tree(tree, region, anchor, ctx);
+			for (const SLPBundle &bundle: tree.bundles)
+				processed_nodes.insert(bundle.vector);
+			++store_groups;
+		}
+	}
+
+	SLPPass::MemoryFacts SLPPass::collect_memory_facts(Region *region, const LocalAliasResult &alias_result,
+	                                                   const DataLayout &layout)
+	{
+		MemoryFacts facts;
+		facts.region = region;
+		facts.alias_result = &alias_result;
+		facts.layout = &layout;
+
+		for (Node *node: region->get_nodes())
+		{
+			Node *address = address_operand(node);
+			if (!address || facts.locations.contains(address))
+				continue;
+
+			if (const MemoryLocation *location = alias_result.get_location(address);
+				location && location->base && location->offset >= 0)
+			{
+				facts.locations.emplace(address, *location);
+				continue;
+			}
+
+			/* allocations and parameters have no location of their own; they sit at offset 0 of themselves */
+			switch (address->ir_type)
+			{
+				case NodeType::STACK_ALLOC:
+				case NodeType::HEAP_ALLOC:
+				case NodeType::PARAM:
+					facts.locations.emplace(address, MemoryLocation { alias_result.get_pointer_source(address), 0, 0 });
+					break;
+				default:
+					break;
+			}
+		}
+
+		number_positions(facts);
+		return facts;
+	}
+
+	void SLPPass::number_positions(MemoryFacts &facts)
+	{
+		facts.order.clear();
+		facts.positions.clear();
+		for (Node *node: facts.region->get_nodes())
+		{
+			facts.positions.emplace(node, facts.order.size());
+			facts.order.push_back(node);
+		}
+	}
+
+	std::vector<std::vector<Node *> > SLPPass::find_store_groups(const MemoryFacts &facts) const
+	{
+		struct Bucket
+		{
+			const Node *base;
+			DataType type;
+			std::vector<std::pair<std::int64_t, Node *> > stores; /* offset, store */
+		};
+
+		/* buckets stay in the order their first store appears, so groups are found deterministically */
+		std::vector<Bucket> buckets;
+		std::unordered_map<const Node *, std::vector<std::size_t> > buckets_of_base;
+		for (Node *node: facts.order)
+		{
+			if (node->ir_type != NodeType::PTR_STORE || node->inputs.size() != 2 || !node->inputs[0] ||
+			    (node->props & NodeProps::NO_OPTIMIZE) != NodeProps::NONE)
+				continue;
+
+			const DataType type = node->inputs[0]->type_kind;
+			const auto location = facts.locations.find(node->inputs[1]);
+			if (!is_simd_compatible_type(type) || location == facts.locations.end())
+				continue;
+
+			const Node *base = location->second.base;
+			auto &indices = buckets_of_base[base];
+			auto it = std::ranges::find_if(indices,
+			                               [&](const std::size_t index)
+			                               {
+				                               return buckets[index].type == type;
+			                               });
+			if (it == indices.end())
+			{
+				indices.push_back(buckets.size());
+				buckets.push_back({ base, type, {} });
+				it = std::prev(indices.end());
+			}
+			buckets[*it].stores.emplace_back(location->second.offset, node);
+		}
+
+		std::vector<std::vector<Node *> > groups;
+		for (auto &[base, type, stores]: buckets)
+		{
+			const auto element_size = static_cast<std::int64_t>(facts.layout->get_size(type));
+			if (element_size == 0 || stores.size() < 2)
+				continue;
+
+			std::ranges::stable_sort(stores, {}, &std::pair<std::int64_t, Node *>::first);
+
+			std::size_t begin = 0;
+			while (begin < stores.size())
+			{
+				std::size_t end = begin + 1;
+				while (end < stores.size() && stores[end].first == stores[end - 1].first + element_size)
+					++end;
+
+				/* split the run into the widest power of two lanes that fit, largest first */
+				const std::uint32_t max_width = choose_width(type);
+				while (end - begin >= 2)
+				{
+					std::size_t width = std::bit_floor(std::min<std::size_t>(end - begin, max_width));
+					std::vector<Node *> group;
+					group.reserve(width);
+					for (std::size_t i = begin; i < begin + width; ++i)
+						group.push_back(stores[i].second);
+					groups.push_back(std::move(group));
+					begin += width;
+				}
+				begin = end;
+			}
+		}
+
+		return groups;
+	}
+
+	bool SLPPass::can_sink_stores(const std::vector<Node *> &group, const Node *anchor, const MemoryFacts &facts)
+	{
+		const std::unordered_set<const Node *> members(group.begin(), group.end());
+		const std::size_t anchor_position = facts.positions.at(anchor);
+		for (Node *store: group)
+		{
+			for (std::size_t i = facts.positions.at(store) + 1; i < anchor_position; ++i)
+			{
+				Node *node = facts.order[i];
+				if (members.contains(node))
+					continue;
+				if (is_memory_barrier(node) || (address_operand(node) && may_overlap(store, node, facts)))
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	SLPTree SLPPass::build_tree(const std::vector<Node *> &group, const MemoryFacts &facts,
+	                            const std::unordered_set<const Node *> &forced)
+	{
+		SLPTree tree;
+		tree.bundles.push_back({ SLPBundle::Kind::STORE, group, {}, nullptr });
+
+		std::unordered_set<const Node *> claimed(group.begin(), group.end());
+		std::vector<Node *> values;
+		values.reserve(group.size());
+		for (Node *store: group)
+			values.push_back(store->inputs[0]);
+
+		const std::size_t operand = build_bundle(tree, values, facts, forced, claimed, 1);
+		tree.bundles[0].operands.push_back(operand);
+		return tree;
+	}
+
+	std::size_t SLPPass::build_bundle(SLPTree &tree, const std::vector<Node *> &lanes, const MemoryFacts &facts, // NOLINT(*-no-recursion)
+	                                  const std::unordered_set<const Node *> &forced,
+	                                  std::unordered_set<const Node *> &claimed, const std::size_t depth)
+	{
+		for (std::size_t i = 0; i < tree.bundles.size(); ++i)
+		{
+			if (tree.bundles[i].lanes == lanes)
+				return i;
+		}
+
+		const std::size_t index = tree.bundles.size();
+		tree.bundles.push_back({ SLPBundle::Kind::GATHER, lanes, {}, nullptr });
+
+		const Node *first = lanes[0];
+		if (std::ranges::all_of(lanes, [&](const Node *lane) { return lane == first; }))
+		{
+			tree.bundles[index].kind = SLPBundle::Kind::SPLAT;
+			return index;
+		}
+
+		std::unordered_set<const Node *> seen;
+		const bool packable = depth < MAX_TREE_DEPTH &&
+		                      is_simd_compatible_type(first->type_kind) &&
+		                      std::ranges::all_of(lanes,
+		                                          [&](const Node *lane)
+		                                          {
+			                                          return seen.insert(lane).second &&
+			                                                 lane->parent_region == facts.region &&
+			                                                 lane->ir_type == first->ir_type &&
+			                                                 lane->type_kind == first->type_kind &&
+			                                                 lane->inputs.size() == first->inputs.size() &&
+			                                                 std::ranges::none_of(lane->inputs,
+			                                                                      [](const Node *input)
+			                                                                      {
+				                                                                      return !input;
+			                                                                      }) &&
+			                                                 (lane->props & NodeProps::NO_OPTIMIZE) == NodeProps::NONE &&
+			                                                 !forced.contains(lane) && !claimed.contains(lane);
+		                                          });
+		if (!packable)
+			return index;
+
+		if (first->ir_type == NodeType::PTR_LOAD)
+		{
+			if (are_consecutive_accesses(lanes, facts))
+			{
+				tree.bundles[index].kind = SLPBundle::Kind::LOAD;
+				claimed.insert(lanes.begin(), lanes.end());
+			}
+			return index;
+		}
+
+		if (!can_vectorize_operation(first->ir_type) || first->ir_type == NodeType::LOAD ||
+		    first->ir_type == NodeType::STORE || first->ir_type == NodeType::PTR_STORE)
+			return index;
+
+		tree.bundles[index].kind = SLPBundle::Kind::OPERATION;
+		claimed.insert(lanes.begin(), lanes.end());
+		for (std::size_t i = 0; i < first->inputs.size(); ++i)
+		{
+			std::vector<Node *> operands;
+			operands.reserve(lanes.size());
+			for (const Node *lane: lanes)
+				operands.push_back(lane->inputs[i]);
+
+			const std::size_t operand = build_bundle(tree, operands, facts, forced, claimed, depth + 1);
+			tree.bundles[index].operands.push_back(operand);
+		}
+
+		return index;
+	}
+
+	std::vector<const Node *> SLPPass::find_unsafe_lanes(const SLPTree &tree, const Node *anchor,
+	                                                      const MemoryFacts &facts)
+	{
+		std::unordered_set<const Node *> packed;
+		std::unordered_set<const Node *> scalar;
+		for (const SLPBundle &bundle: tree.bundles)
+		{
+			auto &lanes = bundle.kind == SLPBundle::Kind::GATHER || bundle.kind == SLPBundle::Kind::SPLAT
+				              ? scalar
+				              : packed;
+			lanes.insert(bundle.lanes.begin(), bundle.lanes.end());
+		}
+
+		const std::size_t anchor_position = facts.positions.at(anchor);
+		std::vector<const Node *> unsafe;
+		for (const SLPBundle &bundle: tree.bundles)
+		{
+			if (bundle.kind != SLPBundle::Kind::LOAD && bundle.kind != SLPBundle::Kind::OPERATION)
+				continue;
+
+			for (Node *lane: bundle.lanes)
+			{
+				/* a gather still needs the scalar, and users before the anchor would read an extract placed after them */
+				bool safe = !scalar.contains(lane) &&
+				            std::ranges::all_of(lane->users,
+				                                [&](const Node *user)
+				                                {
+					                                if (packed.contains(user))
+						                                return true;
+					                                const auto position = facts.positions.find(user);
+					                                return position != facts.positions.end() &&
+					                                       position->second >= anchor_position;
+				                                });
+
+				/* the vector load reads at the anchor, so nothing in between may write what it reads */
+				if (safe && bundle.kind == SLPBundle::Kind::LOAD)
+				{
+					for (std::size_t i = facts.positions.at(lane) + 1; safe && i < anchor_position; ++i)
+					{
+						Node *node = facts.order[i];
+						if (is_memory_barrier(node))
+							safe = false;
+						else if (node->ir_type == NodeType::PTR_STORE && !packed.contains(node))
+							safe = !may_overlap(lane, node, facts); /* stores of the group sink below the load anyway */
+					}
+				}
+
+				if (!safe)
+					unsafe.push_back(lane);
+			}
+		}
+
+		return unsafe;
+	}
+
+	std::size_t SLPPass::count_extracts(const SLPTree &tree)
+	{
+		std::unordered_set<const Node *> internal;
+		for (const SLPBundle &bundle: tree.bundles)
+		{
+			if (bundle.kind != SLPBundle::Kind::GATHER && bundle.kind != SLPBundle::Kind::SPLAT)
+				internal.insert(bundle.lanes.begin(), bundle.lanes.end());
+		}
+
+		std::size_t extracts = 0;
+		for (const SLPBundle &bundle: tree.bundles)
+		{
+			if (bundle.kind != SLPBundle::Kind::LOAD && bundle.kind != SLPBundle::Kind::OPERATION)
+				continue;
+
+			for (const Node *lane: bundle.lanes)
+			{
+				extracts += std::ranges::any_of(lane->users,
+				                                [&](const Node *user)
+				                                {
+					                                return !internal.contains(user);
+				                                });
+			}
+		}
+
+		return extracts;
+	}
+
+	std::vector<const Node *> SLPPass::find_unsupported_lanes(const SLPTree &tree) const
+	{
+		std::vector<const Node *> unsupported;
+		if (!target)
+			return unsupported;
+
+		for (const SLPBundle &bundle: tree.bundles)
+		{
+			if (bundle.kind != SLPBundle::Kind::LOAD && bundle.kind != SLPBundle::Kind::OPERATION)
+				continue;
+
+			const Node *first = bundle.lanes[0];
+			if (target->get_vector_cost(first->ir_type, first->type_kind,
+			                            static_cast<std::uint32_t>(bundle.lanes.size())) == VectorTarget::UNSUPPORTED)
+				unsupported.insert(unsupported.end(), bundle.lanes.begin(), bundle.lanes.end());
+		}
+
+		return unsupported;
+	}
+
+	std::int64_t SLPPass::estimate_savings(const SLPTree &tree) const
+	{
+		if (!target)
+		{
+			/* each packed bundle replaces its lanes with one vector node; each gathered lane,
+			 * splat and extract costs a node of its own */
+			std::int64_t saved = 0;
+			std::int64_t cost = static_cast<std::int64_t>(count_extracts(tree));
+			for (const SLPBundle &bundle: tree.bundles)
+			{
+				switch (bundle.kind)
+				{
+					case SLPBundle::Kind::STORE:
+					case SLPBundle::Kind::LOAD:
+					case SLPBundle::Kind::OPERATION:
+						saved += static_cast<std::int64_t>(bundle.lanes.size()) - 1;
+						break;
+					case SLPBundle::Kind::SPLAT:
+						++cost;
+						break;
+					case SLPBundle::Kind::GATHER:
+						cost += static_cast<std::int64_t>(bundle.lanes.size());
+						break;
+				}
+			}
+
+			return saved - cost;
+		}
+
+		std::int64_t scalar = 0;
+		std::int64_t vector = static_cast<std::int64_t>(count_extracts(tree) * target->get_extract_cost());
+		for (const SLPBundle &bundle: tree.bundles)
+		{
+			const Node *first = bundle.lanes[0];
+			const auto lanes = static_cast<std::uint32_t>(bundle.lanes.size());
+			if (bundle.kind == SLPBundle::Kind::SPLAT)
+			{
+				vector += target->get_splat_cost();
+				continue;
+			}
+			if (bundle.kind == SLPBundle::Kind::GATHER)
+			{
+				vector += estimate_gather_cost(bundle.lanes);
+				continue;
+			}
+
+			/* a store costs what the type of its value does */
+			const DataType element = bundle.kind == SLPBundle::Kind::STORE ? first->inputs[0]->type_kind : first->type_kind;
+			const std::uint32_t cost = target->get_vector_cost(first->ir_type, element, lanes);
+			if (cost == VectorTarget::UNSUPPORTED)
+				return 0;
+
+			scalar += static_cast<std::int64_t>(target->get_scalar_cost(first->ir_type, element)) * lanes;
+			vector += cost;
+		}
+
+		return scalar - vector;
+	}
+
+	std::int64_t SLPPass::estimate_savings(const VectorCandidate &candidate) const
+	{
+		const auto width = static_cast<std::uint32_t>(candidate.scalar_ops.size());
+		const std::uint32_t cost = target->get_vector_cost(candidate.operation, candidate.element_type, width);
+		if (cost == VectorTarget::UNSUPPORTED || width == 0)
+			return 0;
+
+		const std::int64_t scalar = static_cast<std::int64_t>(
+			                            target->get_scalar_cost(candidate.operation, candidate.element_type)) * width;
+		std::int64_t vector = cost + static_cast<std::int64_t>(target->get_extract_cost()) * width;
+		for (std::size_t i = 0; i < candidate.scalar_ops[0]->inputs.size(); ++i)
+		{
+			std::vector<Node *> operands;
+			for (const Node *op: candidate.scalar_ops)
+			{
+				if (i < op->inputs.size() && op->inputs[i])
+					operands.push_back(op->inputs[i]);
+			}
+			if (!operands.empty())
+				vector += estimate_gather_cost(operands);
+		}
+
+		return scalar - vector;
+	}
+
+	std::int64_t SLPPass::estimate_gather_cost(const std::vector<Node *> &lanes) const
+	{
+		const Node *first = lanes[0];
+		if (std::ranges::all_of(lanes, [&](const Node *lane) { return lane == first; }))
+			return target->get_splat_cost();
+
+		if (std::ranges::all_of(lanes, [](const Node *lane) { return lane->ir_type == NodeType::LIT; }))
+		{
+			if (const std::uint32_t cost = target->get_vector_cost(NodeType::PTR_LOAD, first->type_kind,
+			                                                       static_cast<std::uint32_t>(lanes.size()));
+				cost != VectorTarget::UNSUPPORTED)
+				return cost;
+		}
+
+		return static_cast<std::int64_t>(target->get_insert_cost()) * static_cast<std::int64_t>(lanes.size());
+	}
+
+	std::uint32_t SLPPass::choose_width(const DataType element_type) const
+	{
+		if (!target)
+			return get_max_vector_width(element_type);
+		return std::max(target->get_max_lanes(element_type), 1u);
+	}
+
+	std::size_t SLPPass::emit_tree(SLPTree &tree, Region *region, Node *anchor, Context &ctx)
+	{
+		emit_bundle(tree, 0, region, anchor, ctx);
+
+		std::unordered_set<const Node *> internal;
+		std::vector<Node *> scalars;
+		for (const SLPBundle &bundle: tree.bundles)
+		{
+			if (bundle.kind == SLPBundle::Kind::GATHER || bundle.kind == SLPBundle::Kind::SPLAT)
+				continue;
+			internal.insert(bundle.lanes.begin(), bundle.lanes.end());
+			scalars.insert(scalars.end(), bundle.lanes.begin(), bundle.lanes.end());
+		}
+
+		/* scalars still read after the anchor are taken back out of their vector */
+		for (const SLPBundle &bundle: tree.bundles)
+		{
+			if (bundle.kind != SLPBundle::Kind::LOAD && bundle.kind != SLPBundle::Kind::OPERATION)
+				continue;
+
+			for (std::size_t i = 0; i < bundle.lanes.size(); ++i)
+			{
+				Node *lane = bundle.lanes[i];
+				if (std::ranges::all_of(lane->users, [&](const Node *user) { return internal.contains(user); }))
+					continue;
+
+				Node *extract = ctx.create<Node>();
+				extract->ir_type = NodeType::VECTOR_EXTRACT;
+				extract->type_kind = lane->type_kind;
+				extract->inputs.push_back(bundle.vector);
+				bundle.vector->users.push_back(extract);
+
+				Node *index = ctx.create<Node>();
+				index->ir_type = NodeType::LIT;
+				index->type_kind = DataType::UINT32;
+				index->data.set<std::uint32_t, DataType::UINT32>(static_cast<std::uint32_t>(i));
+				extract->inputs.push_back(index);
+				index->users.push_back(extract);
+
+				region->insert_node_before(anchor, index);
+				region->insert_node_before(anchor, extract);
+				replace_node_uses(lane, extract);
+			}
+		}
+
+		remove_scalar_operations(scalars, region);
+		return scalars.size();
+	}
+
+	Node *SLPPass::emit_bundle(SLPTree &tree, const std::size_t index, Region *region, Node *anchor, Context &ctx) // NOLINT(*-no-recursion)
+	{
+		if (Node *vector = tree.bundles[index].vector)
+			return vector;
+
+		std::vector<Node *> operands;
+		for (const std::size_t operand: tree.bundles[index].operands)
+			operands.push_back(emit_bundle(tree, operand, region, anchor, ctx));
+
+		SLPBundle &bundle = tree.bundles[index];
+		Node *first = bundle.lanes[0];
+		const DataType vector_type = ctx.create_vector_type(first->type_kind,
+		                                                    static_cast<std::uint32_t>(bundle.lanes.size()));
+
+		Node *vector = ctx.create<Node>();
+		vector->type_kind = vector_type;
+		switch (bundle.kind)
+		{
+			case SLPBundle::Kind::STORE:
+				/* lane 0 has the lowest address, so the whole group is stored from there */
+				vector->ir_type = NodeType::PTR_STORE;
+				vector->type_kind = first->type_kind;
+				vector->inputs = { operands[0], address_operand(first) };
+				break;
+			case SLPBundle::Kind::LOAD:
+				vector->ir_type = NodeType::PTR_LOAD;
+				vector->inputs = { address_operand(first) };
+				break;
+			case SLPBundle::Kind::OPERATION:
+				vector->ir_type = first->ir_type;
+				vector->inputs = std::move(operands);
+				break;
+			case SLPBundle::Kind::SPLAT:
+				vector->ir_type = NodeType::VECTOR_SPLAT;
+				vector->inputs = { first };
+				break;
+			case SLPBundle::Kind::GATHER:
+				vector->ir_type = NodeType::VECTOR_BUILD;
+				vector->inputs = bundle.lanes;
+				break;
+		}
+
+		for (Node *input: vector->inputs)
+			input->users.push_back(vector);
+
+		region->insert_node_before(anchor, vector);
+		bundle.vector = vector;
+		return vector;
+	}
+
+	bool SLPPass::are_consecutive_accesses(const std::vector<Node *> &accesses, const MemoryFacts &facts)
+	{
+		const auto first = facts.locations.find(address_operand(accesses[0]));
+		if (first == facts.locations.end())
+			return false;
+
+		const auto element_size = static_cast<std::int64_t>(access_size(accesses[0], facts));
+		if (element_size == 0)
+			return false;
+
+		for (std::size_t i = 1; i < accesses.size(); ++i)
+		{
+			const auto location = facts.locations.find(address_operand(accesses[i]));
+			if (location == facts.locations.end() ||
+			    location->second.base != first->second.base ||
+			    location->second.offset != first->second.offset + static_cast<std::int64_t>(i) * element_size)
+				return false;
+		}
+
+		return true;
+	}
+
+	bool SLPPass::may_overlap(Node *a, Node *b, const MemoryFacts &facts)
+	{
+		Node *address_a = address_operand(a);
+		Node *address_b = address_operand(b);
+		const auto location_a = facts.locations.find(address_a);
+		const auto location_b = facts.locations.find(address_b);
+
+		/* the analysis sizes every pointer location by the pointer, so adjacent elements of one
+		 * base look like partial aliases to it; compare the accessed bytes instead */
+		if (location_a != facts.locations.end() && location_b != facts.locations.end() &&
+		    location_a->second.base == location_b->second.base)
+		{
+			const auto size_a = static_cast<std::int64_t>(access_size(a, facts));
+			const auto size_b = static_cast<std::int64_t>(access_size(b, facts));
+			if (size_a == 0 || size_b == 0)
+				return true;
+
+			const std::int64_t begin_a = location_a->second.offset;
+			const std::int64_t begin_b = location_b->second.offset;
+			return begin_a < begin_b + size_b && begin_b < begin_a + size_a;
+		}
+
+		return facts.alias_result->may_alias(address_a, address_b);
+	}
+
+	bool SLPPass::is_memory_barrier(const Node *node)
+	{
+		switch (node->ir_type)
+		{
+			case NodeType::CALL:
+			case NodeType::INVOKE:
+			case NodeType::FREE:
+			case NodeType::LOAD:
+			case NodeType::STORE:
+			case NodeType::ATOMIC_LOAD:
+			case NodeType::ATOMIC_STORE:
+			case NodeType::ATOMIC_CAS:
+				return true;
+			case NodeType::PTR_LOAD:
+			case NodeType::PTR_STORE:
+				return (node->props & NodeProps::NO_OPTIMIZE) != NodeProps::NONE;
+			default:
+				return false;
+		}
+	}
+
+	Node *SLPPass::address_operand(const Node *access)
+	{
+		if (access->ir_type == NodeType::PTR_LOAD && !access->inputs.empty())
+			return access->inputs[0];
+		if (access->ir_type == NodeType::PTR_STORE && access->inputs.size() >= 2)
+			return access->inputs[1];
+		return nullptr;
+	}
+
+	std::uint64_t SLPPass::access_size(const Node *access, const MemoryFacts &facts)
+	{
+		const DataType type = access->ir_type == NodeType::PTR_STORE ? access->inputs[0]->type_kind : access->type_kind;
+
+		/* the layout does not size vectors */
+		if (is_vector_type(type))
+			return 0;
+		return facts.layout->get_size(type);
+	}
+
 	DependencyGraph SLPPass::build_dependency_graph(Region *region)
 	{
 		DependencyGraph graph;
@@ -151,6 +855,11 @@ namespace blm
 		{
 			if (processed_nodes.contains(node) || !can_vectorize_operation(node->ir_type))
 				continue;
+
+			/* memory accesses are only packed as store groups, where their addresses are known to be adjacent */
+			if (node->ir_type == NodeType::LOAD || node->ir_type == NodeType::STORE || address_operand(node))
+				continue;
+
 			std::vector node_candidates = {
 				try_build_candidate(node, region),
 				try_build_isomorphic_candidate(node, region),
@@ -179,7 +888,7 @@ namespace blm
 		candidate.element_type = start_node->type_kind;
 		candidate.scalar_ops.push_back(start_node);
 
-		std::uint32_t max_width = get_max_vector_width(candidate.element_type);
+		std::uint32_t max_width = choose_width(candidate.element_type);
 		for (Node *node: region->get_nodes())
 		{
 			if (node == start_node || processed_nodes.contains(node))
@@ -204,7 +913,7 @@ namespace blm
 		candidate.element_type = start_node->type_kind;
 		candidate.scalar_ops.push_back(start_node);
 
-		std::uint32_t max_width = get_max_vector_width(candidate.element_type);
+		std::uint32_t max_width = choose_width(candidate.element_type);
 		for (Node *node: region->get_nodes())
 		{
 			if (node == start_node || processed_nodes.contains(node))
@@ -225,13 +934,13 @@ namespace blm
 		return candidate;
 	}
 
-	VectorCandidate SLPPass::try_build_chain_candidate(Node *start_node, Region *)
+	VectorCandidate SLPPass::try_build_chain_candidate(Node *start_node, Region *) const
 	{
 		VectorCandidate candidate;
 		candidate.operation = start_node->ir_type;
 		candidate.element_type = start_node->type_kind;
 
-		std::vector<Node *> chain = find_operation_chain(start_node);
+		std::vector<Node *> chain = find_operation_chain(start_node, choose_width(start_node->type_kind));
 		if (chain.size() >= 2)
 		{
 			candidate.scalar_ops = chain;
@@ -241,7 +950,7 @@ namespace blm
 		return candidate;
 	}
 
-	std::vector<Node *> SLPPass::find_operation_chain(Node *start)
+	std::vector<Node *> SLPPass::find_operation_chain(Node *start, const std::uint32_t max_width)
 	{
 		std::vector<Node *> chain;
 		std::unordered_set<Node *> visited;
@@ -257,7 +966,7 @@ namespace blm
 			{
 				if (user->ir_type == start->ir_type &&
 				    user->type_kind == start->type_kind &&
-				    chain.size() < get_max_vector_width(start->type_kind))
+				    chain.size() < max_width)
 				{
 					build_chain(user);
 				}
@@ -474,14 +1183,15 @@ namespace blm
 			operand->users.push_back(vector_build);
 		}
 
+		/* the first scalar op in region order */
 		Node *earliest_user = scalar_ops[0];
-		for (Node *scalar_op: scalar_ops)
+		for (Node *node: region->get_nodes())
 		{
-			const auto &nodes = region->get_nodes();
-			auto earliest_pos = std::find(nodes.begin(), nodes.end(), earliest_user);
-			auto current_pos = std::find(nodes.begin(), nodes.end(), scalar_op);
-			if (current_pos < earliest_pos)
-				earliest_user = scalar_op;
+			if (std::ranges::find(scalar_ops, node) != scalar_ops.end())
+			{
+				earliest_user = node;
+				break;
+			}
 		}
 
 		region->insert_node_before(earliest_user, vector_build);
@@ -530,6 +1240,9 @@ namespace blm
 					new_node->users.push_back(user);
 				}
 			}
+
+			if (user->parent_region)
+				user->parent_region->mark_changed();
 		}
 		old_node->users.clear();
 	}
@@ -589,30 +1302,4 @@ namespace blm
 			region->remove_node(op);
 		}
 	}
-
-	Region *SLPPass::find_function_region(Node *function, Module &module) const
-	{
-		if (!function || function->ir_type != NodeType::FUNCTION)
-			return nullptr;
-
-		const std::string_view func_name = module.get_context().get_string(function->str_id);
-		return find_region_by_name(module.get_root_region(), func_name);
-	}
-
-	Region *SLPPass::find_region_by_name(const Region *region, std::string_view name) const // NOLINT(*-no-recursion)
-	{
-		if (!region)
-			return nullptr;
-
-		if (region->get_name() == name)
-			return const_cast<Region *>(region);
-
-		for (const Region *child: region->get_children())
-		{
-			if (Region *found = find_region_by_name(child, name))
-				return found;
-		}
-
-		return nullptr;
-	}
 }
@@ -0,0 +1,230 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <algorithm>
+#include <bloom/transform/vectorize/vector-target.hpp>
+
+namespace blm
+{
+	namespace
+	{
+		constexpr DataType integer_types[] = {
+			DataType::INT8, DataType::INT16, DataType::INT32, DataType::INT64,
+			DataType::UINT8, DataType::UINT16, DataType::UINT32, DataType::UINT64,
+		};
+
+		constexpr DataType float_types[] = { DataType::FLOAT32, DataType::FLOAT64 };
+
+		std::uint32_t element_bits(const DataType type)
+		{
+			switch (type)
+			{
+				case DataType::INT8:
+				case DataType::UINT8:
+					return 8;
+				case DataType::INT16:
+				case DataType::UINT16:
+					return 16;
+				case DataType::INT32:
+				case DataType::UINT32:
+				case DataType::FLOAT32:
+					return 32;
+				case DataType::INT64:
+				case DataType::UINT64:
+				case DataType::FLOAT64:
+					return 64;
+				default:
+					return 0;
+			}
+		}
+
+		/* costs every preset shares: one-cycle arithmetic, bitwise ops and full-register
+		 * loads and stores, and an integer divide with no vector form */
+		VectorTarget make_base(std::string name, const std::uint32_t register_bits)
+		{
+			VectorTarget target(std::move(name), register_bits);
+			for (const DataType type: integer_types)
+				target.add_element_type(type);
+			for (const DataType type: float_types)
+				target.add_element_type(type);
+
+			for (const NodeType op: { NodeType::ADD, NodeType::SUB, NodeType::BAND, NodeType::BOR,
+			                          NodeType::BXOR, NodeType::BSHL, NodeType::BSHR,
+			                          NodeType::PTR_LOAD, NodeType::PTR_STORE })
+				target.set_cost(op, { 1, 1 });
+
+			target.set_cost(NodeType::MUL, { 1, 2 });
+			target.set_cost(NodeType::DIV, { 20, VectorTarget::UNSUPPORTED });
+			for (const DataType type: float_types)
+				target.set_cost(NodeType::MUL, type, { 1, 1 });
+
+			/* no byte multiply or shift; widened and narrowed again */
+			for (const DataType type: { DataType::INT8, DataType::UINT8 })
+			{
+				target.set_cost(NodeType::MUL, type, { 1, 4 });
+				target.set_cost(NodeType::BSHL, type, { 1, 4 });
+				target.set_cost(NodeType::BSHR, type, { 1, 4 });
+			}
+			for (const DataType type: { DataType::INT16, DataType::UINT16 })
+				target.set_cost(NodeType::MUL, type, { 1, 1 });
+			return target;
+		}
+
+		void set_float_divide(VectorTarget &target, const OperationCost f32, const OperationCost f64)
+		{
+			target.set_cost(NodeType::DIV, DataType::FLOAT32, f32);
+			target.set_cost(NodeType::DIV, DataType::FLOAT64, f64);
+		}
+
+		void set_i64_multiply(VectorTarget &target, const std::uint32_t vector)
+		{
+			target.set_cost(NodeType::MUL, DataType::INT64, { 1, vector });
+			target.set_cost(NodeType::MUL, DataType::UINT64, { 1, vector });
+		}
+	}
+
+	VectorTarget::VectorTarget(std::string name, const std::uint32_t register_bits)
+		: name(std::move(name)), register_bits(register_bits)
+	{
+		costs.fill({ 1, UNSUPPORTED });
+	}
+
+	VectorTarget &VectorTarget::add_element_type(const DataType type)
+	{
+		if (!supports_element_type(type))
+			element_types.push_back(type);
+		return *this;
+	}
+
+	bool VectorTarget::supports_element_type(const DataType type) const
+	{
+		return std::ranges::find(element_types, type) != element_types.end();
+	}
+
+	std::uint32_t VectorTarget::get_max_lanes(const DataType element) const
+	{
+		const std::uint32_t bits = element_bits(element);
+		if (bits == 0 || !supports_element_type(element))
+			return 0;
+		return register_bits / bits;
+	}
+
+	VectorTarget &VectorTarget::set_cost(const NodeType op, const OperationCost cost)
+	{
+		costs[static_cast<std::size_t>(op)] = cost;
+		return *this;
+	}
+
+	VectorTarget &VectorTarget::set_cost(const NodeType op, const DataType element, const OperationCost cost)
+	{
+		const std::pair key { op, element };
+		if (const auto it = std::ranges::find(element_costs, key, &decltype(element_costs)::value_type::first);
+			it != element_costs.end())
+			it->second = cost;
+		else
+			element_costs.emplace_back(key, cost);
+		return *this;
+	}
+
+	VectorTarget &VectorTarget::set_shuffle_costs(const std::uint32_t insert, const std::uint32_t extract,
+	                                              const std::uint32_t splat)
+	{
+		insert_cost = insert;
+		extract_cost = extract;
+		splat_cost = splat;
+		return *this;
+	}
+
+	std::uint32_t VectorTarget::get_scalar_cost(const NodeType op, const DataType element) const
+	{
+		return get_cost(op, element).scalar;
+	}
+
+	std::uint32_t VectorTarget::get_vector_cost(const NodeType op, const DataType element,
+	                                            const std::uint32_t lanes) const
+	{
+		const std::uint32_t max_lanes = get_max_lanes(element);
+		const std::uint32_t cost = get_cost(op, element).vector;
+		if (max_lanes == 0 || cost == UNSUPPORTED)
+			return UNSUPPORTED;
+
+		const std::uint32_t registers = (lanes + max_lanes - 1) / max_lanes;
+		return cost * registers;
+	}
+
+	const OperationCost &VectorTarget::get_cost(const NodeType op, const DataType element) const
+	{
+		const std::pair key { op, element };
+		if (const auto it = std::ranges::find(element_costs, key, &decltype(element_costs)::value_type::first);
+			it != element_costs.end())
+			return it->second;
+		return costs[static_cast<std::size_t>(op)];
+	}
+
+	const VectorTarget &VectorTarget::x86_64_sse()
+	{
+		static const VectorTarget target = []
+		{
+			VectorTarget sse = make_base("sse", 128);
+			set_float_divide(sse, { 4, 4 }, { 4, 4 });
+			set_i64_multiply(sse, 6); /* no pmullq; built from pmuludq and shifts */
+
+			/* shift amounts must be uniform across lanes before AVX2 */
+			sse.set_cost(NodeType::BSHL, { 1, 2 });
+			sse.set_cost(NodeType::BSHR, { 1, 2 });
+			sse.set_shuffle_costs(1, 1, 1);
+			return sse;
+		}();
+		return target;
+	}
+
+	const VectorTarget &VectorTarget::x86_64_avx2()
+	{
+		static const VectorTarget target = []
+		{
+			VectorTarget avx2 = make_base("avx2", 256);
+			set_float_divide(avx2, { 4, 5 }, { 4, 8 });
+			set_i64_multiply(avx2, 6);
+
+			/* inserts and extracts into the upper half cross the 128-bit lanes */
+			avx2.set_shuffle_costs(2, 2, 1);
+			return avx2;
+		}();
+		return target;
+	}
+
+	const VectorTarget &VectorTarget::x86_64_avx512()
+	{
+		static const VectorTarget target = []
+		{
+			VectorTarget avx512 = make_base("avx512", 512);
+			set_float_divide(avx512, { 4, 10 }, { 4, 16 });
+			set_i64_multiply(avx512, 3); /* vpmullq */
+			avx512.set_shuffle_costs(2, 2, 1);
+			return avx512;
+		}();
+		return target;
+	}
+
+	const VectorTarget &VectorTarget::aarch64_neon()
+	{
+		static const VectorTarget target = []
+		{
+			VectorTarget neon = make_base("neon", 128);
+			set_float_divide(neon, { 5, 7 }, { 7, 12 });
+			set_i64_multiply(neon, UNSUPPORTED); /* no 64-bit lane multiply */
+			neon.set_shuffle_costs(1, 1, 1);
+			return neon;
+		}();
+		return target;
+	}
+
+	const VectorTarget *VectorTarget::find(const std::string_view name)
+	{
+		for (const VectorTarget *target: { &x86_64_sse(), &x86_64_avx2(), &x86_64_avx512(), &aarch64_neon() })
+		{
+			if (target->get_name() == name)
+				return target;
+		}
+		return nullptr;
+	}
+}
@@ -0,0 +1,204 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <bloom/analysis/dominators.hpp>
+#include <bloom/foundation/context.hpp>
+#include <bloom/foundation/module.hpp>
+#include <bloom/foundation/pass-context.hpp>
+#include <bloom/foundation/transform-pass.hpp>
+#include <gtest/gtest.h>
+
+class DominatorTreeFixture : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		context = std::make_unique<blm::Context>();
+		module = context->create_module("dom_test");
+	}
+
+	void TearDown() override
+	{
+		context.reset();
+	}
+
+	/* region with an ENTRY node so that it can be the target of control flow */
+	blm::Region *block(const std::string_view name, blm::Region *parent = nullptr) const
+	{
+		blm::Region *region = module->create_region(name, parent);
+		auto *entry = region->create_node<blm::Node>();
+		entry->ir_type = blm::NodeType::ENTRY;
+		return region;
+	}
+
+	static void jump(blm::Region *from, const blm::Region *to)
+	{
+		auto *node = from->create_node<blm::Node>();
+		node->ir_type = blm::NodeType::JUMP;
+		node->inputs.push_back(to->get_nodes().front());
+	}
+
+	static void branch(blm::Region *from, const blm::Region *on_true, const blm::Region *on_false)
+	{
+		auto *node = from->create_node<blm::Node>();
+		node->ir_type = blm::NodeType::BRANCH;
+		node->inputs.push_back(nullptr);
+		node->inputs.push_back(on_true->get_nodes().front());
+		node->inputs.push_back(on_false->get_nodes().front());
+	}
+
+	std::unique_ptr<blm::Context> context;
+	blm::Module *module = nullptr;
+};
+
+TEST_F(DominatorTreeFixture, StructuredNesting)
+{
+	blm::Region *root = module->get_root_region();
+	blm::Region *func = block("func");
+	blm::Region *inner = block("inner", func);
+	blm::Region *leaf = block("leaf", inner);
+	blm::Region *other = block("other", func);
+
+	const blm::DominatorTree tree(root);
+	EXPECT_EQ(tree.get_root(), root);
+	EXPECT_EQ(tree.get_idom(root), nullptr);
+	EXPECT_EQ(tree.get_idom(func), root);
+	EXPECT_EQ(tree.get_idom(leaf), inner);
+
+	EXPECT_TRUE(tree.dominates(func, leaf));
+	EXPECT_TRUE(tree.dominates(leaf, leaf));
+	EXPECT_TRUE(tree.strictly_dominates(root, other));
+	EXPECT_FALSE(tree.strictly_dominates(leaf, leaf));
+	EXPECT_FALSE(tree.dominates(inner, other));
+	EXPECT_FALSE(tree.dominates(leaf, func));
+	EXPECT_EQ(tree.nearest_common_dominator(leaf, other), func);
+}
+
+TEST_F(DominatorTreeFixture, SiblingJumpDoesNotDominate)
+{
+	blm::Region *func = block("func");
+	blm::Region *a = block("a", func);
+	blm::Region *b = block("b", func);
+	jump(a, b);
+
+	const blm::DominatorTree tree(module->get_root_region());
+	EXPECT_EQ(tree.get_idom(b), func);
+	EXPECT_FALSE(tree.dominates(a, b));
+	EXPECT_EQ(tree.nearest_common_dominator(a, b), func);
+}
+
+TEST_F(DominatorTreeFixture, JumpIntoNestedRegion)
+{
+	/* w is nested in z but also entered from y, so only x dominates it */
+	blm::Region *x = block("x");
+	blm::Region *y = block("y", x);
+	blm::Region *z = block("z", x);
+	blm::Region *w = block("w", z);
+	jump(y, w);
+
+	const blm::DominatorTree tree(module->get_root_region());
+	EXPECT_EQ(tree.get_idom(w), x);
+	EXPECT_FALSE(tree.dominates(z, w));
+	EXPECT_TRUE(tree.dominates(x, w));
+	EXPECT_EQ(tree.nearest_common_dominator(y, w), x);
+}
+
+TEST_F(DominatorTreeFixture, LoopHeaderDominatesBody)
+{
+	blm::Region *func = block("func");
+	blm::Region *header = block("header", func);
+	blm::Region *body = block("body", header);
+	blm::Region *exit = block("exit", func);
+	jump(func, header);
+	branch(header, body, exit);
+	jump(body, header);
+
+	const blm::DominatorTree tree(module->get_root_region());
+	EXPECT_TRUE(tree.dominates(header, body));
+	EXPECT_FALSE(tree.dominates(body, header));
+	EXPECT_EQ(tree.get_idom(exit), func);
+	EXPECT_EQ(tree.size(), module->get_root_region()->get_children().size() + 4);
+}
+
+TEST_F(DominatorTreeFixture, UnknownRegions)
+{
+	blm::Region *func = block("func");
+	blm::Region *detached = block("detached", func);
+
+	const blm::DominatorTree tree(func);
+	blm::Region *root = module->get_root_region();
+	EXPECT_FALSE(tree.contains(root));
+	EXPECT_TRUE(tree.contains(detached));
+	EXPECT_TRUE(tree.dominates(root, root));
+	EXPECT_FALSE(tree.dominates(root, func));
+	EXPECT_FALSE(tree.dominates(func, root));
+	EXPECT_EQ(tree.get_idom(root), nullptr);
+	EXPECT_EQ(tree.nearest_common_dominator(root, func), nullptr);
+
+	const blm::DominatorTree empty;
+	EXPECT_EQ(empty.size(), 0);
+	EXPECT_EQ(empty.get_root(), nullptr);
+	EXPECT_FALSE(empty.dominates(func, detached));
+}
+
+namespace
+{
+	class MockTransform final : public blm::TransformPass
+	{
+	public:
+		[[nodiscard]] std::string_view name() const override
+		{
+			return "mock-transform";
+		}
+
+		[[nodiscard]] std::string_view description() const override
+		{
+			return "does nothing";
+		}
+
+		bool run(blm::Module &, blm::PassContext &) override
+		{
+			return true;
+		}
+	};
+}
+
+TEST_F(DominatorTreeFixture, CachedInPassContext)
+{
+	blm::Region *func = block("func");
+	blm::Region *inner = block("inner", func);
+
+	blm::PassContext pass_context(*module);
+	EXPECT_EQ(blm::get_dominator_tree(pass_context), nullptr);
+
+	blm::DominatorTreeAnalysisPass pass;
+	ASSERT_TRUE(pass.run(*module, pass_context));
+
+	const blm::DominatorTree *tree = blm::get_dominator_tree(pass_context);
+	ASSERT_NE(tree, nullptr);
+	EXPECT_TRUE(tree->dominates(func, inner));
+	EXPECT_EQ(pass_context.get_stat("dominator_tree.regions"), tree->size());
+
+	pass_context.invalidate_by(typeid(MockTransform));
+	EXPECT_EQ(blm::get_dominator_tree(pass_context), nullptr);
+}
+
+TEST_F(DominatorTreeFixture, SurvivesTransformsThatPreserveCFG)
+{
+	block("func");
+
+	blm::PassContext pass_context(*module);
+	blm::DominatorTreeAnalysisPass pass;
+	ASSERT_TRUE(pass.run(*module, pass_context));
+
+	const auto *result = pass_context.get_result<blm::DominatorTreeResult>(typeid(blm::DominatorTreeAnalysisPass));
+	ASSERT_NE(result, nullptr);
+	EXPECT_FALSE(result->invalidated_by(typeid(MockTransform), blm::PreservedAnalyses::none().preserve_cfg()));
+	EXPECT_TRUE(result->invalidated_by(typeid(MockTransform), blm::PreservedAnalyses::none()));
+	EXPECT_TRUE(result->invalidated_by(typeid(MockTransform)));
+
+	pass_context.invalidate_by(typeid(MockTransform), blm::PreservedAnalyses::none().preserve_cfg());
+	EXPECT_NE(blm::get_dominator_tree(pass_context), nullptr);
+
+	pass_context.invalidate_by(typeid(MockTransform), blm::PreservedAnalyses::none());
+	EXPECT_EQ(blm::get_dominator_tree(pass_context), nullptr);
+}
@@ -3,6 +3,7 @@
 #include <bloom/analysis/laa.hpp>
 #include <bloom/foundation/context.hpp>
 #include <bloom/foundation/pass-context.hpp>
+#include <bloom/foundation/region.hpp>
 #include <bloom/ir/builder.hpp>
 #include <gtest/gtest.h>
 
@@ -645,3 +646,139 @@ TEST_F(LocalAliasAnalysisFixture, AtomicOperations)
 	EXPECT_TRUE(aa_result->maybe_modified_by(atomic_load, atomic_store));
     EXPECT_TRUE(aa_result->maybe_modified_by(regular_load, atomic_store));
 }
+
+TEST_F(LocalAliasAnalysisFixture, RelationsMatchPairwiseAlias)
+{
+	auto *module = builder->create_module("test_module");
+	auto func = builder->create_function("test_function", { blm::DataType::POINTER, blm::DataType::INT64 },
+	                                     blm::DataType::VOID);
+
+	std::vector<blm::Node *> stores;
+	std::vector<blm::Node *> loads;
+
+	func.body([&]
+	{
+		auto *param_ptr = func.add_parameter("ptr", blm::DataType::POINTER);
+		auto *param_offset = func.add_parameter("offset", blm::DataType::INT64);
+		auto *value = builder->literal(42);
+
+		/* addresses into three objects at several offsets, one unknown offset per object,
+		 * plus an escaped parameter */
+		std::vector<blm::Node *> addresses { param_ptr };
+		for (int object = 0; object < 3; ++object)
+		{
+			auto *alloc = builder->stack_alloc(builder->literal(64), blm::DataType::INT32);
+			addresses.push_back(alloc);
+			addresses.push_back(builder->ptr_add(alloc, param_offset));
+			for (std::int64_t offset = 4; offset < 64; offset += 12)
+				addresses.push_back(builder->ptr_add(alloc, builder->literal(offset)));
+		}
+
+		std::uint32_t seed = 12345;
+		const auto next = [&] { return (seed = seed * 1103515245 + 12345) >> 16; };
+		for (int i = 0; i < 64; ++i)
+		{
+			blm::Node *address = addresses[next() % addresses.size()];
+			if (next() % 2)
+				stores.push_back(builder->store(value, address));
+			else
+				loads.push_back(builder->load(address, blm::DataType::INT32));
+		}
+	});
+
+	blm::PassContext pass_ctx(*module, 1);
+	blm::LocalAliasAnalysisPass aa;
+	const auto result = aa.analyze(*module, pass_ctx);
+	auto *aa_result = dynamic_cast<blm::LocalAliasResult *>(result.get());
+	ASSERT_NE(aa_result, nullptr);
+
+	std::size_t related = 0;
+	for (blm::Node *store: stores)
+	{
+		for (blm::Node *load: loads)
+		{
+			blm::Node *store_address = store->inputs[1];
+			blm::Node *load_address = load->inputs[0];
+			const bool expected = store_address == load_address ||
+			                      aa_result->alias(store_address, load_address) != blm::AliasResult::NO_ALIAS;
+			EXPECT_EQ(aa_result->maybe_modified_by(load, store), expected);
+			related += expected;
+		}
+	}
+
+	/* both cases have to occur for the comparison to mean anything */
+	EXPECT_GT(related, 0u);
+	EXPECT_LT(related, stores.size() * loads.size());
+
+	for (blm::Node *load: loads)
+	{
+		const auto affecting = aa_result->get_affecting_stores(load);
+		EXPECT_TRUE(std::ranges::is_sorted(affecting, {}, [](const blm::Node *node) { return node->index; }));
+		for (blm::Node *store: affecting)
+			EXPECT_TRUE(aa_result->maybe_modified_by(load, store));
+	}
+}
+
+TEST_F(LocalAliasAnalysisFixture, KeepsResultsOfUnchangedFunctions)
+{
+	auto *module = builder->create_module("test_module");
+
+	struct Accesses
+	{
+		blm::Node *func = nullptr;
+		blm::Node *object_a = nullptr;
+		blm::Node *object_b = nullptr;
+		blm::Node *store = nullptr;
+		blm::Node *load = nullptr;
+	};
+
+	const auto build = [&](const std::string_view name)
+	{
+		Accesses accesses;
+		auto func = builder->create_function(name, {}, blm::DataType::VOID);
+		func.body([&]
+		{
+			accesses.object_a = builder->stack_alloc(builder->literal(16), blm::DataType::INT32);
+			accesses.object_b = builder->stack_alloc(builder->literal(16), blm::DataType::INT32);
+			accesses.store = builder->store(builder->literal(1), accesses.object_a);
+			accesses.load = builder->load(accesses.object_b, blm::DataType::INT32);
+		});
+		accesses.func = func.get_function();
+		return accesses;
+	};
+
+	const Accesses f = build("f");
+	const Accesses g = build("g");
+
+	blm::PassContext pass_ctx(*module, 1);
+	const blm::LocalAliasResult &aa_result = blm::get_local_alias_result(*module, pass_ctx);
+	const blm::FunctionAliasResult *g_result = aa_result.get_function_result(g.func);
+	ASSERT_NE(g_result, nullptr);
+	ASSERT_NE(aa_result.get_function_result(f.func), nullptr);
+	const blm::NodeId g_begin = g_result->get_range().begin;
+	EXPECT_FALSE(aa_result.maybe_modified_by(g.load, g.store));
+
+	/* growing f moves g in the numbering but leaves it unchanged */
+	blm::Node *extra = module->get_function_region(f.func)->create_node<blm::Node>();
+	extra->ir_type = blm::NodeType::STACK_ALLOC;
+	extra->type_kind = blm::DataType::POINTER;
+
+	EXPECT_EQ(&blm::get_local_alias_result(*module, pass_ctx), &aa_result);
+	EXPECT_EQ(aa_result.get_function_result(g.func), g_result);
+	EXPECT_NE(g_result->get_range().begin, g_begin);
+	EXPECT_TRUE(aa_result.is_allocation_site(extra));
+	EXPECT_TRUE(aa_result.is_allocation_site(g.object_a));
+	EXPECT_EQ(aa_result.alias(g.object_a, g.object_b), blm::AliasResult::NO_ALIAS);
+	EXPECT_FALSE(aa_result.maybe_modified_by(g.load, g.store));
+	EXPECT_EQ(aa_result.alias(f.object_a, g.object_a), blm::AliasResult::NO_ALIAS);
+
+	/* an input rewritten in place is reported through the region */
+	std::erase(g.object_b->users, g.load);
+	g.load->inputs[0] = g.object_a;
+	g.object_a->users.push_back(g.load);
+	g.load->parent_region->mark_changed();
+
+	blm::get_local_alias_result(*module, pass_ctx);
+	EXPECT_TRUE(aa_result.maybe_modified_by(g.load, g.store));
+	EXPECT_EQ(aa_result.get_affecting_stores(g.load), std::vector<blm::Node *> { g.store });
+}
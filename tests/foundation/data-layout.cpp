@@ -0,0 +1,71 @@
+/* this project is part of the Bloom Project; licensed under the MIT license. see LICENSE for more info */
+
+#include <bloom/foundation/context.hpp>
+#include <bloom/foundation/data-layout.hpp>
+#include <gtest/gtest.h>
+
+class DataLayoutFixture : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		context = std::make_unique<blm::Context>();
+
+		/* struct { i8 tag; f64 value; i16 id[3]; i32 count; } */
+		id_array = context->create_array_type(blm::DataType::INT16, 3);
+		record = context->create_struct_type({
+			                                     { "tag", blm::DataType::INT8 },
+			                                     { "value", blm::DataType::FLOAT64 },
+			                                     { "id", id_array },
+			                                     { "count", blm::DataType::INT32 }
+		                                     }, 32, 8);
+	}
+
+	void TearDown() override
+	{
+		context.reset();
+	}
+
+	std::unique_ptr<blm::Context> context;
+	blm::DataType id_array = {};
+	blm::DataType record = {};
+};
+
+TEST_F(DataLayoutFixture, SizesAndAlignment)
+{
+	const blm::DataLayout &layout = context->get_data_layout();
+	EXPECT_EQ(layout.get_size(blm::DataType::INT16), 2u);
+	EXPECT_EQ(layout.get_size(id_array), 6u);
+	EXPECT_EQ(layout.get_alignment(id_array), 2u);
+	EXPECT_EQ(layout.get_size(record), 32u);
+	EXPECT_EQ(layout.get_alignment(record), 8u);
+	EXPECT_EQ(layout.get_size(context->create_pointer_type(record)), 8u);
+}
+
+TEST_F(DataLayoutFixture, FieldOffsets)
+{
+	const blm::DataLayout &layout = context->get_data_layout();
+	const std::vector<std::uint64_t> expected = { 0, 8, 16, 24 };
+	EXPECT_EQ(layout.get_field_offsets(record), expected);
+	EXPECT_TRUE(layout.get_field_offsets(blm::DataType::INT32).empty());
+	EXPECT_TRUE(layout.get_field_offsets(id_array).empty());
+
+	EXPECT_EQ(layout.compute_field_offsets(context->get_type(record).get<blm::DataType::STRUCT>().fields), expected);
+}
+
+TEST_F(DataLayoutFixture, OffsetToField)
+{
+	const blm::DataLayout &layout = context->get_data_layout();
+	EXPECT_EQ(layout.get_field_at(record, 0), 0u);
+	EXPECT_EQ(layout.get_field_at(record, 16), 2u);
+	EXPECT_EQ(layout.get_field_at(record, 24), 3u);
+	EXPECT_EQ(layout.get_field_at(record, 4), blm::DataLayout::NO_FIELD);
+	EXPECT_EQ(layout.get_field_at(record, -8), blm::DataLayout::NO_FIELD);
+
+	EXPECT_EQ(layout.get_field_containing(record, 12), 1u);
+	EXPECT_EQ(layout.get_field_containing(record, 20), 2u);
+	EXPECT_EQ(layout.get_field_containing(record, 27), 3u);
+	EXPECT_EQ(layout.get_field_containing(record, 3), blm::DataLayout::NO_FIELD); /* padding after tag */
+	EXPECT_EQ(layout.get_field_containing(record, 22), blm::DataLayout::NO_FIELD); /* padding after id */
+	EXPECT_EQ(layout.get_field_containing(record, 28), blm::DataLayout::NO_FIELD);
+}
@@ -0,0 +1,362 @@
+/* this project is part of the Bloom Project; licensed under the MIT license. see LICENSE for more info */
+
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <bloom/foundation/context.hpp>
+#include <bloom/foundation/function-pipeline.hpp>
+#include <bloom/foundation/module.hpp>
+#include <bloom/foundation/pass-context.hpp>
+#include <bloom/foundation/pass-manager.hpp>
+#include <bloom/foundation/region.hpp>
+#include <bloom/transform/constfold.hpp>
+#include <bloom/transform/cse.hpp>
+#include <bloom/transform/dce.hpp>
+#include <bloom/transform/instcombine/instcombine.hpp>
+#include <gtest/gtest.h>
+
+/* records the threads functions were run on */
+class ThreadRecordingPass final : public blm::FunctionPass
+{
+public:
+    struct Record
+    {
+        std::mutex mutex;
+        std::set<std::thread::id> threads;
+    };
+
+    explicit ThreadRecordingPass(Record& record) : record(record) {}
+
+    [[nodiscard]] std::string_view name() const override
+    {
+        return "thread-recording";
+    }
+
+    [[nodiscard]] std::string_view description() const override
+    {
+        return "records the threads functions run on";
+    }
+
+    bool run_on_function(const blm::FunctionUnit&, blm::PassContext&) override
+    {
+        /* long enough for idle workers to pick up functions when there are any */
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        const std::lock_guard lock(record.mutex);
+        record.threads.insert(std::this_thread::get_id());
+        return false;
+    }
+
+    [[nodiscard]] std::unique_ptr<blm::FunctionPass> clone() const override
+    {
+        return std::make_unique<ThreadRecordingPass>(record);
+    }
+
+private:
+    Record& record;
+};
+
+class FunctionPipelineFixture : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        context = std::make_unique<blm::Context>();
+        module = std::make_unique<blm::Module>(*context, "test_module");
+    }
+
+    void TearDown() override
+    {
+        module.reset();
+        context.reset();
+    }
+
+    static blm::Node* connect(blm::Region* region, const blm::NodeType type, blm::Node* lhs, blm::Node* rhs)
+    {
+        auto* node = region->create_node<blm::Node>();
+        node->ir_type = type;
+        node->type_kind = blm::DataType::INT32;
+        node->inputs.push_back(lhs);
+        node->inputs.push_back(rhs);
+        lhs->users.push_back(node);
+        rhs->users.push_back(node);
+        return node;
+    }
+
+    /* ret (p + (2 + 3)) - (p + (2 + 3)), plus an unused literal */
+    blm::Region* create_function(const std::string& name)
+    {
+        auto* region = module->create_region(name);
+
+        auto* entry = region->create_node<blm::Node>();
+        entry->ir_type = blm::NodeType::ENTRY;
+
+        auto* param = region->create_node<blm::Node>();
+        param->ir_type = blm::NodeType::PARAM;
+        param->type_kind = blm::DataType::INT32;
+
+        auto* two = region->create_node<blm::Node>();
+        two->ir_type = blm::NodeType::LIT;
+        two->type_kind = blm::DataType::INT32;
+        two->data.set<std::int32_t, blm::DataType::INT32>(2);
+
+        auto* three = region->create_node<blm::Node>();
+        three->ir_type = blm::NodeType::LIT;
+        three->type_kind = blm::DataType::INT32;
+        three->data.set<std::int32_t, blm::DataType::INT32>(3);
+
+        auto* unused = region->create_node<blm::Node>();
+        unused->ir_type = blm::NodeType::LIT;
+        unused->type_kind = blm::DataType::INT32;
+        unused->data.set<std::int32_t, blm::DataType::INT32>(42);
+
+        auto* sum = connect(region, blm::NodeType::ADD, two, three);
+        auto* lhs = connect(region, blm::NodeType::ADD, param, sum);
+        auto* rhs = connect(region, blm::NodeType::ADD, param, sum);
+        auto* result = connect(region, blm::NodeType::SUB, lhs, rhs);
+
+        auto* ret = region->create_node<blm::Node>();
+        ret->ir_type = blm::NodeType::RET;
+        ret->inputs.push_back(result);
+        result->users.push_back(ret);
+
+        auto* func = region->create_node<blm::Node>();
+        func->ir_type = blm::NodeType::FUNCTION;
+        func->str_id = context->intern_string(name);
+        module->add_function(func);
+        return region;
+    }
+
+    static void add_passes(blm::FunctionPipeline& pipeline)
+    {
+        pipeline.add_pass<blm::ConstantFoldingPass>()
+                .add_pass<blm::InstcombinePass>()
+                .add_pass<blm::CSEPass>()
+                .add_pass<blm::DCEPass>();
+    }
+
+    std::unique_ptr<blm::Context> context;
+    std::unique_ptr<blm::Module> module;
+};
+
+TEST_F(FunctionPipelineFixture, EmptyModuleNoChanges)
+{
+    blm::FunctionPipeline pipeline(4);
+    add_passes(pipeline);
+
+    blm::PassContext pass_ctx(*module, 1);
+    EXPECT_FALSE(pipeline.run(*module, pass_ctx));
+}
+
+TEST_F(FunctionPipelineFixture, RunsEveryPassOnEveryFunction)
+{
+    constexpr std::size_t function_count = 64;
+    std::vector<blm::Region*> bodies;
+    for (std::size_t i = 0; i < function_count; ++i)
+        bodies.push_back(create_function("f" + std::to_string(i)));
+
+    blm::FunctionPipeline pipeline(4);
+    add_passes(pipeline);
+    EXPECT_EQ(pipeline.get_thread_count(), 4);
+
+    blm::PassContext pass_ctx(*module, 1);
+    EXPECT_TRUE(pipeline.run(*module, pass_ctx));
+
+    /* every worker's statistics end up in the caller's context */
+    EXPECT_EQ(pass_ctx.get_stat("constant_folding.folded_nodes"), function_count);
+    EXPECT_EQ(pass_ctx.get_stat("cse.eliminated_expressions"), function_count);
+
+    /* all functions share the single pooled literal the sums folded to */
+    const blm::Node* folded = nullptr;
+    for (const blm::Region* body: bodies)
+    {
+        const blm::Node* ret = nullptr;
+        for (const blm::Node* node: body->get_nodes())
+        {
+            if (node->ir_type == blm::NodeType::RET)
+                ret = node;
+            EXPECT_NE(node->ir_type, blm::NodeType::LIT);
+        }
+        ASSERT_NE(ret, nullptr);
+
+        const blm::Node* result = ret->inputs[0];
+        ASSERT_EQ(result->inputs.size(), 2);
+        EXPECT_EQ(result->inputs[0], result->inputs[1]);
+
+        const blm::Node* constant = result->inputs[0]->inputs[1];
+        ASSERT_EQ(constant->ir_type, blm::NodeType::LIT);
+        EXPECT_EQ(constant->as<blm::DataType::INT32>(), 5);
+        if (folded)
+        {
+            EXPECT_EQ(constant, folded);
+        }
+        folded = constant;
+    }
+    EXPECT_EQ(folded->users.size(), function_count);
+}
+
+TEST_F(FunctionPipelineFixture, MatchesSequentialRun)
+{
+    for (int i = 0; i < 16; ++i)
+        create_function("f" + std::to_string(i));
+
+    blm::FunctionPipeline sequential(1);
+    add_passes(sequential);
+    blm::PassContext sequential_ctx(*module, 1);
+    sequential.run(*module, sequential_ctx);
+
+    auto other_context = std::make_unique<blm::Context>();
+    std::swap(context, other_context);
+    auto other_module = std::make_unique<blm::Module>(*context, "test_module");
+    std::swap(module, other_module);
+    for (int i = 0; i < 16; ++i)
+        create_function("f" + std::to_string(i));
+
+    blm::FunctionPipeline parallel(4);
+    add_passes(parallel);
+    blm::PassContext parallel_ctx(*module, 1);
+    parallel.run(*module, parallel_ctx);
+
+    for (const std::string_view stat: { "constant_folding.folded_nodes", "cse.eliminated_expressions", "dce.removed_nodes" })
+        EXPECT_EQ(parallel_ctx.get_stat(stat), sequential_ctx.get_stat(stat)) << stat;
+
+    other_module.reset();
+    other_context.reset();
+}
+
+TEST_F(FunctionPipelineFixture, SingleThreadedContextRunsSerially)
+{
+    module.reset();
+    context = std::make_unique<blm::Context>(blm::NodeAllocation::SLAB);
+    module = std::make_unique<blm::Module>(*context, "test_module");
+    for (int i = 0; i < 16; ++i)
+        create_function("f" + std::to_string(i));
+
+    ThreadRecordingPass::Record record;
+    blm::FunctionPipeline pipeline(4);
+    add_passes(pipeline);
+    pipeline.add_pass<ThreadRecordingPass>(record);
+    blm::PassContext pass_ctx(*module, 1);
+    EXPECT_TRUE(pipeline.run(*module, pass_ctx));
+
+    /* slab contexts are single-threaded, so every function runs on the caller */
+    ASSERT_EQ(record.threads.size(), 1);
+    EXPECT_EQ(*record.threads.begin(), std::this_thread::get_id());
+    EXPECT_EQ(pass_ctx.get_stat("constant_folding.folded_nodes"), 16);
+}
+
+TEST_F(FunctionPipelineFixture, IteratesToFixpoint)
+{
+    constexpr std::size_t function_count = 8;
+    std::vector<blm::Region*> bodies;
+    for (std::size_t i = 0; i < function_count; ++i)
+        bodies.push_back(create_function("f" + std::to_string(i)));
+
+    /* CSE makes both sides of the subtraction the same node; only a second instcombine sees x - x */
+    blm::FunctionPipeline pipeline(4);
+    add_passes(pipeline);
+    pipeline.set_max_iterations(8);
+
+    blm::PassContext pass_ctx(*module, 1);
+    EXPECT_TRUE(pipeline.run(*module, pass_ctx));
+
+    const auto& iterations = pipeline.get_iteration_stats();
+    ASSERT_EQ(iterations.size(), 3);
+    EXPECT_EQ(iterations[0].functions, function_count);
+    EXPECT_EQ(iterations[0].changed, function_count);
+    EXPECT_EQ(iterations[1].changed, function_count);
+    EXPECT_EQ(iterations.back().changed, 0);
+    EXPECT_EQ(pass_ctx.get_stat("function_pipeline.iterations"), 3);
+
+    for (const blm::Region* body: bodies)
+    {
+        const blm::Node* ret = nullptr;
+        for (const blm::Node* node: body->get_nodes())
+        {
+            if (node->ir_type == blm::NodeType::RET)
+                ret = node;
+        }
+        ASSERT_NE(ret, nullptr);
+        ASSERT_EQ(ret->inputs[0]->ir_type, blm::NodeType::LIT);
+        EXPECT_EQ(ret->inputs[0]->as<blm::DataType::INT32>(), 0);
+    }
+}
+
+TEST_F(FunctionPipelineFixture, RevisitsOnlyChangedFunctions)
+{
+    create_function("changing");
+
+    /* already minimal: nothing to fold, combine or remove */
+    auto* region = module->create_region("stable");
+    auto* entry = region->create_node<blm::Node>();
+    entry->ir_type = blm::NodeType::ENTRY;
+    auto* param = region->create_node<blm::Node>();
+    param->ir_type = blm::NodeType::PARAM;
+    param->type_kind = blm::DataType::INT32;
+    auto* ret = region->create_node<blm::Node>();
+    ret->ir_type = blm::NodeType::RET;
+    ret->inputs.push_back(param);
+    param->users.push_back(ret);
+    auto* func = region->create_node<blm::Node>();
+    func->ir_type = blm::NodeType::FUNCTION;
+    func->str_id = context->intern_string("stable");
+    module->add_function(func);
+
+    blm::FunctionPipeline pipeline(2);
+    add_passes(pipeline);
+    pipeline.set_max_iterations(8);
+
+    blm::PassContext pass_ctx(*module, 1);
+    pipeline.run(*module, pass_ctx);
+
+    const auto& iterations = pipeline.get_iteration_stats();
+    ASSERT_GE(iterations.size(), 2);
+    EXPECT_EQ(iterations[0].functions, 2);
+    EXPECT_EQ(iterations[0].changed, 1);
+    EXPECT_EQ(iterations[1].functions, 1);
+}
+
+TEST_F(FunctionPipelineFixture, StopsAtIterationCap)
+{
+    create_function("f");
+
+    blm::FunctionPipeline pipeline(1);
+    add_passes(pipeline);
+    pipeline.set_max_iterations(2);
+
+    blm::PassContext pass_ctx(*module, 1);
+    EXPECT_TRUE(pipeline.run(*module, pass_ctx));
+    EXPECT_EQ(pipeline.get_iteration_stats().size(), 2);
+    EXPECT_EQ(pipeline.get_iteration_stats().back().changed, 1);
+
+    /* the default runs the sequence once */
+    blm::FunctionPipeline once(1);
+    add_passes(once);
+    EXPECT_EQ(once.get_max_iterations(), 1);
+    once.run(*module, pass_ctx);
+    EXPECT_EQ(once.get_iteration_stats().size(), 1);
+}
+
+TEST_F(FunctionPipelineFixture, IterationsInStatistics)
+{
+    create_function("f");
+
+    auto pipeline = std::make_unique<blm::FunctionPipeline>(1);
+    add_passes(*pipeline);
+    pipeline->set_max_iterations(4);
+
+    blm::PassManager manager(*module, 1);
+    manager.add_pass(std::move(pipeline));
+    EXPECT_TRUE(manager.run_all());
+
+    std::stringstream output;
+    manager.print_statistics(output);
+    const std::string text = output.str();
+    EXPECT_NE(text.find("function-pipeline"), std::string::npos);
+    EXPECT_NE(text.find("iteration 1"), std::string::npos);
+    EXPECT_NE(text.find("iteration 3"), std::string::npos);
+    EXPECT_EQ(text.find("iteration 4"), std::string::npos);
+}
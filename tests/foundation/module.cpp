@@ -63,6 +63,29 @@ TEST_F(ModuleFixture, RegionHierarchy)
     EXPECT_EQ(region4->get_children().size(), 0);
 }
 
+TEST_F(ModuleFixture, RegionRemoval)
+{
+    auto* parent = module->create_region("parent");
+    auto* child = module->create_region("child", parent);
+    auto* first = module->create_region("dup");
+    auto* second = module->create_region("dup");
+
+    module->remove_region(child);
+    EXPECT_TRUE(parent->get_children().empty());
+
+    /* removing the indexed region re-points the name lookup at the next one */
+    auto* func = module->get_root_region()->create_node<blm::Node>();
+    func->ir_type = blm::NodeType::FUNCTION;
+    func->str_id = context->intern_string("dup");
+    module->remove_region(first);
+    module->add_function(func);
+    EXPECT_EQ(module->get_function_region(func), second);
+
+    module->remove_region(second);
+    EXPECT_EQ(module->get_function_region(func), nullptr);
+    EXPECT_EQ(module->get_root_region()->get_children().size(), 1);
+}
+
 TEST_F(ModuleFixture, FunctionManagement)
 {
     auto* node = module->get_root_region()->create_node<blm::Node>();
@@ -110,3 +133,110 @@ TEST_F(ModuleFixture, InvalidFunctionNodes)
     module->add_function(nullptr);
     EXPECT_EQ(module->get_functions().size(), 0); /* noop */
 }
+
+TEST_F(ModuleFixture, FunctionRegionFromParent)
+{
+    auto* body = module->create_region("body");
+    auto* func = body->create_node<blm::Node>();
+    func->ir_type = blm::NodeType::FUNCTION;
+    func->str_id = context->intern_string("func");
+
+    module->add_function(func);
+    EXPECT_EQ(module->get_function_region(func), body);
+}
+
+TEST_F(ModuleFixture, FunctionRegionByName)
+{
+    /* region created before the function is registered */
+    auto* before_region = module->create_region("before");
+    auto* before = module->get_root_region()->create_node<blm::Node>();
+    before->ir_type = blm::NodeType::FUNCTION;
+    before->str_id = context->intern_string("before");
+    module->add_function(before);
+    EXPECT_EQ(module->get_function_region(before), before_region);
+
+    /* region created after the function is registered */
+    auto* after = module->get_root_region()->create_node<blm::Node>();
+    after->ir_type = blm::NodeType::FUNCTION;
+    after->str_id = context->intern_string("after");
+    module->add_function(after);
+    EXPECT_EQ(module->get_function_region(after), nullptr);
+
+    auto* after_region = module->create_region("after");
+    EXPECT_EQ(module->get_function_region(after), after_region);
+}
+
+TEST_F(ModuleFixture, FunctionRegionUpdates)
+{
+    auto* body = module->create_region("func");
+    auto* func = module->get_root_region()->create_node<blm::Node>();
+    func->ir_type = blm::NodeType::FUNCTION;
+    func->str_id = context->intern_string("func");
+    module->add_function(func);
+
+    auto* moved = module->create_region("moved");
+    module->set_function_region(func, moved);
+    EXPECT_EQ(module->get_function_region(func), moved);
+
+    module->set_function_region(func, nullptr);
+    EXPECT_EQ(module->get_function_region(func), nullptr);
+
+    module->set_function_region(func, body);
+    module->remove_function(func);
+    EXPECT_EQ(module->get_functions().size(), 0);
+    EXPECT_EQ(module->get_function_region(func), nullptr);
+}
+
+TEST_F(ModuleFixture, LiteralPoolSharesConstants)
+{
+    auto* a = module->intern_literal<blm::DataType::INT32>(42);
+    auto* b = module->intern_literal<blm::DataType::INT32>(42);
+    ASSERT_NE(a, nullptr);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(a->ir_type, blm::NodeType::LIT);
+    EXPECT_EQ(a->parent_region, module->get_root_region());
+    EXPECT_EQ(a->as<blm::DataType::INT32>(), 42);
+
+    /* same bits, different type */
+    EXPECT_NE(module->intern_literal<blm::DataType::UINT32>(42), a);
+    EXPECT_NE(module->intern_literal<blm::DataType::INT32>(43), a);
+
+    blm::TypedData data;
+    data.set<std::int32_t, blm::DataType::INT32>(42);
+    EXPECT_EQ(module->intern_literal(data), a);
+}
+
+TEST_F(ModuleFixture, LiteralPoolKeysOnBitPattern)
+{
+    auto* zero = module->intern_literal<blm::DataType::FLOAT64>(0.0);
+    auto* negative_zero = module->intern_literal<blm::DataType::FLOAT64>(-0.0);
+    EXPECT_NE(zero, negative_zero);
+    EXPECT_EQ(module->intern_literal<blm::DataType::FLOAT64>(-0.0), negative_zero);
+    EXPECT_NE(module->intern_literal<blm::DataType::FLOAT32>(0.0f), zero);
+}
+
+TEST_F(ModuleFixture, LiteralPoolRecreatesRemovedLiterals)
+{
+    auto* original = module->intern_literal<blm::DataType::INT64>(7);
+    module->get_root_region()->remove_node(original);
+
+    auto* recreated = module->intern_literal<blm::DataType::INT64>(7);
+    EXPECT_NE(recreated, original);
+    EXPECT_EQ(recreated->parent_region, module->get_root_region());
+    EXPECT_EQ(module->intern_literal<blm::DataType::INT64>(7), recreated);
+}
+
+TEST_F(ModuleFixture, LiteralPoolStrings)
+{
+    auto* hello = module->intern_string_literal("hello");
+    EXPECT_EQ(hello->parent_region, module->get_rodata_region());
+    EXPECT_EQ(module->intern_string_literal(std::string_view("hello")), hello);
+    EXPECT_NE(module->intern_string_literal("world"), hello);
+
+    blm::TypedData data;
+    data.set<std::string, blm::DataType::STRING>("hello");
+    EXPECT_EQ(module->intern_literal(data), hello);
+
+    blm::TypedData empty;
+    EXPECT_EQ(module->intern_literal(empty), nullptr);
+}
@@ -0,0 +1,195 @@
+/* this project is part of the Bloom Project; licensed under the MIT license. see LICENSE for more info */
+
+#include <bloom/foundation/context.hpp>
+#include <bloom/foundation/module.hpp>
+#include <bloom/foundation/node-numbering.hpp>
+#include <bloom/foundation/region.hpp>
+#include <gtest/gtest.h>
+
+class NodeNumberingFixture : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		context = std::make_unique<blm::Context>();
+		module = context->create_module("numbering_test");
+	}
+
+	void TearDown() override
+	{
+		context.reset();
+	}
+
+	blm::Node *add(blm::Region *region, const blm::NodeType type = blm::NodeType::ADD) const
+	{
+		auto *node = region->create_node<blm::Node>();
+		node->ir_type = type;
+		return node;
+	}
+
+	std::unique_ptr<blm::Context> context;
+	blm::Module *module = nullptr;
+};
+
+TEST_F(NodeNumberingFixture, FunctionsAreContiguous)
+{
+	blm::Region *root = module->get_root_region();
+	blm::Region *foo = module->create_region("foo");
+	blm::Region *foo_inner = module->create_region("inner", foo);
+	blm::Region *bar = module->create_region("bar");
+
+	blm::Node *global = add(root, blm::NodeType::LIT);
+	blm::Node *a = add(foo);
+	blm::Node *b = add(foo_inner);
+	blm::Node *c = add(bar);
+	blm::Node *d = add(foo);
+
+	const blm::NodeNumbering &numbering = module->get_numbering();
+	EXPECT_EQ(numbering.size(), 5u);
+	for (blm::NodeId i = 0; i < numbering.size(); ++i)
+		EXPECT_EQ(numbering.index_of(numbering[i]), i);
+
+	/* a region tree is one range, in pre-order */
+	const blm::NodeRange foo_range = numbering.range_of(foo);
+	EXPECT_EQ(foo_range.size(), 3u);
+	EXPECT_TRUE(foo_range.contains(numbering.index_of(a)));
+	EXPECT_TRUE(foo_range.contains(numbering.index_of(b)));
+	EXPECT_TRUE(foo_range.contains(numbering.index_of(d)));
+	EXPECT_FALSE(foo_range.contains(numbering.index_of(c)));
+	EXPECT_LT(numbering.index_of(d), numbering.index_of(b));
+	EXPECT_EQ(numbering.range_of(bar).size(), 1u);
+	EXPECT_EQ(numbering.index_of(global), 0u);
+	EXPECT_EQ(numbering.range_of(root).size(), 5u);
+}
+
+TEST_F(NodeNumberingFixture, RenumbersOnDemand)
+{
+	blm::Region *func = module->create_region("func");
+	blm::Node *a = add(func);
+	blm::Node *b = add(func);
+
+	const blm::NodeNumbering &numbering = module->get_numbering();
+	const std::uint64_t generation = numbering.get_generation();
+	EXPECT_EQ(&module->get_numbering(), &numbering);
+	EXPECT_EQ(numbering.get_generation(), generation);
+
+	/* until the next request old indices stay valid and new nodes are unnumbered */
+	blm::Node *c = add(func);
+	EXPECT_FALSE(numbering.contains(c));
+	EXPECT_TRUE(numbering.contains(a));
+
+	func->remove_node(a);
+	module->get_numbering();
+	EXPECT_GT(numbering.get_generation(), generation);
+	EXPECT_EQ(numbering.size(), 2u);
+	EXPECT_FALSE(numbering.contains(a));
+	EXPECT_EQ(numbering.index_of(b), 0u);
+	EXPECT_EQ(numbering.index_of(c), 1u);
+
+	/* a numbering of another region does not cover these nodes */
+	blm::NodeNumbering other;
+	other.assign(module->get_rodata_region());
+	EXPECT_EQ(other.size(), 0u);
+	EXPECT_FALSE(other.contains(b));
+}
+
+TEST_F(NodeNumberingFixture, BitVectorAndMap)
+{
+	blm::Region *foo = module->create_region("foo");
+	blm::Region *bar = module->create_region("bar");
+	std::vector<blm::Node *> nodes;
+	for (int i = 0; i < 70; ++i)
+		nodes.push_back(add(foo));
+	blm::Node *other = add(bar);
+
+	const blm::NodeNumbering &numbering = module->get_numbering();
+	blm::NodeBitVector set(numbering, numbering.range_of(foo));
+	EXPECT_TRUE(set.insert(nodes[0]));
+	EXPECT_FALSE(set.insert(nodes[0]));
+	EXPECT_TRUE(set.insert(nodes[69]));
+	EXPECT_FALSE(set.insert(other)); /* outside the function's range */
+	EXPECT_FALSE(set.insert(nullptr));
+	EXPECT_TRUE(set.contains(nodes[69]));
+	EXPECT_FALSE(set.contains(nodes[1]));
+	EXPECT_EQ(set.count(), 2u);
+
+	std::vector<blm::Node *> members;
+	set.for_each([&](blm::Node *node) { members.push_back(node); });
+	EXPECT_EQ(members, (std::vector<blm::Node *> { nodes[0], nodes[69] }));
+
+	set.erase(nodes[0]);
+	EXPECT_FALSE(set.contains(nodes[0]));
+	set.clear();
+	EXPECT_EQ(set.count(), 0u);
+
+	blm::NodeMap<int> map(numbering, -1);
+	EXPECT_EQ(map.size(), numbering.size());
+	map[nodes[3]] = 3;
+	map[other] = 7;
+	EXPECT_EQ(map.get(nodes[3]), 3);
+	EXPECT_EQ(map.get(nodes[4]), -1);
+	EXPECT_EQ(map.get(other), 7);
+
+	blm::Node loose;
+	EXPECT_EQ(map.find(&loose), nullptr);
+	EXPECT_EQ(map.get(&loose), -1);
+	map.clear();
+	EXPECT_EQ(map.get(nodes[3]), -1);
+}
+
+TEST_F(NodeNumberingFixture, RegionVersionsAndRebase)
+{
+	blm::Region *foo = module->create_region("foo");
+	blm::Region *foo_inner = module->create_region("inner", foo);
+	blm::Region *bar = module->create_region("bar");
+	blm::Node *a = add(foo);
+	blm::Node *b = add(bar);
+
+	const blm::NodeNumbering &numbering = module->get_numbering();
+	EXPECT_EQ(foo->get_version(), foo->get_numbered_version());
+	EXPECT_EQ(bar->get_version(), bar->get_numbered_version());
+	blm::NodeBitVector set(numbering, numbering.range_of(bar));
+	blm::NodeMap<int> map(numbering, numbering.range_of(bar), -1);
+	set.insert(b);
+	map[b] = 5;
+
+	/* a change in a nested region dates the enclosing regions, not the siblings */
+	const std::uint64_t bar_version = bar->get_version();
+	const std::uint64_t foo_version = foo->get_version();
+	const std::uint64_t root_version = module->get_root_region()->get_version();
+	add(foo_inner);
+	EXPECT_NE(foo_inner->get_version(), foo_inner->get_numbered_version());
+	EXPECT_GT(foo->get_version(), foo_version);
+	EXPECT_GT(module->get_root_region()->get_version(), root_version);
+	EXPECT_EQ(bar->get_version(), bar_version);
+	EXPECT_EQ(bar->get_numbered_version(), bar_version);
+
+	/* bar kept its layout, so its tables can follow the renumber */
+	module->get_numbering();
+	set.rebase(numbering.range_of(bar));
+	map.rebase(numbering.range_of(bar));
+	EXPECT_TRUE(set.contains(b));
+	EXPECT_EQ(map.get(b), 5);
+	EXPECT_FALSE(set.contains(a));
+}
+
+TEST_F(NodeNumberingFixture, RegionVersionsNeverGoBack)
+{
+	blm::Region *foo = module->create_region("foo");
+	blm::Region *inner = module->create_region("inner", foo);
+	add(inner);
+	add(inner);
+
+	module->get_numbering();
+	const std::uint64_t numbered = foo->get_version();
+	EXPECT_EQ(foo->get_numbered_version(), numbered);
+
+	/* the removed child's changes stay counted, so the version cannot repeat an older one */
+	blm::Region *late = module->create_region("late", foo);
+	EXPECT_EQ(late->get_numbered_version(), blm::Region::NOT_NUMBERED);
+	late->remove_node(add(late));
+	const std::uint64_t with_late = foo->get_version();
+	EXPECT_GT(with_late, numbered);
+	module->remove_region(late);
+	EXPECT_GT(foo->get_version(), with_late);
+}
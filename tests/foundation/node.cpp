@@ -1,5 +1,6 @@
 /* this project is part of the Bloom Project; licensed under the MIT license. see LICENSE for more info */
 
+#include <cstddef>
 #include <bloom/foundation/node.hpp>
 #include <gtest/gtest.h>
 
@@ -169,3 +170,10 @@ TEST_F(NodeFixture, NodeTypeOperations)
 	node.ir_type = op_nodes[0];
 	EXPECT_EQ(node.ir_type, blm::NodeType::ADD);
 }
+
+TEST_F(NodeFixture, IndexFitsInTailPadding)
+{
+	/* the dense index shares the opcode/type/props word instead of growing the node */
+	EXPECT_EQ(offsetof(blm::Node, index) + sizeof(blm::NodeId), sizeof(blm::Node));
+	EXPECT_EQ(offsetof(blm::Node, index), offsetof(blm::Node, ir_type) + sizeof(std::uint32_t));
+}
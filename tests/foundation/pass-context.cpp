@@ -120,3 +120,61 @@ TEST_F(PassContextFixture, Statistics)
     pass_context->update_stat("test", -2);
     EXPECT_EQ(pass_context->get_stat("test"), 6);
 }
+
+TEST_F(PassContextFixture, InvalidateByKeepsPreservedResults)
+{
+    class CFGResult final : public blm::AnalysisResult
+    {
+    public:
+        [[nodiscard]] bool invalidated_by(const std::type_info&) const override { return true; }
+        [[nodiscard]] bool invalidated_by(const std::type_info&, const blm::PreservedAnalyses& preserved) const override
+        {
+            return !preserved.preserves_cfg();
+        }
+    };
+
+    auto store_all = [this]
+    {
+        pass_context->store_result(typeid(int), std::make_unique<MockResult>(1));
+        pass_context->store_result(typeid(float), std::make_unique<MockResult>(2));
+        pass_context->store_result(typeid(char), std::make_unique<CFGResult>());
+    };
+
+    store_all();
+    pass_context->invalidate_by(typeid(int), blm::PreservedAnalyses::all());
+    EXPECT_TRUE(pass_context->has_result(typeid(int)));
+    EXPECT_TRUE(pass_context->has_result(typeid(float)));
+    EXPECT_TRUE(pass_context->has_result(typeid(char)));
+
+    pass_context->invalidate_by(typeid(int), blm::PreservedAnalyses::none().preserve<float>());
+    EXPECT_FALSE(pass_context->has_result(typeid(int)));
+    EXPECT_TRUE(pass_context->has_result(typeid(float)));
+    EXPECT_FALSE(pass_context->has_result(typeid(char)));
+
+    store_all();
+    pass_context->invalidate_by(typeid(int), blm::PreservedAnalyses::none().preserve_cfg());
+    EXPECT_FALSE(pass_context->has_result(typeid(int)));
+    EXPECT_FALSE(pass_context->has_result(typeid(float)));
+    EXPECT_TRUE(pass_context->has_result(typeid(char)));
+
+    /* results that are not preserved still decide for themselves */
+    store_all();
+    pass_context->invalidate_by(typeid(double), blm::PreservedAnalyses::none());
+    EXPECT_TRUE(pass_context->has_result(typeid(int)));
+    EXPECT_TRUE(pass_context->has_result(typeid(float)));
+    EXPECT_FALSE(pass_context->has_result(typeid(char)));
+}
+
+TEST_F(PassContextFixture, PreservedAnalysesIntersection)
+{
+    auto preserved = blm::PreservedAnalyses::all();
+    preserved.intersect(blm::PreservedAnalyses::none().preserve_cfg().preserve<int>().preserve<float>());
+    EXPECT_FALSE(preserved.preserves_all());
+    EXPECT_TRUE(preserved.preserves_cfg());
+
+    preserved.intersect(blm::PreservedAnalyses::none().preserve<int>());
+    EXPECT_FALSE(preserved.preserves_cfg());
+    EXPECT_TRUE(preserved.preserves(typeid(int)));
+    EXPECT_FALSE(preserved.preserves(typeid(float)));
+    EXPECT_FALSE(preserved.preserves(typeid(double)));
+}
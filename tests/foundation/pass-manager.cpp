@@ -1,6 +1,10 @@
 /* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
 
 #include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+#include <bloom/foundation/analysis-pass.hpp>
 #include <bloom/foundation/context.hpp>
 #include <bloom/foundation/module.hpp>
 #include <bloom/foundation/pass-manager.hpp>
@@ -206,3 +210,144 @@ TEST_F(PassManagerFixture, StatisticsPrinting)
     EXPECT_NE(stats.find("test-pass-b"), std::string::npos);
     EXPECT_NE(stats.find("ms"), std::string::npos);
 }
+
+namespace
+{
+    class CountingResult final : public blm::AnalysisResult
+    {
+    public:
+        [[nodiscard]] bool invalidated_by(const std::type_info&) const override { return false; }
+    };
+
+    class CountingAnalysis final : public blm::AnalysisPass
+    {
+    public:
+        explicit CountingAnalysis(int& runs) : runs(runs) {}
+
+        [[nodiscard]] std::string_view name() const override { return "counting-analysis"; }
+        [[nodiscard]] std::string_view description() const override { return "Counts its runs"; }
+
+        std::unique_ptr<blm::AnalysisResult> analyze(blm::Module&, blm::PassContext&) override
+        {
+            ++runs;
+            return std::make_unique<CountingResult>();
+        }
+
+    private:
+        int& runs;
+    };
+
+    /* requires the analysis; optionally invalidates it */
+    class AnalysisUser final : public blm::Pass
+    {
+    public:
+        AnalysisUser(std::vector<std::string_view>& order, const bool invalidates)
+            : order(order), invalidates(invalidates) {}
+
+        [[nodiscard]] std::string_view name() const override { return "analysis-user"; }
+        [[nodiscard]] std::string_view description() const override { return "Uses the counting analysis"; }
+
+        [[nodiscard]] std::vector<const std::type_info*> required_passes() const override
+        {
+            return get_pass_types<CountingAnalysis>();
+        }
+
+        [[nodiscard]] std::vector<const std::type_info*> invalidated_passes() const override
+        {
+            if (invalidates)
+                return get_pass_types<CountingAnalysis>();
+            return {};
+        }
+
+        bool run(blm::Module&, blm::PassContext& ctx) override
+        {
+            order.push_back(ctx.has_result(typeid(CountingAnalysis)) ? "user-with-result" : "user-without-result");
+            return true;
+        }
+
+    private:
+        std::vector<std::string_view>& order;
+        bool invalidates;
+    };
+
+    template<int N>
+    class CyclicPass final : public blm::Pass
+    {
+    public:
+        [[nodiscard]] std::string_view name() const override { return N == 0 ? "cyclic-0" : "cyclic-1"; }
+        [[nodiscard]] std::string_view description() const override { return "Requires the other cyclic pass"; }
+
+        [[nodiscard]] std::vector<const std::type_info*> required_passes() const override
+        {
+            return get_pass_types<CyclicPass<1 - N>>();
+        }
+
+        bool run(blm::Module&, blm::PassContext&) override { return true; }
+    };
+}
+
+TEST_F(PassManagerFixture, RunAllRunsRequiredPassesOnce)
+{
+    TestPassA* raw_pass_a = pass_a.get();
+    TestPassB* raw_pass_b = pass_b.get();
+
+    /* registered after its user */
+    manager->add_pass(std::move(pass_b));
+    manager->add_pass(std::move(pass_a));
+
+    EXPECT_TRUE(manager->run_all());
+    EXPECT_EQ(raw_pass_a->run_count(), 1);
+    EXPECT_EQ(raw_pass_b->run_count(), 1);
+}
+
+TEST_F(PassManagerFixture, SkipsAnalysesWithValidResults)
+{
+    int analysis_runs = 0;
+    std::vector<std::string_view> order;
+    manager->add_pass<AnalysisUser>(order, false);
+    manager->add_pass<CountingAnalysis>(analysis_runs);
+
+    EXPECT_TRUE(manager->run_all());
+    EXPECT_TRUE(manager->run_all());
+    EXPECT_TRUE(manager->run_pass<CountingAnalysis>());
+
+    EXPECT_EQ(analysis_runs, 1);
+    EXPECT_EQ(order, (std::vector<std::string_view> { "user-with-result", "user-with-result" }));
+}
+
+TEST_F(PassManagerFixture, RerunsInvalidatedAnalyses)
+{
+    int analysis_runs = 0;
+    std::vector<std::string_view> order;
+    manager->add_pass<CountingAnalysis>(analysis_runs);
+    manager->add_pass<AnalysisUser>(order, true);
+
+    EXPECT_TRUE(manager->run_all());
+    EXPECT_TRUE(manager->run_pass<AnalysisUser>());
+
+    EXPECT_EQ(analysis_runs, 2);
+    EXPECT_EQ(order, (std::vector<std::string_view> { "user-with-result", "user-with-result" }));
+    EXPECT_FALSE(manager->get_context().has_result(typeid(CountingAnalysis)));
+}
+
+TEST_F(PassManagerFixture, MissingRequirementThrows)
+{
+    manager->add_pass<TestPassB>();
+    EXPECT_THROW(manager->run_all(), std::runtime_error);
+}
+
+TEST_F(PassManagerFixture, CyclicRequirementsThrow)
+{
+    manager->add_pass<CyclicPass<0>>();
+    manager->add_pass<CyclicPass<1>>();
+
+    try
+    {
+        manager->run_all();
+        FAIL() << "expected a cycle error";
+    }
+    catch (const std::runtime_error& e)
+    {
+        EXPECT_STREQ(e.what(), "pass dependency cycle: cyclic-0 -> cyclic-1 -> cyclic-0");
+    }
+}
@@ -0,0 +1,221 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <bloom/foundation/context.hpp>
+#include <bloom/foundation/function-pipeline.hpp>
+#include <bloom/foundation/module.hpp>
+#include <bloom/foundation/pass-context.hpp>
+#include <bloom/foundation/pass-manager.hpp>
+#include <bloom/foundation/profiler.hpp>
+#include <bloom/foundation/region.hpp>
+#include <bloom/transform/constfold.hpp>
+#include <bloom/transform/dce.hpp>
+#include <gtest/gtest.h>
+
+class ProfilerFixture : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        context = std::make_unique<blm::Context>();
+        module = std::make_unique<blm::Module>(*context, "test_module");
+    }
+
+    void TearDown() override
+    {
+        module.reset();
+        context.reset();
+    }
+
+    /* ret 2 + 3, plus an unused literal */
+    void create_function(const std::string& name)
+    {
+        auto* region = module->create_region(name);
+
+        auto* entry = region->create_node<blm::Node>();
+        entry->ir_type = blm::NodeType::ENTRY;
+
+        auto* two = region->create_node<blm::Node>();
+        two->ir_type = blm::NodeType::LIT;
+        two->type_kind = blm::DataType::INT32;
+        two->data.set<std::int32_t, blm::DataType::INT32>(2);
+
+        auto* three = region->create_node<blm::Node>();
+        three->ir_type = blm::NodeType::LIT;
+        three->type_kind = blm::DataType::INT32;
+        three->data.set<std::int32_t, blm::DataType::INT32>(3);
+
+        auto* unused = region->create_node<blm::Node>();
+        unused->ir_type = blm::NodeType::LIT;
+        unused->type_kind = blm::DataType::INT32;
+        unused->data.set<std::int32_t, blm::DataType::INT32>(42);
+
+        auto* sum = region->create_node<blm::Node>();
+        sum->ir_type = blm::NodeType::ADD;
+        sum->type_kind = blm::DataType::INT32;
+        sum->inputs = { two, three };
+        two->users.push_back(sum);
+        three->users.push_back(sum);
+
+        auto* ret = region->create_node<blm::Node>();
+        ret->ir_type = blm::NodeType::RET;
+        ret->inputs.push_back(sum);
+        sum->users.push_back(ret);
+
+        auto* func = region->create_node<blm::Node>();
+        func->ir_type = blm::NodeType::FUNCTION;
+        func->str_id = context->intern_string(name);
+        module->add_function(func);
+    }
+
+    static std::size_t count(const blm::Profiler& profiler, const std::string_view category)
+    {
+        std::size_t result = 0;
+        for (const auto& event: profiler.get_events())
+            result += event.category == category;
+        return result;
+    }
+
+    std::unique_ptr<blm::Context> context;
+    std::unique_ptr<blm::Module> module;
+};
+
+TEST_F(ProfilerFixture, ScopesNestOnTheirThread)
+{
+    blm::Profiler profiler;
+    std::size_t outer_event;
+    {
+        const blm::Profiler::Scope outer(&profiler, "outer", "pass");
+        outer_event = outer.event();
+        EXPECT_EQ(profiler.current(), outer_event);
+        {
+            const blm::Profiler::Scope inner(&profiler, "inner", "phase");
+            EXPECT_EQ(profiler.current(), inner.event());
+        }
+
+        /* another thread has no open scope of its own */
+        std::thread worker([&]
+        {
+            EXPECT_EQ(profiler.current(), blm::Profiler::NO_EVENT);
+            const blm::Profiler::Scope scope(&profiler, "worker", "function", outer_event);
+        });
+        worker.join();
+    }
+    EXPECT_EQ(profiler.current(), blm::Profiler::NO_EVENT);
+
+    const auto& events = profiler.get_events();
+    ASSERT_EQ(events.size(), 3);
+    EXPECT_EQ(events[0].parent, blm::Profiler::NO_EVENT);
+    EXPECT_EQ(events[1].parent, outer_event);
+    EXPECT_EQ(events[2].parent, outer_event);
+    EXPECT_EQ(events[0].thread, 0);
+    EXPECT_EQ(events[2].thread, 1);
+    EXPECT_GE(events[0].duration, events[1].duration);
+}
+
+TEST_F(ProfilerFixture, NullProfilerRecordsNothing)
+{
+    const blm::Profiler::Scope scope(nullptr, "pass", "pass");
+    EXPECT_FALSE(scope.active());
+    scope.set_nodes_before(1);
+    scope.add_stat("stat", 1);
+}
+
+TEST_F(ProfilerFixture, RecordsPassesFunctionsAndPhases)
+{
+    create_function("f");
+    create_function("g");
+
+    auto pipeline = std::make_unique<blm::FunctionPipeline>(2);
+    pipeline->add_pass<blm::ConstantFoldingPass>().add_pass<blm::DCEPass>();
+    pipeline->set_max_iterations(4);
+
+    blm::Profiler profiler;
+    blm::PassManager manager(*module, 1);
+    manager.get_context().set_profiler(&profiler);
+    manager.add_pass(std::move(pipeline));
+    ASSERT_TRUE(manager.run_all());
+
+    const auto& events = profiler.get_events();
+    ASSERT_FALSE(events.empty());
+
+    const auto& pass = events[0];
+    EXPECT_EQ(pass.name, "function-pipeline");
+    EXPECT_EQ(pass.category, "pass");
+    EXPECT_GT(pass.nodes_before, pass.nodes_after);
+
+    bool folded = false;
+    for (const auto& [name, value]: pass.stats)
+        folded |= name == "constant_folding.folded_nodes" && value == 2;
+    EXPECT_TRUE(folded);
+
+    /* first iteration changes both functions; the second finds nothing left */
+    EXPECT_EQ(count(profiler, "iteration"), 2);
+    EXPECT_EQ(count(profiler, "function"), 4);
+    EXPECT_EQ(count(profiler, "phase"), 8);
+    for (const auto& event: events)
+    {
+        if (event.category == "iteration")
+        {
+            EXPECT_EQ(event.parent, 0);
+        }
+        if (event.category == "function")
+        {
+            EXPECT_EQ(events[event.parent].category, "iteration");
+        }
+        if (event.category == "phase")
+        {
+            EXPECT_EQ(events[event.parent].category, "function");
+        }
+    }
+
+    /* phases carry their own node counts and statistics */
+    std::size_t folded_in_phases = 0;
+    for (const auto& event: events)
+    {
+        if (event.category != "phase" || event.name != "constant-folding")
+            continue;
+
+        EXPECT_GE(event.nodes_before, event.nodes_after);
+        for (const auto& [name, value]: event.stats)
+        {
+            if (name == "constant_folding.folded_nodes")
+                folded_in_phases += value;
+        }
+    }
+    EXPECT_EQ(folded_in_phases, 2);
+}
+
+TEST_F(ProfilerFixture, WritesJsonAndChromeTrace)
+{
+    blm::Profiler profiler;
+    {
+        const blm::Profiler::Scope scope(&profiler, "quote\"d", "pass");
+        scope.set_nodes_before(7);
+        scope.set_nodes_after(5);
+        scope.set_memory_bytes(4096);
+        scope.add_stat("dce.removed_nodes", 2);
+    }
+    EXPECT_EQ(profiler.get_peak_memory_bytes(), 4096);
+
+    std::stringstream json;
+    profiler.write_json(json);
+    const std::string text = json.str();
+    EXPECT_NE(text.find("\"peak_memory_bytes\":4096"), std::string::npos);
+    EXPECT_NE(text.find("\"name\":\"quote\\\"d\""), std::string::npos);
+    EXPECT_NE(text.find("\"parent\":null"), std::string::npos);
+    EXPECT_NE(text.find("\"nodes_before\":7"), std::string::npos);
+    EXPECT_NE(text.find("\"stats\":{\"dce.removed_nodes\":2}"), std::string::npos);
+
+    std::stringstream trace;
+    profiler.write_chrome_trace(trace);
+    const std::string events = trace.str();
+    EXPECT_NE(events.find("\"traceEvents\":["), std::string::npos);
+    EXPECT_NE(events.find("\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(events.find("\"cat\":\"pass\""), std::string::npos);
+
+    profiler.clear();
+    EXPECT_TRUE(profiler.get_events().empty());
+}
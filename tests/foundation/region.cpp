@@ -345,6 +345,125 @@ TEST_F(RegionFixture, InsertAtBeginning)
 	EXPECT_EQ(region->get_nodes()[0], node3);
 }
 
+TEST_F(RegionFixture, InsertNodeAfter)
+{
+	auto *node1 = region->create_node<blm::Node>();
+	auto *node2 = region->create_node<blm::Node>();
+	auto *node3 = context->create<blm::Node>();
+
+	region->insert_node_after(node1, node3);
+
+	/* [node1, node3, node2] */
+	ASSERT_EQ(region->get_nodes().size(), 3);
+	EXPECT_EQ(region->get_nodes()[1], node3);
+	EXPECT_EQ(region->get_nodes().back(), node2);
+
+	/* already in the region; moved rather than duplicated */
+	region->insert_node_after(node2, node1);
+	ASSERT_EQ(region->get_nodes().size(), 3);
+	EXPECT_EQ(region->get_nodes().front(), node3);
+	EXPECT_EQ(region->get_nodes().back(), node1);
+}
+
+TEST_F(RegionFixture, NodeMovesBetweenRegions)
+{
+	auto *other = module->create_region("other");
+	auto *node1 = region->create_node<blm::Node>();
+	auto *node2 = region->create_node<blm::Node>();
+
+	EXPECT_TRUE(region->contains(node1));
+	EXPECT_FALSE(other->contains(node1));
+
+	other->add_node(node1);
+	EXPECT_FALSE(region->contains(node1));
+	EXPECT_TRUE(other->contains(node1));
+	EXPECT_EQ(node1->parent_region, other);
+	ASSERT_EQ(region->get_nodes().size(), 1);
+	EXPECT_EQ(region->get_nodes().front(), node2);
+	EXPECT_EQ(other->get_nodes().size(), 1);
+
+	/* a parent region set by hand doesn't make a node a member */
+	auto *loose = context->create<blm::Node>();
+	loose->parent_region = region;
+	EXPECT_FALSE(region->contains(loose));
+	region->remove_node(loose);
+	EXPECT_EQ(region->get_nodes().size(), 1);
+}
+
+TEST_F(RegionFixture, IterationAcrossRemoval)
+{
+	std::vector<blm::Node *> created;
+	for (int i = 0; i < 5; ++i)
+		created.push_back(region->create_node<blm::Node>());
+
+	/* remove every node as it is visited, capturing the successor first */
+	std::size_t visited = 0;
+	for (blm::Node *node = region->get_nodes().front(); node;)
+	{
+		blm::Node *next = node->region_next;
+		EXPECT_EQ(node, created[visited]);
+		region->remove_node(node);
+		node = next;
+		visited++;
+	}
+
+	EXPECT_EQ(visited, created.size());
+	EXPECT_TRUE(region->get_nodes().empty());
+	EXPECT_EQ(region->get_nodes().front(), nullptr);
+}
+
+TEST_F(RegionFixture, RemovedNodeHasNoLinks)
+{
+	auto *node1 = region->create_node<blm::Node>();
+	auto *node2 = region->create_node<blm::Node>();
+	auto *node3 = region->create_node<blm::Node>();
+	blm::Region *other = module->create_region("other");
+
+	/* an iterator parked on a removed node must not reach its old successor once that
+	 * successor has moved to another region */
+	auto it = region->get_nodes().begin();
+	region->remove_node(node1);
+	other->add_node(node2);
+	EXPECT_EQ(node1->region_prev, nullptr);
+	EXPECT_EQ(node1->region_next, nullptr);
+	EXPECT_EQ(++it, region->get_nodes().end());
+
+	ASSERT_EQ(region->get_nodes().size(), 1);
+	EXPECT_EQ(region->get_nodes().front(), node3);
+	EXPECT_EQ(node3->region_prev, nullptr);
+	EXPECT_EQ(other->get_nodes().front(), node2);
+	EXPECT_EQ(node2->region_next, nullptr);
+}
+
+TEST_F(RegionFixture, ReverseIteration)
+{
+	auto *node1 = region->create_node<blm::Node>();
+	auto *node2 = region->create_node<blm::Node>();
+	auto *node3 = region->create_node<blm::Node>();
+
+	std::vector<blm::Node *> reversed(region->get_nodes().rbegin(), region->get_nodes().rend());
+	ASSERT_EQ(reversed.size(), 3);
+	EXPECT_EQ(reversed[0], node3);
+	EXPECT_EQ(reversed[1], node2);
+	EXPECT_EQ(reversed[2], node1);
+}
+
+TEST_F(RegionFixture, ReplaceNodeKeepsPosition)
+{
+	auto *node1 = region->create_node<blm::Node>();
+	auto *node2 = region->create_node<blm::Node>();
+	auto *node3 = region->create_node<blm::Node>();
+	auto *replacement = context->create<blm::Node>();
+
+	EXPECT_TRUE(region->replace_node(node2, replacement));
+	ASSERT_EQ(region->get_nodes().size(), 3);
+	EXPECT_EQ(region->get_nodes()[0], node1);
+	EXPECT_EQ(region->get_nodes()[1], replacement);
+	EXPECT_EQ(region->get_nodes()[2], node3);
+	EXPECT_FALSE(region->contains(node2));
+	EXPECT_EQ(node2->parent_region, nullptr);
+}
+
 TEST_F(RegionFixture, IsTerminated)
 {
 	EXPECT_FALSE(region->is_terminated());
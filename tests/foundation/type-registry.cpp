@@ -195,3 +195,69 @@ TEST_F(TypeRegistryFixture, ForwardDeclarations)
 	EXPECT_EQ(struct_info.fields[0].first, "next");
 	EXPECT_EQ(struct_info.fields[0].second, placeholder);
 }
+
+TEST_F(TypeRegistryFixture, CachedLayout)
+{
+	EXPECT_EQ(type_registry->get_size(blm::DataType::INT16), 2u);
+	EXPECT_EQ(type_registry->get_size(blm::DataType::POINTER), 8u);
+	EXPECT_EQ(type_registry->get_size(blm::DataType::VOID), 0u);
+	EXPECT_EQ(type_registry->get_alignment(blm::DataType::VOID), 1u);
+	EXPECT_EQ(type_registry->get_size(int32_type), 4u);
+
+	auto ptr_int32 = type_registry->create_pointer_type(int32_type);
+	EXPECT_EQ(type_registry->get_size(ptr_int32), 8u);
+	EXPECT_EQ(type_registry->get_alignment(ptr_int32), 8u);
+
+	auto array_type = type_registry->create_array_type(float64_type, 6);
+	EXPECT_EQ(type_registry->get_size(array_type), 48u);
+	EXPECT_EQ(type_registry->get_alignment(array_type), 8u);
+
+	auto vector_type = type_registry->create_vector_type(float32_type, 4);
+	EXPECT_EQ(type_registry->get_size(vector_type), 16u);
+	EXPECT_EQ(type_registry->get_alignment(vector_type), 16u);
+
+	std::vector<std::pair<std::string, blm::DataType> > fields = {
+		{ "values", array_type },
+		{ "count", int32_type }
+	};
+	auto struct_type = type_registry->create_struct_type(fields, 56, 8);
+	EXPECT_EQ(type_registry->get_size(struct_type), 56u);
+	EXPECT_EQ(type_registry->get_alignment(struct_type), 8u);
+
+	auto func_type = type_registry->create_function_type(int32_type, {});
+	EXPECT_EQ(type_registry->get_size(func_type), 0u);
+}
+
+TEST_F(TypeRegistryFixture, StructuralKeysDistinguishFieldNames)
+{
+	/* "ab" + "c" and "a" + "bc" must not share an encoding */
+	auto first = type_registry->create_struct_type({ { "ab", int32_type }, { "c", int32_type } }, 8, 4);
+	auto second = type_registry->create_struct_type({ { "a", int32_type }, { "bc", int32_type } }, 8, 4);
+	EXPECT_NE(first, second);
+
+	blm::TypedData data;
+	data.set<blm::DataTypeTraits<blm::DataType::STRUCT>::type, blm::DataType::STRUCT>(
+		{ 8, 4, { { "ab", int32_type }, { "c", int32_type } } });
+	EXPECT_EQ(type_registry->register_type(std::move(data)), blm::get_base_type_id(first));
+}
+
+TEST_F(TypeRegistryFixture, ReferencesSurviveGrowth)
+{
+	auto ptr_int32 = type_registry->create_pointer_type(int32_type);
+	const auto &ptr_data = type_registry->get_type(ptr_int32);
+
+	for (std::uint64_t i = 1; i <= 500; ++i)
+		type_registry->create_array_type(int32_type, i);
+
+	EXPECT_EQ(ptr_data.get<blm::DataType::POINTER>().pointee_type, int32_type);
+	EXPECT_EQ(type_registry->get_size(type_registry->create_array_type(int32_type, 500)), 2000u);
+}
+
+TEST_F(TypeRegistryFixture, ExhaustedIdSpaceThrows)
+{
+	EXPECT_THROW(
+		{
+			for (int i = 0; i < 4096; ++i)
+				type_registry->reserve_type_id();
+		}, std::runtime_error);
+}
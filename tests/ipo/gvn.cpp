@@ -0,0 +1,135 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <string>
+#include <bloom/foundation/context.hpp>
+#include <bloom/foundation/module.hpp>
+#include <bloom/foundation/region.hpp>
+#include <bloom/ipo/gvn.hpp>
+#include <bloom/ipo/pass-manager.hpp>
+#include <gtest/gtest.h>
+
+class IPOGVNFixture : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        context = std::make_unique<blm::Context>();
+    }
+
+    void TearDown() override
+    {
+        context.reset();
+    }
+
+    static blm::Node *connect(blm::Region *region, const blm::NodeType type, blm::Node *lhs, blm::Node *rhs)
+    {
+        auto *node = region->create_node<blm::Node>();
+        node->ir_type = type;
+        node->type_kind = blm::DataType::INT32;
+        node->inputs.push_back(lhs);
+        node->inputs.push_back(rhs);
+        lhs->users.push_back(node);
+        rhs->users.push_back(node);
+        return node;
+    }
+
+    /* a module with one function returning (a + b) * (a + b) */
+    blm::Module *create_module(const std::string &name)
+    {
+        blm::Module *module = context->create_module(name);
+        auto *region = module->create_region("f");
+
+        auto *entry = region->create_node<blm::Node>();
+        entry->ir_type = blm::NodeType::ENTRY;
+
+        auto *a = region->create_node<blm::Node>();
+        a->ir_type = blm::NodeType::PARAM;
+        a->type_kind = blm::DataType::INT32;
+
+        auto *b = region->create_node<blm::Node>();
+        b->ir_type = blm::NodeType::PARAM;
+        b->type_kind = blm::DataType::INT32;
+
+        auto *lhs = connect(region, blm::NodeType::ADD, a, b);
+        auto *rhs = connect(region, blm::NodeType::ADD, a, b);
+        auto *product = connect(region, blm::NodeType::MUL, lhs, rhs);
+
+        auto *ret = region->create_node<blm::Node>();
+        ret->ir_type = blm::NodeType::RET;
+        ret->inputs.push_back(product);
+        product->users.push_back(ret);
+
+        auto *func = region->create_node<blm::Node>();
+        func->ir_type = blm::NodeType::FUNCTION;
+        func->str_id = context->intern_string("f");
+        module->add_function(func);
+        return module;
+    }
+
+    std::unique_ptr<blm::Context> context;
+};
+
+TEST_F(IPOGVNFixture, EliminatesInEveryModule)
+{
+    std::vector<blm::Module *> modules;
+    for (int i = 0; i < 32; ++i)
+        modules.push_back(create_module("m" + std::to_string(i)));
+
+    blm::IPOPassManager manager(modules, 1, false, 0, 4);
+    manager.add_pass<blm::IPOGVNPass>();
+    EXPECT_TRUE(manager.run_pass<blm::IPOGVNPass>());
+
+    std::size_t local_total = 0;
+    for (blm::Module *module : modules)
+    {
+        const blm::Region *body = module->get_function_region(module->get_functions().front());
+        const blm::Node *product = nullptr;
+        for (const blm::Node *node : body->get_nodes())
+        {
+            if (node->ir_type == blm::NodeType::MUL)
+                product = node;
+        }
+        ASSERT_NE(product, nullptr);
+        EXPECT_EQ(product->inputs[0], product->inputs[1]);
+
+        local_total += manager.get_context().get_module_context(*module).get_stat("cse.eliminated_expressions");
+    }
+    EXPECT_EQ(manager.get_context().get_stat("ipo_gvn.total_eliminated"), local_total);
+}
+
+TEST_F(IPOGVNFixture, MatchesSequentialRun)
+{
+    std::vector<blm::Module *> sequential_modules;
+    std::vector<blm::Module *> parallel_modules;
+    for (int i = 0; i < 16; ++i)
+    {
+        sequential_modules.push_back(create_module("s" + std::to_string(i)));
+        parallel_modules.push_back(create_module("p" + std::to_string(i)));
+    }
+
+    blm::IPOPassManager sequential(sequential_modules, 1, false, 0, 1);
+    sequential.add_pass<blm::IPOGVNPass>();
+    sequential.run_pass<blm::IPOGVNPass>();
+
+    blm::IPOPassManager parallel(parallel_modules, 1, false, 0, 4);
+    parallel.add_pass<blm::IPOGVNPass>();
+    parallel.run_pass<blm::IPOGVNPass>();
+
+    EXPECT_EQ(parallel.get_context().get_stat("ipo_gvn.total_eliminated"),
+              sequential.get_context().get_stat("ipo_gvn.total_eliminated"));
+}
+
+TEST_F(IPOGVNFixture, KeepsAliasResultsPerModule)
+{
+    std::vector<blm::Module *> modules = { create_module("a"), create_module("b") };
+
+    blm::IPOPassManager manager(modules, 1, false, 0, 2);
+    manager.add_pass<blm::IPOGVNPass>();
+    manager.run_pass<blm::IPOGVNPass>();
+
+    for (blm::Module *module : modules)
+    {
+        const blm::PassContext &local = manager.get_context().get_module_context(*module);
+        EXPECT_TRUE(local.has_result(typeid(blm::LocalAliasAnalysisPass)));
+    }
+}
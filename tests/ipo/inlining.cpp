@@ -1,6 +1,7 @@
 /* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
 
 #include <sstream>
+#include <unordered_set>
 #include <bloom/foundation/context.hpp>
 #include <bloom/ipo/callgraph.hpp>
 #include <bloom/ipo/inlining.hpp>
@@ -48,14 +49,15 @@ protected:
 		pass_manager->run_all();
 	}
 
-	blm::Region *find_inlined_region(blm::Module *module)
+	/* the cloned body is spliced into the caller and its clone region destroyed */
+	bool has_clone_region(blm::Module *module)
 	{
 		for (const blm::Region *child: module->get_root_region()->get_children())
 		{
 			if (child->get_name().find("inlined") != std::string_view::npos)
-				return const_cast<blm::Region *>(child);
+				return true;
 		}
-		return nullptr;
+		return false;
 	}
 
 	blm::Region *find_region_by_name(blm::Module *module, std::string_view name)
@@ -68,12 +70,28 @@ protected:
 		return nullptr;
 	}
 
-	bool has_literal_value(blm::Region *region, std::int32_t value)
+	/* literals are pooled in the root region, so look at what the region's nodes use as well */
+	std::unordered_set<blm::Node *> literals_used_by(blm::Region *region)
 	{
+		std::unordered_set<blm::Node *> literals;
 		for (blm::Node *node: region->get_nodes())
 		{
-			if (node->ir_type == blm::NodeType::LIT &&
-			    node->type_kind == blm::DataType::INT32 &&
+			if (node->ir_type == blm::NodeType::LIT)
+				literals.insert(node);
+			for (blm::Node *input: node->inputs)
+			{
+				if (input && input->ir_type == blm::NodeType::LIT)
+					literals.insert(input);
+			}
+		}
+		return literals;
+	}
+
+	bool has_literal_value(blm::Region *region, std::int32_t value)
+	{
+		for (blm::Node *node: literals_used_by(region))
+		{
+			if (node->type_kind == blm::DataType::INT32 &&
 			    node->as<blm::DataType::INT32>() == value)
 			{
 				return true;
@@ -146,8 +164,10 @@ TEST_F(IPOInliningPassFixture, ParameterSubstitutionCorrectness)
 
 	pass_manager->print_statistics();
 
-	blm::Region *inlined_region = find_inlined_region(module);
+	EXPECT_FALSE(has_clone_region(module));
+	blm::Region *inlined_region = find_region_by_name(module, "caller");
 	ASSERT_NE(inlined_region, nullptr);
+	EXPECT_EQ(count_nodes_of_type(inlined_region, blm::NodeType::CALL), 0);
 
 	EXPECT_EQ(count_nodes_of_type(inlined_region, blm::NodeType::PARAM), 0);
 
@@ -236,8 +256,10 @@ TEST_F(IPOInliningPassFixture, ParameterSubstitutionOrder)
 
 	pass_manager->print_statistics();
 
-	blm::Region *inlined_region = find_inlined_region(module);
+	EXPECT_FALSE(has_clone_region(module));
+	blm::Region *inlined_region = find_region_by_name(module, "test");
 	ASSERT_NE(inlined_region, nullptr);
+	EXPECT_EQ(count_nodes_of_type(inlined_region, blm::NodeType::CALL), 0);
 
 	bool found_correct_subtraction = false;
 	for (const blm::Node *node: inlined_region->get_nodes())
@@ -347,7 +369,10 @@ TEST_F(IPOInliningPassFixture, NoInlineableTargets)
 	std::cout << print_module_ir(*module, "after") << "\n";
 
 	EXPECT_EQ(pass_manager->get_context().get_stat("ipo_inlining.optimized_calls"), 0);
-	EXPECT_EQ(find_inlined_region(module), nullptr);
+	EXPECT_FALSE(has_clone_region(module));
+	blm::Region *caller_region = find_region_by_name(module, "caller");
+	ASSERT_NE(caller_region, nullptr);
+	EXPECT_EQ(count_nodes_of_type(caller_region, blm::NodeType::CALL), 1);
 }
 
 TEST_F(IPOInliningPassFixture, LoadOperationInlining)
@@ -425,8 +450,11 @@ TEST_F(IPOInliningPassFixture, LoadOperationInlining)
 	std::cout << std::endl;
 
 	/* verify inlining occurred */
-	blm::Region *inlined_region = find_inlined_region(module);
-	ASSERT_NE(inlined_region, nullptr) << "Inlined region should exist";
+	EXPECT_FALSE(has_clone_region(module)) << "Clone region should be destroyed after splicing";
+	blm::Region *inlined_region = find_region_by_name(module, "caller");
+	ASSERT_NE(inlined_region, nullptr);
+	EXPECT_EQ(count_nodes_of_type(inlined_region, blm::NodeType::CALL), 0)
+		<< "Call site should be replaced by the callee body";
 
 	/* verify no parameter nodes remain */
 	EXPECT_EQ(count_nodes_of_type(inlined_region, blm::NodeType::PARAM), 0)
@@ -545,8 +573,10 @@ TEST_F(IPOInliningPassFixture, LoadStoreOrderPreservation)
 
 	pass_manager->print_statistics();
 
-	blm::Region *inlined_region = find_inlined_region(module);
+	EXPECT_FALSE(has_clone_region(module));
+	blm::Region *inlined_region = find_region_by_name(module, "caller");
 	ASSERT_NE(inlined_region, nullptr);
+	EXPECT_EQ(count_nodes_of_type(inlined_region, blm::NodeType::CALL), 0);
 
 	EXPECT_GT(count_nodes_of_type(inlined_region, blm::NodeType::PTR_STORE), 0);
 	EXPECT_GT(count_nodes_of_type(inlined_region, blm::NodeType::PTR_LOAD), 0);
@@ -564,8 +594,8 @@ TEST_F(IPOInliningPassFixture, LoadStoreOrderPreservation)
 	ASSERT_FALSE(store_nodes.empty());
 	ASSERT_FALSE(load_nodes.empty());
 	const auto &nodes = inlined_region->get_nodes();
-	auto store_pos = std::ranges::find(nodes, store_nodes[0]);
-	auto load_pos = std::ranges::find(nodes, load_nodes[0]);
+	auto store_pos = std::ranges::distance(nodes.begin(), std::ranges::find(nodes, store_nodes[0]));
+	auto load_pos = std::ranges::distance(nodes.begin(), std::ranges::find(nodes, load_nodes[0]));
 
 	EXPECT_LT(store_pos, load_pos);
 
@@ -626,9 +656,9 @@ TEST_F(IPOInliningPassFixture, MultiplCallsLiteralReuse)
 	std::size_t literal_7_count = 0;
 	std::size_t mul_count = 0;
 
-	for (blm::Node *node: caller_region->get_nodes())
+	for (blm::Node *node: literals_used_by(caller_region))
 	{
-		if (node->ir_type == blm::NodeType::LIT && node->type_kind == blm::DataType::INT32)
+		if (node->type_kind == blm::DataType::INT32)
 		{
 			std::int32_t val = node->as<blm::DataType::INT32>();
 			if (val == 5)
@@ -636,11 +666,8 @@ TEST_F(IPOInliningPassFixture, MultiplCallsLiteralReuse)
 			if (val == 7)
 				literal_7_count++;
 		}
-		if (node->ir_type == blm::NodeType::MUL)
-		{
-			mul_count++;
-		}
 	}
+	mul_count = count_nodes_of_type(caller_region, blm::NodeType::MUL);
 
 	EXPECT_EQ(mul_count, 3);
 	EXPECT_GE(literal_5_count, 1);
@@ -691,7 +718,8 @@ TEST_F(IPOInliningPassFixture, CrossModuleInlining)
 
 	EXPECT_GT(pass_manager->get_context().get_stat("ipo_inlining.optimized_calls"), 0);
 
-	blm::Region *inlined_region = find_inlined_region(module_b);
+	EXPECT_FALSE(has_clone_region(module_b));
+	blm::Region *inlined_region = find_region_by_name(module_b, "caller");
 	EXPECT_NE(inlined_region, nullptr);
 
 	if (inlined_region)
@@ -1,8 +1,15 @@
 /* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
 
+#include <chrono>
+#include <mutex>
+#include <set>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <bloom/foundation/context.hpp>
 #include <bloom/foundation/module.hpp>
+#include <bloom/foundation/profiler.hpp>
 #include <bloom/ipo/pass-context.hpp>
 #include <bloom/ipo/pass-manager.hpp>
 #include <bloom/ipo/pass.hpp>
@@ -335,3 +342,134 @@ TEST_F(IPOPassContextFixture, PatternMatching)
     EXPECT_FALSE(pass_context->has_result("call_graph.module2"));
     EXPECT_TRUE(pass_context->has_result("escape_analysis.global"));
 }
+
+TEST_F(IPOPassContextFixture, ModuleContextsAreKeptPerModule)
+{
+    blm::PassContext &local1 = pass_context->get_module_context(*module1);
+    blm::PassContext &local2 = pass_context->get_module_context(*module2);
+
+    EXPECT_NE(&local1, &local2);
+    EXPECT_EQ(&local1.module(), module1);
+    EXPECT_EQ(local1.opt_level(), 2);
+    EXPECT_EQ(&pass_context->get_module_context(*module1), &local1);
+
+    local1.update_stat("local.count", 3);
+    EXPECT_EQ(pass_context->get_module_context(*module1).get_stat("local.count"), 3);
+
+    /* a changed module starts over with a fresh context */
+    pass_context->invalidate_by_modules({ module1 });
+    EXPECT_EQ(pass_context->get_module_context(*module1).get_stat("local.count"), 0);
+    EXPECT_EQ(&pass_context->get_module_context(*module2), &local2);
+}
+
+TEST_F(IPOPassContextFixture, ForEachModuleVisitsEveryModuleOnce)
+{
+    std::vector<blm::Module *> many;
+    for (int i = 0; i < 32; ++i)
+        many.push_back(context->create_module("m" + std::to_string(i)));
+    many.push_back(nullptr);
+
+    blm::IPOPassContext parallel_context(many, 1, false, 4);
+    EXPECT_EQ(parallel_context.get_thread_count(), 4);
+
+    const bool changed = parallel_context.for_each_module([](blm::Module &module, blm::PassContext &local) {
+        EXPECT_EQ(&local.module(), &module);
+        local.update_stat("visits", 1);
+        return module.get_name() == "m7";
+    });
+
+    EXPECT_TRUE(changed);
+    for (blm::Module *module : many)
+    {
+        if (module)
+        {
+            EXPECT_EQ(parallel_context.get_module_context(*module).get_stat("visits"), 1);
+        }
+    }
+
+    EXPECT_FALSE(parallel_context.for_each_module([](blm::Module &, blm::PassContext &) { return false; }));
+}
+
+TEST_F(IPOPassContextFixture, ForEachModuleRethrows)
+{
+    EXPECT_THROW(pass_context->for_each_module([&](blm::Module &module, blm::PassContext &) -> bool {
+        if (&module == module2)
+            throw std::runtime_error("failed");
+        return false;
+    }), std::runtime_error);
+}
+
+TEST_F(IPOPassContextFixture, ForEachModuleRunsSharedSlabContextSerially)
+{
+    blm::Context slab_context(blm::NodeAllocation::SLAB);
+    std::vector<blm::Module *> shared;
+    for (int i = 0; i < 8; ++i)
+        shared.push_back(slab_context.create_module("m" + std::to_string(i)));
+
+    blm::IPOPassContext parallel_context(shared, 1, false, 4);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    parallel_context.for_each_module([&](blm::Module &, blm::PassContext &) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        const std::lock_guard lock(mutex);
+        threads.insert(std::this_thread::get_id());
+        return false;
+    });
+
+    /* the modules would allocate from one slab concurrently, so they run on the caller */
+    ASSERT_EQ(threads.size(), 1);
+    EXPECT_EQ(*threads.begin(), std::this_thread::get_id());
+}
+
+TEST_F(IPOPassManagerFixture, ProfilesEveryRun)
+{
+    manager->add_pass<TestIPOPassA>();
+
+    blm::Profiler profiler;
+    manager->set_profiler(&profiler);
+    manager->run_pass<TestIPOPassA>();
+    manager->run_pass<TestIPOPassA>();
+
+    const auto &events = profiler.get_events();
+    ASSERT_EQ(events.size(), 2);
+    for (const auto &event: events)
+    {
+        EXPECT_EQ(event.name, "test-ipo-pass-a");
+        EXPECT_EQ(event.category, "ipo-pass");
+        EXPECT_EQ(event.parent, blm::Profiler::NO_EVENT);
+        ASSERT_EQ(event.stats.size(), 1);
+        EXPECT_EQ(event.stats[0].first, "test.modules_processed");
+        EXPECT_EQ(event.stats[0].second, 3);
+    }
+
+    /* both runs count towards the printed time */
+    std::stringstream output;
+    manager->print_statistics(output);
+    EXPECT_NE(output.str().find("test-ipo-pass-a"), std::string::npos);
+}
+
+TEST_F(IPOPassContextFixture, ForEachModuleProfilesModules)
+{
+    blm::Profiler profiler;
+    pass_context->set_profiler(&profiler);
+
+    std::size_t outer;
+    {
+        const blm::Profiler::Scope scope(&profiler, "outer", "ipo-pass");
+        outer = scope.event();
+        pass_context->for_each_module([](blm::Module &, blm::PassContext &local) {
+            return local.get_profiler() != nullptr;
+        });
+    }
+
+    std::size_t module_events = 0;
+    for (const auto &event: profiler.get_events())
+    {
+        if (event.category != "module")
+            continue;
+        ++module_events;
+        EXPECT_EQ(event.parent, outer);
+        EXPECT_TRUE(event.name == "module1" || event.name == "module2");
+    }
+    EXPECT_EQ(module_events, 2);
+}
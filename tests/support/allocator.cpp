@@ -2,8 +2,11 @@
 
 #include <memory>
 #include <string>
+#include <thread>
+#include <unordered_set>
 #include <utility>
 #include <vector>
+#include <bloom/foundation/context.hpp>
 #include <bloom/support/allocator.hpp>
 #include <gtest/gtest.h>
 
@@ -198,3 +201,242 @@ TEST_F(AllocatorFixture, SharedState)
 
     alloc2.deallocate(ptr, 1);
 }
+
+TEST_F(AllocatorFixture, ArenaBumpAllocation)
+{
+    ach::arena arena;
+    EXPECT_EQ(arena.allocate(0), nullptr);
+
+    auto* a = static_cast<char*>(arena.allocate(24, 8));
+    auto* b = static_cast<char*>(arena.allocate(24, 8));
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+
+    /* consecutive small allocations come from the same chunk */
+    EXPECT_EQ(b - a, 24);
+    EXPECT_EQ(arena.chunk_count(), 1);
+
+    auto* aligned = arena.allocate(1, 64);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 64, 0);
+}
+
+TEST_F(AllocatorFixture, ArenaLargeAllocation)
+{
+    ach::arena arena(64 * 1024);
+    void* small = arena.allocate(16);
+    const std::size_t chunks = arena.chunk_count();
+
+    /* a large request gets its own chunk and does not retire the current one */
+    auto* large = static_cast<char*>(arena.allocate(1024 * 1024));
+    ASSERT_NE(large, nullptr);
+    large[0] = 1;
+    large[1024 * 1024 - 1] = 2;
+    EXPECT_EQ(arena.chunk_count(), chunks + 1);
+    EXPECT_GE(arena.bytes_reserved(), 1024 * 1024);
+
+    auto* next = static_cast<char*>(arena.allocate(16));
+    EXPECT_EQ(next - static_cast<char*>(small), 16);
+}
+
+TEST_F(AllocatorFixture, ArenasDoNotShareChunks)
+{
+    ach::arena first;
+    ach::arena second;
+
+    void* a = first.allocate(32);
+    void* b = second.allocate(32);
+    void* c = first.allocate(32);
+    EXPECT_EQ(static_cast<char*>(c) - static_cast<char*>(a), 32);
+    EXPECT_NE(b, c);
+    EXPECT_EQ(first.chunk_count(), 1);
+    EXPECT_EQ(second.chunk_count(), 1);
+}
+
+TEST_F(AllocatorFixture, ArenasWithCollidingIdsKeepTheirChunks)
+{
+    /* ids are consecutive, so the first and last of five agree in their low two bits */
+    std::vector<std::unique_ptr<ach::arena>> arenas;
+    for (int i = 0; i < 5; ++i)
+        arenas.push_back(std::make_unique<ach::arena>());
+
+    ach::arena& first = *arenas.front();
+    ach::arena& last = *arenas.back();
+    for (int round = 0; round < 64; ++round)
+    {
+        ASSERT_NE(first.allocate(32), nullptr);
+        ASSERT_NE(last.allocate(32), nullptr);
+    }
+    EXPECT_EQ(first.chunk_count(), 1);
+    EXPECT_EQ(last.chunk_count(), 1);
+}
+
+TEST_F(AllocatorFixture, ArenaConcurrentAllocation)
+{
+    constexpr int threads = 8;
+    constexpr int per_thread = 20000;
+
+    ach::arena arena(16 * 1024);
+    std::vector<std::vector<std::uint64_t*>> results(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t]
+        {
+            results[t].reserve(per_thread);
+            for (int i = 0; i < per_thread; ++i)
+            {
+                auto* slot = static_cast<std::uint64_t*>(arena.allocate(sizeof(std::uint64_t) * 2, 8));
+                slot[0] = static_cast<std::uint64_t>(t);
+                slot[1] = static_cast<std::uint64_t>(i);
+                results[t].push_back(slot);
+            }
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+
+    /* every block is distinct and kept what its thread wrote */
+    std::unordered_set<std::uint64_t*> seen;
+    for (int t = 0; t < threads; ++t)
+    {
+        for (int i = 0; i < per_thread; ++i)
+        {
+            std::uint64_t* slot = results[t][i];
+            ASSERT_TRUE(seen.insert(slot).second);
+            ASSERT_EQ(slot[0], static_cast<std::uint64_t>(t));
+            ASSERT_EQ(slot[1], static_cast<std::uint64_t>(i));
+        }
+    }
+    EXPECT_GT(arena.chunk_count(), static_cast<std::size_t>(threads));
+}
+
+TEST_F(AllocatorFixture, ConcurrentNodeCreation)
+{
+    constexpr int threads = 8;
+    constexpr int per_thread = 10000;
+
+    blm::Context context;
+    ASSERT_EQ(context.get_node_allocation(), blm::NodeAllocation::ARENA);
+
+    std::vector<std::vector<blm::Node*>> nodes(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t]
+        {
+            blm::Node* prev = nullptr;
+            for (int i = 0; i < per_thread; ++i)
+            {
+                auto* node = context.create<blm::Node>();
+                node->ir_type = blm::NodeType::ADD;
+                node->str_id = static_cast<blm::StringTable::StringId>(t);
+                if (prev)
+                    node->inputs.push_back(prev);
+                nodes[t].push_back(node);
+                prev = node;
+            }
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+
+    for (int t = 0; t < threads; ++t)
+    {
+        for (int i = 0; i < per_thread; ++i)
+        {
+            const blm::Node* node = nodes[t][i];
+            ASSERT_EQ(reinterpret_cast<std::uintptr_t>(node) % alignof(blm::Node), 0);
+            ASSERT_EQ(node->str_id, static_cast<blm::StringTable::StringId>(t));
+            ASSERT_EQ(node->inputs.size(), i == 0 ? 0u : 1u);
+            if (i > 0)
+            {
+                ASSERT_EQ(node->inputs[0], nodes[t][i - 1]);
+            }
+        }
+    }
+    EXPECT_GE(context.get_arena().bytes_reserved(), threads * per_thread * sizeof(blm::Node));
+}
+
+TEST_F(AllocatorFixture, SlabPacksWithoutHeaders)
+{
+    ach::slab slab;
+    EXPECT_EQ(slab.allocate(0), nullptr);
+
+    auto* a = static_cast<char*>(slab.allocate(24, 8));
+    auto* b = static_cast<char*>(slab.allocate(24, 8));
+    auto* c = static_cast<char*>(slab.allocate(20, 4));
+    EXPECT_EQ(b - a, 24);
+    EXPECT_EQ(c - b, 24); /* 20 bytes share the 24-byte class */
+
+    auto* wide = slab.allocate(48, 16);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(wide) % 16, 0);
+    EXPECT_EQ(ach::slab::slot_size(sizeof(blm::Node), alignof(blm::Node)), sizeof(blm::Node));
+    EXPECT_EQ(slab.bytes_reserved(), 2 * ach::slab::PAGE_SIZE);
+}
+
+TEST_F(AllocatorFixture, SlabReusesFreedBlocks)
+{
+    ach::slab slab;
+    std::vector<void*> blocks;
+    for (int i = 0; i < 10000; ++i)
+        blocks.push_back(slab.allocate(32, 8));
+    const std::size_t reserved = slab.bytes_reserved();
+
+    /* free every other block; the next allocations fill the holes without new pages */
+    std::unordered_set<void*> freed;
+    for (std::size_t i = 0; i < blocks.size(); i += 2)
+    {
+        slab.deallocate(blocks[i]);
+        freed.insert(blocks[i]);
+    }
+    for (std::size_t i = 0; i < freed.size(); ++i)
+        EXPECT_TRUE(freed.contains(slab.allocate(32, 8)));
+    EXPECT_EQ(slab.bytes_reserved(), reserved);
+}
+
+TEST_F(AllocatorFixture, SlabLargeAndOveraligned)
+{
+    ach::slab slab;
+    auto* large = static_cast<char*>(slab.allocate(200000));
+    ASSERT_NE(large, nullptr);
+    large[0] = 1;
+    large[199999] = 2;
+
+    void* overaligned = slab.allocate(64, 256);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(overaligned) % 256, 0);
+
+    const std::size_t reserved = slab.bytes_reserved();
+    slab.deallocate(large);
+    EXPECT_LT(slab.bytes_reserved(), reserved);
+    slab.deallocate(overaligned);
+    EXPECT_EQ(slab.bytes_reserved(), 0);
+}
+
+TEST_F(AllocatorFixture, SlabCreateDestroy)
+{
+    ach::slab slab;
+    auto* obj = slab.create<ComplexType>("slab", 7, 2.5);
+    EXPECT_EQ(obj->name, "slab");
+
+    {
+        std::unique_ptr<ComplexType, ach::slab_deleter<ComplexType>> owned(
+            slab.create<ComplexType>("owned", 1, 1.0), { &slab });
+        EXPECT_EQ(owned->value, 1);
+    }
+
+    /* the block released by the deleter is handed out again */
+    auto* again = slab.create<ComplexType>("again", 2, 2.0);
+    slab.destroy(obj);
+    slab.destroy(again);
+}
+
+TEST_F(AllocatorFixture, SlabNodeAllocation)
+{
+    blm::Context context(blm::NodeAllocation::SLAB);
+    auto* first = context.create<blm::Node>();
+    auto* second = context.create<blm::Node>();
+    EXPECT_EQ(reinterpret_cast<char*>(second) - reinterpret_cast<char*>(first),
+              static_cast<std::ptrdiff_t>(sizeof(blm::Node)));
+    EXPECT_EQ(context.get_slab().bytes_reserved(), ach::slab::PAGE_SIZE);
+    EXPECT_EQ(context.get_arena().chunk_count(), 0);
+}
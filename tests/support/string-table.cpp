@@ -1,6 +1,8 @@
 /* this project is part of the Bloom Project; licensed under the MIT license. see LICENSE for more info */
 
+#include <string>
 #include <thread>
+#include <vector>
 #include <bloom/support/string-table.hpp>
 #include <gtest/gtest.h>
 
@@ -64,3 +66,64 @@ TEST_F(StringTableFixture, ClearResetsTable)
 	EXPECT_FALSE(table.contains("one"));
 	EXPECT_EQ(table.intern(""), 0);
 }
+
+TEST_F(StringTableFixture, IdsSpanDirectorySegments)
+{
+	std::vector<blm::StringTable::StringId> ids;
+	for (int i = 0; i < 5000; ++i)
+		ids.push_back(table.intern("name_" + std::to_string(i)));
+
+	EXPECT_EQ(table.size(), 5001);
+	for (int i = 0; i < 5000; ++i)
+		EXPECT_EQ(table.get(ids[i]), "name_" + std::to_string(i));
+
+	EXPECT_EQ(table.get(table.size()), "");
+	EXPECT_EQ(table.get(blm::StringTable::INVALID_STRING_ID), "");
+}
+
+TEST_F(StringTableFixture, InternCopiesTheString)
+{
+	blm::StringTable::StringId id;
+	{
+		std::string temporary = "short_lived";
+		id = table.intern(temporary);
+		temporary.assign("overwritten");
+	}
+
+	EXPECT_EQ(table.get(id), "short_lived");
+	EXPECT_EQ(table.get(id).data()[table.get(id).size()], '\0');
+	EXPECT_EQ(table.intern(std::string_view("short_lived_suffix").substr(0, 11)), id);
+}
+
+TEST_F(StringTableFixture, ConcurrentInternAgreesOnIds)
+{
+	constexpr int threads = 8;
+	constexpr int names = 2000;
+
+	std::vector<std::vector<blm::StringTable::StringId> > seen(threads, std::vector<blm::StringTable::StringId>(names));
+	std::vector<std::thread> workers;
+	for (int t = 0; t < threads; ++t)
+	{
+		workers.emplace_back([&, t]
+		{
+			/* every thread walks the names from a different starting point */
+			for (int i = 0; i < names; ++i)
+			{
+				const int n = (i + t * names / threads) % names;
+				const auto id = table.intern("symbol_" + std::to_string(n));
+				seen[t][n] = id;
+				EXPECT_EQ(table.get(id), "symbol_" + std::to_string(n));
+			}
+		});
+	}
+	for (std::thread &worker: workers)
+		worker.join();
+
+	EXPECT_EQ(table.size(), names + 1);
+	for (int n = 0; n < names; ++n)
+	{
+		for (int t = 1; t < threads; ++t)
+			EXPECT_EQ(seen[t][n], seen[0][n]);
+		EXPECT_TRUE(table.contains("symbol_" + std::to_string(n)));
+	}
+}
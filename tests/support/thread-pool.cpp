@@ -0,0 +1,67 @@
+/* this project is part of the Bloom Project; licensed under the MIT license. see LICENSE for more info */
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include <bloom/support/thread-pool.hpp>
+#include <gtest/gtest.h>
+
+TEST(ThreadPoolTest, ZeroThreadsUsesAtLeastOneWorker)
+{
+	const blm::ThreadPool pool(0);
+	EXPECT_GE(pool.size(), 1);
+}
+
+TEST(ThreadPoolTest, VisitsEveryIndexOnce)
+{
+	blm::ThreadPool pool(4);
+	EXPECT_EQ(pool.size(), 4);
+
+	std::vector<std::atomic<int> > visits(1000);
+	pool.parallel_for(visits.size(), [&](const std::size_t index, const std::size_t worker)
+	{
+		EXPECT_LT(worker, pool.size());
+		visits[index].fetch_add(1);
+	});
+
+	for (const auto &count: visits)
+		EXPECT_EQ(count.load(), 1);
+}
+
+TEST(ThreadPoolTest, RunsSeveralJobsInTurn)
+{
+	blm::ThreadPool pool(3);
+	std::atomic<std::size_t> sum = 0;
+	for (int job = 0; job < 50; ++job)
+		pool.parallel_for(10, [&](const std::size_t index, std::size_t) { sum += index; });
+
+	EXPECT_EQ(sum.load(), 50 * 45);
+}
+
+TEST(ThreadPoolTest, SingleWorkerRunsOnCallingThread)
+{
+	blm::ThreadPool pool(1);
+	std::vector<std::size_t> order;
+	pool.parallel_for(5, [&](const std::size_t index, const std::size_t worker)
+	{
+		EXPECT_EQ(worker, 0);
+		order.push_back(index);
+	});
+
+	EXPECT_EQ(order, (std::vector<std::size_t> { 0, 1, 2, 3, 4 }));
+}
+
+TEST(ThreadPoolTest, RethrowsExceptionFromWorker)
+{
+	blm::ThreadPool pool(4);
+	EXPECT_THROW(pool.parallel_for(100, [](const std::size_t index, std::size_t)
+	{
+		if (index == 42)
+			throw std::runtime_error("failed");
+	}), std::runtime_error);
+
+	/* the pool stays usable */
+	std::atomic<int> calls = 0;
+	pool.parallel_for(8, [&](std::size_t, std::size_t) { ++calls; });
+	EXPECT_EQ(calls.load(), 8);
+}
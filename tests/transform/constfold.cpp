@@ -882,3 +882,97 @@ TEST_F(ConstantFoldingPassFixture, IntAndFloatMixedTypesNotFolded)
     EXPECT_FALSE(changed);
     EXPECT_EQ(ret->inputs[0], add);
 }
+
+TEST_F(ConstantFoldingPassFixture, FoldsChainListedBeforeItsInputs)
+{
+    /* every add is listed before the add it reads, so folding has to follow users */
+    auto* region = module->create_region("test_function");
+
+    auto* one = region->create_node<blm::Node>();
+    one->ir_type = blm::NodeType::LIT;
+    one->type_kind = blm::DataType::INT32;
+    one->data.set<int32_t, blm::DataType::INT32>(1);
+
+    auto* ret = region->create_node<blm::Node>();
+    ret->ir_type = blm::NodeType::RET;
+
+    constexpr int length = 64;
+    blm::Node* previous = one;
+    for (int i = 0; i < length; ++i)
+    {
+        auto* add = context->create<blm::Node>();
+        add->ir_type = blm::NodeType::ADD;
+        add->type_kind = blm::DataType::INT32;
+        add->inputs.push_back(previous);
+        add->inputs.push_back(one);
+        previous->users.push_back(add);
+        one->users.push_back(add);
+        region->insert_at_beginning(add);
+        previous = add;
+    }
+    ret->inputs.push_back(previous);
+    previous->users.push_back(ret);
+
+    blm::PassContext pass_ctx(*module, 1);
+    blm::ConstantFoldingPass const_fold;
+    EXPECT_TRUE(const_fold.run(*module, pass_ctx));
+
+    EXPECT_EQ(pass_ctx.get_stat("constant_folding.folded_nodes"), length);
+    ASSERT_EQ(ret->inputs[0]->ir_type, blm::NodeType::LIT);
+    EXPECT_EQ(ret->inputs[0]->as<blm::DataType::INT32>(), length + 1);
+    EXPECT_EQ(region->get_nodes().size(), 2);
+
+    /* nothing is left to fold */
+    blm::PassContext second_ctx(*module, 1);
+    EXPECT_FALSE(const_fold.run(*module, second_ctx));
+}
+
+TEST_F(ConstantFoldingPassFixture, FoldedBranchDoesNotPreserveCFG)
+{
+    auto* region = module->create_region("test_function");
+    auto* then_region = module->create_region("then", region);
+    auto* else_region = module->create_region("else", region);
+
+    auto* then_entry = then_region->create_node<blm::Node>();
+    then_entry->ir_type = blm::NodeType::ENTRY;
+    auto* else_entry = else_region->create_node<blm::Node>();
+    else_entry->ir_type = blm::NodeType::ENTRY;
+
+    auto* lit1 = region->create_node<blm::Node>();
+    lit1->ir_type = blm::NodeType::LIT;
+    lit1->type_kind = blm::DataType::INT32;
+    lit1->data.set<int32_t, blm::DataType::INT32>(1);
+
+    auto* add = region->create_node<blm::Node>();
+    add->ir_type = blm::NodeType::ADD;
+    add->type_kind = blm::DataType::INT32;
+    add->inputs.push_back(lit1);
+    add->inputs.push_back(lit1);
+    lit1->users.push_back(add);
+
+    auto* ret = region->create_node<blm::Node>();
+    ret->ir_type = blm::NodeType::RET;
+    ret->inputs.push_back(add);
+    add->users.push_back(ret);
+
+    /* folding only arithmetic keeps the CFG */
+    blm::PassContext pass_ctx(*module, 1);
+    blm::ConstantFoldingPass const_fold;
+    EXPECT_TRUE(const_fold.run(*module, pass_ctx));
+    EXPECT_TRUE(const_fold.preserved_analyses().preserves_cfg());
+
+    auto* cond = region->create_node<blm::Node>();
+    cond->ir_type = blm::NodeType::LIT;
+    cond->type_kind = blm::DataType::BOOL;
+    cond->data.set<bool, blm::DataType::BOOL>(true);
+
+    auto* branch = region->create_node<blm::Node>();
+    branch->ir_type = blm::NodeType::BRANCH;
+    branch->inputs = { cond, then_entry, else_entry };
+    cond->users.push_back(branch);
+    then_entry->users.push_back(branch);
+    else_entry->users.push_back(branch);
+
+    EXPECT_TRUE(const_fold.run(*module, pass_ctx));
+    EXPECT_FALSE(const_fold.preserved_analyses().preserves_cfg());
+}
@@ -1,8 +1,10 @@
 /* this project is part of the Bloom Project; licensed under the MIT license. see LICENSE for more info */
 
+#include <bloom/analysis/dominators.hpp>
 #include <bloom/foundation/context.hpp>
 #include <bloom/foundation/module.hpp>
 #include <bloom/foundation/pass-context.hpp>
+#include <bloom/foundation/pass-manager.hpp>
 #include <bloom/foundation/region.hpp>
 #include <bloom/transform/dce.hpp>
 #include <gtest/gtest.h>
@@ -360,3 +362,31 @@ TEST_F(DCEPassFixture, SupportsNestedRegions)
     EXPECT_EQ(pass_ctx.get_stat("dce.removed_nodes"), 1);
     EXPECT_TRUE(inner_region->get_nodes().empty());
 }
+
+TEST_F(DCEPassFixture, KeepsDominatorTree)
+{
+    auto* region = module->create_region("test_function");
+
+    auto* entry = region->create_node<blm::Node>();
+    entry->ir_type = blm::NodeType::ENTRY;
+
+    auto* lit = region->create_node<blm::Node>();
+    lit->ir_type = blm::NodeType::LIT;
+    lit->type_kind = blm::DataType::INT32;
+    lit->data.set<int32_t, blm::DataType::INT32>(42);
+
+    auto* ret = region->create_node<blm::Node>();
+    ret->ir_type = blm::NodeType::RET;
+
+    blm::PassManager manager(*module, 1);
+    manager.add_pass<blm::DominatorTreeAnalysisPass>();
+    manager.add_pass<blm::DCEPass>();
+    ASSERT_TRUE(manager.run_pass<blm::DominatorTreeAnalysisPass>());
+    const blm::DominatorTree* tree = blm::get_dominator_tree(manager.get_context());
+    ASSERT_NE(tree, nullptr);
+
+    /* removing dead nodes leaves the control flow alone */
+    EXPECT_TRUE(manager.run_pass<blm::DCEPass>());
+    EXPECT_EQ(region->get_nodes().size(), 2);
+    EXPECT_EQ(blm::get_dominator_tree(manager.get_context()), tree);
+}
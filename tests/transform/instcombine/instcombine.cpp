@@ -287,7 +287,9 @@ TEST_F(InstcombinePassTest, AdvancedBitwisePatterns)
 	print_ir();
 	std::size_t simplified = run_agbs();
 	print_ir();
-	EXPECT_EQ(simplified, 3);
+
+	/* both patterns, then the `x + x` they leave and the `x * 2` that becomes */
+	EXPECT_EQ(simplified, 4);
 }
 
 TEST_F(InstcombinePassTest, ComparisonStrengthReduction)
@@ -475,7 +477,9 @@ TEST_F(InstcombinePassTest, ShiftIdentities)
 	print_ir("before");
 	std::size_t simplified = run_agbs();
 	print_ir("after");
-	EXPECT_EQ(simplified, 7);
+
+	/* the four shifts, then the adds they leave behind, down to a single `x << 1` */
+	EXPECT_EQ(simplified, 8);
 }
 
 TEST_F(InstcombinePassTest, SimpleMultiplicationDebug)
@@ -517,3 +521,70 @@ TEST_F(InstcombinePassTest, SimpleMultiplicationDebug)
 	EXPECT_GT(shift_count, 0);
 	EXPECT_EQ(mul_count, 0);
 }
+
+TEST_F(InstcombinePassTest, RewritesNodesBuiltByRules)
+{
+	auto func = builder->create_function("test", {}, DataType::INT32);
+	auto x = func.add_parameter("x", DataType::INT32);
+	auto z = func.add_parameter("z", DataType::INT32);
+
+	func.body([&]
+	{
+		/* x - (x & ~z) = x & ~~z, whose new ~~z only simplifies on a revisit */
+		auto not_z = builder->bnot(z);
+		auto and_xz = builder->band(x, not_z);
+		auto sub = builder->sub(x, and_xz);
+		builder->ret(sub);
+	});
+
+	PassContext pass_ctx(*module);
+	InstcombinePass pass;
+	EXPECT_TRUE(pass.run(*module, pass_ctx));
+	EXPECT_EQ(pass_ctx.get_stat("instcombine.rewritten_nodes"), 2);
+	EXPECT_GE(pass_ctx.get_stat("instcombine.visited_nodes"), 5);
+
+	/* `x & ~z` and the `~z` only it used are gone along with the rewritten nodes */
+	EXPECT_EQ(pass_ctx.get_stat("instcombine.erased_nodes"), 2);
+
+	Node *ret_node = nullptr;
+	std::size_t not_count = 0;
+	for (Node *node: module->get_root_region()->get_children()[0]->get_nodes())
+	{
+		if (node->ir_type == NodeType::RET)
+			ret_node = node;
+		if (node->ir_type == NodeType::BNOT)
+			not_count++;
+	}
+	ASSERT_NE(ret_node, nullptr);
+	EXPECT_EQ(not_count, 0);
+
+	Node *result = ret_node->inputs[0];
+	ASSERT_EQ(result->ir_type, NodeType::BAND);
+	EXPECT_EQ(result->inputs[0], x);
+	EXPECT_EQ(result->inputs[1], z);
+}
+
+TEST_F(InstcombinePassTest, ReachesFixpointInOneRun)
+{
+	auto func = builder->create_function("test", {}, DataType::INT32);
+	auto x = func.add_parameter("x", DataType::INT32);
+
+	func.body([&]
+	{
+		/* each step only simplifies once the one before it has */
+		auto step = builder->add(x, builder->literal(0));
+		for (int i = 0; i < 8; ++i)
+			step = builder->mul(builder->add(step, builder->literal(0)), builder->literal(1));
+		builder->ret(step);
+	});
+
+	PassContext first_ctx(*module);
+	InstcombinePass pass;
+	EXPECT_TRUE(pass.run(*module, first_ctx));
+	EXPECT_EQ(first_ctx.get_stat("instcombine.rewritten_nodes"), 17);
+
+	/* nothing is left for a second run */
+	PassContext second_ctx(*module);
+	EXPECT_FALSE(pass.run(*module, second_ctx));
+	EXPECT_EQ(second_ctx.get_stat("instcombine.rewritten_nodes"), 0);
+}
@@ -0,0 +1,169 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <bloom/foundation/context.hpp>
+#include <bloom/foundation/node.hpp>
+#include <bloom/transform/instcombine/rewrite-rule.hpp>
+#include <gtest/gtest.h>
+
+using namespace blm;
+
+namespace
+{
+	/* counts how many rule bodies ran, to see which rules dispatch tried */
+	struct CountingState : RewriteState
+	{
+		int tried = 0;
+	};
+
+	Node *try_and_fail(CountingState &s)
+	{
+		++s.tried;
+		return nullptr;
+	}
+
+	constexpr auto rules = make_rule_set(
+		Rewrite::binary<NodeType::ADD>( /* never fires */
+			Rewrite::to([](CountingState &s) { return try_and_fail(s); })),
+		Rewrite::binary<NodeType::ADD, NodeType::SUB>( /* x op x -> lhs */
+			Rewrite::same_operands(),
+			Rewrite::to([](CountingState &s)
+			{
+				++s.tried;
+				return s.lhs();
+			})),
+		Rewrite::binary<NodeType::ADD>( /* fallback -> rhs */
+			Rewrite::to([](CountingState &s)
+			{
+				++s.tried;
+				return s.rhs();
+			})),
+		Rewrite::unary<NodeType::BNOT>(
+			Rewrite::when([](const CountingState &s) { return s.operand()->ir_type == NodeType::BNOT; }),
+			Rewrite::to([](CountingState &s)
+			{
+				++s.tried;
+				return s.operand()->inputs[0];
+			})),
+		Rewrite::binary<NodeType::MUL>( /* returning the node itself is no rewrite */
+			Rewrite::to([](CountingState &s)
+			{
+				++s.tried;
+				return s.node;
+			}))
+	);
+}
+
+class RewriteRuleTest : public ::testing::Test
+{
+protected:
+	Node *make(const NodeType type, std::vector<Node *> inputs = {})
+	{
+		Node *node = ctx.create<Node>();
+		node->ir_type = type;
+		node->type_kind = DataType::INT32;
+		node->inputs = std::move(inputs);
+		return node;
+	}
+
+	static CountingState state_for(Node *node)
+	{
+		CountingState state;
+		state.node = node;
+		return state;
+	}
+
+	Context ctx;
+};
+
+TEST_F(RewriteRuleTest, CountsRulesPerRoot)
+{
+	static_assert(decltype(rules)::rule_count(NodeType::ADD) == 3);
+	static_assert(decltype(rules)::rule_count(NodeType::SUB) == 1);
+	static_assert(decltype(rules)::rule_count(NodeType::BNOT) == 1);
+	static_assert(decltype(rules)::rule_count(NodeType::DIV) == 0);
+}
+
+TEST_F(RewriteRuleTest, FirstMatchingRuleWins)
+{
+	Node *x = make(NodeType::PARAM);
+	Node *y = make(NodeType::PARAM);
+
+	auto same = state_for(make(NodeType::ADD, { x, x }));
+	EXPECT_EQ(rules.apply(same), BTStatus::SUCCESS);
+	EXPECT_EQ(same.result, x);
+	EXPECT_EQ(same.tried, 2);
+	EXPECT_TRUE(same.has_changed());
+
+	auto different = state_for(make(NodeType::ADD, { x, y }));
+	EXPECT_EQ(rules.apply(different), BTStatus::SUCCESS);
+	EXPECT_EQ(different.result, y);
+	EXPECT_EQ(different.tried, 2);
+}
+
+TEST_F(RewriteRuleTest, TriesOnlyRulesOfTheRootOpcode)
+{
+	Node *x = make(NodeType::PARAM);
+	Node *y = make(NodeType::PARAM);
+
+	/* the ADD-only rules are never entered for a SUB */
+	auto sub = state_for(make(NodeType::SUB, { x, y }));
+	EXPECT_EQ(rules.apply(sub), BTStatus::FAILURE);
+	EXPECT_EQ(sub.tried, 0);
+	EXPECT_EQ(sub.result, nullptr);
+
+	auto div = state_for(make(NodeType::DIV, { x, y }));
+	EXPECT_EQ(rules.apply(div), BTStatus::FAILURE);
+	EXPECT_FALSE(div.has_changed());
+}
+
+TEST_F(RewriteRuleTest, ChecksOperandCount)
+{
+	Node *x = make(NodeType::PARAM);
+
+	auto unary_add = state_for(make(NodeType::ADD, { x }));
+	EXPECT_EQ(rules.apply(unary_add), BTStatus::FAILURE);
+	EXPECT_EQ(unary_add.tried, 0);
+
+	auto null_operand = state_for(make(NodeType::ADD, { x, nullptr }));
+	EXPECT_EQ(rules.apply(null_operand), BTStatus::FAILURE);
+	EXPECT_EQ(null_operand.tried, 0);
+
+	Node *inner = make(NodeType::BNOT, { x });
+	auto double_not = state_for(make(NodeType::BNOT, { inner }));
+	EXPECT_EQ(rules.apply(double_not), BTStatus::SUCCESS);
+	EXPECT_EQ(double_not.result, x);
+}
+
+TEST_F(RewriteRuleTest, RewriteToSelfFails)
+{
+	Node *x = make(NodeType::PARAM);
+
+	auto mul = state_for(make(NodeType::MUL, { x, x }));
+	EXPECT_EQ(rules.apply(mul), BTStatus::FAILURE);
+	EXPECT_EQ(mul.tried, 1);
+	EXPECT_EQ(mul.result, nullptr);
+}
+
+TEST_F(RewriteRuleTest, LinearMatchAgrees)
+{
+	Node *x = make(NodeType::PARAM);
+	Node *y = make(NodeType::PARAM);
+	const std::vector nodes = {
+		make(NodeType::ADD, { x, x }),
+		make(NodeType::ADD, { x, y }),
+		make(NodeType::SUB, { y, y }),
+		make(NodeType::SUB, { x, y }),
+		make(NodeType::BNOT, { make(NodeType::BNOT, { y }) }),
+		make(NodeType::MUL, { x, y }),
+		make(NodeType::LIT),
+	};
+
+	for (Node *node: nodes)
+	{
+		auto indexed = state_for(node);
+		auto linear = state_for(node);
+		EXPECT_EQ(rules.apply(indexed), rules.apply_linear(linear));
+		EXPECT_EQ(indexed.result, linear.result);
+		EXPECT_EQ(indexed.tried, linear.tried);
+	}
+}
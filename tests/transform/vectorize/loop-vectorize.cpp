@@ -0,0 +1,417 @@
+/* this project is part of the bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <functional>
+#include <map>
+#include <gtest/gtest.h>
+#include <bloom/analysis/laa.hpp>
+#include <bloom/ir/builder.hpp>
+#include <bloom/foundation/pass-context.hpp>
+#include <bloom/transform/vectorize/loop-vectorize.hpp>
+
+using namespace blm;
+
+class LoopVectorizeTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		ctx = std::make_unique<blm::Context>();
+		builder = std::make_unique<blm::Builder>(*ctx);
+		module = builder->create_module("test_module");
+	}
+
+	void TearDown() override
+	{
+		builder.reset();
+		ctx.reset();
+	}
+
+	std::size_t run_vectorizer(const VectorTarget* target = nullptr)
+	{
+		PassContext pass_ctx(*module);
+
+		LocalAliasAnalysisPass laa;
+		auto laa_result = laa.analyze(*module, pass_ctx);
+		pass_ctx.store_result(typeid(LocalAliasAnalysisPass), std::move(laa_result));
+
+		LoopVectorizePass pass = target ? LoopVectorizePass(*target) : LoopVectorizePass();
+		pass.run(*module, pass_ctx);
+
+		rejected_loops = pass_ctx.get_stat("loop_vectorize.rejected_loops");
+		widened_nodes = pass_ctx.get_stat("loop_vectorize.widened_nodes");
+		return pass_ctx.get_stat("loop_vectorize.vectorized_loops");
+	}
+
+	/* for (i = 0; i < trip_count; ++i) body(i); over three float arrays `a`, `b` and `c`, or over
+	 * pointer parameters if `pointer_params` */
+	void build_loop(const std::function<void(Node*)>& body, const bool pointer_params = false,
+	                const std::int64_t trip_count = 100, const DataType counter_type = DataType::INT32)
+	{
+		index_type = counter_type;
+		const DataType ptr = builder->pointer_type(DataType::FLOAT32);
+		auto func = pointer_params
+			            ? builder->create_function("kernel", { ptr, ptr, ptr }, DataType::VOID)
+			            : builder->create_function("kernel", {}, DataType::VOID);
+		if (pointer_params)
+		{
+			a = func.add_parameter("a", ptr);
+			b = func.add_parameter("b", ptr);
+			c = func.add_parameter("c", ptr);
+		}
+
+		func.body([&]
+		{
+			auto loop = builder->create_while_loop("header", "body", "exit");
+			header = loop.header.get_region();
+			body_region = loop.body.get_region();
+
+			if (!pointer_params)
+			{
+				a = builder->stack_alloc(builder->literal(400u), DataType::FLOAT32);
+				b = builder->stack_alloc(builder->literal(400u), DataType::FLOAT32);
+				c = builder->stack_alloc(builder->literal(400u), DataType::FLOAT32);
+			}
+			counter = builder->stack_alloc(builder->literal(4), DataType::INT32);
+			builder->store(index_literal(0), counter);
+			preheader_jump = builder->jump(header->get_nodes()[0]);
+
+			loop.header([&]
+			{
+				auto *i = builder->load(counter, index_type);
+				auto *condition = builder->lt(i, index_literal(trip_count));
+				builder->branch(condition,
+				                body_region->get_nodes()[0],
+				                loop.exit.get_region()->get_nodes()[0]);
+			});
+
+			loop.body([&]
+			{
+				auto *i = builder->load(counter, index_type);
+				body(i);
+				builder->store(builder->add(i, index_literal(1)), counter);
+				builder->jump(header->get_nodes()[0]);
+			});
+
+			loop.exit([&]
+			{
+				builder->ret();
+			});
+		});
+	}
+
+	/* address of `base[i + offset]` for 4-byte elements */
+	Node* element(Node* base, Node* i, const int offset = 0) const
+	{
+		Node* index = i;
+		if (offset > 0)
+			index = builder->add(i, index_literal(offset));
+		else if (offset < 0)
+			index = builder->sub(i, index_literal(-offset));
+		return builder->ptr_add(base, builder->mul(index, index_literal(4)));
+	}
+
+	/* literal of the counter's type */
+	Node* index_literal(const std::int64_t value) const
+	{
+		if (index_type == DataType::UINT8)
+			return builder->literal(static_cast<std::uint8_t>(value));
+		return builder->literal(static_cast<std::int32_t>(value));
+	}
+
+	/* evaluates the integer and boolean nodes of the vector loop control with the counter at `i` */
+	std::int64_t evaluate(const Node* node, const std::int64_t i) const
+	{
+		auto wrap = [&](const std::int64_t value)
+		{
+			return index_type == DataType::UINT8
+				       ? static_cast<std::int64_t>(static_cast<std::uint8_t>(value))
+				       : static_cast<std::int64_t>(static_cast<std::int32_t>(value));
+		};
+
+		switch (node->ir_type)
+		{
+			case NodeType::LIT:
+				return node->type_kind == DataType::UINT8 ? node->as<DataType::UINT8>() : node->as<DataType::INT32>();
+			case NodeType::LOAD:
+				return i;
+			case NodeType::ADD:
+				return wrap(evaluate(node->inputs[0], i) + evaluate(node->inputs[1], i));
+			case NodeType::SUB:
+				return wrap(evaluate(node->inputs[0], i) - evaluate(node->inputs[1], i));
+			case NodeType::GTE:
+				return evaluate(node->inputs[0], i) >= evaluate(node->inputs[1], i);
+			case NodeType::LTE:
+				return evaluate(node->inputs[0], i) <= evaluate(node->inputs[1], i);
+			case NodeType::BAND:
+				return evaluate(node->inputs[0], i) & evaluate(node->inputs[1], i);
+			default:
+				ADD_FAILURE() << "unexpected node in vector loop control";
+				return 0;
+		}
+	}
+
+	/* runs the vector loop and then the scalar epilogue from i = 0; returns how often each
+	 * element was visited */
+	std::map<std::int64_t, int> simulate(const std::int64_t trip_count) const
+	{
+		const Region* vector_header = find_region("header.vec");
+		const Region* vector_body = vector_header->get_children()[0];
+		const Node* condition = vector_header->get_nodes().back()->inputs[0];
+		const Node* step = nullptr;
+		for (const Node* node: vector_body->get_nodes())
+		{
+			if (node->ir_type == NodeType::STORE && node->inputs[1] == counter)
+				step = node->inputs[0];
+		}
+
+		std::map<std::int64_t, int> visits;
+		std::int64_t i = 0;
+		for (int guard = 0; guard < 1000 && evaluate(condition, i); ++guard)
+		{
+			for (std::uint32_t lane = 0; lane < LoopVectorizePass::DEFAULT_VF; ++lane)
+				visits[i + lane]++;
+			i = evaluate(step, i);
+		}
+		for (; i < trip_count; ++i)
+			visits[i]++;
+		return visits;
+	}
+
+	/* c[i] = a[i] + b[i] */
+	void build_add_loop(const bool pointer_params = false)
+	{
+		build_loop([&](Node* i)
+		{
+			auto* x = builder->ptr_load(element(a, i), DataType::FLOAT32);
+			auto* y = builder->ptr_load(element(b, i), DataType::FLOAT32);
+			builder->ptr_store(builder->add(x, y), element(c, i));
+		}, pointer_params);
+	}
+
+	Region* find_region(const std::string_view name) const
+	{
+		for (Region* region: header->get_parent()->get_children())
+		{
+			if (region->get_name() == name)
+				return region;
+		}
+		return nullptr;
+	}
+
+	static std::size_t count(const Region* region, const NodeType type, const DataType type_kind)
+	{
+		std::size_t n = 0;
+		for (const Node* node: region->get_nodes())
+			n += node->ir_type == type && node->type_kind == type_kind;
+		return n;
+	}
+
+	std::unique_ptr<Context> ctx;
+	std::unique_ptr<Builder> builder;
+	Module* module = nullptr;
+	Region* header = nullptr;
+	Region* body_region = nullptr;
+	Node* a = nullptr;
+	Node* b = nullptr;
+	Node* c = nullptr;
+	Node* counter = nullptr;
+	Node* preheader_jump = nullptr;
+	DataType index_type = DataType::INT32;
+	std::size_t rejected_loops = 0;
+	std::size_t widened_nodes = 0;
+};
+
+TEST_F(LoopVectorizeTest, VectorizesElementwiseLoop)
+{
+	build_add_loop();
+	const std::size_t scalar_body_size = body_region->get_nodes().size();
+
+	EXPECT_EQ(run_vectorizer(), 1);
+	EXPECT_EQ(rejected_loops, 0);
+	EXPECT_EQ(widened_nodes, 4);
+
+	Region* vector_header = find_region("header.vec");
+	ASSERT_NE(vector_header, nullptr);
+	ASSERT_EQ(vector_header->get_children().size(), 1);
+	const Region* vector_body = vector_header->get_children()[0];
+	EXPECT_EQ(vector_body->get_name(), "body.vec");
+
+	const DataType vector_type = ctx->create_vector_type(DataType::FLOAT32, LoopVectorizePass::DEFAULT_VF);
+	EXPECT_EQ(count(vector_body, NodeType::PTR_LOAD, vector_type), 2);
+	EXPECT_EQ(count(vector_body, NodeType::ADD, vector_type), 1);
+	const Node* store = nullptr;
+	for (const Node* node: vector_body->get_nodes())
+	{
+		if (node->ir_type == NodeType::PTR_STORE)
+			store = node;
+	}
+	ASSERT_NE(store, nullptr);
+	EXPECT_EQ(store->inputs[0]->type_kind, vector_type);
+
+	/* the loop is entered through the vector header, which leaves for the scalar loop */
+	EXPECT_EQ(preheader_jump->inputs[0], vector_header->get_nodes().front());
+	const Node* branch = vector_header->get_nodes().back();
+	ASSERT_EQ(branch->ir_type, NodeType::BRANCH);
+	EXPECT_EQ(branch->inputs[0]->ir_type, NodeType::BAND);
+	EXPECT_EQ(branch->inputs[1], vector_body->get_nodes().front());
+	EXPECT_EQ(branch->inputs[2], header->get_nodes().front());
+	EXPECT_EQ(vector_body->get_nodes().back()->inputs[0], vector_header->get_nodes().front());
+
+	/* the scalar loop stays as the epilogue */
+	EXPECT_EQ(body_region->get_nodes().size(), scalar_body_size);
+	EXPECT_EQ(count(body_region, NodeType::PTR_LOAD, DataType::FLOAT32), 2);
+}
+
+TEST_F(LoopVectorizeTest, LeavesRemainderToScalarEpilogue)
+{
+	/* 103 = 25 * 4 + 3 */
+	build_loop([&](Node* i)
+	{
+		auto* x = builder->ptr_load(element(a, i), DataType::FLOAT32);
+		builder->ptr_store(x, element(c, i));
+	}, false, 103);
+	ASSERT_EQ(run_vectorizer(), 1);
+
+	const auto visits = simulate(103);
+	ASSERT_EQ(visits.size(), 103);
+	EXPECT_EQ(visits.begin()->first, 0);
+	EXPECT_EQ(visits.rbegin()->first, 102);
+	for (const auto& [element, count]: visits)
+		EXPECT_EQ(count, 1) << "element " << element;
+}
+
+TEST_F(LoopVectorizeTest, NarrowCounterDoesNotWrap)
+{
+	/* a UINT8 counter up to 255: `i + VF` wraps to 0 at i = 252 */
+	build_loop([&](Node* i)
+	{
+		auto* x = builder->ptr_load(element(a, i), DataType::FLOAT32);
+		builder->ptr_store(x, element(c, i));
+	}, false, 255, DataType::UINT8);
+	ASSERT_EQ(run_vectorizer(), 1);
+
+	const auto visits = simulate(255);
+	ASSERT_EQ(visits.size(), 255);
+	EXPECT_EQ(visits.rbegin()->first, 254);
+	for (const auto& [element, count]: visits)
+		EXPECT_EQ(count, 1) << "element " << element;
+}
+
+TEST_F(LoopVectorizeTest, SplatsLoopInvariantOperands)
+{
+	build_loop([&](Node* i)
+	{
+		auto* x = builder->ptr_load(element(a, i), DataType::FLOAT32);
+		builder->ptr_store(builder->mul(x, builder->literal(2.0f)), element(c, i));
+	});
+
+	EXPECT_EQ(run_vectorizer(), 1);
+	const Region* vector_body = find_region("header.vec")->get_children()[0];
+	const DataType vector_type = ctx->create_vector_type(DataType::FLOAT32, LoopVectorizePass::DEFAULT_VF);
+	EXPECT_EQ(count(vector_body, NodeType::VECTOR_SPLAT, vector_type), 1);
+	EXPECT_EQ(count(vector_body, NodeType::MUL, vector_type), 1);
+}
+
+TEST_F(LoopVectorizeTest, RejectsLoopCarriedDependence)
+{
+	/* a[i + 1] = a[i] + b[i] reads what the previous iteration wrote */
+	build_loop([&](Node* i)
+	{
+		auto* x = builder->ptr_load(element(a, i), DataType::FLOAT32);
+		auto* y = builder->ptr_load(element(b, i), DataType::FLOAT32);
+		builder->ptr_store(builder->add(x, y), element(a, i, 1));
+	});
+
+	EXPECT_EQ(run_vectorizer(), 0);
+	EXPECT_EQ(rejected_loops, 1);
+	EXPECT_EQ(find_region("header.vec"), nullptr);
+}
+
+TEST_F(LoopVectorizeTest, AllowsDependencesTheVectorLoopKeeps)
+{
+	/* a[i] = a[i + 1] + b[i] reads each element before a later iteration writes it */
+	build_loop([&](Node* i)
+	{
+		auto* x = builder->ptr_load(element(a, i, 1), DataType::FLOAT32);
+		auto* y = builder->ptr_load(element(b, i), DataType::FLOAT32);
+		builder->ptr_store(builder->add(x, y), element(a, i));
+	});
+	EXPECT_EQ(run_vectorizer(), 1);
+}
+
+TEST_F(LoopVectorizeTest, AllowsDependencesAVectorApart)
+{
+	/* a[i + VF] = a[i] + b[i] reads what a previous vector iteration wrote */
+	build_loop([&](Node* i)
+	{
+		auto* x = builder->ptr_load(element(a, i), DataType::FLOAT32);
+		auto* y = builder->ptr_load(element(b, i), DataType::FLOAT32);
+		builder->ptr_store(builder->add(x, y), element(a, i, LoopVectorizePass::DEFAULT_VF));
+	});
+	EXPECT_EQ(run_vectorizer(), 1);
+}
+
+TEST_F(LoopVectorizeTest, RejectsPointersThatMayAlias)
+{
+	build_add_loop(true);
+	EXPECT_EQ(run_vectorizer(), 0);
+	EXPECT_EQ(rejected_loops, 1);
+}
+
+TEST_F(LoopVectorizeTest, RejectsCounterUsedAsValue)
+{
+	/* c[i] = a[i] + i needs a vector of indices */
+	build_loop([&](Node* i)
+	{
+		auto* x = builder->ptr_load(element(a, i), DataType::INT32);
+		builder->ptr_store(builder->add(x, i), element(c, i));
+	});
+	EXPECT_EQ(run_vectorizer(), 0);
+	EXPECT_EQ(rejected_loops, 1);
+}
+
+TEST_F(LoopVectorizeTest, RejectsNonUnitStride)
+{
+	/* c[2 * i] = a[i] */
+	build_loop([&](Node* i)
+	{
+		auto* x = builder->ptr_load(element(a, i), DataType::FLOAT32);
+		builder->ptr_store(x, builder->ptr_add(c, builder->mul(i, builder->literal(8))));
+	});
+	EXPECT_EQ(run_vectorizer(), 0);
+	EXPECT_EQ(rejected_loops, 1);
+}
+
+TEST_F(LoopVectorizeTest, ChoosesVFFromTarget)
+{
+	build_add_loop();
+	EXPECT_EQ(run_vectorizer(&VectorTarget::x86_64_avx2()), 1);
+
+	Region* vector_header = find_region("header.vec");
+	ASSERT_NE(vector_header, nullptr);
+	const Region* vector_body = vector_header->get_children()[0];
+	EXPECT_EQ(count(vector_body, NodeType::ADD, ctx->create_vector_type(DataType::FLOAT32, 8)), 1);
+
+	/* the vector header leaves room for one VF of iterations */
+	const Node* limit = nullptr;
+	for (const Node* node: vector_header->get_nodes())
+	{
+		if (node->ir_type == NodeType::SUB)
+			limit = node;
+	}
+	ASSERT_NE(limit, nullptr);
+	EXPECT_EQ(limit->inputs[1]->as<DataType::INT32>(), 8);
+}
+
+TEST_F(LoopVectorizeTest, RejectsOperationsTheTargetLacks)
+{
+	/* no 64-bit lane multiply on NEON */
+	build_loop([&](Node* i)
+	{
+		auto* x = builder->ptr_load(builder->ptr_add(a, builder->mul(i, builder->literal(8))), DataType::INT64);
+		auto* y = builder->ptr_load(builder->ptr_add(b, builder->mul(i, builder->literal(8))), DataType::INT64);
+		builder->ptr_store(builder->mul(x, y), builder->ptr_add(c, builder->mul(i, builder->literal(8))));
+	});
+	EXPECT_EQ(run_vectorizer(&VectorTarget::aarch64_neon()), 0);
+	EXPECT_EQ(rejected_loops, 1);
+}
@@ -24,7 +24,7 @@ protected:
 		ctx.reset();
 	}
 
-	std::pair<std::size_t, std::size_t> run_slp()
+	std::pair<std::size_t, std::size_t> run_slp(const VectorTarget* target = nullptr)
 	{
 		PassContext pass_ctx(*module);
 
@@ -32,9 +32,13 @@ protected:
 		auto laa_result = laa.analyze(*module, pass_ctx);
 		pass_ctx.store_result(typeid(LocalAliasAnalysisPass), std::move(laa_result));
 
-		SLPPass slp;
+		SLPPass slp = target ? SLPPass(*target) : SLPPass();
 		slp.run(*module, pass_ctx);
 
+		store_groups = pass_ctx.get_stat("slp.store_groups");
+		rejected_store_groups = pass_ctx.get_stat("slp.rejected_store_groups");
+		rejected_candidates = pass_ctx.get_stat("slp.rejected_candidates");
+		cycles_saved = pass_ctx.get_stat("slp.estimated_cycles_saved");
 		return {
 			pass_ctx.get_stat("slp.vectorized_operations"),
 			pass_ctx.get_stat("slp.vector_groups")
@@ -59,6 +63,32 @@ protected:
 		return count;
 	}
 
+	/* address of the `index`th float past `base` */
+	Node* element(Node* base, int index) const
+	{
+		return builder->ptr_add(base, builder->literal(index * 4));
+	}
+
+	/* c[i] = a[i] * b[i] over two 64-bit integers */
+	void build_multiply_kernel() const
+	{
+		auto func = builder->create_function("test", {}, DataType::VOID);
+		func.body([&]
+		{
+			auto a = builder->stack_alloc(builder->literal(16u), DataType::INT64);
+			auto b = builder->stack_alloc(builder->literal(16u), DataType::INT64);
+			auto c = builder->stack_alloc(builder->literal(16u), DataType::INT64);
+			for (int i = 0; i < 2; ++i)
+			{
+				auto offset = builder->literal(i * 8);
+				auto x = builder->ptr_load(builder->ptr_add(a, offset), DataType::INT64);
+				auto y = builder->ptr_load(builder->ptr_add(b, offset), DataType::INT64);
+				builder->ptr_store(builder->mul(x, y), builder->ptr_add(c, offset));
+			}
+			builder->ret(nullptr);
+		});
+	}
+
 	std::size_t count_node_type(NodeType type, const Region* region = nullptr) const
 	{
 		if (!region)
@@ -80,6 +110,10 @@ protected:
 	std::unique_ptr<Context> ctx;
 	std::unique_ptr<Builder> builder;
 	Module* module = nullptr;
+	std::size_t store_groups = 0;
+	std::size_t rejected_store_groups = 0;
+	std::size_t rejected_candidates = 0;
+	std::size_t cycles_saved = 0;
 };
 
 TEST_F(SLPPassTest, VectorizesIndependentAdds)
@@ -436,3 +470,218 @@ TEST_F(SLPPassTest, HandlesBitwiseOperations)
 	EXPECT_EQ(vector_groups, 2);    /* one for ANDs, one for ORs */
 	EXPECT_EQ(vectorized_ops, 4);   /* 2 ands + 2 ors */
 }
+
+TEST_F(SLPPassTest, VectorizesAdjacentLoadsAndStores)
+{
+	auto func = builder->create_function("test", {}, DataType::VOID);
+	func.body([&]
+	{
+		auto a = builder->stack_alloc(builder->literal(16u), DataType::FLOAT32);
+		auto b = builder->stack_alloc(builder->literal(16u), DataType::FLOAT32);
+		auto c = builder->stack_alloc(builder->literal(16u), DataType::FLOAT32);
+
+		/* c[i] = a[i] + b[i] */
+		for (int i = 0; i < 4; ++i)
+		{
+			auto x = builder->ptr_load(element(a, i), DataType::FLOAT32);
+			auto y = builder->ptr_load(element(b, i), DataType::FLOAT32);
+			builder->ptr_store(builder->add(x, y), element(c, i));
+		}
+		builder->ret(nullptr);
+	});
+
+	auto [vectorized_ops, vector_groups] = run_slp();
+
+	EXPECT_EQ(store_groups, 1);
+	EXPECT_EQ(vector_groups, 1);
+	EXPECT_EQ(vectorized_ops, 16); /* 4 stores, 4 adds and 8 loads */
+
+	EXPECT_EQ(count_node_type(NodeType::PTR_STORE), 1);
+	EXPECT_EQ(count_node_type(NodeType::PTR_LOAD), 2);
+	EXPECT_EQ(count_node_type(NodeType::ADD), 1);
+	EXPECT_EQ(count_node_type(NodeType::VECTOR_BUILD), 0);
+	EXPECT_EQ(count_node_type(NodeType::VECTOR_EXTRACT), 0);
+	EXPECT_EQ(count_vector_operations(), 3);
+}
+
+TEST_F(SLPPassTest, GroupsOnlyAdjacentStores)
+{
+	auto func = builder->create_function("test", {}, DataType::VOID);
+	func.body([&]
+	{
+		auto a = builder->stack_alloc(builder->literal(32u), DataType::FLOAT32);
+		auto b = builder->stack_alloc(builder->literal(32u), DataType::FLOAT32);
+
+		/* b[i] = a[i] for i = 0, 1 and 3 */
+		for (const int i: { 0, 1, 3 })
+			builder->ptr_store(builder->ptr_load(element(a, i), DataType::FLOAT32), element(b, i));
+		builder->ret(nullptr);
+	});
+
+	run_slp();
+
+	EXPECT_EQ(store_groups, 1);
+	EXPECT_EQ(count_node_type(NodeType::PTR_STORE), 2);
+	EXPECT_EQ(count_node_type(NodeType::PTR_LOAD), 2);
+	EXPECT_EQ(count_vector_operations(), 1);
+}
+
+TEST_F(SLPPassTest, RejectsStoresNeedingMoreGathersThanTheySave)
+{
+	auto func = builder->create_function("test", {}, DataType::VOID);
+	func.body([&]
+	{
+		auto a = builder->stack_alloc(builder->literal(16u), DataType::FLOAT32);
+		for (int i = 0; i < 4; ++i)
+			builder->ptr_store(builder->literal(static_cast<float>(i) + 0.5f), element(a, i));
+		builder->ret(nullptr);
+	});
+
+	auto [vectorized_ops, vector_groups] = run_slp();
+
+	/* saves 3 stores but builds the vector out of 4 scalars */
+	EXPECT_EQ(rejected_store_groups, 1);
+	EXPECT_EQ(store_groups, 0);
+	EXPECT_EQ(vectorized_ops, 0);
+	EXPECT_EQ(count_node_type(NodeType::PTR_STORE), 4);
+	EXPECT_EQ(count_node_type(NodeType::VECTOR_BUILD), 0);
+}
+
+TEST_F(SLPPassTest, SplatsStoresOfOneValue)
+{
+	auto func = builder->create_function("test", {}, DataType::VOID);
+	func.body([&]
+	{
+		auto a = builder->stack_alloc(builder->literal(16u), DataType::FLOAT32);
+		auto value = builder->literal(1.5f);
+		for (int i = 0; i < 4; ++i)
+			builder->ptr_store(value, element(a, i));
+		builder->ret(nullptr);
+	});
+
+	run_slp();
+
+	EXPECT_EQ(store_groups, 1);
+	EXPECT_EQ(count_node_type(NodeType::PTR_STORE), 1);
+	EXPECT_EQ(count_node_type(NodeType::VECTOR_SPLAT), 1);
+}
+
+TEST_F(SLPPassTest, DoesNotMoveStoresPastAliasingAccess)
+{
+	auto func = builder->create_function("test", {}, DataType::VOID);
+	func.body([&]
+	{
+		auto a = builder->stack_alloc(builder->literal(16u), DataType::FLOAT32);
+		auto b = builder->stack_alloc(builder->literal(16u), DataType::FLOAT32);
+
+		auto x = builder->ptr_load(element(a, 0), DataType::FLOAT32);
+		auto y = builder->ptr_load(element(a, 1), DataType::FLOAT32);
+		builder->ptr_store(x, element(b, 0));
+
+		/* overwrites b[0]; the first store cannot sink past it */
+		builder->ptr_store(builder->literal(7), element(b, 0));
+		builder->ptr_store(y, element(b, 1));
+		builder->ret(nullptr);
+	});
+
+	run_slp();
+
+	EXPECT_EQ(store_groups, 0);
+	EXPECT_EQ(rejected_store_groups, 1);
+	EXPECT_EQ(count_node_type(NodeType::PTR_STORE), 3);
+	EXPECT_EQ(count_vector_operations(), 0);
+}
+
+TEST_F(SLPPassTest, ExtractsLanesUsedOutsideTheTree)
+{
+	auto func = builder->create_function("test", {}, DataType::VOID);
+	func.body([&]
+	{
+		auto a = builder->stack_alloc(builder->literal(16u), DataType::FLOAT32);
+		auto b = builder->stack_alloc(builder->literal(16u), DataType::FLOAT32);
+		auto c = builder->stack_alloc(builder->literal(4u), DataType::FLOAT32);
+
+		std::vector<Node*> loads;
+		for (int i = 0; i < 4; ++i)
+		{
+			loads.push_back(builder->ptr_load(element(a, i), DataType::FLOAT32));
+			builder->ptr_store(loads.back(), element(b, i));
+		}
+
+		/* reads lane 2 of the vector load after the group */
+		builder->ptr_store(loads[2], c);
+		builder->ret(nullptr);
+	});
+
+	run_slp();
+
+	EXPECT_EQ(store_groups, 1);
+	EXPECT_EQ(count_node_type(NodeType::VECTOR_EXTRACT), 1);
+	EXPECT_EQ(count_node_type(NodeType::PTR_STORE), 2);
+	EXPECT_EQ(count_node_type(NodeType::PTR_LOAD), 1);
+}
+
+TEST_F(SLPPassTest, ChoosesWidthFromTargetRegisters)
+{
+	auto func = builder->create_function("test", {}, DataType::VOID);
+	func.body([&]
+	{
+		auto a = builder->stack_alloc(builder->literal(64u), DataType::FLOAT32);
+		auto b = builder->stack_alloc(builder->literal(64u), DataType::FLOAT32);
+		for (int i = 0; i < 16; ++i)
+			builder->ptr_store(builder->ptr_load(element(a, i), DataType::FLOAT32), element(b, i));
+		builder->ret(nullptr);
+	});
+
+	/* 16 floats are four SSE registers */
+	run_slp(&VectorTarget::x86_64_sse());
+
+	EXPECT_EQ(store_groups, 4);
+	EXPECT_EQ(count_node_type(NodeType::PTR_STORE), 4);
+	EXPECT_EQ(cycles_saved, 24); /* 32 scalar loads and stores for 8 vector ones */
+}
+
+TEST_F(SLPPassTest, GathersOperationsTheTargetLacks)
+{
+	build_multiply_kernel();
+
+	/* NEON has no 64-bit lane multiply; gathering the products costs more than it saves */
+	run_slp(&VectorTarget::aarch64_neon());
+
+	EXPECT_EQ(store_groups, 0);
+	EXPECT_EQ(rejected_store_groups, 1);
+	EXPECT_EQ(count_vector_operations(), 0);
+}
+
+TEST_F(SLPPassTest, PacksOperationsTheTargetHas)
+{
+	build_multiply_kernel();
+	run_slp(&VectorTarget::x86_64_avx512());
+
+	EXPECT_EQ(store_groups, 1);
+	EXPECT_EQ(count_node_type(NodeType::MUL), 1);
+	EXPECT_EQ(cycles_saved, 2); /* 8 scalar cycles for 2 loads, a store and a 3-cycle multiply */
+}
+
+TEST_F(SLPPassTest, RejectsCandidatesThatCostCycles)
+{
+	auto func = builder->create_function("test", {}, DataType::VOID);
+	func.body([&]
+	{
+		auto x = builder->literal(1);
+		auto y = builder->literal(2);
+		auto ptr1 = builder->stack_alloc(builder->literal(4u), DataType::INT32);
+		auto ptr2 = builder->stack_alloc(builder->literal(4u), DataType::INT32);
+		builder->store(builder->add(x, y), ptr1);
+		builder->store(builder->add(y, x), ptr2);
+		builder->ret(nullptr);
+	});
+
+	/* two adds do not pay for building their operands and extracting both results */
+	auto [vectorized_ops, vector_groups] = run_slp(&VectorTarget::x86_64_avx2());
+
+	EXPECT_EQ(vectorized_ops, 0);
+	EXPECT_EQ(vector_groups, 0);
+	EXPECT_EQ(rejected_candidates, 1);
+	EXPECT_EQ(count_vector_operations(), 0);
+}
@@ -0,0 +1,57 @@
+/* this project is part of the Bloom project; licensed under the MIT license. see LICENSE for more info */
+
+#include <bloom/transform/vectorize/vector-target.hpp>
+#include <gtest/gtest.h>
+
+using namespace blm;
+
+TEST(VectorTargetTest, LanesFollowRegisterWidth)
+{
+	EXPECT_EQ(VectorTarget::x86_64_sse().get_max_lanes(DataType::FLOAT32), 4);
+	EXPECT_EQ(VectorTarget::x86_64_avx2().get_max_lanes(DataType::FLOAT32), 8);
+	EXPECT_EQ(VectorTarget::x86_64_avx512().get_max_lanes(DataType::INT8), 64);
+	EXPECT_EQ(VectorTarget::aarch64_neon().get_max_lanes(DataType::FLOAT64), 2);
+	EXPECT_EQ(VectorTarget::x86_64_avx2().get_max_lanes(DataType::BOOL), 0);
+}
+
+TEST(VectorTargetTest, VectorCostCountsRegisters)
+{
+	const VectorTarget &sse = VectorTarget::x86_64_sse();
+	EXPECT_EQ(sse.get_vector_cost(NodeType::ADD, DataType::INT32, 4), 1);
+	EXPECT_EQ(sse.get_vector_cost(NodeType::ADD, DataType::INT32, 8), 2);
+	EXPECT_EQ(sse.get_vector_cost(NodeType::ADD, DataType::INT32, 3), 1);
+	EXPECT_EQ(sse.get_vector_cost(NodeType::CALL, DataType::INT32, 4), VectorTarget::UNSUPPORTED);
+}
+
+TEST(VectorTargetTest, ElementCostsOverrideOpcodeCosts)
+{
+	const VectorTarget &neon = VectorTarget::aarch64_neon();
+	EXPECT_EQ(neon.get_vector_cost(NodeType::MUL, DataType::INT32, 4), 2);
+	EXPECT_EQ(neon.get_vector_cost(NodeType::MUL, DataType::INT64, 2), VectorTarget::UNSUPPORTED);
+	EXPECT_EQ(neon.get_vector_cost(NodeType::DIV, DataType::INT32, 4), VectorTarget::UNSUPPORTED);
+	EXPECT_NE(neon.get_vector_cost(NodeType::DIV, DataType::FLOAT32, 4), VectorTarget::UNSUPPORTED);
+	EXPECT_EQ(VectorTarget::x86_64_avx512().get_vector_cost(NodeType::MUL, DataType::UINT64, 8), 3);
+}
+
+TEST(VectorTargetTest, CustomTargets)
+{
+	VectorTarget target("custom", 64);
+	EXPECT_EQ(target.get_max_lanes(DataType::INT16), 0);
+
+	target.add_element_type(DataType::INT16)
+	      .set_cost(NodeType::ADD, { 2, 3 })
+	      .set_cost(NodeType::ADD, DataType::INT16, { 1, 1 })
+	      .set_shuffle_costs(4, 5, 6);
+	EXPECT_EQ(target.get_max_lanes(DataType::INT16), 4);
+	EXPECT_EQ(target.get_scalar_cost(NodeType::ADD, DataType::INT16), 1);
+	EXPECT_EQ(target.get_scalar_cost(NodeType::ADD, DataType::INT32), 2);
+	EXPECT_EQ(target.get_vector_cost(NodeType::ADD, DataType::INT32, 2), VectorTarget::UNSUPPORTED);
+	EXPECT_EQ(target.get_extract_cost(), 5);
+}
+
+TEST(VectorTargetTest, FindsPresetsByName)
+{
+	EXPECT_EQ(VectorTarget::find("avx2"), &VectorTarget::x86_64_avx2());
+	EXPECT_EQ(VectorTarget::find("neon"), &VectorTarget::aarch64_neon());
+	EXPECT_EQ(VectorTarget::find("altivec"), nullptr);
+}